@@ -421,6 +421,86 @@ weed_error_t weed_set_custom_array(weed_plant_t *plant, const char *key, uint32_
   return weed_leaf_set(plant, key, seed_type, num_elems, (weed_voidptr_t)values);
 }
 
+#ifdef WEED_HAVE_KEY_INTERN
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// variants using interned keys
+
+int weed_plant_has_leaf_k(weed_plant_t *plant, const weed_key_t *key) {
+  if (weed_leaf_get_k(plant, key, 0, NULL) == WEED_SUCCESS) return WEED_TRUE;
+  return WEED_FALSE;
+}
+
+
+static inline weed_error_t weed_value_get_k(weed_plant_t *plant, const weed_key_t *key, uint32_t seed_type,
+    weed_voidptr_t retval) {
+  uint32_t st = weed_leaf_seed_type_k(plant, key);
+  if (st == WEED_SEED_INVALID) return WEED_ERROR_NOSUCH_LEAF;
+  if (st != seed_type) return WEED_ERROR_WRONG_SEED_TYPE;
+  return weed_leaf_get_k(plant, key, 0, retval);
+}
+
+
+static inline weed_voidptr_t weed_get_arrayx_k(weed_plant_t *plant, const weed_key_t *key,
+    uint32_t seed_type, weed_size_t typelen, int *elems) {
+  char *retvals = NULL;
+  weed_size_t num_elems;
+  if (elems) *elems = 0;
+  if (weed_leaf_seed_type_k(plant, key) != seed_type) return NULL;
+  if (!(num_elems = weed_leaf_num_elements_k(plant, key))) return NULL;
+  if (!(retvals = (char *)(*_calloc_func)(num_elems, typelen))) return NULL;
+  for (weed_size_t i = 0; i < num_elems; i++) {
+    if (weed_leaf_get_k(plant, key, (int32_t)i, (weed_voidptr_t)&retvals[i * typelen]) != WEED_SUCCESS) {
+      (*_free_func)(retvals);
+      return NULL;
+    }
+  }
+  if (elems) *elems = (int)num_elems;
+  return retvals;
+}
+
+
+int32_t weed_get_int_value_k(weed_plant_t *plant, const weed_key_t *key, weed_error_t *error) {
+  int32_t retval = 0;
+  weed_error_t err = weed_value_get_k(plant, key, WEED_SEED_INT, &retval);
+  if (error) *error = err;
+  return retval;
+}
+
+
+int32_t weed_get_boolean_value_k(weed_plant_t *plant, const weed_key_t *key, weed_error_t *error) {
+  int32_t retval = WEED_FALSE;
+  weed_error_t err = weed_value_get_k(plant, key, WEED_SEED_BOOLEAN, &retval);
+  if (error) *error = err;
+  return retval;
+}
+
+
+double weed_get_double_value_k(weed_plant_t *plant, const weed_key_t *key, weed_error_t *error) {
+  double retval = 0.;
+  weed_error_t err = weed_value_get_k(plant, key, WEED_SEED_DOUBLE, &retval);
+  if (error) *error = err;
+  return retval;
+}
+
+
+weed_voidptr_t weed_get_voidptr_value_k(weed_plant_t *plant, const weed_key_t *key, weed_error_t *error) {
+  weed_voidptr_t retval = NULL;
+  weed_error_t err = weed_value_get_k(plant, key, WEED_SEED_VOIDPTR, &retval);
+  if (error) *error = err;
+  return retval;
+}
+
+
+int32_t *weed_get_int_array_counted_k(weed_plant_t *plant, const weed_key_t *key, int *count) {
+  return (int32_t *)(weed_get_arrayx_k(plant, key, WEED_SEED_INT, 4, count));
+}
+
+
+weed_voidptr_t *weed_get_voidptr_array_counted_k(weed_plant_t *plant, const weed_key_t *key, int *count) {
+  return (weed_voidptr_t *)(weed_get_arrayx_k(plant, key, WEED_SEED_VOIDPTR, WEED_VOIDPTR_SIZE, count));
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int32_t weed_get_plant_type(weed_plant_t *plant) {
@@ -114,6 +114,19 @@ weed_voidptr_t *weed_get_voidptr_array_counted(weed_plant_t *, const char *key,
 weed_plant_t **weed_get_plantptr_array_counted(weed_plant_t *, const char *key, int *count);
 weed_voidptr_t *weed_get_custom_array_counted(weed_plant_t *, const char *key, uint32_t seed_type, int *count);
 
+#ifdef WEED_HAVE_KEY_INTERN
+/* variants taking a key handle from weed_key_intern(), these avoid rehashing the key on every call.
+   Only getters are provided: setting goes through weed_leaf_set, which the host may override */
+int weed_plant_has_leaf_k(weed_plant_t *, const weed_key_t *key);
+
+int32_t weed_get_int_value_k(weed_plant_t *, const weed_key_t *key, weed_error_t *);
+int32_t weed_get_boolean_value_k(weed_plant_t *, const weed_key_t *key, weed_error_t *);
+double weed_get_double_value_k(weed_plant_t *, const weed_key_t *key, weed_error_t *);
+void *weed_get_voidptr_value_k(weed_plant_t *, const weed_key_t *key, weed_error_t *);
+int32_t *weed_get_int_array_counted_k(weed_plant_t *, const weed_key_t *key, int *count);
+weed_voidptr_t *weed_get_voidptr_array_counted_k(weed_plant_t *, const weed_key_t *key, int *count);
+#endif
+
 /* make a copy dest leaf from src leaf. Pointers are copied by reference only, but strings are allocated */
 weed_error_t weed_leaf_copy(weed_plant_t *dest, const char *keyt, weed_plant_t *src, const char *keyf);
 
@@ -98,10 +98,19 @@ typedef struct {
   pthread_mutex_t	data_mutex;
 } leaf_priv_data_t;
 
+/// open addressed index of the leaves in a plant, keyed by key_hash
+typedef struct {
+  weed_size_t		size; // always a power of 2
+  weed_size_t		nused; // live entries + tombstones
+  weed_leaf_t		*slots[];
+} leaf_index_t;
+
 typedef struct {
   leaf_priv_data_t	ldata;
   pthread_rwlock_t	reader_count;
   pthread_mutex_t	structure_mutex;
+  leaf_index_t		*index; // NULL unless indexing is enabled and the plant has grown large enough
+  weed_size_t		nleaves; // not counting the plant itself
 } plant_priv_data_t;
 
 #define is_plant(leaf) (leaf->key_hash == WEED_MAGIC_HASH)
@@ -123,6 +132,8 @@ typedef struct {
 
 #define get_count_lock(plant) (&(((plant_priv_data_t *)((plant)->private_data))->reader_count))
 
+#define get_plant_pdata(plant) ((plant_priv_data_t *)((plant)->private_data))
+
 #define data_lock_unlock(obj) do {					\
     if ((obj)) pthread_rwlock_unlock(get_data_lock((obj)));} while (0)
 
@@ -217,6 +228,7 @@ static int chain_lock_upgrade(weed_leaf_t *leaf, int have_rdlock, int is_del) {
 
 static int allbugfixes = 0;
 static int debugmode = 0;
+static int use_index = 0;
 
 static int32_t _abi_ = WEED_ABI_VERSION;
 
@@ -247,6 +259,8 @@ static weed_error_t _weed_leaf_get_private_data(weed_plant_t *, const char *key,
 /* internal functions */
 static weed_leaf_t *weed_find_leaf(weed_plant_t *, const char *key, uint32_t *hash_ret)
   GNU_FLATTEN GNU_HOT;
+static weed_leaf_t *weed_find_leaf_hashed(weed_plant_t *, const char *key, uint32_t hash, uint32_t *hash_ret)
+  GNU_FLATTEN GNU_HOT;
 static weed_leaf_t *weed_leaf_new(const char *key, uint32_t seed_type, uint32_t hash) GNU_FLATTEN;
 
 static int weed_strcmp(const char *, const char *) GNU_HOT;
@@ -294,6 +308,7 @@ EXPORTED weed_error_t weed_init(int32_t abi, uint64_t init_flags) {
 
   if (init_flags & WEED_INIT_ALLBUGFIXES) allbugfixes = 1;
   if (init_flags & WEED_INIT_DEBUGMODE) debugmode = 1;
+  if (init_flags & WEED_INIT_HASHINDEX) use_index = 1;
 
   if (debugmode) {
     fprintf(stderr, "Weed padding size is %d\n", _WEED_PADBYTES_);
@@ -368,52 +383,174 @@ static uint32_t weed_hash(const char *key) {
 					     seed_type == WEED_SEED_INT64 ? 8 : \
 					     seed_type == WEED_SEED_STRING ? size : 0)
 
-static inline void *weed_data_free(weed_data_t **data, weed_size_t num_valid_elems,
-				   weed_size_t num_elems, uint32_t seed_type) {
-  int is_nonptr = !weed_seed_is_ptr(seed_type);
-  for (weed_size_t i = 0; i < num_valid_elems; i++) {
-    if (is_nonptr && data[i]->value.voidptr)
-      weed_unmalloc_and_copy(data[i]->size, data[i]->value.voidptr);
-    weed_unmalloc_sizeof(weed_data_t, data[i]);
+// the data for a leaf is held in a single block: the array of element pointers, then the elements
+// themselves, then (for non-pointer types) the values which the elements point to.
+// Thus setting a leaf costs just one allocation, however many values it has. Since the data is only
+// ever replaced as a whole, never modified in place, the elements do not need to be freed separately
+#define WEED_DATA_ALIGN 8
+#define WEED_DATA_HDR_SIZE(num_elems) ((((num_elems) * (sizeof(weed_data_t *) + sizeof(weed_data_t))) \
+					 + WEED_DATA_ALIGN - 1) & ~(WEED_DATA_ALIGN - 1))
+
+static inline size_t weed_data_block_size(weed_data_t **data, weed_size_t num_elems, uint32_t seed_type) {
+  size_t bsize = WEED_DATA_HDR_SIZE(num_elems);
+  if (!weed_seed_is_ptr(seed_type)) {
+    if (seed_type != WEED_SEED_STRING) bsize += num_elems * weed_seed_get_size(seed_type, 0);
+    else for (weed_size_t i = 0; i < num_elems; i++) bsize += data[i]->size;
   }
-  weed_unmalloc_and_copy(num_elems * sizeof(weed_data_t *), data);
+  return bsize;
+}
+
+static inline void *weed_data_free(weed_data_t **data, weed_size_t num_elems, uint32_t seed_type) {
+#ifdef USE_GSLICE
+  // the slice allocator needs the size of the block back
+  weed_unmalloc_and_copy(weed_data_block_size(data, num_elems, seed_type), data);
+#else
+  (void)num_elems; (void)seed_type;
+  free(data);
+#endif
   return NULL;
 }
 
 static inline weed_data_t **weed_data_new(uint32_t seed_type, weed_size_t num_elems,
 					  weed_voidptr_t values) {
-  weed_data_t **data;
+  weed_data_t **data, *elems;
+  char **valuec = (char **)values;
+  weed_voidptr_t *valuep = (weed_voidptr_t *)values;
+  weed_funcptr_t *valuef = (weed_funcptr_t *)values;
+  size_t hsize = WEED_DATA_HDR_SIZE(num_elems), bsize = hsize;
+  size_t vsize = weed_seed_get_size(seed_type, 0);
+  char *payload;
+
   if (!num_elems) return NULL;
-  if (!(data = (weed_data_t **)weed_malloc(num_elems * sizeof(weed_data_t *)))) return NULL;
-  else {
-    char **valuec = (char **)values;
-    weed_voidptr_t *valuep = (weed_voidptr_t *)values;
-    weed_funcptr_t *valuef = (weed_funcptr_t *)values;
-    int is_ptr = (weed_seed_is_ptr(seed_type));
-    for (int i = 0; i < num_elems; i++) {
-      if (!(data[i] = weed_malloc_sizeof(weed_data_t)))
-	return weed_data_free(data, --i, num_elems, seed_type);
-      if (seed_type == WEED_SEED_STRING) {
-        data[i]->value.voidptr = (weed_voidptr_t)(((data[i]->size = weed_strlen(valuec[i])) > 0) ?
-						  (weed_voidptr_t)weed_malloc_and_copy(data[i]->size, valuec[i]) : NULL);
-      } else {
-        data[i]->size = weed_seed_get_size(seed_type, 0);
-        if (seed_type == WEED_SEED_FUNCPTR)
-	  memcpy(&data[i]->value.funcptr, &valuef[i], WEED_FUNCPTR_SIZE);
-        else {
-          if (is_ptr) memcpy(&data[i]->value.voidptr, &valuep[i], WEED_VOIDPTR_SIZE);
-          else data[i]->value.voidptr =
-		 (weed_voidptr_t)(weed_malloc_and_copy(data[i]->size,
-						       (char *)values + i * data[i]->size));
-        }}
-      if (!is_ptr && !data[i]->value.voidptr && data[i]->size > 0) //ymemory error
-        return weed_data_free(data, --i, num_elems, seed_type);
-    }}
+
+  if (seed_type == WEED_SEED_STRING) {
+    for (weed_size_t i = 0; i < num_elems; i++) bsize += weed_strlen(valuec[i]);
+  } else if (!weed_seed_is_ptr(seed_type)) bsize += num_elems * vsize;
+
+  if (!(data = (weed_data_t **)weed_malloc(bsize))) return NULL;
+  elems = (weed_data_t *)((char *)data + num_elems * sizeof(weed_data_t *));
+  payload = (char *)data + hsize;
+
+  for (weed_size_t i = 0; i < num_elems; i++) {
+    weed_data_t *elem = data[i] = &elems[i];
+    if (seed_type == WEED_SEED_STRING) {
+      if ((elem->size = weed_strlen(valuec[i])) > 0) {
+	elem->value.voidptr = (weed_voidptr_t)payload;
+	memcpy(payload, valuec[i], elem->size);
+	payload += elem->size;
+      } else elem->value.voidptr = NULL;
+    } else {
+      elem->size = vsize;
+      if (seed_type == WEED_SEED_FUNCPTR)
+	memcpy(&elem->value.funcptr, &valuef[i], WEED_FUNCPTR_SIZE);
+      else if (weed_seed_is_ptr(seed_type))
+	memcpy(&elem->value.voidptr, &valuep[i], WEED_VOIDPTR_SIZE);
+      else {
+	elem->value.voidptr = (weed_voidptr_t)payload;
+	memcpy(payload, (char *)values + i * vsize, vsize);
+	payload += vsize;
+      }}}
   return data;
 }
 
-static inline weed_leaf_t *weed_find_leaf(weed_plant_t *plant, const char *key, uint32_t *hash_ret) {
-  uint32_t hash = WEED_MAGIC_HASH;
+// plants with this many leaves (or more) get an index, if WEED_INIT_HASHINDEX was set
+#define WEED_INDEX_MIN_LEAVES 16
+#define WEED_INDEX_MIN_SIZE 32
+#define WEED_INDEX_TOMBSTONE ((weed_leaf_t *)1)
+
+// the index is only read by threads running in non-check mode, i.e those counted in reader_count;
+// it is only modified by threads holding the chain writelock on the plant.
+// Adding to a free slot is safe with concurrent readers, anything which could leave a reader with a stale
+// pointer (replacing or freeing the index, removing a leaf) is done only after reader_count_wait()
+
+static inline leaf_index_t *leaf_index_get(weed_plant_t *plant) {
+  return __atomic_load_n(&get_plant_pdata(plant)->index, __ATOMIC_ACQUIRE);
+}
+
+static inline void leaf_index_insert(leaf_index_t *index, weed_leaf_t *leaf) {
+  weed_size_t mask = index->size - 1, i = leaf->key_hash & mask;
+  while (index->slots[i] && index->slots[i] != WEED_INDEX_TOMBSTONE) i = (i + 1) & mask;
+  if (!index->slots[i]) index->nused++;
+  __atomic_store_n(&index->slots[i], leaf, __ATOMIC_RELEASE);
+}
+
+static inline weed_leaf_t *leaf_index_find(leaf_index_t *index, uint32_t hash, const char *key) {
+  weed_size_t mask = index->size - 1, i = hash & mask;
+  weed_leaf_t *leaf;
+  while ((leaf = __atomic_load_n(&index->slots[i], __ATOMIC_ACQUIRE))) {
+    if (leaf != WEED_INDEX_TOMBSTONE && leaf->key_hash == hash && !weed_strcmp((char *)leaf->key, (char *)key))
+      return leaf;
+    i = (i + 1) & mask;
+  }
+  return NULL;
+}
+
+static leaf_index_t *leaf_index_build(weed_plant_t *plant, weed_size_t nleaves) {
+  leaf_index_t *index;
+  weed_size_t size = WEED_INDEX_MIN_SIZE;
+  while (size < nleaves * 2) size <<= 1;
+  if (!(index = (leaf_index_t *)calloc(1, sizeof(leaf_index_t) + size * sizeof(weed_leaf_t *)))) return NULL;
+  index->size = size;
+  for (weed_leaf_t *leaf = plant->next; leaf; leaf = leaf->next) leaf_index_insert(index, leaf);
+  return index;
+}
+
+// replace the index; caller must hold the chain writelock, and there must be no readers in non-check mode
+// apart from ones which started before we were called and which we will wait for here
+static void leaf_index_replace(weed_plant_t *plant, leaf_index_t *newindex) {
+  plant_priv_data_t *pdata = get_plant_pdata(plant);
+  leaf_index_t *oldindex = pdata->index;
+  __atomic_store_n(&pdata->index, newindex, __ATOMIC_RELEASE);
+  if (oldindex) {
+    reader_count_wait(plant);
+    free(oldindex);
+  }
+}
+
+// a new leaf was added to plant; caller holds the chain writelock
+static void leaf_index_add(weed_plant_t *plant, weed_leaf_t *leaf) {
+  plant_priv_data_t *pdata = get_plant_pdata(plant);
+  leaf_index_t *index = pdata->index;
+  pdata->nleaves++;
+  if (!use_index) return;
+  if (!index) {
+    if (pdata->nleaves >= WEED_INDEX_MIN_LEAVES) leaf_index_replace(plant, leaf_index_build(plant, pdata->nleaves));
+    return;
+  }
+  if ((index->nused + 1) * 4 > index->size * 3) {
+    // too full (including tombstones), rebuild; if this fails we carry on with the old index
+    leaf_index_t *newindex = leaf_index_build(plant, pdata->nleaves);
+    if (newindex) {
+      leaf_index_replace(plant, newindex);
+      return;
+    }
+  }
+  leaf_index_insert(index, leaf);
+}
+
+// leaf was unlinked from plant; caller holds the chain writelock and has waited for non-checking readers
+static void leaf_index_remove(weed_plant_t *plant, weed_leaf_t *leaf) {
+  plant_priv_data_t *pdata = get_plant_pdata(plant);
+  leaf_index_t *index = pdata->index;
+  pdata->nleaves--;
+  if (!index) return;
+  if (pdata->nleaves < WEED_INDEX_MIN_LEAVES / 2) {
+    // back to a simple list
+    pdata->index = NULL;
+    free(index);
+    return;
+  }
+  for (weed_size_t mask = index->size - 1, i = leaf->key_hash & mask; index->slots[i]; i = (i + 1) & mask) {
+    if (index->slots[i] == leaf) {
+      index->slots[i] = WEED_INDEX_TOMBSTONE;
+      break;
+    }
+  }
+}
+
+// hash must be weed_hash(key) (ignored if key is NULL or empty)
+static inline weed_leaf_t *weed_find_leaf_hashed(weed_plant_t *plant, const char *key, uint32_t hash,
+    uint32_t *hash_ret) {
   weed_leaf_t *leaf = plant, *chain_leaf = NULL;
   int checkmode = 0;
 
@@ -437,9 +574,12 @@ static inline weed_leaf_t *weed_find_leaf(weed_plant_t *plant, const char *key,
       }
     }
 
-    hash = weed_hash(key);
-
-    while (leaf && (hash != leaf->key_hash || weed_strcmp((char *)leaf->key, (char *)key))) {
+    if (!checkmode && is_plant(plant) && leaf_index_get(plant)) {
+      // checking readers must walk the chain, but otherwise we can use the index
+      if (hash != plant->key_hash || weed_strcmp((char *)plant->key, (char *)key))
+        leaf = leaf_index_find(leaf_index_get(plant), hash, key);
+    }
+    else while (leaf && (hash != leaf->key_hash || weed_strcmp((char *)leaf->key, (char *)key))) {
       leaf = leaf->next;
       if (checkmode && leaf) {
 	// lock leaf so it cannot be freed till we have passed over it
@@ -455,14 +595,21 @@ static inline weed_leaf_t *weed_find_leaf(weed_plant_t *plant, const char *key,
       if (!checkmode) reader_count_sub(plant);
     }
   }
-  else data_lock_readlock(leaf);
+  else {
+    data_lock_readlock(leaf);
+    hash = WEED_MAGIC_HASH;
+  }
   if (hash_ret) *hash_ret = hash;
   return leaf;
 }
 
+static inline weed_leaf_t *weed_find_leaf(weed_plant_t *plant, const char *key, uint32_t *hash_ret) {
+  return weed_find_leaf_hashed(plant, key, weed_hash(key), hash_ret);
+}
+
 static inline void *weed_leaf_free(weed_leaf_t *leaf) {
   if (leaf->data)
-    weed_data_free((void *)leaf->data, leaf->num_elements, leaf->num_elements, leaf->seed_type);
+    weed_data_free(leaf->data, leaf->num_elements, leaf->seed_type);
   if (leaf->key != leaf->padding) weed_unmalloc_and_copy(weed_strlen(leaf->key) + 1,
 							 (void *)leaf->key);
   data_lock_unlock(leaf);
@@ -472,6 +619,7 @@ static inline void *weed_leaf_free(weed_leaf_t *leaf) {
 
   if (is_plant(leaf)) {
     plant_priv_data_t *pdata = (plant_priv_data_t *)leaf->private_data;
+    if (pdata->index) free(pdata->index);
     weed_unmalloc_sizeof(plant_priv_data_t, pdata);
   }
   else {
@@ -506,6 +654,8 @@ static inline weed_leaf_t *weed_leaf_new(const char *key, uint32_t seed_type, ui
 
     pthread_rwlock_init(&pdata->reader_count, NULL);
     pthread_mutex_init(&pdata->structure_mutex, NULL);
+    pdata->index = NULL;
+    pdata->nleaves = 0;
     leaf->private_data = (void *)pdata;
   }
   else {
@@ -553,8 +703,15 @@ static weed_error_t _weed_plant_free(weed_plant_t *plant) {
       leafprev->next = leafnext;
       data_lock_readlock(leaf);
       weed_leaf_free(leaf);
+      get_plant_pdata(plant)->nleaves--;
     }}
 
+  if (get_plant_pdata(plant)->index) {
+    // only undeletable leaves remain, so drop the index; it will be rebuilt if the plant grows again
+    free(get_plant_pdata(plant)->index);
+    get_plant_pdata(plant)->index = NULL;
+  }
+
   if (!plant->next) {
     // remove lock temporarily just in case other threads were trying to grab a read lock
     chain_lock_unlock(plant);
@@ -662,6 +819,7 @@ static weed_error_t _weed_leaf_delete(weed_plant_t *plant, const char *key) {
 
   // adjust the link
   leafprev->next = leaf->next;
+  leaf_index_remove(plant, leaf);
 
   // and that is it, job done. Now we can free leaf at leisure
   plant->flags ^= WEED_FLAG_OP_DELETE;
@@ -734,12 +892,10 @@ static char **_weed_plant_list_leaves(weed_plant_t *plant, weed_size_t *nleaves)
   return leaflist;
 }
 
-static weed_error_t _weed_leaf_set(weed_plant_t *plant, const char *key,
-				   uint32_t seed_type, weed_size_t num_elems,
-                                   weed_voidptr_t values) {
+static inline weed_error_t weed_leaf_set_hashed(weed_plant_t *plant, const char *key, uint32_t hash,
+    uint32_t seed_type, weed_size_t num_elems, weed_voidptr_t values) {
   weed_data_t **data = NULL;
   weed_leaf_t *leaf;
-  uint32_t hash;
   int isnew = 0;
   weed_size_t old_num_elems = 0;
   weed_data_t **old_data = NULL;
@@ -750,7 +906,7 @@ static weed_error_t _weed_leaf_set(weed_plant_t *plant, const char *key,
   // lock out other setters
   chain_lock_upgrade(plant, 0, 0);
 
-  if (!(leaf = weed_find_leaf(plant, key, &hash))) {
+  if (!(leaf = weed_find_leaf_hashed(plant, key, hash, &hash))) {
     if (!(leaf = weed_leaf_new(key, seed_type, hash))) {
       chain_lock_unlock(plant);
       return WEED_ERROR_MEMORY_ALLOCATION;
@@ -801,22 +957,29 @@ static weed_error_t _weed_leaf_set(weed_plant_t *plant, const char *key,
 
   if (isnew) {
     weed_leaf_append(plant, leaf);
+    leaf_index_add(plant, leaf);
     chain_lock_unlock(plant);
   }
   else data_lock_unlock(leaf);
 
-  if (old_data) weed_data_free(old_data, old_num_elems, old_num_elems, seed_type);
+  if (old_data) weed_data_free(old_data, old_num_elems, seed_type);
 
   return WEED_SUCCESS;
 }
 
-static weed_error_t _weed_leaf_get(weed_plant_t *plant, const char *key, int32_t idx,
-				   weed_voidptr_t value) {
+static weed_error_t _weed_leaf_set(weed_plant_t *plant, const char *key,
+				   uint32_t seed_type, weed_size_t num_elems,
+                                   weed_voidptr_t values) {
+  return weed_leaf_set_hashed(plant, key, weed_hash(key), seed_type, num_elems, values);
+}
+
+static inline weed_error_t weed_leaf_get_hashed(weed_plant_t *plant, const char *key, uint32_t hash,
+    int32_t idx, weed_voidptr_t value) {
   weed_data_t **data;
   uint32_t type;
   weed_leaf_t *leaf;
 
-  if (!(leaf = weed_find_leaf(plant, key, NULL))) {
+  if (!(leaf = weed_find_leaf_hashed(plant, key, hash, NULL))) {
     return WEED_ERROR_NOSUCH_LEAF;
   }
 
@@ -843,6 +1006,11 @@ static weed_error_t _weed_leaf_get(weed_plant_t *plant, const char *key, int32_t
   return_unlock(leaf, WEED_SUCCESS);
 }
 
+static weed_error_t _weed_leaf_get(weed_plant_t *plant, const char *key, int32_t idx,
+				   weed_voidptr_t value) {
+  return weed_leaf_get_hashed(plant, key, weed_hash(key), idx, value);
+}
+
 static weed_size_t _weed_leaf_num_elements(weed_plant_t *plant, const char *key) {
   weed_leaf_t *leaf;
   if (!(leaf = weed_find_leaf(plant, key, NULL))) return 0;
@@ -875,3 +1043,84 @@ static weed_error_t _weed_leaf_get_private_data(weed_plant_t *plant, const char
   if (!(leaf = weed_find_leaf(plant, key, NULL))) return WEED_ERROR_NOSUCH_LEAF;
   return_unlock(leaf, WEED_ERROR_CONCURRENCY);
 }
+
+/* interned keys */
+
+#define WEED_INTERN_MIN_SIZE 256
+
+static pthread_mutex_t intern_mutex = PTHREAD_MUTEX_INITIALIZER;
+static weed_key_t **interned = NULL;
+static weed_size_t intern_size = 0, intern_count = 0;
+
+static inline weed_key_t *intern_find(uint32_t hash, const char *key) {
+  weed_size_t mask = intern_size - 1, i = hash & mask;
+  for (; interned[i]; i = (i + 1) & mask)
+    if (interned[i]->hash == hash && !weed_strcmp(interned[i]->key, key)) return interned[i];
+  return NULL;
+}
+
+static inline void intern_insert(weed_key_t **table, weed_size_t size, weed_key_t *wkey) {
+  weed_size_t mask = size - 1, i = wkey->hash & mask;
+  while (table[i]) i = (i + 1) & mask;
+  table[i] = wkey;
+}
+
+EXPORTED const weed_key_t *weed_key_intern(const char *key) {
+  // keys are never freed, so the same handle may be used for the lifetime of the process
+  weed_key_t *wkey = NULL;
+  uint32_t hash;
+  if (!key || !*key) return NULL;
+  hash = weed_hash(key);
+  pthread_mutex_lock(&intern_mutex);
+  if (intern_size && (wkey = intern_find(hash, key))) {
+    pthread_mutex_unlock(&intern_mutex);
+    return wkey;
+  }
+  if ((intern_count + 1) * 2 > intern_size) {
+    weed_size_t nsize = intern_size ? intern_size << 1 : WEED_INTERN_MIN_SIZE;
+    weed_key_t **ntable = (weed_key_t **)calloc(nsize, sizeof(weed_key_t *));
+    if (!ntable) {
+      pthread_mutex_unlock(&intern_mutex);
+      return NULL;
+    }
+    for (weed_size_t i = 0; i < intern_size; i++) if (interned[i]) intern_insert(ntable, nsize, interned[i]);
+    free(interned);
+    interned = ntable;
+    intern_size = nsize;
+  }
+  if ((wkey = (weed_key_t *)malloc(sizeof(weed_key_t)))) {
+    if (!(wkey->key = strdup(key))) {
+      free(wkey);
+      wkey = NULL;
+    } else {
+      wkey->hash = hash;
+      intern_insert(interned, intern_size, wkey);
+      intern_count++;
+    }
+  }
+  pthread_mutex_unlock(&intern_mutex);
+  return wkey;
+}
+
+EXPORTED weed_error_t weed_leaf_get_k(weed_plant_t *plant, const weed_key_t *key, int32_t idx, weed_voidptr_t value) {
+  if (!key) return WEED_ERROR_NOSUCH_LEAF;
+  return weed_leaf_get_hashed(plant, key->key, key->hash, idx, value);
+}
+
+EXPORTED weed_error_t weed_leaf_set_k(weed_plant_t *plant, const weed_key_t *key, uint32_t seed_type,
+                                      weed_size_t num_elems, weed_voidptr_t values) {
+  if (!key) return WEED_ERROR_NOSUCH_LEAF;
+  return weed_leaf_set_hashed(plant, key->key, key->hash, seed_type, num_elems, values);
+}
+
+EXPORTED weed_size_t weed_leaf_num_elements_k(weed_plant_t *plant, const weed_key_t *key) {
+  weed_leaf_t *leaf;
+  if (!key || !(leaf = weed_find_leaf_hashed(plant, key->key, key->hash, NULL))) return 0;
+  return_unlock(leaf, leaf->num_elements);
+}
+
+EXPORTED uint32_t weed_leaf_seed_type_k(weed_plant_t *plant, const weed_key_t *key) {
+  weed_leaf_t *leaf;
+  if (!key || !(leaf = weed_find_leaf_hashed(plant, key->key, key->hash, NULL))) return WEED_SEED_INVALID;
+  return_unlock(leaf, leaf->seed_type);
+}
@@ -166,8 +166,28 @@ __WEED_FN_DEF__ weed_leaf_get_private_data_f weed_leaf_get_private_data;
   /// set this to expose extra debug functions
 #define WEED_INIT_DEBUGMODE			(1<<1)
 
+  /// set this to give plants with many leaves a hash index, speeding up leaf lookups at the cost of some memory
+#define WEED_INIT_HASHINDEX			(1<<2)
+
 int32_t weed_get_abi_version(void);
 
+  /// interned keys: weed_key_intern() returns a handle holding a copy of the key and its precomputed hash,
+  /// which can be passed to the _k functions in place of the key string. Interning the same string again
+  /// returns the same handle. Handles are never freed.
+#define WEED_HAVE_KEY_INTERN
+
+typedef struct {
+  const char *key;
+  uint32_t hash;
+} weed_key_t;
+
+const weed_key_t *weed_key_intern(const char *key);
+weed_error_t weed_leaf_get_k(weed_plant_t *, const weed_key_t *key, int32_t idx, weed_voidptr_t value);
+weed_error_t weed_leaf_set_k(weed_plant_t *, const weed_key_t *key, uint32_t seed_type, weed_size_t num_elems,
+                             weed_voidptr_t values);
+weed_size_t weed_leaf_num_elements_k(weed_plant_t *, const weed_key_t *key);
+uint32_t weed_leaf_seed_type_k(weed_plant_t *, const weed_key_t *key);
+
 #endif
 
 #ifdef __WEED_HOST__
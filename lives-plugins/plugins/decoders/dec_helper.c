@@ -8,6 +8,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if !defined (IS_MINGW) && !defined (IS_SOLARIS) && !defined (__FreeBSD__)
+#include <endian.h>
+#endif
 
 double get_fps(const char *uri) {
 #ifndef IS_MINGW
@@ -49,3 +55,195 @@ exit:
 #endif
   return ret;
 }
+
+
+//////////////////////////////////////////////////////////////////////////
+// keyframe index
+
+#define KF_INDEX_MIN_SIZE 64
+
+void lives_kf_index_free(lives_kf_index_t *kfi) {
+  if (kfi->entries != NULL) free(kfi->entries);
+  kfi->entries = NULL;
+  kfi->nentries = kfi->size = 0;
+  kfi->max_dts = 0;
+}
+
+
+static boolean kf_index_grow(lives_kf_index_t *kfi, int nsize) {
+  lives_kf_entry_t *entries;
+  if (nsize < KF_INDEX_MIN_SIZE) nsize = KF_INDEX_MIN_SIZE;
+  if (nsize <= kfi->size) return TRUE;
+  entries = (lives_kf_entry_t *)realloc(kfi->entries, nsize * sizeof(lives_kf_entry_t));
+  if (entries == NULL) return FALSE;
+  kfi->entries = entries;
+  kfi->size = nsize;
+  return TRUE;
+}
+
+
+/// returns the position of the first entry with dts > the given dts
+static int kf_index_upper(const lives_kf_index_t *kfi, int64_t dts) {
+  int lo = 0, hi = kfi->nentries, mid;
+  while (lo < hi) {
+    mid = lo + ((hi - lo) >> 1);
+    if (kfi->entries[mid].dts <= dts) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+
+int lives_kf_index_add(lives_kf_index_t *kfi, int64_t dts, int64_t offs) {
+  int pos = kfi->nentries;
+
+  if (kfi->nentries == kfi->size && !kf_index_grow(kfi, kfi->size * 2)) return -1;
+
+  // while scanning, keyframes nearly always arrive in order, so this is just an append
+  if (pos > 0 && kfi->entries[pos - 1].dts > dts) {
+    pos = kf_index_upper(kfi, dts);
+    memmove(&kfi->entries[pos + 1], &kfi->entries[pos], (kfi->nentries - pos) * sizeof(lives_kf_entry_t));
+  }
+
+  kfi->entries[pos].dts = dts;
+  kfi->entries[pos].offs = offs;
+  kfi->nentries++;
+  return pos;
+}
+
+
+int lives_kf_index_find(const lives_kf_index_t *kfi, int64_t dts) {
+  int pos;
+  if (kfi->nentries == 0) return -1;
+  pos = kf_index_upper(kfi, dts) - 1;
+  return pos < 0 ? 0 : pos;
+}
+
+
+/// convert in place between host order and the little-endian order used in the sidecar file
+static void kf_swap_le(int64_t *vals, size_t count) {
+#if !defined (IS_MINGW) && !defined (IS_SOLARIS) && !defined (__FreeBSD__)
+# if __BYTE_ORDER == __BIG_ENDIAN
+  register size_t i;
+  for (i = 0; i < count; i++) {
+    uint64_t v = (uint64_t)vals[i];
+    v = ((v & 0x00000000000000FFULL) << 56) | ((v & 0x000000000000FF00ULL) << 40)
+        | ((v & 0x0000000000FF0000ULL) << 24) | ((v & 0x00000000FF000000ULL) << 8)
+        | ((v & 0x000000FF00000000ULL) >> 8) | ((v & 0x0000FF0000000000ULL) >> 24)
+        | ((v & 0x00FF000000000000ULL) >> 40) | ((v & 0xFF00000000000000ULL) >> 56);
+    vals[i] = (int64_t)v;
+  }
+# endif
+#endif
+}
+
+
+boolean lives_kf_index_save(const lives_kf_index_t *kfi, const char *fname, int64_t fsize, int64_t mtime) {
+  // format: version, fsize, mtime, max_dts, nentries, then nentries * (dts, offs), all 64 bit little-endian
+  int64_t hdr[4];
+  size_t dsize;
+  int64_t *data;
+  int fd;
+
+  if (kfi->nentries == 0) return FALSE;
+
+  if ((fd = open(fname, O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR)) == -1) return FALSE;
+
+  if (write(fd, LIVES_KF_INDEX_VERSION, 4) < 4) goto failwr;
+
+  hdr[0] = fsize;
+  hdr[1] = mtime;
+  hdr[2] = kfi->max_dts;
+  hdr[3] = kfi->nentries;
+  kf_swap_le(hdr, 4);
+  if (write(fd, hdr, sizeof(hdr)) < (ssize_t)sizeof(hdr)) goto failwr;
+
+  dsize = kfi->nentries * sizeof(lives_kf_entry_t);
+  data = (int64_t *)kfi->entries;
+#if !defined (IS_MINGW) && !defined (IS_SOLARIS) && !defined (__FreeBSD__)
+# if __BYTE_ORDER == __BIG_ENDIAN
+  data = (int64_t *)malloc(dsize);
+  if (data == NULL) goto failwr;
+  memcpy(data, kfi->entries, dsize);
+  kf_swap_le(data, kfi->nentries * 2);
+# endif
+#endif
+  if (write(fd, data, dsize) < (ssize_t)dsize) {
+    if (data != (int64_t *)kfi->entries) free(data);
+    goto failwr;
+  }
+  if (data != (int64_t *)kfi->entries) free(data);
+
+  close(fd);
+  return TRUE;
+
+failwr:
+  close(fd);
+  unlink(fname);
+  return FALSE;
+}
+
+
+static boolean kf_index_check(const lives_kf_index_t *kfi, int64_t fsize) {
+  int64_t last_dts = 0, last_offs = 0;
+  register int i;
+  for (i = 0; i < kfi->nentries; i++) {
+    if (kfi->entries[i].dts < last_dts || kfi->entries[i].offs < last_offs) return FALSE;
+    if (kfi->max_dts > 0 && kfi->entries[i].dts > kfi->max_dts) return FALSE;
+    if (kfi->entries[i].offs >= fsize) return FALSE;
+    last_dts = kfi->entries[i].dts;
+    last_offs = kfi->entries[i].offs;
+  }
+  return TRUE;
+}
+
+
+int64_t lives_kf_index_load(lives_kf_index_t *kfi, const char *fname, int64_t fsize, int64_t mtime) {
+  char ver[4];
+  int64_t hdr[4];
+  int64_t pair[2];
+  size_t dsize;
+  int fd;
+
+  if (kfi->nentries > 0) return kfi->max_dts;
+
+  if ((fd = open(fname, O_RDONLY)) < 0) return 0;
+
+  if (read(fd, ver, 4) < 4) goto failrd;
+
+  if (!strncmp(ver, LIVES_KF_INDEX_VERSION, 4)) {
+    if (read(fd, hdr, sizeof(hdr)) < (ssize_t)sizeof(hdr)) goto failrd;
+    kf_swap_le(hdr, 4);
+    if (hdr[0] != fsize || hdr[1] != mtime) goto failrd;
+    if (hdr[2] < 0 || hdr[3] <= 0 || hdr[3] > (fsize >> 2)) goto failrd;
+    if (!kf_index_grow(kfi, (int)hdr[3])) goto failrd;
+    dsize = hdr[3] * sizeof(lives_kf_entry_t);
+    if (read(fd, kfi->entries, dsize) < (ssize_t)dsize) goto failrd;
+    kf_swap_le((int64_t *)kfi->entries, hdr[3] * 2);
+    kfi->nentries = (int)hdr[3];
+    kfi->max_dts = hdr[2];
+  } else if (!strncmp(ver, "V1.0", 4)) {
+    // older format, no size check or count; max_dts followed by (dts, offs) pairs up to eof
+    // it records nothing about the media file, so we can only reject it if the media was modified after it was written
+    struct stat sb;
+    if (fstat(fd, &sb) || (int64_t)sb.st_mtime < mtime) goto failrd;
+    if (read(fd, hdr, 8) < 8) goto failrd;
+    kf_swap_le(hdr, 1);
+    if (hdr[0] < 0) goto failrd;
+    while (read(fd, pair, sizeof(pair)) == (ssize_t)sizeof(pair)) {
+      kf_swap_le(pair, 2);
+      if (lives_kf_index_add(kfi, pair[0], pair[1]) < 0) goto failrd;
+    }
+    kfi->max_dts = hdr[0];
+  } else goto failrd;
+
+  if (!kf_index_check(kfi, fsize)) goto failrd;
+
+  close(fd);
+  return kfi->max_dts;
+
+failrd:
+  lives_kf_index_free(kfi);
+  close(fd);
+  return 0;
+}
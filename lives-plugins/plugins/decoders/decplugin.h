@@ -300,6 +300,38 @@ void module_unload(void);
 
 double get_fps(const char *uri);
 
+/// keyframe index shared by the demuxing decoders (see dec_helper.c)
+/// entries are kept sorted by dts in a single contiguous array, so lookup is a binary search
+/// pointers into entries are only valid until the next add, callers should copy the values they need
+typedef struct {
+  int64_t dts; ///< dts of keyframe
+  int64_t offs;  ///< offset in file
+} lives_kf_entry_t;
+
+typedef struct {
+  lives_kf_entry_t *entries;
+  int nentries;
+  int size; ///< allocated entries
+  int64_t max_dts; ///< dts of the last frame in the stream, or 0 if not yet known
+} lives_kf_index_t;
+
+#define LIVES_KF_INDEX_VERSION "V2.1"
+
+void lives_kf_index_free(lives_kf_index_t *);
+
+/// add a keyframe, returns its position in the index or -1 on error; equal dts values are inserted after existing ones
+int lives_kf_index_add(lives_kf_index_t *, int64_t dts, int64_t offs);
+
+/// returns the position of the last keyframe with dts <= the given dts (or 0 if it precedes all keyframes), -1 if empty
+int lives_kf_index_find(const lives_kf_index_t *, int64_t dts);
+
+/// save / load the index to a sidecar file (relative to the cwd, i.e the clip directory)
+/// fsize and mtime are the size and modification time of the media file, the cached index is rejected if either does not match
+boolean lives_kf_index_save(const lives_kf_index_t *, const char *fname, int64_t fsize, int64_t mtime);
+
+/// returns max_dts, or 0 if there is no usable sidecar file; does nothing if the index already has entries
+int64_t lives_kf_index_load(lives_kf_index_t *, const char *fname, int64_t fsize, int64_t mtime);
+
 enum LiVESMediaType {
   LIVES_MEDIA_TYPE_UNKNOWN = 0,
   LIVES_MEDIA_TYPE_VIDEO,
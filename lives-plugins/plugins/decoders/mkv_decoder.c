@@ -1075,12 +1075,12 @@ static int64_t get_last_video_dts(lives_clip_data_t *cdata) {
   boolean got_picture = FALSE;
 
   pthread_mutex_lock(&priv->idxc->mutex);
-  if (priv->idxc->idxht == NULL) {
+  if (priv->idxc->kfi.nentries == 0) {
     pthread_mutex_unlock(&priv->idxc->mutex);
     return 0;
   }
   // jump to last dts in keyframe index
-  ldts = priv->idxc->idxht->dts;
+  ldts = priv->idxc->kfi.entries[priv->idxc->kfi.nentries - 1].dts;
 
   // never trust the given duration in a video clip.
   //
@@ -1147,27 +1147,21 @@ static uint32_t calc_dts_delta(const lives_clip_data_t *cdata) {
   lives_mkv_priv_t *priv = cdata->priv;
 
   uint32_t deltadts, origdts, idxdts;
-  index_entry *idx;
+  int64_t idxoffs;
   int frames = 0;
   boolean got_picture = FALSE;
 
   pthread_mutex_lock(&priv->idxc->mutex);
-  if (priv->idxc->idxhh == NULL) {
+  if (priv->idxc->kfi.nentries < 2) {
     pthread_mutex_unlock(&priv->idxc->mutex);
     return 0;
   }
   // seek to 0
 
-  idx = matroska_read_seek(cdata, 0);
-  origdts = idx->dts;
+  origdts = matroska_read_seek(cdata, 0);
 
-  idx = idx->next;
-
-  if (idx == NULL) {
-    pthread_mutex_unlock(&priv->idxc->mutex);
-    return 0;
-  }
-  idxdts = idx->dts;
+  idxdts = priv->idxc->kfi.entries[1].dts;
+  idxoffs = priv->idxc->kfi.entries[1].offs;
   pthread_mutex_unlock(&priv->idxc->mutex);
   got_eof = FALSE;
 
@@ -1185,7 +1179,7 @@ static uint32_t calc_dts_delta(const lives_clip_data_t *cdata) {
       return 0;
     }
 
-    if (priv->avpkt.pos >= idx->offs) break;
+    if (priv->avpkt.pos >= idxoffs) break;
 
 #if LIBAVCODEC_VERSION_MAJOR >= 52
     avcodec_decode_video2(priv->ctx, priv->picture, &got_picture, &priv->avpkt);
@@ -1208,83 +1202,22 @@ static uint32_t calc_dts_delta(const lives_clip_data_t *cdata) {
 
 /////////////////////////////////////////////////////
 
-static void index_free(index_entry *idx) {
-  index_entry *cidx = idx, *next;
-
-  while (cidx != NULL) {
-    next = cidx->next;
-    free(cidx);
-    cidx = next;
-  }
-}
-
-
-/// here we assume that pts of interframes > pts of previous keyframe
-// should be true for most formats (except eg. dirac)
-
-// we further assume that pts == dts for all frames
-
-static index_entry *index_walk(index_entry *idx, int64_t pts) {
-  index_entry *xidx = idx;
-  while (xidx != NULL) {
-    //fprintf(stderr, "VALS %ld %ld\n", pts, xidx->dts);
-    //if (xidx->next)
-    //fprintf(stderr, "VALS2 %ld\n", xidx->next->dts);
-    if (xidx->next == NULL || (pts >= xidx->dts && pts < xidx->next->dts)) return xidx;
-    xidx = xidx->next;
-  }
-  /// oops. something went wrong
-  return NULL;
-}
+/// index cache, kept in the clip directory so that reopening the clip can skip parsing the cues and the scan for the last frame
+#define MKV_INDEX_FILE "mkv_index"
 
+// lock idxc->mutex before calling these
 
-index_entry *lives_add_idx(const lives_clip_data_t *cdata, uint64_t offset, int64_t pts) {
+static int lives_add_idx(const lives_clip_data_t *cdata, uint64_t offset, int64_t pts) {
   lives_mkv_priv_t *priv = cdata->priv;
-  index_entry *nidx;
-  index_entry *nentry;
-
-  nidx = priv->idxc->idxht;
-
-  nentry = malloc(sizeof(index_entry));
-
-  nentry->dts = pts;
-  nentry->offs = offset;
-  nentry->next = NULL;
-
-  if (nidx == NULL) {
-    // first entry in list
-    priv->idxc->idxhh = priv->idxc->idxht = nentry;
-    return nentry;
-  }
-
-  if (nidx->dts < pts) {
-    // last entry in list
-    nidx->next = nentry;
-    priv->idxc->idxht = nentry;
-    return nentry;
-  }
-
-  if (priv->idxc->idxhh->dts > pts) {
-    // before head
-    nentry->next = priv->idxc->idxhh;
-    priv->idxc->idxhh = nentry;
-    return nentry;
-  }
-
-  nidx = index_walk(priv->idxc->idxhh, pts);
-
-  // after nidx in list
-
-  nentry->next = nidx->next;
-  nidx->next = nentry;
-
-  return nentry;
+  return lives_kf_index_add(&priv->idxc->kfi, pts, offset);
 }
 
 
-static index_entry *get_idx_for_pts(const lives_clip_data_t *cdata, int64_t pts) {
+static lives_kf_entry_t *get_idx_for_pts(const lives_clip_data_t *cdata, int64_t pts) {
   lives_mkv_priv_t *priv = cdata->priv;
-  return index_walk(priv->idxc->idxhh, pts);
+  int pos = lives_kf_index_find(&priv->idxc->kfi, pts);
+  if (pos < 0) return NULL;
+  return &priv->idxc->kfi.entries[pos];
 }
 
 
@@ -1301,6 +1234,7 @@ static int lives_mkv_read_header(lives_clip_data_t *cdata) {
   //uint64_t max_start = 0;
   Ebml ebml = { 0 };
   AVStream *st;
+  boolean have_idx;
   int i, j, k, res;
 
   matroska->ctx = s;
@@ -1611,12 +1545,18 @@ static int lives_mkv_read_header(lives_clip_data_t *cdata) {
     return -5;
   }
 
-  /* Parse the CUES now since we need the index data to seek. */
-  if (priv->matroska.cues_parsing_deferred) {
+  /* Parse the CUES now since we need the index data to seek,
+     unless we already have the index from another client or from a previous open */
+  pthread_mutex_lock(&priv->idxc->mutex);
+  lives_kf_index_load(&priv->idxc->kfi, MKV_INDEX_FILE, priv->filesize, priv->filemtime);
+  have_idx = priv->idxc->kfi.nentries > 0;
+  pthread_mutex_unlock(&priv->idxc->mutex);
+
+  if (!have_idx && priv->matroska.cues_parsing_deferred) {
     matroska_parse_cues(cdata);
   }
 
-  if (priv->idxc->idxhh == NULL) {
+  if (priv->idxc->kfi.nentries == 0) {
     fprintf(stderr, "mkv_decoder: no seek info found\n");
     return -6;
   }
@@ -1680,6 +1620,18 @@ static int lives_mkv_read_header(lives_clip_data_t *cdata) {
 }
 
 
+static void mkv_save_index(lives_clip_data_t *cdata) {
+  lives_mkv_priv_t *priv = cdata->priv;
+
+  if (cdata->nframes <= 0 || cdata->fps <= 0.) return;
+
+  pthread_mutex_lock(&priv->idxc->mutex);
+  priv->idxc->kfi.max_dts = frame_to_dts(cdata, cdata->nframes);
+  lives_kf_index_save(&priv->idxc->kfi, MKV_INDEX_FILE, priv->filesize, priv->filemtime);
+  pthread_mutex_unlock(&priv->idxc->mutex);
+}
+
+
 static index_container_t *idxc_for(lives_clip_data_t *cdata) {
   // check all idxc for string match with URI
   index_container_t *idxc;
@@ -1706,8 +1658,7 @@ static index_container_t *idxc_for(lives_clip_data_t *cdata) {
   // match not found, create a new index container
   idxc = (index_container_t *)malloc(sizeof(index_container_t));
 
-  idxc->idxhh = NULL;
-  idxc->idxht = NULL;
+  memset(&idxc->kfi, 0, sizeof(lives_kf_index_t));
 
   idxc->nclients = 1;
   idxc->clients = (lives_clip_data_t **)malloc(sizeof(lives_clip_data_t *));
@@ -1734,7 +1685,8 @@ static void idxc_release(lives_clip_data_t *cdata) {
 
   if (idxc->nclients == 1) {
     // remove this index
-    index_free(idxc->idxhh);
+    mkv_save_index(cdata);
+    lives_kf_index_free(&idxc->kfi);
     free(idxc->clients);
     for (i = 0; i < nidxc; i++) {
       if (indices[i] == idxc) {
@@ -1771,7 +1723,7 @@ static void idxc_release(lives_clip_data_t *cdata) {
 
 static void idxc_release_all(void) {
   for (register int i = 0; i < nidxc; i++) {
-    index_free(indices[i]->idxhh);
+    lives_kf_index_free(&indices[i]->kfi);
     free(indices[i]->clients);
     free(indices[i]);
   }
@@ -1886,6 +1838,7 @@ static boolean attach_stream(lives_clip_data_t *cdata, boolean isclone) {
 
   fstat(priv->fd, &sb);
   priv->filesize = sb.st_size;
+  priv->filemtime = (int64_t)sb.st_mtime;
 
   sprintf(cdata->audio_name, "%s", "");
 
@@ -2095,7 +2048,12 @@ skip_probe:
     if (!recheck) return TRUE;
   }
 
-  ldts = get_last_video_dts(cdata);
+  // if the index was cached, it also knows where the stream ends
+  pthread_mutex_lock(&priv->idxc->mutex);
+  ldts = priv->idxc->kfi.max_dts;
+  pthread_mutex_unlock(&priv->idxc->mutex);
+
+  if (ldts <= 0) ldts = get_last_video_dts(cdata);
 
   if (ldts == 0) ldts = duration * 1000.;
 
@@ -2182,6 +2140,7 @@ static lives_clip_data_t *mkv_clone(lives_clip_data_t *cdata) {
   if (spriv) {
     clone->priv = dpriv = (lives_mkv_priv_t *)calloc(1, sizeof(lives_mkv_priv_t));
     dpriv->filesize = spriv->filesize;
+    dpriv->filemtime = spriv->filemtime;
     dpriv->inited = TRUE;
   } else {
     clone = init_cdata(clone);
@@ -2634,24 +2593,25 @@ static boolean matroska_read_packet(const lives_clip_data_t *cdata, AVPacket *pk
 }
 
 
-static index_entry *matroska_read_seek(const lives_clip_data_t *cdata, int64_t timestamp) {
+static int64_t matroska_read_seek(const lives_clip_data_t *cdata, int64_t timestamp) {
+  // returns the dts of the keyframe we seeked to, or -1 if there is no index
   lives_mkv_priv_t *priv = cdata->priv;
   MatroskaDemuxContext *matroska = &priv->matroska;
   //AVFormatContext *s=priv->s;
 
   //AVStream *st = priv->vidst;
 
-  index_entry *idx;
+  lives_kf_entry_t *idx;
 
   // lock idxc_mutex before calling
 
-  if (!priv->idxc->idxhh) {
-    return NULL;
+  if (priv->idxc->kfi.nentries == 0) {
+    return -1;
   }
 
   if (timestamp != 0) {
     timestamp = FFMIN(timestamp, frame_to_dts(cdata, cdata->nframes));
-    timestamp = FFMAX(timestamp, priv->idxc->idxhh->dts);
+    timestamp = FFMAX(timestamp, priv->idxc->kfi.entries[0].dts);
   }
 
   idx = get_idx_for_pts(cdata, timestamp);
@@ -2676,7 +2636,7 @@ static index_entry *matroska_read_seek(const lives_clip_data_t *cdata, int64_t t
 
   //ff_update_cur_dts(s, st, idx->dts);
 
-  return idx;
+  return idx->dts;
 }
 
 
@@ -2726,7 +2686,7 @@ boolean get_frame(const lives_clip_data_t *cdata, int64_t tframe, int *rowstride
   boolean did_seek = FALSE;
   boolean rev = FALSE;
   unsigned char *dst, *src;
-  index_entry *idx;
+  int64_t kdts;
   int i, p;
 
   got_eof = FALSE;
@@ -2770,16 +2730,16 @@ boolean get_frame(const lives_clip_data_t *cdata, int64_t tframe, int *rowstride
         tframe - priv->last_frame > rescan_limit) {
       timex = -get_current_ticks();
       pthread_mutex_lock(&priv->idxc->mutex);
-      idx = matroska_read_seek(cdata, target_pts);
+      kdts = matroska_read_seek(cdata, target_pts);
       pthread_mutex_unlock(&priv->idxc->mutex);
-      nextframe = dts_to_frame(cdata, idx->dts);
+      nextframe = dts_to_frame(cdata, kdts);
       if (got_eof) goto cleanup;
 
       if (priv->picture) {
         avcodec_flush_buffers(priv->ctx);
       }
 #ifdef DEBUG_KFRAMES
-      if (idx) printf("got kframe %ld for frame %ld\n", dts_to_frame(cdata, idx->dts), tframe);
+      if (kdts >= 0) printf("got kframe %ld for frame %ld\n", dts_to_frame(cdata, kdts), tframe);
 #endif
       did_seek = TRUE;
     } else nextframe = priv->last_frame + 1;
@@ -1045,19 +1045,8 @@ const AVCodecTag codec_movvideo_tags[] = {
 
 ///////////////////////////////////////////////
 
-// TODO - this is a lazy implementation - for speed we should use bi-directional skip-lists
-
-typedef struct _index_entry index_entry;
-
-struct _index_entry {
-  index_entry *next; ///< ptr to next entry
-  int64_t dts; ///< dts of keyframe
-  uint64_t offs;  ///< offset in file
-};
-
 typedef struct {
-  index_entry *idxhh;  ///< head of head list
-  index_entry *idxht; ///< tail of head list
+  lives_kf_index_t kfi; ///< sorted keyframe index (dec_helper.c)
 
   int nclients;
   lives_clip_data_t **clients;
@@ -1074,6 +1063,7 @@ typedef struct {
   int64_t input_position;
   int64_t data_start;
   off_t filesize;
+  int64_t filemtime; ///< modification time of the media file, used to validate the index cache
   MatroskaDemuxContext matroska;
   AVFormatContext *s;
   AVCodec *codec;
@@ -1095,10 +1085,10 @@ static int ebml_parse_elem(const lives_clip_data_t *cdata,  EbmlSyntax *syntax,
 
 static boolean matroska_read_packet(const lives_clip_data_t *cdata, AVPacket *pkt);
 
-static index_entry *matroska_read_seek(const lives_clip_data_t *cdata, int64_t timestamp);
+static int64_t matroska_read_seek(const lives_clip_data_t *cdata, int64_t timestamp);
 
 static int matroska_read_close(const lives_clip_data_t *cdata);
 
 static void matroska_clear_queue(MatroskaDemuxContext *matroska);
 
-static index_entry *lives_add_idx(const lives_clip_data_t *cdata, uint64_t offset, int64_t pts);
+static int lives_add_idx(const lives_clip_data_t *cdata, uint64_t offset, int64_t pts);
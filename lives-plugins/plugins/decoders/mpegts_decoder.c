@@ -29,10 +29,6 @@
 #include <ctype.h>
 #include <sys/stat.h>
 
-#if !defined (IS_MINGW) && !defined (IS_SOLARIS) && !defined (__FreeBSD__)
-#include <endian.h>
-#endif
-
 static const char *plname = "lives_mpegts";
 static int vmaj = 1;
 static int vmin = 4;
@@ -151,17 +147,6 @@ static inline void init_get_bits(GetBitContext *s,
 }
 
 
-static void index_free(index_entry *idx) {
-  index_entry *cidx = idx, *next;
-
-  while (cidx != NULL) {
-    next = cidx->next;
-    free(cidx);
-    cidx = next;
-  }
-}
-
-
 //////////////////////////////////////////////////////////////////////////
 
 /// here we assume that pts of interframes > pts of previous keyframe
@@ -169,62 +154,19 @@ static void index_free(index_entry *idx) {
 
 // we further assume that pts == dts for all frames
 
-static index_entry *index_walk(index_entry *idx, uint32_t pts) {
-  index_entry *xidx = idx;
-  while (xidx != NULL) {
-    if (xidx->next == NULL || (pts >= xidx->dts && pts < xidx->next->dts)) return xidx;
-    xidx = xidx->next;
-  }
-  /// oops. something went wrong
-  return NULL;
-}
-
+// lock idxc->mutex before calling these
 
-index_entry *lives_add_idx(const lives_clip_data_t *cdata, uint64_t offset, int64_t pts) {
+static int lives_add_idx(const lives_clip_data_t *cdata, uint64_t offset, int64_t pts) {
   lives_mpegts_priv_t *priv = cdata->priv;
-  index_entry *nidx = priv->idxc->idxht;
-  index_entry *nentry;
-
-  nentry = malloc(sizeof(index_entry));
-
-  nentry->dts = pts;
-  nentry->offs = offset;
-  nentry->next = NULL;
-
-  if (nidx == NULL) {
-    // first entry in list
-    priv->idxc->idxhh = priv->idxc->idxht = nentry;
-    return nentry;
-  }
-
-  if (nidx->dts < pts) {
-    // last entry in list
-    nidx->next = nentry;
-    priv->idxc->idxht = nentry;
-    return nentry;
-  }
-
-  if (priv->idxc->idxhh->dts > pts) {
-    // before head
-    nentry->next = priv->idxc->idxhh;
-    priv->idxc->idxhh = nentry;
-    return nentry;
-  }
-
-  nidx = index_walk(priv->idxc->idxhh, pts);
-
-  // after nidx in list
-
-  nentry->next = nidx->next;
-  nidx->next = nentry;
-
-  return nentry;
+  return lives_kf_index_add(&priv->idxc->kfi, pts, offset);
 }
 
 
-static index_entry *get_idx_for_pts(const lives_clip_data_t *cdata, int64_t pts) {
+static lives_kf_entry_t *get_idx_for_pts(const lives_clip_data_t *cdata, int64_t pts) {
   lives_mpegts_priv_t *priv = cdata->priv;
-  return index_walk(priv->idxc->idxhh, pts);
+  int pos = lives_kf_index_find(&priv->idxc->kfi, pts);
+  if (pos < 0) return NULL;
+  return &priv->idxc->kfi.entries[pos];
 }
 
 
@@ -2588,22 +2530,30 @@ static lives_clip_data_t *init_cdata(lives_clip_data_t *data) {
 }
 
 
-static index_entry *mpegts_read_seek(const lives_clip_data_t *cdata, uint32_t timestamp) {
+static int64_t mpegts_read_seek(const lives_clip_data_t *cdata, uint32_t timestamp) {
   // use unadj timestamp
+  // returns the dts of the keyframe we seeked to, or -1 if there is no index
 
   lives_mpegts_priv_t *priv = cdata->priv;
 
-  index_entry *idx;
+  lives_kf_entry_t *idx;
+  int64_t dts;
 
-  if (priv->idxc == NULL || !priv->idxc->idxhh) return NULL;
+  if (priv->idxc == NULL) return -1;
 
   pthread_mutex_lock(&priv->idxc->mutex);
+  if (priv->idxc->kfi.nentries == 0) {
+    pthread_mutex_unlock(&priv->idxc->mutex);
+    return -1;
+  }
+
   timestamp = FFMIN(timestamp, frame_to_dts(cdata, cdata->nframes));
-  timestamp = FFMAX(timestamp, priv->idxc->idxhh->dts);
+  timestamp = FFMAX(timestamp, priv->idxc->kfi.entries[0].dts);
 
   idx = get_idx_for_pts(cdata, timestamp);
 
   priv->input_position = idx->offs;
+  dts = idx->dts;
   pthread_mutex_unlock(&priv->idxc->mutex);
 
   lseek(priv->fd, priv->input_position, SEEK_SET);
@@ -2616,7 +2566,7 @@ static index_entry *mpegts_read_seek(const lives_clip_data_t *cdata, uint32_t ti
 
   avcodec_flush_buffers(priv->ctx);
 
-  return idx;
+  return dts;
 }
 
 
@@ -2646,8 +2596,7 @@ static index_container_t *idxc_for(lives_clip_data_t *cdata) {
   // match not found, create a new index container
   idxc = (index_container_t *)malloc(sizeof(index_container_t));
 
-  idxc->idxhh = NULL;
-  idxc->idxht = NULL;
+  memset(&idxc->kfi, 0, sizeof(lives_kf_index_t));
 
   idxc->nclients = 1;
   idxc->clients = (lives_clip_data_t **)malloc(sizeof(lives_clip_data_t *));
@@ -2681,7 +2630,7 @@ static void idxc_release(lives_clip_data_t *cdata) {
 
   if (idxc->nclients == 1) {
     // remove this index
-    index_free(idxc->idxhh);
+    lives_kf_index_free(&idxc->kfi);
     free(idxc->clients);
     for (i = 0; i < nidxc; i++) {
       if (indices[i] == idxc) {
@@ -2720,7 +2669,7 @@ static void idxc_release_all(void) {
   register int i;
 
   for (i = 0; i < nidxc; i++) {
-    index_free(indices[i]->idxhh);
+    lives_kf_index_free(&indices[i]->kfi);
     free(indices[i]->clients);
     free(indices[i]);
   }
@@ -2910,6 +2859,7 @@ static boolean attach_stream(lives_clip_data_t *cdata, boolean isclone) {
 
   fstat(priv->fd, &sb);
   priv->filesize = sb.st_size;
+  priv->filemtime = (int64_t)sb.st_mtime;
 
   if (read(priv->fd, header, MPEGTS_PROBE_SIZE) < MPEGTS_PROBE_SIZE) {
     // for example, might be a directory
@@ -3257,6 +3207,7 @@ static lives_clip_data_t *mpegts_clone(lives_clip_data_t *cdata) {
   if (spriv) {
     clone->priv = dpriv = (lives_mpegts_priv_t *)calloc(1, sizeof(lives_mpegts_priv_t));
     dpriv->filesize = spriv->filesize;
+    dpriv->filemtime = spriv->filemtime;
     dpriv->inited = TRUE;
   } else {
     clone = init_cdata(clone);
@@ -3530,10 +3481,10 @@ boolean get_frame(const lives_clip_data_t *cdata, int64_t tframe, int *rowstride
     priv->picture = NULL;
 
     if (priv->last_frame == -1 || (tframe < priv->last_frame) || (tframe - priv->last_frame > rescan_limit)) {
-      idx = mpegts_read_seek(cdata, target_pts);
+      kdts = mpegts_read_seek(cdata, target_pts);
 
-      if (idx)
-        nextframe = dts_to_frame(cdata, idx->dts);
+      if (kdts >= 0)
+        nextframe = dts_to_frame(cdata, kdts);
       else {
         nextframe = priv->last_frame + 1;
       }
@@ -3544,7 +3495,7 @@ boolean get_frame(const lives_clip_data_t *cdata, int64_t tframe, int *rowstride
 
       //#define DEBUG_KFRAMES
 #ifdef DEBUG_KFRAMES
-      if (idx != NULL) printf("got kframe %ld for frame %ld\n", nextframe, tframe);
+      if (kdts >= 0) printf("got kframe %ld for frame %ld\n", nextframe, tframe);
 #endif
     } else {
       nextframe = priv->last_frame + 1;
@@ -3644,145 +3595,24 @@ boolean get_frame(const lives_clip_data_t *cdata, int64_t tframe, int *rowstride
   return TRUE;
 }
 
-#if !defined (IS_MINGW) && !defined (IS_SOLARIS) && !defined (__FreeBSD__)
-
-# if __BYTE_ORDER == __BIG_ENDIAN
-static void reverse_bytes(uint8_t *out, const uint8_t *in, size_t count) {
-  register int i;
-  for (i = 0; i < count; i++) {
-    out[i] = in[count - i - 1];
-  }
-}
-#endif
-
-#endif
-
-
-static ssize_t lives_write_le(int fd, const void *buf, size_t count) {
-#if !defined (IS_MINGW) && !defined (IS_SOLARIS) && !defined (__FreeBSD__)
-# if __BYTE_ORDER == __BIG_ENDIAN
-  uint8_t xbuf[count];
-  reverse_bytes(xbuf, (const uint8_t *)buf, count);
-  return write(fd, xbuf, count);
-# else
-  return write(fd, buf, count);
-# endif
-#else
-  return write(fd, buf, count);
-#endif
-}
-
-
-ssize_t lives_read_le(int fd, void *buf, size_t count) {
-#if !defined (IS_MINGW) && !defined (IS_SOLARIS) && !defined (__FreeBSD__)
-# if __BYTE_ORDER == __BIG_ENDIAN
-  uint8_t xbuf[count];
-  ssize_t retval = read(fd, buf, count);
-  if (retval < count) return retval;
-  reverse_bytes((uint8_t *)buf, (const uint8_t *)xbuf, count);
-  return retval;
-#else
-  return read(fd, buf, count);
-#endif
-#else
-  return read(fd, buf, count);
-#endif
-}
-
+/// index cache, kept in the clip directory so that reopening the clip can skip the full scan
+#define MPEGTS_INDEX_FILE "sync_index"
 
 static void mpegts_save_index(lives_clip_data_t *cdata) {
   lives_mpegts_priv_t *priv = cdata->priv;
-  index_entry *idx = priv->idxc->idxhh;
-
-  int fd;
-
-  int64_t max_dts = frame_to_dts(cdata, cdata->nframes);
-
-  const char ver[4] = "V1.0";
-
-  if (idx == NULL) return;
-
-  if ((fd = open("sync_index", O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR)) == -1) return;
-
-  if (write(fd, ver, 4) < 4) goto donewr;
-
-  if (lives_write_le(fd, &max_dts, 8) < 8) goto failwr;
-
-  // dump index to file in le format
-
-  while (idx != NULL) {
-    if (lives_write_le(fd, &idx->dts, 8) < 8) goto failwr;
-    if (lives_write_le(fd, &idx->offs, 8) < 8) goto failwr;
-    idx = idx->next;
-  }
-
-donewr:
-  close(fd);
-  return;
-
-failwr:
-  close(fd);
-  unlink("sync_index");
-  return;
 
+  pthread_mutex_lock(&priv->idxc->mutex);
+  priv->idxc->kfi.max_dts = frame_to_dts(cdata, cdata->nframes);
+  lives_kf_index_save(&priv->idxc->kfi, MPEGTS_INDEX_FILE, priv->filesize, priv->filemtime);
+  pthread_mutex_unlock(&priv->idxc->mutex);
 }
 
 
 static int64_t mpegts_load_index(lives_clip_data_t *cdata) {
   // returns max_dts
-  char hdr[4];
-
+  // lock idxc->mutex before calling
   lives_mpegts_priv_t *priv = cdata->priv;
-
-  int64_t dts, last_dts = 0, max_dts = 0;
-  uint64_t offs, last_offs = 0;
-
-  int fd;
-  int count = 0;
-
-  ssize_t bytes;
-
-  if ((fd = open("sync_index", O_RDONLY)) < 0) return 0;
-
-  if (read(fd, hdr, 4) < 4) goto donerd;
-
-  if (strncmp(hdr, "V1.0", 4)) goto donerd;
-
-  bytes = lives_read_le(fd, &max_dts, 8);
-  if (bytes < 8) goto failrd;
-
-  if (max_dts < last_dts) goto failrd;
-
-  while (1) {
-    bytes = lives_read_le(fd, &dts, 8);
-    if (bytes < 8) break;
-
-    if (dts < last_dts) goto failrd;
-    if (dts > max_dts) goto failrd;
-
-    bytes = lives_read_le(fd, &offs, 8);
-    if (bytes < 8) break;
-
-    if (offs < last_offs) goto failrd;
-    if (offs >= priv->filesize) goto failrd;
-
-    lives_add_idx(cdata, offs, dts);
-
-    last_dts = dts;
-    last_offs = offs;
-
-    count++;
-  }
-
-donerd:
-  close(fd);
-  return max_dts;
-
-failrd:
-  if (priv->idxc != NULL && priv->idxc->idxhh != NULL) idxc_release(cdata);
-
-  close(fd);
-  return 0;
+  return lives_kf_index_load(&priv->idxc->kfi, MPEGTS_INDEX_FILE, priv->filesize, priv->filemtime);
 }
 
 
@@ -303,17 +303,8 @@ const AVCodecTag ff_mp4_obj_type[] = {
 #define AV_CODEC_ID_FIRST_SUBTITLE 0x17000
 #define AV_CODEC_ID_FIRST_UNKNOWN 0x18000
 
-typedef struct _index_entry index_entry;
-
-struct _index_entry {
-  index_entry *next; ///< ptr to next entry
-  int64_t dts; ///< dts of keyframe
-  uint64_t offs;  ///< offset in file
-};
-
 typedef struct {
-  index_entry *idxhh;  ///< head of head list
-  index_entry *idxht; ///< tail of head list
+  lives_kf_index_t kfi; ///< sorted keyframe index (dec_helper.c)
 
   int nclients;
   lives_clip_data_t **clients;
@@ -331,6 +322,7 @@ typedef struct {
   int64_t input_position;
   int64_t data_start;
   off_t filesize;
+  int64_t filemtime; ///< modification time of the media file, used to validate the index cache
 
   int64_t start_dts;
 
@@ -148,69 +148,90 @@ static index_entry *find_pagepos_in_index(index_entry *idx, int64_t pagepos) {
 #endif
 
 
+#define theora_kframe(priv, gpos) ((gpos) >> (priv)->vstream->stpriv->keyframe_granule_shift)
+#define theora_frame(priv, gpos) (theora_kframe(priv, gpos) + (gpos) - (theora_kframe(priv, gpos) \
+                                  << (priv)->vstream->stpriv->keyframe_granule_shift))
+
+/// returns the position in idxc->tidx of the first entry with keyframe > kframe (or with keyframe >= kframe if strict is FALSE)
+static int theora_index_search(lives_ogg_priv_t *priv, int64_t kframe, boolean strict) {
+  index_container_t *idxc = priv->idxc;
+  int lo = 0, hi = idxc->ntidx, mid;
+  int64_t xkframe;
+
+  while (lo < hi) {
+    mid = lo + ((hi - lo) >> 1);
+    xkframe = theora_kframe(priv, idxc->tidx[mid]->value);
+    if (xkframe < kframe || (strict && xkframe == kframe)) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+
 static index_entry *theora_index_entry_add(lives_clip_data_t *cdata, int64_t granule, int64_t pagepos) {
   // add or update entry for keyframe and return it
-  index_entry *idx, *oidx, *last_idx = NULL;
-  int64_t gpos, frame, kframe, tframe, tkframe;
+  index_entry *idx;
+  index_container_t *idxc;
+  int64_t tkframe, tframe;
+  int pos;
 
   lives_ogg_priv_t *priv = (lives_ogg_priv_t *)cdata->priv;
 
   if (priv->vstream == NULL) return NULL;
 
-  tkframe = granule >> priv->vstream->stpriv->keyframe_granule_shift;
-  tframe = tkframe + granule - (tkframe << priv->vstream->stpriv->keyframe_granule_shift);
+  tkframe = theora_kframe(priv, granule);
+  tframe = theora_frame(priv, granule);
 
   if (tkframe < 1) return NULL;
 
-  oidx = idx = priv->idxc->idx;
+  idxc = priv->idxc;
 
-  if (!idx) {
-    index_entry *ie = index_entry_new();
-    ie->value = granule;
-    ie->pagepos = pagepos;
-    priv->idxc->idx = ie;
-    return ie;
-  }
+  pos = theora_index_search(priv, tkframe, FALSE);
 
-  while (idx) {
-    gpos = idx->value;
-
-    kframe = gpos >> priv->vstream->stpriv->keyframe_granule_shift;
-    if (kframe > tframe) break;
-
-    if (kframe == tkframe) {
-      // entry exists, update it if applicable, and return it in found
-      frame = kframe + gpos - (kframe << priv->vstream->stpriv->keyframe_granule_shift);
-      if (frame < tframe) {
-        idx->value = granule;
-        idx->pagepos = pagepos;
-      }
-      return idx;
+  if (pos < idxc->ntidx && theora_kframe(priv, idxc->tidx[pos]->value) == tkframe) {
+    // entry exists, update it if applicable, and return it
+    idx = idxc->tidx[pos];
+    if (theora_frame(priv, idx->value) < tframe) {
+      idx->value = granule;
+      idx->pagepos = pagepos;
     }
-
-    last_idx = idx;
-    idx = idx->next;
+    return idx;
   }
 
-  // insert after last_idx
+  // insert after the last entry with keyframe <= tframe
+  if (pos < idxc->ntidx) pos = theora_index_search(priv, tframe, TRUE);
+
+  if (idxc->ntidx == idxc->tidx_size) {
+    index_entry **tidx;
+    int nsize = idxc->tidx_size ? idxc->tidx_size * 2 : 256;
+    tidx = (index_entry **)realloc(idxc->tidx, nsize * sizeof(index_entry *));
+    if (tidx == NULL) return NULL;
+    idxc->tidx = tidx;
+    idxc->tidx_size = nsize;
+  }
 
   idx = index_entry_new();
+  idx->value = granule;
+  idx->pagepos = pagepos;
 
-  if (last_idx) {
+  if (pos > 0) {
+    index_entry *last_idx = idxc->tidx[pos - 1];
     idx->next = last_idx->next;
     last_idx->next = idx;
     idx->prev = last_idx;
   } else {
-    idx->next = oidx;
-    oidx = idx;
+    idx->next = idxc->idx;
+    idxc->idx = idx;
   }
 
   if (idx->next) {
     idx->next->prev = idx;
   }
 
-  idx->value = granule;
-  idx->pagepos = pagepos;
+  if (pos < idxc->ntidx)
+    memmove(&idxc->tidx[pos + 1], &idxc->tidx[pos], (idxc->ntidx - pos) * sizeof(index_entry *));
+  idxc->tidx[pos] = idx;
+  idxc->ntidx++;
 
   return idx;
 }
@@ -275,13 +296,35 @@ static index_entry *dirac_index_entry_add(lives_clip_data_t *cdata, int64_t page
 
 static index_entry *get_bounds_for(lives_clip_data_t *cdata, int64_t tframe, int64_t *ppos_lower, int64_t *ppos_upper) {
   // find upper and lower pagepos for frame; if we find an exact match, we return it
-  int64_t kframe, frame, gpos;
+  int64_t kframe, frame;
 
   lives_ogg_priv_t *priv = (lives_ogg_priv_t *)cdata->priv;
   index_entry *idx = priv->idxc->idx;
 
   *ppos_lower = *ppos_upper = -1;
 
+  if (priv->vstream->stpriv->fourcc_priv == FOURCC_THEORA) {
+    index_container_t *idxc = priv->idxc;
+    int pos = theora_index_search(priv, tframe, TRUE), i;
+
+    // the first valid entry starting after tframe is the upper bound
+    for (i = pos; i < idxc->ntidx; i++) {
+      if (idxc->tidx[i]->pagepos >= 0) break;
+    }
+
+    // the last valid entry starting at or before tframe either contains it, or is the lower bound
+    while (--pos >= 0) {
+      idx = idxc->tidx[pos];
+      if (idx->pagepos < 0) continue;
+      if (theora_frame(priv, idx->value) >= tframe) return idx;
+      *ppos_lower = idx->pagepos;
+      break;
+    }
+
+    if (i < idxc->ntidx) *ppos_upper = idxc->tidx[i]->pagepos;
+    return NULL;
+  }
+
   while (idx) {
     if (idx->pagepos < 0) {
       // kframe was found to be invalid
@@ -289,13 +332,7 @@ static index_entry *get_bounds_for(lives_clip_data_t *cdata, int64_t tframe, int
       continue;
     }
 
-    if (priv->vstream->stpriv->fourcc_priv == FOURCC_THEORA) {
-      gpos = idx->value;
-      kframe = gpos >> priv->vstream->stpriv->keyframe_granule_shift;
-      frame = kframe + gpos - (kframe << priv->vstream->stpriv->keyframe_granule_shift);
-    } else {
-      kframe = frame = idx->value;
-    }
+    kframe = frame = idx->value;
 
     //fprintf(stderr,"check %lld against %lld\n",tframe,kframe);
 
@@ -509,6 +546,8 @@ static index_container_t *idxc_for(lives_clip_data_t *cdata) {
   idxc = (index_container_t *)malloc(sizeof(index_container_t));
 
   idxc->idx = NULL;
+  idxc->tidx = NULL;
+  idxc->ntidx = idxc->tidx_size = 0;
 
   idxc->nclients = 1;
   idxc->clients = (lives_clip_data_t **)malloc(sizeof(lives_clip_data_t *));
@@ -536,6 +575,7 @@ static void idxc_release(lives_clip_data_t *cdata) {
   if (idxc->nclients == 1) {
     // remove this index
     index_entries_free(idxc->idx);
+    if (idxc->tidx != NULL) free(idxc->tidx);
     free(idxc->clients);
     for (i = 0; i < nidxc; i++) {
       if (indices[i] == idxc) {
@@ -575,6 +615,7 @@ static void idxc_release_all(void) {
 
   for (i = 0; i < nidxc; i++) {
     index_entries_free(indices[i]->idx);
+    if (indices[i]->tidx != NULL) free(indices[i]->tidx);
     free(indices[i]->clients);
     free(indices[i]);
   }
@@ -93,6 +93,11 @@ struct _index_entry {
 typedef struct {
   index_entry *idx;
 
+  /// theora only: the same entries in keyframe order, so lookups can use a binary search
+  index_entry **tidx;
+  int ntidx;
+  int tidx_size;
+
   int nclients;
   lives_clip_data_t **clients;
   pthread_mutex_t mutex;
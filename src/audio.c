@@ -11,10 +11,40 @@
 #include "effects.h"
 #include "resample.h"
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 static char *storedfnames[NSTOREDFDS];
 static int storedfds[NSTOREDFDS];
 static boolean storedfdsset = FALSE;
 
+/// per track resampler state for render_audio_segment(); [0] when rendering to a buffer, [1] when rendering to a file.
+/// Each set is held locked by render_audio_segment() while it renders, so that it cannot be freed under it
+static lives_resampler_t **track_rs[2];
+static int *track_rs_clip[2];
+static int n_track_rs[2];
+static pthread_mutex_t track_rs_mutex[2] = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER};
+
+/// resampler state for push_audio_to_channel(), one set per audio channel being fed, so that consecutive frames
+/// of audio are resampled as one continuous stream. Slots are reused least recently used first.
+/// A slot belongs to the channel holding its id in WEED_LEAF_HOST_PUSH_RS_ID, so a new channel which happens to be
+/// allocated at the address of a freed one never inherits its state
+#define PUSH_RS_SLOTS 16
+
+typedef struct {
+  int64_t id;
+  lives_resampler_t **rs; ///< one per channel of audio_data
+  int nchans;
+  int arate, trate;
+  uint64_t last_used;
+} push_rs_t;
+
+static push_rs_t push_rs[PUSH_RS_SLOTS];
+static uint64_t push_rs_clock;
+static int64_t push_rs_last_id;
+static pthread_mutex_t push_rs_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 
 static void audio_reset_stored_fnames(void) {
   for (int i = 0; i < NSTOREDFDS; i++) {
@@ -70,6 +100,8 @@ LIVES_GLOBAL_INLINE const char *audio_player_get_display_name(const char *aplaye
 
 void audio_free_fnames(void) {
   // cleanup stored filehandles after playback/fade/render
+  audio_reset_track_resamplers(FALSE);
+  audio_reset_track_resamplers(TRUE);
   if (!storedfdsset) return;
   for (int i = 0; i < NSTOREDFDS; i++) {
     lives_freep((void **)&storedfnames[i]);
@@ -79,6 +111,95 @@ void audio_free_fnames(void) {
 }
 
 
+/// get the resampler for a track, starting a new stream if the clip changed or the track was seeked.
+/// Must be called with track_rs_mutex[set] held
+static lives_resampler_t *get_track_resampler(int set, int track, int clipno, boolean seeked) {
+  if (track >= n_track_rs[set]) {
+    int ntracks = track + 1;
+    lives_resampler_t **rsa = (lives_resampler_t **)lives_realloc(track_rs[set], ntracks * sizeof(lives_resampler_t *));
+    int *clips;
+    if (!rsa) return NULL;
+    track_rs[set] = rsa;
+    clips = (int *)lives_realloc(track_rs_clip[set], ntracks * sizint);
+    if (!clips) return NULL;
+    track_rs_clip[set] = clips;
+    for (int i = n_track_rs[set]; i < ntracks; i++) {
+      track_rs[set][i] = NULL;
+      track_rs_clip[set][i] = -1;
+    }
+    n_track_rs[set] = ntracks;
+  }
+  if (!track_rs[set][track]) track_rs[set][track] = lives_resampler_new();
+  if (track_rs_clip[set][track] != clipno || seeked) {
+    lives_resampler_reset(track_rs[set][track]);
+    track_rs_clip[set][track] = clipno;
+  }
+  return track_rs[set][track];
+}
+
+
+static void push_rs_slot_free(push_rs_t *slot) {
+  for (int i = 0; i < slot->nchans; i++) lives_resampler_free(slot->rs[i]);
+  lives_freep((void **)&slot->rs);
+  slot->nchans = 0;
+  slot->id = 0;
+}
+
+
+/// get the resamplers for achan, carrying over their state from the previous frame, provided the rates are unchanged
+/// must be called with push_rs_mutex held
+static lives_resampler_t **get_push_resamplers(weed_plant_t *achan, int nchans, int arate, int trate) {
+  push_rs_t *slot = NULL;
+  int64_t id = weed_get_int64_value(achan, WEED_LEAF_HOST_PUSH_RS_ID, NULL);
+  if (!id) {
+    id = ++push_rs_last_id;
+    weed_set_int64_value(achan, WEED_LEAF_HOST_PUSH_RS_ID, id);
+  }
+  for (int i = 0; i < PUSH_RS_SLOTS; i++) {
+    if (push_rs[i].id == id) {
+      slot = &push_rs[i];
+      break;
+    }
+    if (!slot || push_rs[i].last_used < slot->last_used) slot = &push_rs[i];
+  }
+  if (slot->id != id || slot->nchans != nchans) {
+    push_rs_slot_free(slot);
+    if (!(slot->rs = (lives_resampler_t **)lives_calloc(nchans, sizeof(lives_resampler_t *)))) return NULL;
+    for (int i = 0; i < nchans; i++) {
+      if (!(slot->rs[i] = lives_resampler_new())) {
+        slot->nchans = i;
+        push_rs_slot_free(slot);
+        return NULL;
+      }
+    }
+    slot->nchans = nchans;
+    slot->id = id;
+  } else if (slot->arate != arate || slot->trate != trate) {
+    for (int i = 0; i < nchans; i++) lives_resampler_reset(slot->rs[i]);
+  }
+  slot->arate = arate;
+  slot->trate = trate;
+  slot->last_used = ++push_rs_clock;
+  return slot->rs;
+}
+
+
+void audio_reset_track_resamplers(boolean to_file) {
+  int set = to_file ? 1 : 0;
+  pthread_mutex_lock(&track_rs_mutex[set]);
+  for (int i = 0; i < n_track_rs[set]; i++) lives_resampler_free(track_rs[set][i]);
+  lives_freep((void **)&track_rs[set]);
+  lives_freep((void **)&track_rs_clip[set]);
+  n_track_rs[set] = 0;
+  pthread_mutex_unlock(&track_rs_mutex[set]);
+  if (to_file) return;
+  // the filter channels are fed during playback
+  pthread_mutex_lock(&push_rs_mutex);
+  for (int i = 0; i < PUSH_RS_SLOTS; i++) push_rs_slot_free(&push_rs[i]);
+  pthread_mutex_unlock(&push_rs_mutex);
+}
+
+
 void append_to_audio_bufferf(float *src, uint64_t nsamples, int channum) {
   // append float audio to the audio frame buffer
   size_t nsampsize;
@@ -462,7 +583,7 @@ void sample_move_d8_d16(short *dst, uint8_t *src,
   // convert 8 bit audio to 16 bit audio
 
   // endianess will be machine endian
-  static double rem = 0.f;
+  static __thread double rem = 0.f;
   double src_offset_d = rem;
   unsigned char *ptr;
   unsigned char *src_end;
@@ -525,7 +646,7 @@ void sample_move_d16_d16(int16_t *dst, int16_t *src,
                          uint64_t nsamples, size_t tbytes, double scale, int nDstChannels,
                          int nSrcChannels, int swap_endian, int swap_sign) {
   // TODO: going from >1 channels to 1, we should average
-  static double rem = 0.f;
+  static __thread double rem = 0.f; ///< streams needing continuity should use lives_resample_s16()
   double src_offset_d = rem;
   int16_t *ptr;
   int16_t *src_end;
@@ -742,34 +863,321 @@ float sample_move_d16_float(float *dst, short *src, uint64_t nsamples, uint64_t
 }
 
 
-void sample_move_float_float(float *dst, float *src, uint64_t nsamples, double scale, int dst_skip) {
-  // copy one channel of float to a buffer, applying the scale (scale 2.0 to double the rate, etc)
-  static double rem = 0.f;
-  double offs_d = rem;
-  off_t offs = 0;
-  int i;
+//////////////////////////////////////////////////////////////////////
+// windowed-sinc resampler
 
-  if (scale < 0.f) {
-    offs_d = ((double)nsamples * (-scale) - 1.f - rem);
-    offs = (off_t)offs_d;
+// the kernel is a Kaiser windowed sinc, tabulated at RS_PHASES points per zero crossing and linearly interpolated
+// between table points; coefficients for each output sample are normalised to unity gain.
+// For scale > 1. (reading faster than the output rate) the kernel is stretched by up to RESAMPLE_MAX_SPREAD
+// to lower the cutoff, so fast forward / scratching does not alias.
+// Output lags input by a constant RESAMPLE_DELAY source samples, which lets each block be computed using only
+// the samples it was given plus the history kept from the previous block.
+
+#define RS_PHASES 512
+#define RS_KAISER_BETA 8.6
+#define RS_MAX_TAPS (RESAMPLE_HIST + 4)
+
+static float rs_kernel[RESAMPLE_HALF_TAPS * RS_PHASES + 2];
+static pthread_once_t rs_kernel_once = PTHREAD_ONCE_INIT;
+
+static double bessel_i0(double x) {
+  double sum = 1., term = 1., y = x * x / 4.;
+  for (int k = 1; k < 64; k++) {
+    term *= y / ((double)k * (double)k);
+    sum += term;
+    if (term < sum * 1.e-12) break;
+  }
+  return sum;
+}
+
+
+static void rs_kernel_init(void) {
+  const int n = RESAMPLE_HALF_TAPS * RS_PHASES;
+  double ibeta = 1. / bessel_i0(RS_KAISER_BETA);
+  rs_kernel[0] = 1.f;
+  for (int i = 1; i <= n; i++) {
+    double x = (double)i / (double)RS_PHASES, r = x / (double)RESAMPLE_HALF_TAPS;
+    double w = bessel_i0(RS_KAISER_BETA * sqrt(1. - r * r)) * ibeta;
+    rs_kernel[i] = (float)(sin(M_PI * x) / (M_PI * x) * w);
+  }
+  rs_kernel[n + 1] = 0.f;
+}
+
+
+LIVES_LOCAL_INLINE float rs_dot(const float *restrict a, const float *restrict b, int n) {
+  float sum = 0.f;
+  int i = 0;
+#ifdef __SSE__
+  __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+  float part[4];
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
   }
+  for (; i + 4 <= n; i += 4) acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  _mm_storeu_ps(part, _mm_add_ps(acc0, acc1));
+  sum = part[0] + part[1] + part[2] + part[3];
+#endif
+  for (; i < n; i++) sum += a[i] * b[i];
+  return sum;
+}
+
+
+/// fill coeffs for the taps around centre; returns the number of taps, first tap index in *kstart
+static int rs_coeffs(float *coeffs, double centre, double fc, double width, int64_t *kstart) {
+  int64_t k0 = (int64_t)ceil(centre - width), k1 = (int64_t)floor(centre + width);
+  double tscale = fc * (double)RS_PHASES;
+  float sum = 0.f;
+  int n = (int)(k1 - k0 + 1);
+  if (n > RS_MAX_TAPS) n = RS_MAX_TAPS;
+  for (int i = 0; i < n; i++) {
+    double x = fabs((double)(k0 + i) - centre) * tscale;
+    int xi = (int)x;
+    float v = rs_kernel[xi] + (rs_kernel[xi + 1] - rs_kernel[xi]) * (float)(x - (double)xi);
+    coeffs[i] = v;
+    sum += v;
+  }
+  if (sum != 0.f) {
+    sum = 1.f / sum;
+    for (int i = 0; i < n; i++) coeffs[i] *= sum;
+  }
+  *kstart = k0;
+  return n;
+}
+
+
+/**
+   @brief resample one channel
+   x points to source sample 0; x[-RESAMPLE_HIST] to x[nin - 1] must be valid.
+   Output j is read from source position pos + j * step, delayed by RESAMPLE_DELAY.
+*/
+static void rs_run(const float *x, int64_t nin, double pos, double step, float *out, uint64_t nout) {
+  float coeffs[RS_MAX_TAPS];
+  double spread = step < 1. ? 1. : step > (double)RESAMPLE_MAX_SPREAD ? (double)RESAMPLE_MAX_SPREAD : step;
+  double fc = 1. / spread, width = (double)RESAMPLE_HALF_TAPS * spread;
+  double maxp = (double)(nin - 1);
+  int64_t k0;
+  int n;
+
+  for (uint64_t j = 0; j < nout; j++) {
+    double p = pos + step * (double)j, c;
+    if (p > maxp) p = maxp;
+    c = p - (double)RESAMPLE_DELAY;
+    if (fc == 1. && c == floor(c)) {
+      out[j] = x[(int64_t)c];
+      continue;
+    }
+    n = rs_coeffs(coeffs, c, fc, width, &k0);
+    out[j] = rs_dot(coeffs, x + k0, n);
+  }
+}
+
+
+lives_resampler_t *lives_resampler_new(void) {
+  pthread_once(&rs_kernel_once, rs_kernel_init);
+  return (lives_resampler_t *)lives_calloc(1, sizeof(lives_resampler_t));
+}
+
+
+LIVES_GLOBAL_INLINE void lives_resampler_reset(lives_resampler_t *rs) {
+  if (!rs) return;
+  rs->pos = 0.;
+  rs->primed = FALSE;
+}
+
+
+static void rs_free_buffers(lives_resampler_t *rs) {
+  lives_freep((void **)&rs->hist);
+  lives_freep((void **)&rs->line);
+  lives_freep((void **)&rs->out);
+  rs->line_size = rs->out_size = 0;
+  rs->nchans = 0;
+  rs->primed = FALSE;
+}
+
 
-  if (scale == 1.f && dst_skip == 1) {
+void lives_resampler_free(lives_resampler_t *rs) {
+  if (!rs) return;
+  rs_free_buffers(rs);
+  lives_free(rs);
+}
+
+
+static boolean rs_prepare(lives_resampler_t *rs, int nchans, uint64_t nin, uint64_t nout) {
+  size_t lsize = RESAMPLE_HIST + nin;
+  if (nchans != rs->nchans || !rs->hist) {
+    lives_freep((void **)&rs->hist);
+    rs->hist = (float *)lives_calloc(nchans * RESAMPLE_HIST, sizeof(float));
+    if (!rs->hist) {
+      rs_free_buffers(rs);
+      return FALSE;
+    }
+    rs->nchans = nchans;
+    rs->primed = FALSE;
+  }
+  if (lsize > rs->line_size) {
+    lives_freep((void **)&rs->line);
+    if (!(rs->line = (float *)lives_calloc(lsize, sizeof(float)))) {
+      rs_free_buffers(rs);
+      return FALSE;
+    }
+    rs->line_size = lsize;
+  }
+  if (nout > rs->out_size) {
+    lives_freep((void **)&rs->out);
+    if (!(rs->out = (float *)lives_calloc(nout, sizeof(float)))) {
+      rs_free_buffers(rs);
+      return FALSE;
+    }
+    rs->out_size = nout;
+  }
+  return TRUE;
+}
+
+
+/// resample the source already copied into rs->line for channel chan, output goes to rs->out
+static void rs_run_chan(lives_resampler_t *rs, int chan, uint64_t nin, uint64_t nout, double step) {
+  float *hist = rs->hist + chan * RESAMPLE_HIST;
+  float *x = rs->line + RESAMPLE_HIST;
+  if (!rs->primed) for (int i = 0; i < RESAMPLE_HIST; i++) hist[i] = x[0];
+  lives_memcpy(rs->line, hist, RESAMPLE_HIST * sizeof(float));
+  rs_run(x, nin, rs->pos, step, rs->out, nout);
+  lives_memcpy(hist, rs->line + nin, RESAMPLE_HIST * sizeof(float));
+}
+
+
+/// advance the stream position after all channels of a block were processed
+static void rs_commit(lives_resampler_t *rs, uint64_t nin, uint64_t nout, double step) {
+  double pos = rs->pos + step * (double)nout - (double)nin;
+  /// the caller rounds the amount it reads; don't let the difference accumulate
+  if (pos < 0.) pos = 0.;
+  else if (pos >= 2.) pos -= floor(pos);
+  rs->pos = pos;
+  rs->primed = TRUE;
+}
+
+
+/**
+   @brief resample non-interleaved float audio
+   src[i] holds nsrc samples for channel i, read every src_skip floats; dst[i] receives nsamples, written every dst_skip.
+   scale is the read step (source samples per output sample); if negative the source is read backwards.
+*/
+void lives_resample_float(lives_resampler_t *rs, float **dst, int dst_skip, float **src, int src_skip, int nchans,
+                          uint64_t nsrc, uint64_t nsamples, double scale) {
+  double step = fabs(scale);
+  boolean rev = scale < 0.;
+
+  if (!nsamples || !nchans) return;
+  if (!nsrc || step == 0. || !rs_prepare(rs, nchans, nsrc, nsamples)) {
+    for (int c = 0; c < nchans; c++) for (uint64_t j = 0; j < nsamples; j++) dst[c][j * dst_skip] = 0.f;
+    return;
+  }
+
+  for (int c = 0; c < nchans; c++) {
+    float *x = rs->line + RESAMPLE_HIST;
+    if (!rev) {
+      if (src_skip == 1) lives_memcpy(x, src[c], nsrc * sizeof(float));
+      else for (uint64_t i = 0; i < nsrc; i++) x[i] = src[c][i * src_skip];
+    } else for (uint64_t i = 0; i < nsrc; i++) x[i] = src[c][(nsrc - 1 - i) * src_skip];
+    rs_run_chan(rs, c, nsrc, nsamples, step);
+    if (dst_skip == 1) lives_memcpy(dst[c], rs->out, nsamples * sizeof(float));
+    else for (uint64_t j = 0; j < nsamples; j++) dst[c][j * dst_skip] = rs->out[j];
+  }
+  rs_commit(rs, nsrc, nsamples, step);
+}
+
+
+/**
+   @brief resample interleaved 16 bit audio
+   parameters are as for sample_move_d16_d16(), plus the stream state.
+   source channels are mapped to destination channels modulo nSrcChannels.
+*/
+void lives_resample_s16(lives_resampler_t *rs, short *dst, short *src, uint64_t nsamples, size_t tbytes, double scale,
+                        int nDstChannels, int nSrcChannels, int swap_endian, int swap_sign) {
+  uint64_t nin = nSrcChannels > 0 ? tbytes / 2 / nSrcChannels : 0;
+  double step = fabs(scale);
+  boolean rev = scale < 0.;
+  int nchans = MIN(nSrcChannels, nDstChannels);
+
+  if (!rs || nin == 0 || step == 0. || nchans <= 0 || !rs_prepare(rs, nchans, nin, nsamples)) {
+    sample_move_d16_d16(dst, src, nsamples, tbytes, scale, nDstChannels, nSrcChannels, swap_endian, swap_sign);
+    return;
+  }
+
+  for (int c = 0; c < nchans; c++) {
+    float *x = rs->line + RESAMPLE_HIST;
+    short *sp = src + c;
+    short *dp = dst + c;
+
+    for (uint64_t i = 0; i < nin; i++) {
+      int16_t v = sp[(rev ? nin - 1 - i : i) * nSrcChannels];
+      if (swap_endian == SWAP_X_TO_L) v = (int16_t)(((uint16_t)v << 8) | ((uint16_t)v >> 8));
+      if (swap_sign == SWAP_U_TO_S) v = (int16_t)((uint16_t)v - SAMPLE_MAX_16BITI);
+      x[i] = (float)v / SAMPLE_MAX_16BIT_N;
+    }
+
+    rs_run_chan(rs, c, nin, nsamples, step);
+
+    for (uint64_t j = 0; j < nsamples; j++) {
+      float f = rs->out[j] * SAMPLE_MAX_16BIT_N;
+      int16_t v = f >= 32767.f ? 32767 : f <= -32768.f ? -32768 : (int16_t)lrintf(f);
+      if (swap_sign == SWAP_S_TO_U) v = (int16_t)((uint16_t)v + SAMPLE_MAX_16BITI);
+      if (swap_endian == SWAP_L_TO_X) v = (int16_t)(((uint16_t)v << 8) | ((uint16_t)v >> 8));
+      dp[j * nDstChannels] = v;
+    }
+  }
+
+  /// extra destination channels repeat the source channels
+  for (int c = nchans; c < nDstChannels; c++) {
+    int sc = c % nSrcChannels;
+    for (uint64_t j = 0; j < nsamples; j++) dst[j * nDstChannels + c] = dst[j * nDstChannels + sc];
+  }
+
+  rs_commit(rs, nin, nsamples, step);
+}
+
+
+/**
+   @brief copy one channel of float to a buffer, resampling
+   nsrc samples are available in src; scale is the read step (2.0 to double the rate, etc),
+   negative to read backwards. rs holds the stream state, if NULL the block is treated as a stream of its own.
+*/
+void sample_move_float_float(lives_resampler_t *rs, float *dst, float *src, uint64_t nsamples, uint64_t nsrc,
+                             double scale, int dst_skip) {
+  lives_resampler_t *xrs;
+  float *padded;
+
+  if (rs) {
+    lives_resample_float(rs, &dst, dst_skip, &src, 1, 1, nsrc, nsamples, scale);
+    return;
+  }
+
+  if (scale == 1.f && dst_skip == 1 && nsrc >= nsamples) {
     lives_memcpy((void *)dst, (void *)src, nsamples * sizeof(float));
     return;
   }
 
-  for (i = 0; i < nsamples; i++) {
-    *dst = src[offs];
-    dst += dst_skip;
-    offs = (off_t)((offs_d += scale) + .4999);
+  if (!(xrs = lives_resampler_new())) return;
+  if (!nsrc || !(padded = (float *)lives_calloc(nsrc + RESAMPLE_DELAY, sizeof(float)))) {
+    lives_resample_float(xrs, &dst, dst_skip, &src, 1, 1, nsrc, nsamples, scale);
+    lives_resampler_free(xrs);
+    return;
   }
-  rem = 0.f;
-  if (scale > 0.f) {
-    if (offs_d > offs) rem = offs_d - (double)offs;
+
+  /// a block on its own has no stream to absorb the resampler delay. We start reading at the first sample
+  /// and extend the end of the block (in reading order) by RESAMPLE_DELAY copies of the last one,
+  /// so the output covers the whole block
+  if (scale >= 0.) {
+    lives_memcpy(padded, src, nsrc * sizeof(float));
+    for (uint64_t i = nsrc; i < nsrc + RESAMPLE_DELAY; i++) padded[i] = src[nsrc - 1];
   } else {
-    if (offs_d < offs) rem = (double)offs - offs_d;
+    for (uint64_t i = 0; i < RESAMPLE_DELAY; i++) padded[i] = src[0];
+    lives_memcpy(padded + RESAMPLE_DELAY, src, nsrc * sizeof(float));
   }
+  xrs->pos = (double)RESAMPLE_DELAY;
+  lives_resample_float(xrs, &dst, dst_skip, &padded, 1, 1, nsrc + RESAMPLE_DELAY, nsamples, scale);
+  lives_free(padded);
+  lives_resampler_free(xrs);
 }
 
 
@@ -796,7 +1204,7 @@ int64_t sample_move_float_int(void *holding_buff, float **float_buffer, int nsam
   int i;
   off_t offs = 0, coffs = 0, lcoffs = -1;
 
-  static double coffs_d = 0.f;
+  static __thread double coffs_d = 0.f;
   const double add = (1.0 - CLIP_DECAY);
 
   short *hbuffs = (short *)holding_buff;
@@ -804,7 +1212,7 @@ int64_t sample_move_float_int(void *holding_buff, float **float_buffer, int nsam
   unsigned char *hbuffc = (unsigned char *)holding_buff;
   short val[chans];
   unsigned short valu[chans];
-  static float clip = 1.0;
+  static __thread float clip = 1.0;
   float ovalf[chans], valf[chans], fval;
   float volx = vol, ovolx = -1.;
   boolean checklim = FALSE;
@@ -1248,6 +1656,188 @@ LIVES_LOCAL_INLINE void audio_process_events_to(weed_timecode_t tc) {
 }
 
 
+/**
+   @brief mix down several tracks of non-interleaved float audio in a single pass
+   src[track * nchans + c] is channel c of each track. vol[track] is a linear gain and pan[track] (-1. to 1.)
+   is applied to stereo output in the same way as the audio volume effect; either may be NULL (unity, centred).
+   dst may be the same buffers as track 0.
+*/
+void lives_audio_mix_tracks(float **dst, float **src, int ntracks, int nchans, const float *vol, const float *pan,
+                            uint64_t nsamps) {
+  float gain[ntracks];
+  uint64_t j;
+
+  for (int c = 0; c < nchans; c++) {
+    float *out = dst[c];
+    int t;
+
+    for (t = 0; t < ntracks; t++) {
+      float g = vol ? vol[t] : 1.f;
+      if (nchans == 2 && pan) {
+        if (c == 0 && pan[t] > 0.f) g *= 1.f - pan[t];
+        else if (c == 1 && pan[t] < 0.f) g *= 1.f + pan[t];
+      }
+      gain[t] = g;
+    }
+
+    j = 0;
+#ifdef __SSE__
+    for (; j + 4 <= nsamps; j += 4) {
+      __m128 acc = _mm_setzero_ps();
+      for (t = 0; t < ntracks; t++) {
+        if (gain[t] == 0.f || !src[t * nchans + c]) continue;
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(gain[t]), _mm_loadu_ps(src[t * nchans + c] + j)));
+      }
+      _mm_storeu_ps(out + j, acc);
+    }
+#endif
+    for (; j < nsamps; j++) {
+      float acc = 0.f;
+      for (t = 0; t < ntracks; t++) {
+        if (gain[t] == 0.f || !src[t * nchans + c]) continue;
+        acc += gain[t] * src[t * nchans + c][j];
+      }
+      out[j] = acc;
+    }
+  }
+}
+
+
+/// a range of tracks for render_audio_segment() to read, resample and convert to float
+typedef struct {
+  int first, last; ///< tracks [first, last)
+  int64_t xsamples; ///< output samples per track
+
+  int *from_files, *in_fd, *in_asamps, *in_achans, *in_arate, *in_unsigned;
+  boolean *in_reverse_endian, *is_silent;
+  double *avels, *fromtime, *chvol;
+  size_t *tbytes;
+
+  float **float_buffer; ///< out_achans buffers per track
+  short *holding_buff; ///< private to this job
+  int out_achans, out_arate;
+  lives_resampler_t **rs; ///< per track resampler state
+  boolean use_live_chvols;
+
+  int read_failed; ///< THREADVAR(read_failed) from the worker
+  char *read_failed_file;
+} render_track_job_t;
+
+
+static void *render_track_job(void *arg) {
+  render_track_job_t *job = (render_track_job_t *)arg;
+  short *holding_buff = job->holding_buff;
+  int out_achans = job->out_achans;
+  int64_t xsamples = job->xsamples;
+
+  for (int track = job->first; track < job->last; track++) {
+    float **fbuf = job->float_buffer + track * out_achans;
+    size_t tbytes = job->tbytes[track];
+    ssize_t bytes_read = 0;
+    uint64_t nframes;
+    double zavel;
+    float clip_vol;
+    const uint8_t *in_data = NULL;
+    uint8_t *in_buff = NULL;
+    int in_fd = job->in_fd[track];
+    int in_asamps = job->in_asamps[track], in_achans = job->in_achans[track];
+    int c;
+
+    if (job->is_silent[track] || tbytes <= 0) {
+      // zero float_buff
+      for (c = 0; c < out_achans; c++) lives_memset(fbuf[c], 0, xsamples * sizeof(float));
+      continue;
+    }
+
+    zavel = job->avels[track] * (double)job->in_arate[track] / (double)job->out_arate;
+    nframes = (tbytes / in_asamps / in_achans / fabs(zavel) + .001);
+
+    if (in_asamps == 2 && job->rs[track] && !job->rs[track]->primed) {
+      /// the resampler output lags its input by RESAMPLE_DELAY samples. At the start of a stream we read that many
+      /// samples extra and skip the lag, so the stream stays that far ahead and nothing is lost at the end
+      tbytes += RESAMPLE_DELAY * in_asamps * in_achans;
+      job->rs[track]->pos = (double)RESAMPLE_DELAY;
+    }
+
+    if (in_fd > -1 && zavel >= 0.) {
+      /// reading forwards the data is only read, so we can work on it where it lies
+      lives_buffered_rdonly_set_reversed(in_fd, FALSE);
+      //lives_buffered_rdonly_slurp(in_fd, seekstart[track]);
+      bytes_read = lives_read_buffered_borrow(in_fd, &in_data, tbytes);
+      if (bytes_read < 0) bytes_read = 0;
+    }
+
+    if ((size_t)bytes_read < tbytes) {
+      in_buff = (uint8_t *)lives_calloc_safety(tbytes, 1);
+      if (!in_buff) {
+        for (c = 0; c < out_achans; c++) lives_memset(fbuf[c], 0, xsamples * sizeof(float));
+        continue;
+      }
+      if (in_data) {
+        // short read, the remainder will be padded
+        lives_memcpy(in_buff, in_data, bytes_read);
+      } else if (in_fd > -1 && zavel < 0.) {
+        lives_buffered_rdonly_set_reversed(in_fd, TRUE);
+        lives_lseek_buffered_rdonly(in_fd, - tbytes);
+        bytes_read = lives_read_buffered(in_fd, in_buff, tbytes, TRUE);
+        if (bytes_read < 0) bytes_read = 0;
+        lives_lseek_buffered_rdonly(in_fd, -tbytes);
+      }
+      in_data = in_buff;
+    }
+
+    job->fromtime[track] = (double)lives_buffered_offset(in_fd) / (double)(in_asamps * in_achans * job->in_arate[track]);
+
+    if (THREADVAR(read_failed) == in_fd + 1) {
+      // be forgiving with the ascrap file
+      if (job->from_files[track] != mainw->ascrap_file) {
+        job->read_failed = THREADVAR(read_failed);
+        lives_freep((void **)&job->read_failed_file);
+        job->read_failed_file = THREADVAR(read_failed_file);
+        THREADVAR(read_failed_file) = NULL;
+      }
+      THREADVAR(read_failed) = 0;
+    }
+
+    if (bytes_read < tbytes && bytes_read >= 0)  {
+      pad_with_silence(-1, in_buff, bytes_read, tbytes, in_asamps, mainw->files[job->from_files[track]]->signed_endian
+                       & AFORM_UNSIGNED, mainw->files[job->from_files[track]]->signed_endian & AFORM_BIG_ENDIAN);
+    }
+
+    /// convert to float
+    /// - first we convert to 16 bit stereo (if it was 8 bit and / or mono) and we resample
+    /// input is tbytes bytes at rate * velocity, and we should get out nframes audio frames at out_arate. out_achans
+    /// result is in holding_buff
+    if (in_asamps == 1) {
+      if (zavel < 0.) {
+        if (reverse_buffer(in_buff, tbytes, in_achans))
+          zavel = -zavel;
+      }
+      sample_move_d8_d16(holding_buff, (uint8_t *)in_data, nframes, tbytes, zavel, out_achans, in_achans, 0);
+    } else {
+      if (zavel < 0.) {
+        if (reverse_buffer(in_buff, tbytes, in_achans * 2))
+          zavel = -zavel;
+      }
+      lives_resample_s16(job->rs[track], holding_buff, (short *)in_data, nframes, tbytes, zavel, out_achans, in_achans,
+                         job->in_reverse_endian[track] ? SWAP_X_TO_L : 0, 0);
+    }
+    if (in_buff) lives_free(in_buff);
+
+    /// if we are previewing a rendering, we would get double the volume adjustment, once from the rendering and again from
+    /// the audio player, so in that case we skip the adjustment here
+    if (!mainw->preview_rendering) clip_vol = lives_vol_from_linear(mainw->files[job->from_files[track]]->vol);
+    else clip_vol = 1.;
+    for (c = 0; c < out_achans; c++) {
+      /// now we convert to holding_buff to float in float_buffer and adjust the track volume
+      sample_move_d16_float(fbuf[c], holding_buff + c, nframes, out_achans, job->in_unsigned[track], FALSE,
+                            clip_vol * (job->use_live_chvols ? 1. : job->chvol[track]));
+    }
+  }
+  return NULL;
+}
+
+
 /**
    @brief render a chunk of audio, apply effects and mixing it
 
@@ -1283,10 +1873,8 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
 
   weed_plant_t *shortcut = NULL;
   lives_clip_t *outfile = to_file > -1 ? mainw->files[to_file] : NULL;
-  uint8_t *in_buff;
   void *finish_buff = NULL;  ///< only used if we are writing output to a file
   double *vis = NULL;
-  short *holding_buff;
   weed_layer_t **layers = NULL;
   char *infilename, *outfilename;
   off64_t seekstart[nfiles];
@@ -1301,20 +1889,17 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
 
   boolean in_reverse_endian[nfiles];
   boolean is_silent[nfiles];
+  boolean seeked[nfiles];
 
   size_t max_aud_mem, bytes_to_read, aud_buffer;
-  size_t tbytes;
-
-  ssize_t bytes_read;
-
-  uint64_t nframes;
+  size_t tbytes[nfiles];
 
   weed_timecode_t tc = tc_start;
 
   double ins_pt = tc / TICKS_PER_SECOND_DBL;
   double time = 0.;
   double opvol = opvol_start;
-  double zavel, zzavel, zavel_max = 0.;
+  double zavel, zavel_max = 0.;
 
   boolean out_reverse_endian = FALSE;
   boolean is_fade = FALSE;
@@ -1333,6 +1918,7 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
   int render_block_size = RENDER_BLOCK_SIZE;
   int c, x, y;
   int out_fd = -1;
+  int rs_set = to_file > -1 ? 1 : 0;
 
   int i;
 
@@ -1344,7 +1930,11 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
 
   float *float_buffer[out_achans * nfiles];
   float *chunk_float_buffer[out_achans * nfiles];
-  float clip_vol;
+
+  render_track_job_t jobs[nfiles];
+  lives_thread_t jthreads[nfiles];
+  lives_resampler_t *track_rsp[nfiles];
+  int njobs = 1;
 
   if (out_achans * nfiles * tsamples == 0) return 0l;
 
@@ -1419,6 +2009,7 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
     }
 
     is_silent[track] = FALSE;
+    seeked[track] = FALSE;
     infile = mainw->files[from_files[track]];
 
     in_asamps[track] = infile->asampsize / 8;
@@ -1464,6 +2055,8 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
       seekstart[track] = quant_abytes(fromtime[track], in_arps[track], in_achans[track], in_asamps[track]);
       if (labs(seekstart[track] - seek) > AUD_DIFF_MIN) {
         lives_lseek_buffered_rdonly_absolute(in_fd[track], seekstart[track]);
+        // the stream is discontinuous here, so the resampler history no longer applies
+        seeked[track] = TRUE;
       }
       lives_free(infilename);
     }
@@ -1523,12 +2116,45 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
 
   xsamples = zsamples + (tsamples - (max_segments * zsamples)); // e.g 10 + 30 - 3 * 10 == 10
 
-  holding_buff = (short *)lives_calloc_safety(xsamples * out_achans,  sizeof(short));
-
   for (i = 0; i < out_achans * nfiles; i++) {
     float_buffer[i] = (float *)lives_calloc_safety(xsamples, sizeof(float));
   }
 
+  /// divide the tracks between jobs; with enough tracks, all but the last job run in worker threads
+  if (nfiles >= RENDER_MIN_THREADED_TRACKS && prefs->nfx_threads > 1)
+    njobs = MIN(prefs->nfx_threads, nfiles / RENDER_TRACKS_PER_THREAD);
+
+  /// resampler state is looked up here, since workers must not resize the table, and held until we are done with it
+  pthread_mutex_lock(&track_rs_mutex[rs_set]);
+  for (track = 0; track < nfiles; track++) {
+    track_rsp[track] = is_silent[track] ? NULL : get_track_resampler(rs_set, track, from_files[track], seeked[track]);
+  }
+
+  for (i = 0; i < njobs; i++) {
+    render_track_job_t *job = &jobs[i];
+    lives_memset(job, 0, sizeof(render_track_job_t));
+    job->first = nfiles * i / njobs;
+    job->last = nfiles * (i + 1) / njobs;
+    job->from_files = from_files;
+    job->in_fd = in_fd;
+    job->in_asamps = in_asamps;
+    job->in_achans = in_achans;
+    job->in_arate = in_arate;
+    job->in_unsigned = in_unsigned;
+    job->in_reverse_endian = in_reverse_endian;
+    job->is_silent = is_silent;
+    job->avels = avels;
+    job->fromtime = fromtime;
+    job->chvol = chvol;
+    job->tbytes = tbytes;
+    job->rs = track_rsp;
+    job->float_buffer = float_buffer;
+    job->holding_buff = (short *)lives_calloc_safety(MAX(xsamples, zsamples) * out_achans,  sizeof(short));
+    job->out_achans = out_achans;
+    job->out_arate = out_arate;
+    job->use_live_chvols = use_live_chvols;
+  }
+
   if (to_file > -1)
     finish_buff = lives_calloc_safety(tsamples, out_achans * out_asamps);
 
@@ -1545,102 +2171,32 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
   while (tsamples > 0) {
     tsamples -= xsamples;
 
+    /// tbytes: how many bytes we want to read in for each track. This is xsamples * the track velocity.
+    /// we add a small random factor here, so half the time we round up, half the time we round down
+    /// otherwise we would be gradually losing or gaining samples
     for (track = 0; track < nfiles; track++) {
-      if (is_silent[track]) {
-        // zero float_buff
-        for (c = 0; c < out_achans; c++) {
-          lives_memset(float_buffer[track * out_achans + c], 0, xsamples * sizeof(float));
-        }
-        continue;
-      }
-      /// calculate tbytes for xsamples
+      tbytes[track] = 0;
+      if (is_silent[track]) continue;
       zavel = avels[track] * (double)in_arate[track] / (double)out_arate;
+      tbytes[track] = (int)((double)xsamples * fabs(zavel) + ((double)fastrand() / (double)LIVES_MAXUINT64)) *
+                      in_asamps[track] * in_achans[track];
+    }
 
-      //g_print("zavel is %f\n", zavel);
-      /// tbytes: how many bytes we want to read in. This is xsamples * the track velocity.
-      /// we add a small random factor here, so half the time we round up, half the time we round down
-      /// otherwise we would be gradually losing or gaining samples
-      tbytes = (int)((double)xsamples * fabs(zavel) + ((double)fastrand() / (double)LIVES_MAXUINT64)) *
-               in_asamps[track] * in_achans[track];
-
-      if (tbytes <= 0) {
-        for (c = 0; c < out_achans; c++) {
-          lives_memset(float_buffer[track * out_achans + c], 0, xsamples * sizeof(float));
-        }
-        continue;
-      }
-
-      in_buff = (uint8_t *)lives_calloc_safety(tbytes, 1);
-
-      if (in_fd[track] > -1) {
-        if (zavel < 0.) {
-          lives_buffered_rdonly_set_reversed(in_fd[track], TRUE);
-          lives_lseek_buffered_rdonly(in_fd[track], - tbytes);
-        } else {
-          lives_buffered_rdonly_set_reversed(in_fd[track], FALSE);
-          //lives_buffered_rdonly_slurp(in_fd[track], seekstart[track]);
-        }
-      }
-
-      bytes_read = 0;
-
-      if (in_fd[track] > -1) bytes_read = lives_read_buffered(in_fd[track], in_buff, tbytes, TRUE);
-
-      if (bytes_read < 0) bytes_read = 0;
-
-      if (in_fd[track] > -1) {
-        if (zavel < 0.) {
-          lives_lseek_buffered_rdonly(in_fd[track], -tbytes);
-        }
-      }
-
-      fromtime[track] = (double)lives_buffered_offset(in_fd[track])
-                        / (double)(in_asamps[track] * in_achans[track] * in_arate[track]);
-
-      if (from_files[track] == mainw->ascrap_file) {
-        // be forgiving with the ascrap file
-        if (THREADVAR(read_failed) == in_fd[track] + 1) {
-          THREADVAR(read_failed) = 0;
-        }
-      }
-
-      if (bytes_read < tbytes && bytes_read >= 0)  {
-        pad_with_silence(-1, in_buff, bytes_read, tbytes, in_asamps[track], mainw->files[from_files[track]]->signed_endian
-                         & AFORM_UNSIGNED, mainw->files[from_files[track]]->signed_endian & AFORM_BIG_ENDIAN);
-        //lives_memset(in_buff + bytes_read, 0, tbytes - bytes_read);
-      }
-
-      nframes = (tbytes / (in_asamps[track]) / in_achans[track] / fabs(zavel) + .001);
-
-      /// convert to float
-      /// - first we convert to 16 bit stereo (if it was 8 bit and / or mono) and we resample
-      /// input is tbytes bytes at rate * velocity, and we should get out nframes audio frames at out_arate. out_achans
-      /// result is in holding_buff
-      zzavel = zavel;
-      if (in_asamps[track] == 1) {
-        if (zavel < 0.) {
-          if (reverse_buffer(in_buff, tbytes, in_achans[track]))
-            zavel = -zavel;
-        }
-        sample_move_d8_d16(holding_buff, (uint8_t *)in_buff, nframes, tbytes, zavel, out_achans, in_achans[track], 0);
-      } else {
-        if (zavel < 0.) {
-          if (reverse_buffer(in_buff, tbytes, in_achans[track] * 2))
-            zavel = -zavel;
-        }
-        sample_move_d16_d16(holding_buff, (short *)in_buff, nframes, tbytes, zavel, out_achans,
-                            in_achans[track], in_reverse_endian[track] ? SWAP_X_TO_L : 0, 0);
-      }
-      zavel = zzavel;
-      lives_free(in_buff);
-      /// if we are previewing a rendering, we would get double the volume adjustment, once from the rendering and again from
-      /// the audio player, so in that case we skip the adjustment here
-      if (!mainw->preview_rendering) clip_vol = lives_vol_from_linear(mainw->files[from_files[track]]->vol);
-      else clip_vol = 1.;
-      for (c = 0; c < out_achans; c++) {
-        /// now we convert to holding_buff to float in float_buffer and adjust the track volume
-        sample_move_d16_float(float_buffer[c + track * out_achans], holding_buff + c, nframes,
-                              out_achans, in_unsigned[track], FALSE, clip_vol * (use_live_chvols ? 1. : chvol[track]));
+    /// read, resample and convert each track; with many tracks this is spread over worker threads
+    for (i = 0; i < njobs; i++) {
+      jobs[i].xsamples = xsamples;
+      if (i < njobs - 1) lives_thread_create(&jthreads[i], LIVES_THRDATTR_INLINE_OK, render_track_job, &jobs[i]);
+    }
+    render_track_job(&jobs[njobs - 1]);
+    for (i = 0; i < njobs - 1; i++) lives_thread_join(jthreads[i], NULL);
+
+    for (i = 0; i < njobs; i++) {
+      if (jobs[i].read_failed) {
+        THREADVAR(read_failed) = jobs[i].read_failed;
+        lives_freep((void **)&THREADVAR(read_failed_file));
+        THREADVAR(read_failed_file) = jobs[i].read_failed_file;
+        jobs[i].read_failed_file = NULL;
+        jobs[i].read_failed = 0;
       }
     }
 
@@ -1712,7 +2268,6 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
 
           /// apply the audo effects
           weed_apply_audio_effects(mainw->afilter_map, layers, nbtracks, out_achans, blocksize, out_arate, tc, vis);
-          lives_freep((void **)&vis);
 
           if (layers) {
             /// after processing we get the audio data back from the layers
@@ -1732,6 +2287,15 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
             }
             lives_freep((void **)&layers);
           }
+
+          if (mainw->multitrack && !mainw->multitrack->avol_init_event && nfiles > 1) {
+            /// there is no mixer effect in the chain, so mix down into the first track here,
+            /// using track visibility as the gain
+            float gains[nfiles];
+            for (x = 0; x < nfiles; x++) gains[x] = vis ? fabs(vis[x]) : 1.;
+            lives_audio_mix_tracks(chunk_float_buffer, chunk_float_buffer, nfiles, out_achans, gains, NULL, blocksize);
+          }
+          lives_freep((void **)&vis);
         }
       }
 
@@ -1782,6 +2346,7 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
     }
     xsamples = zsamples;
   }
+  pthread_mutex_unlock(&track_rs_mutex[rs_set]);
 
   if (xsamples > 0) {
     for (i = 0; i < out_achans * nfiles; i++) {
@@ -1790,7 +2355,10 @@ int64_t render_audio_segment(int nfiles, int *from_files, int to_file, double *a
   }
 
   if (finish_buff) lives_free(finish_buff);
-  if (holding_buff) lives_free(holding_buff);
+  for (i = 0; i < njobs; i++) {
+    lives_freep((void **)&jobs[i].holding_buff);
+    lives_freep((void **)&jobs[i].read_failed_file);
+  }
 
   // close files
   for (track = 0; track < nfiles; track++) {
@@ -1934,17 +2502,14 @@ void preview_audio(void) {
       ticks_t timeout = 0;
       if (mainw->cancelled != CANCEL_AUDIO_ERROR) {
         lives_alarm_t alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
-        while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(mainw->jackd) != NULL) {
+        while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(mainw->jackd)) {
           sched_yield(); // wait for seek
           lives_usleep(prefs->sleep_time);
         }
         lives_alarm_clear(alarm_handle);
       }
       if (mainw->cancelled == CANCEL_AUDIO_ERROR) mainw->cancelled = CANCEL_ERROR;
-      jack_message.command = ASERVER_CMD_FILE_CLOSE;
-      jack_message.data = NULL;
-      jack_message.next = NULL;
-      mainw->jackd->msgq = &jack_message;
+      jack_send_cmd(mainw->jackd, ASERVER_CMD_FILE_CLOSE, 0);
       if (timeout == 0) handle_audio_timeout();
     }
   }
@@ -2602,6 +3167,8 @@ void fill_abuffer_from(lives_audio_buf_t *abuf, weed_plant_t *event_list, weed_p
     lives_freep((void **)&avels);
     lives_freep((void **)&aseeks);
 
+    audio_reset_track_resamplers(FALSE);
+
     if (mainw->multitrack && mainw->multitrack->avol_init_event)
       nfiles = weed_leaf_num_elements(mainw->multitrack->avol_init_event, WEED_LEAF_IN_TRACKS);
 
@@ -2886,6 +3453,133 @@ static pthread_t athread;
 static pthread_cond_t cond  = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t cond_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+static lives_audio_cache_stats_t cache_stats;
+
+
+static void ra_flush(lives_audio_readahead_t *ra, int fileno, off_t next, boolean reverse) {
+  // discard everything read ahead and restart from next
+  boolean had_data = FALSE;
+  int i;
+  for (i = 0; i < AUDIO_RA_NCHUNKS; i++) {
+    if (ra->chunks[i].len > 0) had_data = TRUE;
+    ra->chunks[i].len = 0;
+  }
+  ra->fileno = fileno;
+  ra->next = next;
+  ra->reverse = reverse;
+  ra->eof = FALSE;
+  cache_stats.bytes_ahead = 0;
+  if (had_data) cache_stats.flushes++;
+}
+
+
+static lives_audio_readahead_t *ra_new(void) {
+  lives_audio_readahead_t *ra = (lives_audio_readahead_t *)lives_calloc(1, sizeof(lives_audio_readahead_t));
+  int i;
+  if (!ra) return NULL;
+  for (i = 0; i < AUDIO_RA_NCHUNKS; i++) {
+    if (!(ra->chunks[i].data = (uint8_t *)lives_malloc(AUDIO_RA_CHUNK_SIZE))) {
+      while (i--) lives_free(ra->chunks[i].data);
+      lives_free(ra);
+      return NULL;
+    }
+  }
+  ra->fileno = -1;
+  return ra;
+}
+
+
+static void ra_free(lives_audio_readahead_t *ra) {
+  int i;
+  if (!ra) return;
+  for (i = 0; i < AUDIO_RA_NCHUNKS; i++) lives_free(ra->chunks[i].data);
+  lives_free(ra);
+}
+
+
+/// copy bytes from the read ahead chunks starting at seek; returns the number of contiguous bytes found
+static ssize_t ra_gather(lives_audio_readahead_t *ra, uint8_t *dst, off_t seek, ssize_t bytes) {
+  ssize_t done = 0;
+  int i;
+  while (done < bytes) {
+    off_t pos = seek + done;
+    for (i = 0; i < AUDIO_RA_NCHUNKS; i++) {
+      lives_audio_chunk_t *chunk = &ra->chunks[i];
+      if (chunk->len > 0 && pos >= chunk->offs && pos < chunk->offs + chunk->len) {
+        ssize_t avail = chunk->offs + chunk->len - pos;
+        if (avail > bytes - done) avail = bytes - done;
+        lives_memcpy(dst + done, chunk->data + (pos - chunk->offs), avail);
+        done += avail;
+        break;
+      }
+    }
+    if (i == AUDIO_RA_NCHUNKS) break;
+  }
+  return done;
+}
+
+
+/// free chunks the player has moved past; the next request will start at (forwards) or end at (reverse) pos
+static void ra_release(lives_audio_readahead_t *ra, off_t pos) {
+  int i;
+  uint64_t ahead = 0;
+  for (i = 0; i < AUDIO_RA_NCHUNKS; i++) {
+    lives_audio_chunk_t *chunk = &ra->chunks[i];
+    if (chunk->len <= 0) continue;
+    if (ra->reverse ? chunk->offs >= pos : chunk->offs + chunk->len <= pos) chunk->len = 0;
+    else ahead += chunk->len;
+  }
+  cache_stats.bytes_ahead = ahead;
+}
+
+
+/**
+   @brief read one more chunk ahead of the player
+
+   returns FALSE if there is nothing more to do (ring full, start / end of file, or read error)
+*/
+static boolean ra_fill_chunk(lives_audio_buf_t *cbuffer) {
+  lives_audio_readahead_t *ra = cbuffer->_ra;
+  lives_audio_chunk_t *chunk = NULL;
+  off_t offs;
+  ssize_t len = AUDIO_RA_CHUNK_SIZE, got;
+  int i;
+
+  if (!ra || ra->fileno == -1 || ra->eof || cbuffer->_fd == -1 || ra->fileno != cbuffer->_cfileno) return FALSE;
+
+  for (i = 0; i < AUDIO_RA_NCHUNKS; i++) {
+    if (ra->chunks[i].len <= 0) {
+      chunk = &ra->chunks[i];
+      break;
+    }
+  }
+  if (!chunk) return FALSE;
+
+  if (ra->reverse) {
+    if (ra->next <= 0) {
+      ra->eof = TRUE;
+      return FALSE;
+    }
+    if (len > ra->next) len = ra->next;
+    offs = ra->next - len;
+  } else offs = ra->next;
+
+  lives_lseek_buffered_rdonly_absolute(cbuffer->_fd, offs);
+  got = lives_read_buffered(cbuffer->_fd, chunk->data, len, TRUE);
+  if (got <= 0) {
+    ra->eof = TRUE;
+    return FALSE;
+  }
+
+  chunk->offs = offs;
+  chunk->len = got;
+  if (got < len) ra->eof = TRUE; ///< short read: keep what we got and stop here
+  ra->next = ra->reverse ? offs : offs + got;
+  cache_stats.bytes_ahead += got;
+  return TRUE;
+}
+
+
 
 /**
    @brief audio caching worker thread function
@@ -2895,6 +3589,9 @@ static pthread_mutex_t cond_mutex = PTHREAD_MUTEX_INITIALIZER;
    read audio from file into cache
    must be done in real time since other threads may be waiting on the cache
 
+   between requests the thread reads ahead of the player (see lives_audio_readahead_t) so that requests
+   can normally be served from memory; the read ahead data is dropped on seek or when the clip or direction changes
+
    during free playback, this is only used by jack (thus far it has proven too complex to implement for pulse, since it uses
    variable sized buffers.
 
@@ -2903,16 +3600,22 @@ static pthread_mutex_t cond_mutex = PTHREAD_MUTEX_INITIALIZER;
 */
 static void *cache_my_audio(void *arg) {
   lives_audio_buf_t *cbuffer = (lives_audio_buf_t *)arg;
+  lives_audio_readahead_t *ra;
   char *filename;
+  ssize_t got;
+  boolean reverse;
   int i;
 
   while (!cbuffer->die) {
+    // whilst idle, read ahead in the direction of play; a new request is checked for after every chunk
+    while (cbuffer->is_ready && !cbuffer->die && mainw->abufs_to_fill <= 0 && ra_fill_chunk(cbuffer));
+
     // wait for request from client (setting cbuffer->is_ready or cbuffer->die)
+    pthread_mutex_lock(&cond_mutex);
     while (cbuffer->is_ready && !cbuffer->die && mainw->abufs_to_fill <= 0) {
-      pthread_mutex_lock(&cond_mutex);
       pthread_cond_wait(&cond, &cond_mutex);
-      pthread_mutex_unlock(&cond_mutex);
     }
+    pthread_mutex_unlock(&cond_mutex);
 
     if (cbuffer->die) {
       if (!mainw->event_list || (mainw->record
@@ -3132,7 +3835,7 @@ static void *cache_my_audio(void *arg) {
 
       filename = get_audio_file_name(cbuffer->fileno, afile->opening);
 
-      cbuffer->_fd = lives_open_buffered_rdonly(filename);
+      cbuffer->_fd = lives_open_buffered_rdonly_mapped(filename);
       if (cbuffer->_fd == -1) {
         lives_printerr("audio cache thread: error opening %s\n", filename);
         cbuffer->in_achans = 0;
@@ -3144,18 +3847,25 @@ static void *cache_my_audio(void *arg) {
       lives_free(filename);
     }
 
+    reverse = !cbuffer->sequential && cbuffer->shrink_factor < 0.;
+
     if (cbuffer->fileno != cbuffer->_cfileno || cbuffer->seek != cbuffer->_cseek ||
         cbuffer->shrink_factor != cbuffer->_shrink_factor) {
-      if (cbuffer->sequential || cbuffer->shrink_factor > 0.) {
-        lives_buffered_rdonly_set_reversed(cbuffer->_fd, FALSE);
-      } else {
-        lives_buffered_rdonly_set_reversed(cbuffer->_fd, TRUE);
-      }
+      lives_buffered_rdonly_set_reversed(cbuffer->_fd, reverse);
       if (cbuffer->fileno != cbuffer->_cfileno || cbuffer->seek != cbuffer->_cseek) {
         lives_lseek_buffered_rdonly_absolute(cbuffer->_fd, cbuffer->seek);
       }
+      /// source is no longer continuous with the previous block
+      lives_resampler_reset(cbuffer->_resampler);
     }
 
+    /// a file which is still being written (ascrap) may grow under us, so we don't read ahead of it
+    if (!cbuffer->sequential && !cbuffer->_ra) cbuffer->_ra = ra_new();
+    ra = cbuffer->sequential ? NULL : cbuffer->_ra;
+
+    if (ra && (ra->fileno != cbuffer->fileno || ra->reverse != reverse))
+      ra_flush(ra, cbuffer->fileno, cbuffer->seek, reverse);
+
     cbuffer->_cfileno = cbuffer->fileno;
     cbuffer->_shrink_factor = cbuffer->shrink_factor;
 
@@ -3172,8 +3882,23 @@ static void *cache_my_audio(void *arg) {
       }
     }
 
-    // read from file
-    cbuffer->_cbytesize = lives_read_buffered(cbuffer->_fd, cbuffer->_filebuffer, cbuffer->bytesize, TRUE);
+    // read from file, taking what we can from the data read ahead
+    cache_stats.requests++;
+    got = ra ? ra_gather(ra, cbuffer->_filebuffer, cbuffer->seek, cbuffer->bytesize) : 0;
+
+    if (got == cbuffer->bytesize) {
+      cache_stats.hits++;
+      cbuffer->_cbytesize = got;
+    } else {
+      ssize_t res;
+      if (ra) cache_stats.misses++;
+      if (got > 0 || ra) lives_lseek_buffered_rdonly_absolute(cbuffer->_fd, cbuffer->seek + got);
+      res = lives_read_buffered(cbuffer->_fd, cbuffer->_filebuffer + got, cbuffer->bytesize - got, TRUE);
+      cbuffer->_cbytesize = res > 0 ? got + res : got > 0 ? got : res;
+      /// the request was not where we were reading ahead (seek), or we fell behind: restart from here
+      if (ra) ra_flush(ra, cbuffer->fileno, reverse ? cbuffer->seek : cbuffer->seek + cbuffer->_cbytesize, reverse);
+    }
+    if (ra) ra_release(ra, reverse ? cbuffer->seek : cbuffer->seek + cbuffer->_cbytesize);
 
     if (cbuffer->_cbytesize <= 0) {
       // there is not much we can do if we get a read error, since we are running in a realtime thread here
@@ -3213,9 +3938,10 @@ static void *cache_my_audio(void *arg) {
         if (reverse_buffer(cbuffer->_filebuffer, cbuffer->bytesize, cbuffer->in_achans * 2))
           cbuffer->shrink_factor = -cbuffer->shrink_factor;
       }
-      sample_move_d16_d16(cbuffer->buffer16[0], (short *)cbuffer->_filebuffer, cbuffer->samp_space, cbuffer->bytesize,
-                          cbuffer->shrink_factor, cbuffer->out_achans, cbuffer->in_achans,
-                          cbuffer->swap_endian ? SWAP_X_TO_L : 0, 0);
+      if (!cbuffer->_resampler) cbuffer->_resampler = lives_resampler_new();
+      lives_resample_s16(cbuffer->_resampler, cbuffer->buffer16[0], (short *)cbuffer->_filebuffer, cbuffer->samp_space,
+                         cbuffer->bytesize, cbuffer->shrink_factor, cbuffer->out_achans, cbuffer->in_achans,
+                         cbuffer->swap_endian ? SWAP_X_TO_L : 0, 0);
     }
     cbuffer->shrink_factor = cbuffer->_shrink_factor;
 
@@ -3251,6 +3977,7 @@ lives_audio_buf_t *audio_cache_init(void) {
     cache_buffer->buffer32 = NULL;
     cache_buffer->bufferf = NULL;
     cache_buffer->_filebuffer = NULL;
+    cache_buffer->_ra = NULL;
     cache_buffer->_cbytesize = 0;
     cache_buffer->_csamp_space = 0;
     cache_buffer->_cachans = 0;
@@ -3266,6 +3993,8 @@ lives_audio_buf_t *audio_cache_init(void) {
     cache_buffer->_shrink_factor = 0.;
   }
 
+  audio_cache_reset_stats();
+
   // init the audio caching thread for rt playback
   pthread_create(&athread, NULL, cache_my_audio, cache_buffer);
 
@@ -3308,6 +4037,8 @@ void audio_cache_end(void) {
   }
 
   if (cache_buffer->_fd != -1) lives_close_buffered(cache_buffer->_fd);
+  lives_resampler_free(cache_buffer->_resampler);
+  ra_free(cache_buffer->_ra);
 
   // make this threadsafe (kind of)
   xcache_buffer = cache_buffer;
@@ -3325,6 +4056,22 @@ LIVES_GLOBAL_INLINE lives_audio_buf_t *audio_cache_get_buffer(void) {
   return cache_buffer;
 }
 
+
+/// called by a player which needed cached audio before it was ready
+void audio_cache_note_underrun(void) {
+  __atomic_add_fetch(&cache_stats.underruns, 1, __ATOMIC_RELAXED);
+}
+
+
+void audio_cache_get_stats(lives_audio_cache_stats_t *stats) {
+  lives_memcpy(stats, (void *)&cache_stats, sizeof(lives_audio_cache_stats_t));
+}
+
+
+void audio_cache_reset_stats(void) {
+  lives_memset((void *)&cache_stats, 0, sizeof(lives_audio_cache_stats_t));
+}
+
 ///////////////////////////////////////
 
 // plugin handling
@@ -3692,6 +4439,7 @@ boolean push_audio_to_channel(weed_plant_t *filter, weed_plant_t *achan, lives_a
 
   double scale;
 
+  lives_resampler_t **rs = NULL;
   size_t samps, offs = 0;
   boolean rvary = FALSE, lvary = FALSE;
   int trate, tchans, xnchans, flags;
@@ -3796,6 +4544,12 @@ boolean push_audio_to_channel(weed_plant_t *filter, weed_plant_t *achan, lives_a
   // malloc audio_data
   dst = (float **)lives_calloc(tchans, sizeof(float *));
 
+  if (abuf->arate != trate) {
+    // each channel keeps its resampler from one frame to the next, so the chunks join up without a click
+    pthread_mutex_lock(&push_rs_mutex);
+    rs = get_push_resamplers(achan, tchans, abuf->arate, trate);
+  }
+
   // copy data from abuf->bufferf[] to "audio_data"
   for (i = 0; i < tchans; i++) {
     pthread_mutex_lock(&mainw->abuf_mutex);
@@ -3805,12 +4559,13 @@ boolean push_audio_to_channel(weed_plant_t *filter, weed_plant_t *achan, lives_a
       if (abuf->arate == trate) {
         lives_memcpy(dst[i], src, alen * sizeof(float));
       } else {
-        // needs resample
-        sample_move_float_float(dst[i], src, alen, scale, 1);
+        // needs resample; we read arate / trate source samples per output sample
+        sample_move_float_float(rs ? rs[i] : NULL, dst[i], src, alen, samps, 1. / scale, 1);
       }
     } else dst[i] = NULL;
     pthread_mutex_unlock(&mainw->abuf_mutex);
   }
+  if (abuf->arate != trate) pthread_mutex_unlock(&push_rs_mutex);
 
   // set channel values
   weed_channel_set_audio_data(achan, dst, trate, tchans, alen);
@@ -38,6 +38,16 @@
 /// chunk size for interpolate/effect cycle
 #define RENDER_BLOCK_SIZE 1024
 
+/// when rendering at least this many audio tracks, tracks are read and resampled in parallel
+#define RENDER_MIN_THREADED_TRACKS 4
+
+/// minimum tracks handled by each rendering thread
+#define RENDER_TRACKS_PER_THREAD 2
+
+/// audio cache thread: number and size of the chunks read ahead of the player
+#define AUDIO_RA_NCHUNKS 8
+#define AUDIO_RA_CHUNK_SIZE 65536
+
 /// size of silent block in bytes
 #define SILENCE_BLOCK_SIZE BUFFER_FILL_BYTES_LARGE
 
@@ -46,9 +56,22 @@
 /// used when we have an event_list (i.e multitrack or previewing a recording in CE)
 #define XSAMPLES 393216
 
+/// windowed-sinc resampler: kernel half width in zero crossings at unity rate
+#define RESAMPLE_HALF_TAPS 8
+
+/// when reading faster than unity the kernel is widened (low-pass for anti-aliasing), up to this factor
+#define RESAMPLE_MAX_SPREAD 4
+
+/// constant group delay of the resampler, in source samples
+#define RESAMPLE_DELAY (RESAMPLE_HALF_TAPS * RESAMPLE_MAX_SPREAD)
+
+/// source samples of history kept per channel between blocks
+#define RESAMPLE_HIST (RESAMPLE_DELAY * 2)
+
 #define AUD_WRITE_CHECK 0xFFFFFFFFF4000000 ///< after recording this many bytes we check disk space (default 128MB)
 
 #define WEED_LEAF_HOST_KEEP_ADATA "keep_adata" /// set to WEED_TRUE in layer if doing zero-copy audio porcessing
+#define WEED_LEAF_HOST_PUSH_RS_ID "host_push_rs_id" /// set in an audio channel fed by push_audio_to_channel()
 
 /////////////////////////////////////
 /// asynch msging
@@ -73,6 +96,54 @@ typedef enum {
   LIVES_CONVERT_OPERATION
 } lives_operation_t;
 
+/**
+   @brief per-stream resampler state
+
+   one of these should be held for each continuous audio stream (player, cache reader, multitrack track).
+   It carries the fractional read position and the trailing source samples of the previous block,
+   so consecutive blocks are interpolated seamlessly. Call lives_resampler_reset() on seek.
+*/
+typedef struct {
+  double pos; ///< read position for the next block, in source samples
+  int nchans; ///< channels held in hist
+  boolean primed; ///< hist contains valid samples
+  float *hist; ///< RESAMPLE_HIST samples per channel, taken from the end of the last block
+  float *line; ///< scratch: history + one channel of source
+  float *out; ///< scratch: one channel of output
+  size_t line_size, out_size;
+} lives_resampler_t;
+
+/**
+   @brief raw audio read ahead by the cache thread
+
+   while the player is consuming one request, the cache thread reads the following chunks of the audio file
+   (in the direction of play) into these slots, so the next request can usually be served without touching the disk.
+   The ring is discarded whenever the clip, the direction or the seek position changes discontinuously.
+*/
+typedef struct {
+  off_t offs; ///< offset in the audio file of the first byte held
+  ssize_t len; ///< bytes held; 0 if the slot is free
+  uint8_t *data; ///< AUDIO_RA_CHUNK_SIZE bytes
+} lives_audio_chunk_t;
+
+typedef struct {
+  lives_audio_chunk_t chunks[AUDIO_RA_NCHUNKS];
+  int fileno; ///< clip the chunks belong to, or -1
+  boolean reverse; ///< reading ahead towards the start of the file
+  boolean eof; ///< read ahead reached the end (or start) of the file
+  off_t next; ///< forwards: offset of the next chunk to read; reverse: end of the next chunk to read
+} lives_audio_readahead_t;
+
+/// counters for the audio cache thread, see audio_cache_get_stats()
+typedef struct {
+  volatile uint64_t requests; ///< read requests served
+  volatile uint64_t hits; ///< requests served entirely from read ahead data
+  volatile uint64_t misses; ///< requests which had to wait for the file
+  volatile uint64_t flushes; ///< times the read ahead data was discarded (seek, clip or direction change)
+  volatile uint64_t underruns; ///< times a player needed data before the cache thread had delivered it
+  volatile uint64_t bytes_ahead; ///< bytes buffered ahead of the most recent request
+} lives_audio_cache_stats_t;
+
 typedef struct {
   lives_operation_t operation; // read, write, or convert [readonly by server]
   volatile boolean is_ready; // [readwrite all]
@@ -130,12 +201,14 @@ typedef struct {
   size_t _csamp_space; ///< current sample buffer size in single channel samples
   int _fd; ///< file descriptor
   int _cfileno; ///< current fileno
-  int _cseek;  ///< current seek pos
+  off_t _cseek;  ///< current seek pos
   int _cachans; ///< current output channels
   int _cin_interleaf;
   int _cout_interleaf;
   int _casamps; ///< current out_asamps
   double _shrink_factor;  ///< resampling ratio
+  lives_resampler_t *_resampler; ///< resampler state for the stream being read
+  lives_audio_readahead_t *_ra; ///< data read ahead of the current request (free playback only)
 
   volatile boolean die;  ///< set to TRUE to shut down thread
 } lives_audio_buf_t;
@@ -181,7 +254,23 @@ int64_t sample_move_abuf_float(float **obuf, int nchans, int nsamps, int out_ara
 
 int64_t sample_move_abuf_int16(short *obuf, int nchans, int nsamps, int out_arate) GNU_HOT;
 
-void sample_move_float_float(float *dst, float *src, uint64_t nsamples, double scale, int dst_skip) GNU_HOT;
+void sample_move_float_float(lives_resampler_t *, float *dst, float *src, uint64_t nsamples, uint64_t nsrc, double scale,
+                             int dst_skip) GNU_HOT;
+
+lives_resampler_t *lives_resampler_new(void);
+void lives_resampler_reset(lives_resampler_t *);
+void lives_resampler_free(lives_resampler_t *);
+
+void lives_resample_float(lives_resampler_t *, float **dst, int dst_skip, float **src, int src_skip, int nchans,
+                          uint64_t nsrc, uint64_t nsamples, double scale) GNU_HOT;
+
+void lives_resample_s16(lives_resampler_t *, short *dst, short *src, uint64_t nsamples, size_t tbytes, double scale,
+                        int nDstChannels, int nSrcChannels, int swap_endian, int swap_sign) GNU_HOT;
+
+void audio_reset_track_resamplers(boolean to_file); ///< free the resampler state for rendering to a file or to a buffer
+
+void lives_audio_mix_tracks(float **dst, float **src, int ntracks, int nchans, const float *vol, const float *pan,
+                            uint64_t nsamps) GNU_HOT;
 
 boolean float_deinterleave(float *fbuffer, int nsamps, int nchans) GNU_HOT;
 boolean float_interleave(float *fbuffer, int nsamps, int nchans) GNU_HOT;
@@ -240,6 +329,9 @@ void preview_aud_vol(void);
 lives_audio_buf_t *audio_cache_init(void);
 void audio_cache_end(void);
 lives_audio_buf_t *audio_cache_get_buffer(void);
+void audio_cache_note_underrun(void);
+void audio_cache_get_stats(lives_audio_cache_stats_t *);
+void audio_cache_reset_stats(void);
 
 boolean apply_rte_audio_init(void);
 void apply_rte_audio_end(boolean del);
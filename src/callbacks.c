@@ -495,6 +495,7 @@ void lives_exit(int signum) {
     }
 
     weed_unload_all();
+    cc_engine_stop();
 
 #ifdef VALGRIND_ON
     lives_list_free_all(&mainw->current_layouts_map);
@@ -32,6 +32,11 @@
 
 #include "main.h"
 
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__)) && !defined (USE_EXTEND)
+#define CC_HAVE_SIMD ///< build the vectorised YUV <-> RGB kernels
+#include <immintrin.h>
+#endif
+
 boolean weed_palette_is_sane(int pal);
 
 #define USE_THREADS 1 ///< set to 0 to disable threading for pixbuf operations, 1 to enable. Other values are invalid.
@@ -844,6 +849,458 @@ static void init_unal(void) {
 }
 
 
+//////////////////////////////////////////////////////////////
+// vectorised YUV <-> RGB kernels
+
+// the kernels use Q16 fixed point coefficients which are sampled from the active conversion tables, so they reproduce
+// the scalar LUT path for legal input values (out of range values in clamped YUV are clipped first).
+// The LUT functions remain the reference implementation and are used for row tails, gamma corrected output,
+// and when no suitable CPU extension is available.
+// Each row function returns the number of pixels it converted; the caller finishes the remainder.
+
+#define CC_SIMD_NONE 0
+#define CC_SIMD_SSE41 1
+#define CC_SIMD_AVX2 2
+
+/// byte orderings for packed RGB
+#define CC_ORDER_RGB 0
+#define CC_ORDER_BGR 1
+#define CC_ORDER_ARGB 2
+
+static int cc_simd = CC_SIMD_NONE;
+
+typedef struct {
+  int32_t ky, kr_v, kg_u, kg_v, kb_u;
+  int32_t cr, cg, cb; ///< constant terms, including rounding
+  int32_t ymin, ymax, uvmin, uvmax;
+} cc_yuv2rgb_coeffs_t;
+
+typedef struct {
+  int32_t ky_r, ky_g, ky_b, ku_r, ku_g, ku_b, kv_r, kv_g, kv_b;
+  int32_t cy, cu, cv;
+  int32_t ymin, ymax, uvmin, uvmax;
+} cc_rgb2yuv_coeffs_t;
+
+static cc_yuv2rgb_coeffs_t yr_co;
+static cc_rgb2yuv_coeffs_t ry_co;
+
+static int32_t lut_slope(const int *lut, int lo, int hi) {
+  return (int32_t)lrint((double)(lut[hi] - lut[lo]) / (double)(hi - lo));
+}
+
+#define lut_base(lut, lo, slope) ((lut)[lo] - (slope) * (lo))
+
+static void set_simd_coeffs(int clamping) {
+  // called from set_conversion_arrays(), after the table pointers have been set
+  int ylo = 0, yhi = 255, uvlo = 0, uvhi = 255;
+  if (clamping == WEED_YUV_CLAMPING_CLAMPED) {
+    ylo = uvlo = YUV_CLAMP_MINI;
+    yhi = Y_CLAMP_MAXI;
+    uvhi = UV_CLAMP_MAXI;
+  }
+
+  if (conv_YR_inited) {
+    // sample strictly inside the clipping range, since the tables saturate at the edges
+    int32_t ybase;
+    yr_co.ky = lut_slope(RGB_Y, ylo + 1, yhi - 1);
+    yr_co.kr_v = lut_slope(R_Cr, uvlo + 1, uvhi - 1);
+    yr_co.kg_u = lut_slope(G_Cb, uvlo + 1, uvhi - 1);
+    yr_co.kg_v = lut_slope(G_Cr, uvlo + 1, uvhi - 1);
+    yr_co.kb_u = lut_slope(B_Cb, uvlo + 1, uvhi - 1);
+    ybase = lut_base(RGB_Y, ylo + 1, yr_co.ky) + (1 << (FP_BITS - 1));
+    yr_co.cr = ybase + lut_base(R_Cr, uvlo + 1, yr_co.kr_v);
+    yr_co.cg = ybase + lut_base(G_Cb, uvlo + 1, yr_co.kg_u) + lut_base(G_Cr, uvlo + 1, yr_co.kg_v);
+    yr_co.cb = ybase + lut_base(B_Cb, uvlo + 1, yr_co.kb_u);
+    yr_co.ymin = ylo;
+    yr_co.ymax = yhi;
+    yr_co.uvmin = uvlo;
+    yr_co.uvmax = uvhi;
+  }
+
+  if (conv_RY_inited) {
+    ry_co.ky_r = lut_slope(Y_R, 0, 255);
+    ry_co.ky_g = lut_slope(Y_G, 0, 255);
+    ry_co.ky_b = lut_slope(Y_B, 0, 255);
+    ry_co.ku_r = lut_slope(Cb_R, 0, 255);
+    ry_co.ku_g = lut_slope(Cb_G, 0, 255);
+    ry_co.ku_b = lut_slope(Cb_B, 0, 255);
+    ry_co.kv_r = lut_slope(Cr_R, 0, 255);
+    ry_co.kv_g = lut_slope(Cr_G, 0, 255);
+    ry_co.kv_b = lut_slope(Cr_B, 0, 255);
+    ry_co.cy = Y_R[0] + Y_G[0] + Y_B[0] + (1 << (FP_BITS - 1));
+    ry_co.cu = Cb_R[0] + Cb_G[0] + Cb_B[0] + (1 << (FP_BITS - 1));
+    ry_co.cv = Cr_R[0] + Cr_G[0] + Cr_B[0] + (1 << (FP_BITS - 1));
+    ry_co.ymin = ylo;
+    ry_co.ymax = yhi;
+    ry_co.uvmin = uvlo;
+    ry_co.uvmax = uvhi;
+  }
+}
+
+
+#ifdef CC_HAVE_SIMD
+
+static void get_order_shifts(int order, int *rsh, int *gsh, int *bsh, int *ash) {
+  // bit offsets of each component within a little endian 32 bit pixel
+  switch (order) {
+  case CC_ORDER_BGR:
+    *bsh = 0; *gsh = 8; *rsh = 16; *ash = 24;
+    break;
+  case CC_ORDER_ARGB:
+    *ash = 0; *rsh = 8; *gsh = 16; *bsh = 24;
+    break;
+  default:
+    *rsh = 0; *gsh = 8; *bsh = 16; *ash = 24;
+    break;
+  }
+}
+
+#define SSE41_FN __attribute__((target("sse4.1")))
+#define AVX2_FN __attribute__((target("avx2")))
+
+// SSE4.1 - 4 pixels per step
+
+static inline SSE41_FN __m128i load4_u8_sse41(const uint8_t *p) {
+  int32_t v;
+  lives_memcpy(&v, p, 4);
+  return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v));
+}
+
+static inline SSE41_FN void store4_u8_sse41(uint8_t *p, __m128i v) {
+  // v holds 4 values in 0 - 255
+  int32_t x = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packus_epi32(v, v), v));
+  lives_memcpy(p, &x, 4);
+}
+
+static inline SSE41_FN __m128i expand3_sse41(const uint8_t *p) {
+  // 4 x 3 byte pixels -> 4 x 32 bit, top byte zero. Reads 16 bytes.
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), mask);
+}
+
+static inline SSE41_FN void store_pixels_sse41(uint8_t *p, __m128i px, int opsize) {
+  if (opsize == 4) _mm_storeu_si128((__m128i *)p, px);
+  else {
+    const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    int32_t x;
+    px = _mm_shuffle_epi8(px, mask);
+    _mm_storel_epi64((__m128i *)p, px);
+    x = _mm_extract_epi32(px, 2);
+    lives_memcpy(p + 8, &x, 4);
+  }
+}
+
+#define CLAMP_SSE41(x, lo, hi) _mm_min_epi32(_mm_max_epi32((x), (lo)), (hi))
+
+static inline SSE41_FN __m128i yuv2rgb_4_sse41(__m128i y, __m128i u, __m128i v, __m128i a,
+    __m128i rsh, __m128i gsh, __m128i bsh, __m128i ash) {
+  const __m128i zero = _mm_setzero_si128(), max = _mm_set1_epi32(255);
+  __m128i r, g, b;
+  y = _mm_mullo_epi32(CLAMP_SSE41(y, _mm_set1_epi32(yr_co.ymin), _mm_set1_epi32(yr_co.ymax)), _mm_set1_epi32(yr_co.ky));
+  u = CLAMP_SSE41(u, _mm_set1_epi32(yr_co.uvmin), _mm_set1_epi32(yr_co.uvmax));
+  v = CLAMP_SSE41(v, _mm_set1_epi32(yr_co.uvmin), _mm_set1_epi32(yr_co.uvmax));
+
+  r = _mm_add_epi32(_mm_add_epi32(y, _mm_mullo_epi32(v, _mm_set1_epi32(yr_co.kr_v))), _mm_set1_epi32(yr_co.cr));
+  g = _mm_add_epi32(_mm_add_epi32(y, _mm_mullo_epi32(u, _mm_set1_epi32(yr_co.kg_u))),
+                    _mm_add_epi32(_mm_mullo_epi32(v, _mm_set1_epi32(yr_co.kg_v)), _mm_set1_epi32(yr_co.cg)));
+  b = _mm_add_epi32(_mm_add_epi32(y, _mm_mullo_epi32(u, _mm_set1_epi32(yr_co.kb_u))), _mm_set1_epi32(yr_co.cb));
+
+  r = CLAMP_SSE41(_mm_srai_epi32(r, FP_BITS), zero, max);
+  g = CLAMP_SSE41(_mm_srai_epi32(g, FP_BITS), zero, max);
+  b = CLAMP_SSE41(_mm_srai_epi32(b, FP_BITS), zero, max);
+
+  return _mm_or_si128(_mm_or_si128(_mm_sll_epi32(r, rsh), _mm_sll_epi32(g, gsh)),
+                      _mm_or_si128(_mm_sll_epi32(b, bsh), _mm_sll_epi32(a, ash)));
+}
+
+static inline SSE41_FN void rgb2yuv_4_sse41(__m128i r, __m128i g, __m128i b, __m128i *y, __m128i *u, __m128i *v) {
+#define DOT_SSE41(k0, k1, k2, c) _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi32(r, _mm_set1_epi32(k0)), \
+                                                             _mm_mullo_epi32(g, _mm_set1_epi32(k1))), \
+                                               _mm_add_epi32(_mm_mullo_epi32(b, _mm_set1_epi32(k2)), _mm_set1_epi32(c)))
+  *y = CLAMP_SSE41(_mm_srai_epi32(DOT_SSE41(ry_co.ky_r, ry_co.ky_g, ry_co.ky_b, ry_co.cy), FP_BITS),
+                   _mm_set1_epi32(ry_co.ymin), _mm_set1_epi32(ry_co.ymax));
+  *u = CLAMP_SSE41(_mm_srai_epi32(DOT_SSE41(ry_co.ku_r, ry_co.ku_g, ry_co.ku_b, ry_co.cu), FP_BITS),
+                   _mm_set1_epi32(ry_co.uvmin), _mm_set1_epi32(ry_co.uvmax));
+  *v = CLAMP_SSE41(_mm_srai_epi32(DOT_SSE41(ry_co.kv_r, ry_co.kv_g, ry_co.kv_b, ry_co.cv), FP_BITS),
+                   _mm_set1_epi32(ry_co.uvmin), _mm_set1_epi32(ry_co.uvmax));
+#undef DOT_SSE41
+}
+
+
+static SSE41_FN int yuvp_row_to_rgb_sse41(const uint8_t *ys, const uint8_t *us, const uint8_t *vs, const uint8_t *as,
+    uint8_t *dest, int width, int opsize, int order) {
+  int rs, gs, bs, as_;
+  __m128i rsh, gsh, bsh, ash, a = _mm_set1_epi32(255);
+  int x = 0;
+  get_order_shifts(order, &rs, &gs, &bs, &as_);
+  rsh = _mm_cvtsi32_si128(rs); gsh = _mm_cvtsi32_si128(gs); bsh = _mm_cvtsi32_si128(bs); ash = _mm_cvtsi32_si128(as_);
+  for (; x + 4 <= width; x += 4) {
+    if (as) a = load4_u8_sse41(as + x);
+    store_pixels_sse41(dest + x * opsize, yuv2rgb_4_sse41(load4_u8_sse41(ys + x), load4_u8_sse41(us + x),
+                       load4_u8_sse41(vs + x), a, rsh, gsh, bsh, ash), opsize);
+  }
+  return x;
+}
+
+
+static SSE41_FN int yuvpk_row_to_rgb_sse41(const uint8_t *src, int ipsize, uint8_t *dest, int width, int opsize, int order) {
+  const __m128i bmask = _mm_set1_epi32(0xFF);
+  int rs, gs, bs, as_;
+  __m128i rsh, gsh, bsh, ash, a = _mm_set1_epi32(255), px;
+  int x = 0;
+  get_order_shifts(order, &rs, &gs, &bs, &as_);
+  rsh = _mm_cvtsi32_si128(rs); gsh = _mm_cvtsi32_si128(gs); bsh = _mm_cvtsi32_si128(bs); ash = _mm_cvtsi32_si128(as_);
+  // packed 3 byte input reads 4 bytes past the last pixel, so leave a margin of 2 pixels
+  for (; x + (ipsize == 3 ? 6 : 4) <= width; x += 4) {
+    if (ipsize == 3) px = expand3_sse41(src + x * 3);
+    else {
+      px = _mm_loadu_si128((const __m128i *)(src + x * 4));
+      a = _mm_srli_epi32(px, 24);
+    }
+    store_pixels_sse41(dest + x * opsize, yuv2rgb_4_sse41(_mm_and_si128(px, bmask),
+                       _mm_and_si128(_mm_srli_epi32(px, 8), bmask),
+                       _mm_and_si128(_mm_srli_epi32(px, 16), bmask), a, rsh, gsh, bsh, ash), opsize);
+  }
+  return x;
+}
+
+
+static SSE41_FN int rgb_row_to_yuv_sse41(const uint8_t *src, int ipsize, int order, uint8_t *ys, uint8_t *us, uint8_t *vs,
+    uint8_t *as, uint8_t *dest, int opsize, int width) {
+  // if dest is set, output is packed YUV888 / YUVA8888, otherwise planar to ys, us, vs (and as if non-NULL)
+  const __m128i bmask = _mm_set1_epi32(0xFF);
+  int rs, gs, bs, as_;
+  __m128i rsh, gsh, bsh, ash, px, r, g, b, a = _mm_set1_epi32(255), y, u, v;
+  int x = 0;
+  get_order_shifts(order, &rs, &gs, &bs, &as_);
+  rsh = _mm_cvtsi32_si128(rs); gsh = _mm_cvtsi32_si128(gs); bsh = _mm_cvtsi32_si128(bs); ash = _mm_cvtsi32_si128(as_);
+  for (; x + (ipsize == 3 ? 6 : 4) <= width; x += 4) {
+    if (ipsize == 3) px = expand3_sse41(src + x * 3);
+    else {
+      px = _mm_loadu_si128((const __m128i *)(src + x * 4));
+      a = _mm_and_si128(_mm_srl_epi32(px, ash), bmask);
+    }
+    r = _mm_and_si128(_mm_srl_epi32(px, rsh), bmask);
+    g = _mm_and_si128(_mm_srl_epi32(px, gsh), bmask);
+    b = _mm_and_si128(_mm_srl_epi32(px, bsh), bmask);
+    rgb2yuv_4_sse41(r, g, b, &y, &u, &v);
+    if (dest) {
+      store_pixels_sse41(dest + x * opsize, _mm_or_si128(_mm_or_si128(y, _mm_slli_epi32(u, 8)),
+                         _mm_or_si128(_mm_slli_epi32(v, 16), _mm_slli_epi32(a, 24))), opsize);
+    } else {
+      store4_u8_sse41(ys + x, y);
+      store4_u8_sse41(us + x, u);
+      store4_u8_sse41(vs + x, v);
+      if (as) store4_u8_sse41(as + x, a);
+    }
+  }
+  return x;
+}
+
+// AVX2 - 8 pixels per step
+
+static inline AVX2_FN __m256i load8_u8_avx2(const uint8_t *p) {
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p));
+}
+
+static inline AVX2_FN void store8_u8_avx2(uint8_t *p, __m256i v) {
+  // packing works within each 128 bit lane, so the low 4 bytes of each lane hold the results
+  __m256i pk = _mm256_packus_epi16(_mm256_packus_epi32(v, v), v);
+  int32_t x = _mm_cvtsi128_si32(_mm256_castsi256_si128(pk));
+  lives_memcpy(p, &x, 4);
+  x = _mm_cvtsi128_si32(_mm256_extracti128_si256(pk, 1));
+  lives_memcpy(p + 4, &x, 4);
+}
+
+static inline AVX2_FN __m256i expand3_avx2(const uint8_t *p) {
+  // 8 x 3 byte pixels -> 8 x 32 bit. Reads 28 bytes.
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), mask);
+  __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 12)), mask);
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+static inline AVX2_FN void store_pixels_avx2(uint8_t *p, __m256i px, int opsize) {
+  if (opsize == 4) _mm256_storeu_si256((__m256i *)p, px);
+  else {
+    const __m256i mask = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                          0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    __m128i lo, hi;
+    int32_t x;
+    px = _mm256_shuffle_epi8(px, mask);
+    lo = _mm256_castsi256_si128(px);
+    hi = _mm256_extracti128_si256(px, 1);
+    _mm_storel_epi64((__m128i *)p, lo);
+    x = _mm_extract_epi32(lo, 2);
+    lives_memcpy(p + 8, &x, 4);
+    _mm_storel_epi64((__m128i *)(p + 12), hi);
+    x = _mm_extract_epi32(hi, 2);
+    lives_memcpy(p + 20, &x, 4);
+  }
+}
+
+#define CLAMP_AVX2(x, lo, hi) _mm256_min_epi32(_mm256_max_epi32((x), (lo)), (hi))
+
+static inline AVX2_FN __m256i yuv2rgb_8_avx2(__m256i y, __m256i u, __m256i v, __m256i a,
+    __m128i rsh, __m128i gsh, __m128i bsh, __m128i ash) {
+  const __m256i zero = _mm256_setzero_si256(), max = _mm256_set1_epi32(255);
+  __m256i r, g, b;
+  y = _mm256_mullo_epi32(CLAMP_AVX2(y, _mm256_set1_epi32(yr_co.ymin), _mm256_set1_epi32(yr_co.ymax)),
+                         _mm256_set1_epi32(yr_co.ky));
+  u = CLAMP_AVX2(u, _mm256_set1_epi32(yr_co.uvmin), _mm256_set1_epi32(yr_co.uvmax));
+  v = CLAMP_AVX2(v, _mm256_set1_epi32(yr_co.uvmin), _mm256_set1_epi32(yr_co.uvmax));
+
+  r = _mm256_add_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(v, _mm256_set1_epi32(yr_co.kr_v))),
+                       _mm256_set1_epi32(yr_co.cr));
+  g = _mm256_add_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(u, _mm256_set1_epi32(yr_co.kg_u))),
+                       _mm256_add_epi32(_mm256_mullo_epi32(v, _mm256_set1_epi32(yr_co.kg_v)),
+                                        _mm256_set1_epi32(yr_co.cg)));
+  b = _mm256_add_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(u, _mm256_set1_epi32(yr_co.kb_u))),
+                       _mm256_set1_epi32(yr_co.cb));
+
+  r = CLAMP_AVX2(_mm256_srai_epi32(r, FP_BITS), zero, max);
+  g = CLAMP_AVX2(_mm256_srai_epi32(g, FP_BITS), zero, max);
+  b = CLAMP_AVX2(_mm256_srai_epi32(b, FP_BITS), zero, max);
+
+  return _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(r, rsh), _mm256_sll_epi32(g, gsh)),
+                         _mm256_or_si256(_mm256_sll_epi32(b, bsh), _mm256_sll_epi32(a, ash)));
+}
+
+static inline AVX2_FN void rgb2yuv_8_avx2(__m256i r, __m256i g, __m256i b, __m256i *y, __m256i *u, __m256i *v) {
+#define DOT_AVX2(k0, k1, k2, c) _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(r, _mm256_set1_epi32(k0)), \
+                                                                  _mm256_mullo_epi32(g, _mm256_set1_epi32(k1))), \
+                                                 _mm256_add_epi32(_mm256_mullo_epi32(b, _mm256_set1_epi32(k2)), \
+                                                                  _mm256_set1_epi32(c)))
+  *y = CLAMP_AVX2(_mm256_srai_epi32(DOT_AVX2(ry_co.ky_r, ry_co.ky_g, ry_co.ky_b, ry_co.cy), FP_BITS),
+                  _mm256_set1_epi32(ry_co.ymin), _mm256_set1_epi32(ry_co.ymax));
+  *u = CLAMP_AVX2(_mm256_srai_epi32(DOT_AVX2(ry_co.ku_r, ry_co.ku_g, ry_co.ku_b, ry_co.cu), FP_BITS),
+                  _mm256_set1_epi32(ry_co.uvmin), _mm256_set1_epi32(ry_co.uvmax));
+  *v = CLAMP_AVX2(_mm256_srai_epi32(DOT_AVX2(ry_co.kv_r, ry_co.kv_g, ry_co.kv_b, ry_co.cv), FP_BITS),
+                  _mm256_set1_epi32(ry_co.uvmin), _mm256_set1_epi32(ry_co.uvmax));
+#undef DOT_AVX2
+}
+
+
+static AVX2_FN int yuvp_row_to_rgb_avx2(const uint8_t *ys, const uint8_t *us, const uint8_t *vs, const uint8_t *as,
+                                        uint8_t *dest, int width, int opsize, int order) {
+  int rs, gs, bs, as_;
+  __m128i rsh, gsh, bsh, ash;
+  __m256i a = _mm256_set1_epi32(255);
+  int x = 0;
+  get_order_shifts(order, &rs, &gs, &bs, &as_);
+  rsh = _mm_cvtsi32_si128(rs); gsh = _mm_cvtsi32_si128(gs); bsh = _mm_cvtsi32_si128(bs); ash = _mm_cvtsi32_si128(as_);
+  for (; x + 8 <= width; x += 8) {
+    if (as) a = load8_u8_avx2(as + x);
+    store_pixels_avx2(dest + x * opsize, yuv2rgb_8_avx2(load8_u8_avx2(ys + x), load8_u8_avx2(us + x),
+                      load8_u8_avx2(vs + x), a, rsh, gsh, bsh, ash), opsize);
+  }
+  return x;
+}
+
+
+static AVX2_FN int yuvpk_row_to_rgb_avx2(const uint8_t *src, int ipsize, uint8_t *dest, int width, int opsize, int order) {
+  const __m256i bmask = _mm256_set1_epi32(0xFF);
+  int rs, gs, bs, as_;
+  __m128i rsh, gsh, bsh, ash;
+  __m256i a = _mm256_set1_epi32(255), px;
+  int x = 0;
+  get_order_shifts(order, &rs, &gs, &bs, &as_);
+  rsh = _mm_cvtsi32_si128(rs); gsh = _mm_cvtsi32_si128(gs); bsh = _mm_cvtsi32_si128(bs); ash = _mm_cvtsi32_si128(as_);
+  for (; x + (ipsize == 3 ? 10 : 8) <= width; x += 8) {
+    if (ipsize == 3) px = expand3_avx2(src + x * 3);
+    else {
+      px = _mm256_loadu_si256((const __m256i *)(src + x * 4));
+      a = _mm256_srli_epi32(px, 24);
+    }
+    store_pixels_avx2(dest + x * opsize, yuv2rgb_8_avx2(_mm256_and_si256(px, bmask),
+                      _mm256_and_si256(_mm256_srli_epi32(px, 8), bmask),
+                      _mm256_and_si256(_mm256_srli_epi32(px, 16), bmask), a, rsh, gsh, bsh, ash), opsize);
+  }
+  return x;
+}
+
+
+static AVX2_FN int rgb_row_to_yuv_avx2(const uint8_t *src, int ipsize, int order, uint8_t *ys, uint8_t *us, uint8_t *vs,
+                                       uint8_t *as, uint8_t *dest, int opsize, int width) {
+  const __m256i bmask = _mm256_set1_epi32(0xFF);
+  int rs, gs, bs, as_;
+  __m128i rsh, gsh, bsh, ash;
+  __m256i px, r, g, b, a = _mm256_set1_epi32(255), y, u, v;
+  int x = 0;
+  get_order_shifts(order, &rs, &gs, &bs, &as_);
+  rsh = _mm_cvtsi32_si128(rs); gsh = _mm_cvtsi32_si128(gs); bsh = _mm_cvtsi32_si128(bs); ash = _mm_cvtsi32_si128(as_);
+  for (; x + (ipsize == 3 ? 10 : 8) <= width; x += 8) {
+    if (ipsize == 3) px = expand3_avx2(src + x * 3);
+    else {
+      px = _mm256_loadu_si256((const __m256i *)(src + x * 4));
+      a = _mm256_and_si256(_mm256_srl_epi32(px, ash), bmask);
+    }
+    r = _mm256_and_si256(_mm256_srl_epi32(px, rsh), bmask);
+    g = _mm256_and_si256(_mm256_srl_epi32(px, gsh), bmask);
+    b = _mm256_and_si256(_mm256_srl_epi32(px, bsh), bmask);
+    rgb2yuv_8_avx2(r, g, b, &y, &u, &v);
+    if (dest) {
+      store_pixels_avx2(dest + x * opsize, _mm256_or_si256(_mm256_or_si256(y, _mm256_slli_epi32(u, 8)),
+                        _mm256_or_si256(_mm256_slli_epi32(v, 16), _mm256_slli_epi32(a, 24))), opsize);
+    } else {
+      store8_u8_avx2(ys + x, y);
+      store8_u8_avx2(us + x, u);
+      store8_u8_avx2(vs + x, v);
+      if (as) store8_u8_avx2(as + x, a);
+    }
+  }
+  return x;
+}
+
+#endif // CC_HAVE_SIMD
+
+/// planar YUV row -> packed RGB / BGR / ARGB. as may be NULL, in which case alpha is set to 255
+static int yuvp_row_to_rgb(const uint8_t *ys, const uint8_t *us, const uint8_t *vs, const uint8_t *as,
+                           uint8_t *dest, int width, int opsize, int order) {
+#ifdef CC_HAVE_SIMD
+  switch (cc_simd) {
+  case CC_SIMD_AVX2: return yuvp_row_to_rgb_avx2(ys, us, vs, as, dest, width, opsize, order);
+  case CC_SIMD_SSE41: return yuvp_row_to_rgb_sse41(ys, us, vs, as, dest, width, opsize, order);
+  default: break;
+  }
+#endif
+  return 0;
+}
+
+/// packed YUV888 / YUVA8888 row -> packed RGB / BGR / ARGB. Alpha is copied from YUVA input, otherwise set to 255
+static int yuvpk_row_to_rgb(const uint8_t *src, int ipsize, uint8_t *dest, int width, int opsize, int order) {
+#ifdef CC_HAVE_SIMD
+  switch (cc_simd) {
+  case CC_SIMD_AVX2: return yuvpk_row_to_rgb_avx2(src, ipsize, dest, width, opsize, order);
+  case CC_SIMD_SSE41: return yuvpk_row_to_rgb_sse41(src, ipsize, dest, width, opsize, order);
+  default: break;
+  }
+#endif
+  return 0;
+}
+
+/// packed RGB / BGR / ARGB row -> packed YUV (if dest is non-NULL) or planar YUV (as may be NULL)
+static int rgb_row_to_yuv(const uint8_t *src, int ipsize, int order, uint8_t *ys, uint8_t *us, uint8_t *vs,
+                          uint8_t *as, uint8_t *dest, int opsize, int width) {
+#ifdef CC_HAVE_SIMD
+  switch (cc_simd) {
+  case CC_SIMD_AVX2: return rgb_row_to_yuv_avx2(src, ipsize, order, ys, us, vs, as, dest, opsize, width);
+  case CC_SIMD_SSE41: return rgb_row_to_yuv_sse41(src, ipsize, order, ys, us, vs, as, dest, opsize, width);
+  default: break;
+  }
+#endif
+  return 0;
+}
+
+
+static void init_simd_kernels(void) {
+#ifdef CC_HAVE_SIMD
+  if (capable->simd_caps & CPU_SIMD_AVX2) cc_simd = CC_SIMD_AVX2;
+  else if (capable->simd_caps & CPU_SIMD_SSE4_1) cc_simd = CC_SIMD_SSE41;
+#endif
+}
+
+
 static void set_conversion_arrays(int clamping, int subspace) {
   // set conversion arrays for RGB <-> YUV, also min/max YUV values
   // depending on clamping and subspace
@@ -947,6 +1404,8 @@ static void set_conversion_arrays(int clamping, int subspace) {
     max_Y = max_UV = 255;
     cavg = (uint8_t *)cavgu;
   }
+
+  if (cc_simd != CC_SIMD_NONE) set_simd_coeffs(clamping);
 }
 
 
@@ -1666,6 +2125,7 @@ void init_colour_engine(void) {
   init_unal();
   init_gamma_tx();
   init_conversions(LIVES_INTENTION_PLAY);
+  init_simd_kernels();
 #ifdef WEED_ADVANCED_PALETTES
   init_advanced_palettes();
 #endif
@@ -2276,6 +2736,261 @@ void pixel_data_planar_from_membuf(void **pixel_data, void *data, size_t size, i
 }
 
 
+///////////////////////////////////////////////////////////
+// conversion engine
+
+/// frames are split into horizontal tiles of roughly CC_TILE_BYTES (sized to stay resident in L2), rather than one
+/// band per thread. Tiles are claimed dynamically by a persistent set of pinned worker threads plus the calling thread,
+/// so a slow band no longer holds up the whole frame, and there is no per-call thread submission or allocation.
+#define CC_TILE_BYTES (256 * 1024)
+#define CC_MAX_TILES_PER_THREAD 4
+#define CC_MAX_BATCHES 16 ///< max concurrent conversions; further callers just convert inline
+
+typedef struct {
+  lives_funcptr_t func;
+  lives_cc_params *ccparams;
+  int ntiles;
+  volatile int next; ///< next tile to be claimed
+  volatile int ndone; ///< number of tiles completed
+  volatile int active; ///< set once the batch is ready to be worked on
+  volatile int nusers; ///< workers currently inspecting the batch; must be 0 before the slot is reused
+  volatile int in_use;
+} cc_batch_t;
+
+static cc_batch_t cc_batches[CC_MAX_BATCHES];
+static pthread_t *cc_workers = NULL;
+static volatile int cc_nworkers = 0; ///< workers with idx >= this exit
+static volatile uint64_t cc_gen = 0;
+static pthread_mutex_t cc_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cc_cond = PTHREAD_COND_INITIALIZER; ///< workers wait here for new batches
+static pthread_cond_t cc_done_cond = PTHREAD_COND_INITIALIZER; ///< callers wait here for their batch to finish
+static pthread_mutex_t cc_resize_mutex = PTHREAD_MUTEX_INITIALIZER; ///< serialises starting / resizing the engine
+
+
+static int cc_get_ntiles(int height, int rowbytes) {
+  int nthreads = prefs->nfx_threads;
+  int ntiles = (int)(((size_t)height * (size_t)abs(rowbytes)) / CC_TILE_BYTES);
+  if (ntiles < nthreads) ntiles = nthreads;
+  if (ntiles > nthreads * CC_MAX_TILES_PER_THREAD) ntiles = nthreads * CC_MAX_TILES_PER_THREAD;
+  // tile heights are aligned to 4 rows
+  if (ntiles > (height >> 2)) ntiles = height >> 2;
+  if (ntiles < 1) ntiles = 1;
+  return ntiles;
+}
+
+
+static __thread uint8_t *cc_scratch = NULL;
+static __thread size_t cc_scratch_size = 0;
+
+/// the scratch buffer is also registered under this key, so it is freed when its thread exits
+/// (pool threads are reaped when idle)
+static pthread_key_t cc_scratch_key;
+static pthread_once_t cc_scratch_once = PTHREAD_ONCE_INIT;
+
+static void cc_scratch_free(void *buf) {
+  lives_free(buf);
+}
+
+
+static void cc_scratch_key_init(void) {
+  pthread_key_create(&cc_scratch_key, cc_scratch_free);
+}
+
+
+/// returns a row scratch buffer of at least size bytes, owned by the calling thread
+/// it is kept between calls and only grows, so per tile row buffers need no allocation once warmed up
+/// the buffer is only valid until the next call from the same thread, so it must not be held across nested conversions
+static uint8_t *cc_get_scratch(size_t size) {
+  if (size > cc_scratch_size) {
+    uint8_t *buf = (uint8_t *)lives_realloc(cc_scratch, size);
+    if (!buf) return NULL;
+    pthread_once(&cc_scratch_once, cc_scratch_key_init);
+    pthread_setspecific(cc_scratch_key, buf);
+    cc_scratch = buf;
+    cc_scratch_size = size;
+  }
+  return cc_scratch;
+}
+
+
+static boolean cc_batch_work(cc_batch_t *batch) {
+  // claim and process tiles until there are none left; returns TRUE if we processed anything
+  boolean worked = FALSE;
+  int tile;
+  while ((tile = __atomic_fetch_add(&batch->next, 1, __ATOMIC_ACQ_REL)) < batch->ntiles) {
+    (*batch->func)(&batch->ccparams[tile]);
+    if (__atomic_add_fetch(&batch->ndone, 1, __ATOMIC_ACQ_REL) == batch->ntiles) {
+      // last tile, wake the caller if it is waiting in cc_run_tiles()
+      pthread_mutex_lock(&cc_mutex);
+      pthread_cond_broadcast(&cc_done_cond);
+      pthread_mutex_unlock(&cc_mutex);
+    }
+    worked = TRUE;
+  }
+  return worked;
+}
+
+
+static void *cc_worker(void *arg) {
+  int idx = LIVES_POINTER_TO_INT(arg);
+  if (!rpmalloc_is_thread_initialized()) {
+    rpmalloc_thread_initialize();
+  }
+
+  // cc_engine_resize() holds the lock until cc_nworkers is set, so this waits for the final count
+  pthread_mutex_lock(&cc_mutex);
+  pthread_mutex_unlock(&cc_mutex);
+
+#ifdef __linux__
+  if (__atomic_load_n(&cc_nworkers, __ATOMIC_ACQUIRE) < capable->ncpus) {
+    // pin each worker to its own core, leaving the first core for the caller
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET((idx + 1) % capable->ncpus, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+  }
+#endif
+
+  while (1) {
+    uint64_t gen = __atomic_load_n(&cc_gen, __ATOMIC_ACQUIRE);
+    boolean worked = FALSE;
+
+    // the engine was shrunk or stopped
+    if (idx >= __atomic_load_n(&cc_nworkers, __ATOMIC_ACQUIRE)) break;
+
+    for (int i = 0; i < CC_MAX_BATCHES; i++) {
+      // start from a different slot in each worker, so concurrent conversions are spread between them
+      cc_batch_t *batch = &cc_batches[(i + idx) % CC_MAX_BATCHES];
+      if (!__atomic_load_n(&batch->active, __ATOMIC_ACQUIRE)) continue;
+      __atomic_add_fetch(&batch->nusers, 1, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&batch->active, __ATOMIC_SEQ_CST)) {
+        if (cc_batch_work(batch)) worked = TRUE;
+      }
+      if (!__atomic_sub_fetch(&batch->nusers, 1, __ATOMIC_SEQ_CST)
+          && !__atomic_load_n(&batch->active, __ATOMIC_SEQ_CST)) {
+        // the caller may be waiting in cc_batch_release()
+        pthread_mutex_lock(&cc_mutex);
+        pthread_cond_broadcast(&cc_done_cond);
+        pthread_mutex_unlock(&cc_mutex);
+      }
+    }
+
+    if (worked) continue;
+
+    pthread_mutex_lock(&cc_mutex);
+    while (cc_gen == gen) pthread_cond_wait(&cc_cond, &cc_mutex);
+    pthread_mutex_unlock(&cc_mutex);
+  }
+  return NULL;
+}
+
+
+/// set the number of engine workers, starting or joining threads as needed
+static void cc_engine_resize(int nworkers) {
+  int oldn;
+  pthread_mutex_lock(&cc_resize_mutex);
+  oldn = cc_nworkers;
+  if (nworkers > oldn) {
+    pthread_t *workers = (pthread_t *)lives_realloc(cc_workers, nworkers * sizeof(pthread_t));
+    if (workers) {
+      cc_workers = workers;
+      // new workers wait on the lock until cc_nworkers is set, see cc_worker()
+      pthread_mutex_lock(&cc_mutex);
+      for (int i = oldn; i < nworkers; i++) {
+        pthread_create(&cc_workers[i], NULL, cc_worker, LIVES_INT_TO_POINTER(i));
+      }
+      __atomic_store_n(&cc_nworkers, nworkers, __ATOMIC_RELEASE);
+      pthread_mutex_unlock(&cc_mutex);
+    }
+  } else if (nworkers < oldn) {
+    // surplus workers finish any tiles they claimed, then exit; callers still have their own batches covered
+    pthread_mutex_lock(&cc_mutex);
+    __atomic_store_n(&cc_nworkers, nworkers, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&cc_gen, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&cc_cond);
+    pthread_mutex_unlock(&cc_mutex);
+    for (int i = nworkers; i < oldn; i++) pthread_join(cc_workers[i], NULL);
+    if (!nworkers) {
+      lives_free(cc_workers);
+      cc_workers = NULL;
+    }
+  }
+  pthread_mutex_unlock(&cc_resize_mutex);
+}
+
+
+/// start the engine, or resize it if prefs->nfx_threads has changed since the last call
+static boolean cc_engine_start(void) {
+  int nworkers = prefs->nfx_threads - 1;
+  if (nworkers < 0) nworkers = 0;
+  if (LIVES_UNLIKELY(__atomic_load_n(&cc_nworkers, __ATOMIC_ACQUIRE) != nworkers)) cc_engine_resize(nworkers);
+  return __atomic_load_n(&cc_nworkers, __ATOMIC_ACQUIRE) > 0;
+}
+
+
+/// join all engine workers; the engine is restarted by the next threaded conversion
+void cc_engine_stop(void) {
+  cc_engine_resize(0);
+}
+
+
+static cc_batch_t *cc_batch_acquire(void) {
+  for (int i = 0; i < CC_MAX_BATCHES; i++) {
+    if (!__atomic_exchange_n(&cc_batches[i].in_use, 1, __ATOMIC_ACQ_REL)) return &cc_batches[i];
+  }
+  return NULL;
+}
+
+
+static void cc_batch_release(cc_batch_t *batch) {
+  __atomic_store_n(&batch->active, 0, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&batch->nusers, __ATOMIC_SEQ_CST)) {
+    // the last worker to leave sees active == 0 and signals us
+    pthread_mutex_lock(&cc_mutex);
+    while (__atomic_load_n(&batch->nusers, __ATOMIC_SEQ_CST)) pthread_cond_wait(&cc_done_cond, &cc_mutex);
+    pthread_mutex_unlock(&cc_mutex);
+  }
+  __atomic_store_n(&batch->in_use, 0, __ATOMIC_RELEASE);
+}
+
+
+/**
+   @brief run func over ntiles prefilled ccparams, using the conversion engine
+
+   the calling thread works on its own batch alongside the engine workers, and returns once all tiles are done.
+   If the engine is not available, or all batch slots are in use, the tiles are simply processed inline
+*/
+static void cc_run_tiles(lives_funcptr_t func, lives_cc_params *ccparams, int ntiles) {
+  cc_batch_t *batch = NULL;
+
+  if (ntiles > 1 && cc_engine_start()) batch = cc_batch_acquire();
+  if (!batch) {
+    for (int i = 0; i < ntiles; i++) (*func)(&ccparams[i]);
+    return;
+  }
+
+  batch->func = func;
+  batch->ccparams = ccparams;
+  batch->ntiles = ntiles;
+  batch->next = batch->ndone = 0;
+  __atomic_store_n(&batch->active, 1, __ATOMIC_SEQ_CST);
+
+  pthread_mutex_lock(&cc_mutex);
+  __atomic_add_fetch(&cc_gen, 1, __ATOMIC_RELEASE);
+  pthread_cond_broadcast(&cc_cond);
+  pthread_mutex_unlock(&cc_mutex);
+
+  cc_batch_work(batch);
+  if (__atomic_load_n(&batch->ndone, __ATOMIC_ACQUIRE) < ntiles) {
+    // workers are still finishing their tiles; whoever completes the last one signals us
+    pthread_mutex_lock(&cc_mutex);
+    while (__atomic_load_n(&batch->ndone, __ATOMIC_ACQUIRE) < ntiles) pthread_cond_wait(&cc_done_cond, &cc_mutex);
+    pthread_mutex_unlock(&cc_mutex);
+  }
+  cc_batch_release(batch);
+}
+
+
 ///////////////////////////////////////////////////////////
 // frame conversions
 
@@ -2290,14 +3005,15 @@ static void convert_yuv888_to_rgb_frame(uint8_t *src, int hsize, int vsize, int
     set_conversion_arrays(clamping, subspace);
 
     if (prefs->nfx_threads > 1) {
-      lives_thread_t threads[prefs->nfx_threads];
+      int ntiles = cc_get_ntiles(vsize, irowstride);
       uint8_t *end = src + vsize * irowstride;
-      int nthreads = 1;
+      int nthreads = 0;
       int dheight, xdheight;
-      lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+      lives_cc_params ccparams[ntiles];
 
-      xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-      for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+      lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+      xdheight = CEIL((double)vsize / (double)ntiles, 4);
+      for (i = ntiles - 1; i >= 0; i--) {
         dheight = xdheight;
 
         if ((src + dheight * i * irowstride) < end) {
@@ -2318,18 +3034,11 @@ static void convert_yuv888_to_rgb_frame(uint8_t *src, int hsize, int vsize, int
           ccparams[i].in_subspace = subspace;
           ccparams[i].thread_id = i;
 
-          if (i == 0) convert_yuv888_to_rgb_frame_thread(&ccparams[i]);
-          else {
-            lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv888_to_rgb_frame_thread, &ccparams[i]);
-            nthreads++;
-          }
+          if (!nthreads) nthreads = i + 1;
         }
       }
 
-      for (i = 1; i < nthreads; i++) {
-        lives_thread_join(threads[i], NULL);
-      }
-      lives_free(ccparams);
+      cc_run_tiles(convert_yuv888_to_rgb_frame_thread, ccparams, nthreads);
       return;
     }
   }
@@ -2339,7 +3048,10 @@ static void convert_yuv888_to_rgb_frame(uint8_t *src, int hsize, int vsize, int
   irowstride -= hsize * 3;
 
   for (y = 0; y < vsize; y++) {
-    for (x = 0; x < hsize; x++) {
+    x = yuvpk_row_to_rgb(src, 3, dest, hsize, offs, CC_ORDER_RGB);
+    src += x * 3;
+    dest += x * offs;
+    for (; x < hsize; x++) {
       yuv888_2_rgb(src, dest, add_alpha);
       src += 3;
       dest += offs;
@@ -2371,14 +3083,15 @@ static void convert_yuva8888_to_rgba_frame(uint8_t *src, int hsize, int vsize, i
     set_conversion_arrays(clamping, subspace);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
+    int ntiles = cc_get_ntiles(vsize, irowstride);
     uint8_t *end = src + vsize * irowstride;
-    int nthreads = 1;
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -2399,18 +3112,11 @@ static void convert_yuva8888_to_rgba_frame(uint8_t *src, int hsize, int vsize, i
         ccparams[i].in_subspace = subspace;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuva8888_to_rgba_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuva8888_to_rgba_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuva8888_to_rgba_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -2419,7 +3125,10 @@ static void convert_yuva8888_to_rgba_frame(uint8_t *src, int hsize, int vsize, i
   irowstride -= hsize * 4;
 
   for (y = 0; y < vsize; y++) {
-    for (x = 0; x < hsize; x++) {
+    x = yuvpk_row_to_rgb(src, 4, dest, hsize, offs, CC_ORDER_RGB);
+    src += x * 4;
+    dest += x * offs;
+    for (; x < hsize; x++) {
       yuva8888_2_rgba(src, dest, del_alpha);
       src += 4;
       dest += offs;
@@ -2449,14 +3158,15 @@ static void convert_yuv888_to_bgr_frame(uint8_t *src, int hsize, int vsize, int
     set_conversion_arrays(clamping, subspace);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
+    int ntiles = cc_get_ntiles(vsize, irowstride);
     uint8_t *end = src + vsize * irowstride;
-    int nthreads = 1;
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -2477,18 +3187,11 @@ static void convert_yuv888_to_bgr_frame(uint8_t *src, int hsize, int vsize, int
         ccparams[i].in_subspace = subspace;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuv888_to_bgr_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv888_to_bgr_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuv888_to_bgr_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -2497,7 +3200,10 @@ static void convert_yuv888_to_bgr_frame(uint8_t *src, int hsize, int vsize, int
   irowstride -= hsize * 3;
 
   for (y = 0; y < vsize; y++) {
-    for (x = 0; x < hsize; x++) {
+    x = yuvpk_row_to_rgb(src, 3, dest, hsize, offs, CC_ORDER_BGR);
+    src += x * 3;
+    dest += x * offs;
+    for (; x < hsize; x++) {
       yuv888_2_bgr(src, dest, add_alpha);
       src += 3;
       dest += offs;
@@ -2528,14 +3234,15 @@ static void convert_yuva8888_to_bgra_frame(uint8_t *src, int hsize, int vsize, i
     set_conversion_arrays(clamping, subspace);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
+    int ntiles = cc_get_ntiles(vsize, irowstride);
     uint8_t *end = src + vsize * irowstride;
-    int nthreads = 1;
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -2556,18 +3263,11 @@ static void convert_yuva8888_to_bgra_frame(uint8_t *src, int hsize, int vsize, i
         ccparams[i].in_subspace = subspace;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuva8888_to_bgra_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuva8888_to_bgra_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuva8888_to_bgra_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -2576,7 +3276,10 @@ static void convert_yuva8888_to_bgra_frame(uint8_t *src, int hsize, int vsize, i
   irowstride -= 4 * hsize;
 
   for (y = 0; y < vsize; y++) {
-    for (x = 0; x < hsize; x++) {
+    x = yuvpk_row_to_rgb(src, 4, dest, hsize, offs, CC_ORDER_BGR);
+    src += x * 4;
+    dest += x * offs;
+    for (; x < hsize; x++) {
       yuva8888_2_bgra(src, dest, del_alpha);
       src += 4;
       dest += offs;
@@ -2606,14 +3309,15 @@ static void convert_yuv888_to_argb_frame(uint8_t *src, int hsize, int vsize, int
     set_conversion_arrays(clamping, subspace);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
+    int ntiles = cc_get_ntiles(vsize, irowstride);
     uint8_t *end = src + vsize * irowstride;
-    int nthreads = 1;
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -2633,18 +3337,11 @@ static void convert_yuv888_to_argb_frame(uint8_t *src, int hsize, int vsize, int
         ccparams[i].in_subspace = subspace;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuv888_to_argb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv888_to_argb_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuv888_to_argb_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -2652,7 +3349,10 @@ static void convert_yuv888_to_argb_frame(uint8_t *src, int hsize, int vsize, int
   irowstride -= hsize * 3;
 
   for (y = 0; y < vsize; y++) {
-    for (x = 0; x < hsize; x++) {
+    x = yuvpk_row_to_rgb(src, 3, dest, hsize, 4, CC_ORDER_ARGB);
+    src += x * 3;
+    dest += x * 4;
+    for (; x < hsize; x++) {
       yuv888_2_argb(src, dest);
       src += 3;
       dest += 4;
@@ -2683,14 +3383,15 @@ static void convert_yuva8888_to_argb_frame(uint8_t *src, int hsize, int vsize, i
     set_conversion_arrays(clamping, subspace);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
+    int ntiles = cc_get_ntiles(vsize, irowstride);
     uint8_t *end = src + vsize * irowstride;
-    int nthreads = 1;
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -2710,18 +3411,11 @@ static void convert_yuva8888_to_argb_frame(uint8_t *src, int hsize, int vsize, i
         ccparams[i].in_subspace = subspace;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuva8888_to_argb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuva8888_to_rgba_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuva8888_to_argb_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -2729,7 +3423,10 @@ static void convert_yuva8888_to_argb_frame(uint8_t *src, int hsize, int vsize, i
   irowstride -= hsize * 4;
 
   for (y = 0; y < vsize; y++) {
-    for (x = 0; x < hsize; x++) {
+    x = yuvpk_row_to_rgb(src, 4, dest, hsize, 4, CC_ORDER_ARGB);
+    src += x * 4;
+    dest += x * 4;
+    for (; x < hsize; x++) {
       yuva8888_2_argb(src, dest);
       src += 4;
       dest += 4;
@@ -2752,7 +3449,8 @@ static void *convert_yuva8888_to_argb_frame_thread(void *data) {
 static void convert_yuv420p_to_rgb_frame(uint8_t **src, int width, int height, boolean is_bottom, int *istrides, int orowstride,
     uint8_t *dest, boolean add_alpha, boolean is_422, int sampling, int clamping, int subspace,
     int gamma, int tgamma, uint8_t *gamma_lut, int thread_id) {
-  int i, j;
+  int i, j, k;
+  uint8_t *ubuf = NULL, *vbuf = NULL;
   uint8_t *s_y = src[0], *s_u = src[1], *s_v = src[2];
   int opsize = 3;
   int irow = istrides[0] - width;
@@ -2768,14 +3466,15 @@ static void convert_yuv420p_to_rgb_frame(uint8_t **src, int width, int height, b
 
     if (tgamma) gamma_lut = create_gamma_lut(1.0, gamma, tgamma);
     if (prefs->nfx_threads > 1) {
-      lives_thread_t threads[prefs->nfx_threads];
+      int ntiles = cc_get_ntiles(height, istrides[0]);
       uint8_t *end = src[0] + height * istrides[0];
-      int nthreads = 1;
+      int nthreads = 0;
       int dheight, xdheight;
-      lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+      lives_cc_params ccparams[ntiles];
 
-      xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-      for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+      lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+      xdheight = CEIL((double)height / (double)ntiles, 4);
+      for (i = ntiles - 1; i >= 0; i--) {
         dheight = xdheight;
 
         if ((src[0] + dheight * i * istrides[0]) < end) {
@@ -2790,7 +3489,7 @@ static void convert_yuv420p_to_rgb_frame(uint8_t **src, int width, int height, b
           }
 
           ccparams[i].vsize = dheight;
-          if (i == prefs->nfx_threads - 1) {
+          if (!nthreads) {
             ccparams[i].is_bottom = TRUE;
           }
           ccparams[i].irowstrides[0] = istrides[0];
@@ -2805,24 +3504,23 @@ static void convert_yuv420p_to_rgb_frame(uint8_t **src, int width, int height, b
           ccparams[i].lut = gamma_lut;
           ccparams[i].thread_id = i;
 
-          if (i == 0) convert_yuv420p_to_rgb_frame_thread(&ccparams[i]);
-          else {
-            lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv420p_to_rgb_frame_thread, &ccparams[i]);
-            nthreads++;
-          }
+          if (!nthreads) nthreads = i + 1;
         }
       }
 
-      for (i = 1; i < nthreads; i++) {
-        lives_thread_join(threads[i], NULL);
-      }
-      lives_free(ccparams);
+      cc_run_tiles(convert_yuv420p_to_rgb_frame_thread, ccparams, nthreads);
       if (gamma_lut) lives_gamma_lut_free(gamma_lut);
       return;
     }
   }
 
   if (add_alpha) opsize = 4;
+  if (cc_simd != CC_SIMD_NONE && !gamma_lut) {
+    // upsampled chroma is collected for each row, then the row is converted in one pass
+    ubuf = cc_get_scratch(width * 2);
+    if (ubuf) vbuf = ubuf + width;
+  }
+
   width *= opsize;
 
   for (i = 0; i < height; i++) {
@@ -2860,7 +3558,10 @@ static void convert_yuv420p_to_rgb_frame(uint8_t **src, int width, int height, b
       }
       if (gamma_lut)
         yuv2rgb_with_gamma(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2], gamma_lut);
-      else
+      else if (ubuf) {
+        ubuf[uv_offs * 2] = u;
+        vbuf[uv_offs * 2] = v;
+      } else
         yuv2rgb(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2]);
       if (add_alpha) dest[j + 3] = 255;
 
@@ -2895,11 +3596,20 @@ static void convert_yuv420p_to_rgb_frame(uint8_t **src, int width, int height, b
       }
       if (gamma_lut)
         yuv2rgb_with_gamma(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2], gamma_lut);
-      else
+      else if (ubuf) {
+        ubuf[uv_offs * 2 + 1] = u;
+        vbuf[uv_offs * 2 + 1] = v;
+      } else
         yuv2rgb(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2]);
       if (add_alpha) dest[j + 3] = 255;
       uv_offs++;
     }
+    if (ubuf) {
+      int npix = width / opsize;
+      uint8_t *r_y = s_y - npix;
+      k = yuvp_row_to_rgb(r_y, ubuf, vbuf, NULL, dest, npix, opsize, CC_ORDER_RGB);
+      for (; k < npix; k++) yuv2rgb(r_y[k], ubuf[k], vbuf[k], &dest[k * opsize], &dest[k * opsize + 1], &dest[k * opsize + 2]);
+    }
     s_y += irow;
     dest += orowstride;
     if (is_422 || !even) {
@@ -2924,7 +3634,8 @@ static void *convert_yuv420p_to_rgb_frame_thread(void *data) {
 static void convert_yuv420p_to_bgr_frame(uint8_t **src, int width, int height, boolean is_bottom, int *istrides, int orowstride,
     uint8_t *dest, boolean add_alpha, boolean is_422, int sampling, int clamping, int subspace,
     int gamma, int tgamma, uint8_t *gamma_lut, int thread_id) {
-  int i, j;
+  int i, j, k;
+  uint8_t *ubuf = NULL, *vbuf = NULL;
   uint8_t *s_y = src[0], *s_u = src[1], *s_v = src[2];
   int opsize = 3;
   int irow = istrides[0] - width;
@@ -2940,14 +3651,15 @@ static void convert_yuv420p_to_bgr_frame(uint8_t **src, int width, int height, b
 
     if (tgamma) gamma_lut = create_gamma_lut(1.0, gamma, tgamma);
     if (prefs->nfx_threads > 1) {
-      lives_thread_t threads[prefs->nfx_threads];
+      int ntiles = cc_get_ntiles(height, istrides[0]);
       uint8_t *end = src[0] + height * istrides[0];
-      int nthreads = 1;
+      int nthreads = 0;
       int dheight, xdheight;
-      lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+      lives_cc_params ccparams[ntiles];
 
-      xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-      for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+      lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+      xdheight = CEIL((double)height / (double)ntiles, 4);
+      for (i = ntiles - 1; i >= 0; i--) {
         dheight = xdheight;
 
         if ((src[0] + dheight * i * istrides[0]) < end) {
@@ -2962,7 +3674,7 @@ static void convert_yuv420p_to_bgr_frame(uint8_t **src, int width, int height, b
           }
 
           ccparams[i].vsize = dheight;
-          if (i == prefs->nfx_threads - 1) ccparams->is_bottom = TRUE;
+          if (!nthreads) ccparams[i].is_bottom = TRUE;
 
           ccparams[i].irowstrides[0] = istrides[0];
           ccparams[i].irowstrides[1] = istrides[1];
@@ -2976,24 +3688,23 @@ static void convert_yuv420p_to_bgr_frame(uint8_t **src, int width, int height, b
           ccparams[i].lut = gamma_lut;
           ccparams[i].thread_id = i;
 
-          if (i == 0) convert_yuv420p_to_bgr_frame_thread(&ccparams[i]);
-          else {
-            lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv420p_to_bgr_frame_thread, &ccparams[i]);
-            nthreads++;
-          }
+          if (!nthreads) nthreads = i + 1;
         }
       }
 
-      for (i = 1; i < nthreads; i++) {
-        lives_thread_join(threads[i], NULL);
-      }
-      lives_free(ccparams);
+      cc_run_tiles(convert_yuv420p_to_bgr_frame_thread, ccparams, nthreads);
       if (gamma_lut) lives_gamma_lut_free(gamma_lut);
       return;
     }
   }
 
   if (add_alpha) opsize = 4;
+  if (cc_simd != CC_SIMD_NONE && !gamma_lut) {
+    // upsampled chroma is collected for each row, then the row is converted in one pass
+    ubuf = cc_get_scratch(width * 2);
+    if (ubuf) vbuf = ubuf + width;
+  }
+
   width *= opsize;
 
   for (i = 0; i < height; i++) {
@@ -3031,7 +3742,10 @@ static void convert_yuv420p_to_bgr_frame(uint8_t **src, int width, int height, b
       }
       if (gamma_lut)
         yuv2bgr_with_gamma(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2], gamma_lut);
-      else
+      else if (ubuf) {
+        ubuf[uv_offs * 2] = u;
+        vbuf[uv_offs * 2] = v;
+      } else
         yuv2bgr(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2]);
       if (add_alpha) dest[j + 3] = 255;
 
@@ -3064,11 +3778,20 @@ static void convert_yuv420p_to_bgr_frame(uint8_t **src, int width, int height, b
       }
       if (gamma_lut)
         yuv2bgr_with_gamma(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2], gamma_lut);
-      else
+      else if (ubuf) {
+        ubuf[uv_offs * 2 + 1] = u;
+        vbuf[uv_offs * 2 + 1] = v;
+      } else
         yuv2bgr(y, u, v, &dest[j], &dest[j + 1], &dest[j + 2]);
       if (add_alpha) dest[j + 3] = 255;
       uv_offs++;
     }
+    if (ubuf) {
+      int npix = width / opsize;
+      uint8_t *r_y = s_y - npix;
+      k = yuvp_row_to_rgb(r_y, ubuf, vbuf, NULL, dest, npix, opsize, CC_ORDER_BGR);
+      for (; k < npix; k++) yuv2bgr(r_y[k], ubuf[k], vbuf[k], &dest[k * opsize], &dest[k * opsize + 1], &dest[k * opsize + 2]);
+    }
     s_y += irow;
     dest += orowstride;
     if (is_422 || !even) {
@@ -3094,7 +3817,8 @@ static void convert_yuv420p_to_argb_frame(uint8_t **src, int width, int height,
     int orowstride,
     uint8_t *dest, boolean is_422, int sampling, int clamping, int subspace,
     int gamma, int tgamma, uint8_t *gamma_lut, int thread_id) {
-  int i, j;
+  int i, j, k;
+  uint8_t *ubuf = NULL, *vbuf = NULL;
   uint8_t *s_y = src[0], *s_u = src[1], *s_v = src[2];
   int opsize = 4;
   int irow = istrides[0] - width;
@@ -3110,14 +3834,15 @@ static void convert_yuv420p_to_argb_frame(uint8_t **src, int width, int height,
 
     if (tgamma) gamma_lut = create_gamma_lut(1.0, gamma, tgamma);
     if (prefs->nfx_threads > 1) {
-      lives_thread_t threads[prefs->nfx_threads];
+      int ntiles = cc_get_ntiles(height, istrides[0]);
       uint8_t *end = src[0] + height * istrides[0];
-      int nthreads = 1;
+      int nthreads = 0;
       int dheight, xdheight;
-      lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+      lives_cc_params ccparams[ntiles];
 
-      xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-      for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+      lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+      xdheight = CEIL((double)height / (double)ntiles, 4);
+      for (i = ntiles - 1; i >= 0; i--) {
         dheight = xdheight;
 
         if ((src[0] + dheight * i * istrides[0]) < end) {
@@ -3132,7 +3857,7 @@ static void convert_yuv420p_to_argb_frame(uint8_t **src, int width, int height,
           }
 
           ccparams[i].vsize = dheight;
-          if (i == prefs->nfx_threads - 1) ccparams->is_bottom = TRUE;
+          if (!nthreads) ccparams[i].is_bottom = TRUE;
 
           ccparams[i].irowstrides[0] = istrides[0];
           ccparams[i].irowstrides[1] = istrides[1];
@@ -3145,23 +3870,22 @@ static void convert_yuv420p_to_argb_frame(uint8_t **src, int width, int height,
           ccparams[i].lut = gamma_lut;
           ccparams[i].thread_id = i;
 
-          if (i == 0) convert_yuv420p_to_argb_frame_thread(&ccparams[i]);
-          else {
-            lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv420p_to_argb_frame_thread, &ccparams[i]);
-            nthreads++;
-          }
+          if (!nthreads) nthreads = i + 1;
         }
       }
 
-      for (i = 1; i < nthreads; i++) {
-        lives_thread_join(threads[i], NULL);
-      }
-      lives_free(ccparams);
+      cc_run_tiles(convert_yuv420p_to_argb_frame_thread, ccparams, nthreads);
       if (gamma_lut) lives_gamma_lut_free(gamma_lut);
       return;
     }
   }
 
+  if (cc_simd != CC_SIMD_NONE && !gamma_lut) {
+    // upsampled chroma is collected for each row, then the row is converted in one pass
+    ubuf = cc_get_scratch(width * 2);
+    if (ubuf) vbuf = ubuf + width;
+  }
+
   width *= opsize;
 
   for (i = 0; i < height; i++) {
@@ -3200,7 +3924,10 @@ static void convert_yuv420p_to_argb_frame(uint8_t **src, int width, int height,
       }
       if (gamma_lut)
         yuv2rgb_with_gamma(y, u, v, &dest[j + 1], &dest[j + 2], &dest[j + 3], gamma_lut);
-      else
+      else if (ubuf) {
+        ubuf[uv_offs * 2] = u;
+        vbuf[uv_offs * 2] = v;
+      } else
         yuv2rgb(y, u, v, &dest[j + 1], &dest[j + 2], &dest[j + 3]);
 
       // second RGB pixel
@@ -3233,10 +3960,19 @@ static void convert_yuv420p_to_argb_frame(uint8_t **src, int width, int height,
       }
       if (gamma_lut)
         yuv2rgb_with_gamma(y, u, v, &dest[j + 1], &dest[j + 2], &dest[j + 3], gamma_lut);
-      else
+      else if (ubuf) {
+        ubuf[uv_offs * 2 + 1] = u;
+        vbuf[uv_offs * 2 + 1] = v;
+      } else
         yuv2rgb(y, u, v, &dest[j + 1], &dest[j + 2], &dest[j + 3]);
       uv_offs++;
     }
+    if (ubuf) {
+      int npix = width / opsize;
+      uint8_t *r_y = s_y - npix;
+      k = yuvp_row_to_rgb(r_y, ubuf, vbuf, NULL, dest, npix, opsize, CC_ORDER_ARGB);
+      for (; k < npix; k++) yuv2rgb(r_y[k], ubuf[k], vbuf[k], &dest[k * opsize + 1], &dest[k * opsize + 2], &dest[k * opsize + 3]);
+    }
     s_y += irow;
     dest += orowstride;
     if (is_422 || !even) {
@@ -3276,13 +4012,14 @@ static void convert_rgb_to_uyvy_frame(uint8_t *rgbdata, int hsize, int vsize, in
   end = rgbdata + rowstride * vsize;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3303,18 +4040,11 @@ static void convert_rgb_to_uyvy_frame(uint8_t *rgbdata, int hsize, int vsize, in
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_rgb_to_uyvy_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_rgb_to_uyvy_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_rgb_to_uyvy_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -3369,13 +4099,14 @@ static void convert_rgb_to_yuyv_frame(uint8_t *rgbdata, int hsize, int vsize, in
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3396,18 +4127,11 @@ static void convert_rgb_to_yuyv_frame(uint8_t *rgbdata, int hsize, int vsize, in
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_rgb_to_yuyv_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_rgb_to_yuyv_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_rgb_to_yuyv_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -3461,13 +4185,14 @@ static void convert_bgr_to_uyvy_frame(uint8_t *rgbdata, int hsize, int vsize, in
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3488,18 +4213,11 @@ static void convert_bgr_to_uyvy_frame(uint8_t *rgbdata, int hsize, int vsize, in
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_bgr_to_uyvy_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_bgr_to_uyvy_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_bgr_to_uyvy_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -3555,13 +4273,14 @@ static void convert_bgr_to_yuyv_frame(uint8_t *rgbdata, int hsize, int vsize, in
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3582,18 +4301,11 @@ static void convert_bgr_to_yuyv_frame(uint8_t *rgbdata, int hsize, int vsize, in
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_bgr_to_yuyv_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_bgr_to_yuyv_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_bgr_to_yuyv_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -3647,13 +4359,14 @@ static void convert_argb_to_uyvy_frame(uint8_t *rgbdata, int hsize, int vsize, i
   hsize = (hsize >> 1) << 1;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3673,18 +4386,11 @@ static void convert_argb_to_uyvy_frame(uint8_t *rgbdata, int hsize, int vsize, i
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_argb_to_uyvy_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_argb_to_uyvy_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_argb_to_uyvy_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -3731,13 +4437,14 @@ static void convert_argb_to_yuyv_frame(uint8_t *rgbdata, int hsize, int vsize, i
   hsize = (hsize >> 1) << 1;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3757,18 +4464,11 @@ static void convert_argb_to_yuyv_frame(uint8_t *rgbdata, int hsize, int vsize, i
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_argb_to_yuyv_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_argb_to_yuyv_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_argb_to_yuyv_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -3812,13 +4512,14 @@ static void convert_rgb_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, int
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3839,18 +4540,11 @@ static void convert_rgb_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, int
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_rgb_to_yuv_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_rgb_to_yuv_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_rgb_to_yuv_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -3862,7 +4556,9 @@ static void convert_rgb_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, int
   orow -= hsize * opsize;
 
   for (; rgbdata < end; rgbdata += rowstride) {
-    for (i = 0; i < iwidth; i += ipsize) {
+    i = rgb_row_to_yuv(rgbdata, ipsize, CC_ORDER_RGB, NULL, NULL, NULL, NULL, u, opsize, hsize);
+    u += i * opsize;
+    for (i *= ipsize; i < iwidth; i += ipsize) {
       if (in_has_alpha) in_alpha = rgbdata[i + 3];
       if (out_has_alpha) u[3] = in_alpha;
       rgb2yuv(rgbdata[i], rgbdata[i + 1], rgbdata[i + 2], &(u[0]), &(u[1]), &(u[2]));
@@ -3903,13 +4599,14 @@ static void convert_rgb_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, in
   if (out_has_alpha) a = yuvp[3];
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -3934,18 +4631,11 @@ static void convert_rgb_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, in
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_rgb_to_yuvp_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_rgb_to_yuvp_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_rgb_to_yuvp_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -3956,7 +4646,12 @@ static void convert_rgb_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, in
   orow -= hsize;
 
   for (; rgbdata < end; rgbdata += rowstride) {
-    for (i = 0; i < iwidth; i += ipsize) {
+    i = rgb_row_to_yuv(rgbdata, ipsize, CC_ORDER_RGB, y, u, v, a, NULL, 0, hsize);
+    y += i;
+    u += i;
+    v += i;
+    if (a) a += i;
+    for (i *= ipsize; i < iwidth; i += ipsize) {
       if (in_has_alpha) in_alpha = rgbdata[i + 3];
       if (out_has_alpha) *(a++) = in_alpha;
       rgb2yuv(rgbdata[i], rgbdata[i + 1], rgbdata[i + 2], y, u, v);
@@ -3995,13 +4690,14 @@ static void convert_bgr_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, int
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -4021,18 +4717,11 @@ static void convert_bgr_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, int
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_bgr_to_yuv_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_bgr_to_yuv_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_bgr_to_yuv_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -4044,7 +4733,9 @@ static void convert_bgr_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, int
   orow -= hsize * opsize;
 
   for (; rgbdata < end; rgbdata += rowstride) {
-    for (i = 0; i < iwidth; i += ipsize) {
+    i = rgb_row_to_yuv(rgbdata, ipsize, CC_ORDER_BGR, NULL, NULL, NULL, NULL, u, opsize, hsize);
+    u += i * opsize;
+    for (i *= ipsize; i < iwidth; i += ipsize) {
       bgr2yuv(rgbdata[i], rgbdata[i + 1], rgbdata[i + 2], &(u[0]), &(u[1]), &(u[2]));
       if (in_has_alpha) in_alpha = rgbdata[i + 3];
       if (out_has_alpha) u[3] = in_alpha;
@@ -4086,13 +4777,14 @@ static void convert_bgr_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, in
   if (out_has_alpha) a = yuvp[3];
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -4117,18 +4809,11 @@ static void convert_bgr_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, in
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_bgr_to_yuvp_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_bgr_to_yuvp_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_bgr_to_yuvp_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -4139,7 +4824,12 @@ static void convert_bgr_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, in
   orow -= hsize;
 
   for (; rgbdata < end; rgbdata += rowstride) {
-    for (i = 0; i < iwidth; i += ipsize) {
+    i = rgb_row_to_yuv(rgbdata, ipsize, CC_ORDER_BGR, y, u, v, a, NULL, 0, hsize);
+    y += i;
+    u += i;
+    v += i;
+    if (a) a += i;
+    for (i *= ipsize; i < iwidth; i += ipsize) {
       bgr2yuv(rgbdata[i], rgbdata[i + 1], rgbdata[i + 2], &(y[0]), &(u[0]), &(v[0]));
       if (in_has_alpha) in_alpha = rgbdata[i + 3];
       if (out_has_alpha) *(a++) = in_alpha;
@@ -4177,13 +4867,14 @@ static void convert_argb_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, in
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -4204,18 +4895,11 @@ static void convert_argb_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, in
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_rgb_to_yuv_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_argb_to_yuv_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_argb_to_yuv_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -4226,7 +4910,9 @@ static void convert_argb_to_yuv_frame(uint8_t *rgbdata, int hsize, int vsize, in
   orow -= hsize * opsize;
 
   for (; rgbdata < end; rgbdata += rowstride) {
-    for (i = 0; i < iwidth; i += ipsize) {
+    i = rgb_row_to_yuv(rgbdata, ipsize, CC_ORDER_ARGB, NULL, NULL, NULL, NULL, u, opsize, hsize);
+    u += i * opsize;
+    for (i *= ipsize; i < iwidth; i += ipsize) {
       if (out_has_alpha) u[3] = rgbdata[i];
       rgb2yuv(rgbdata[i + 1], rgbdata[i + 2], rgbdata[i + 3], &(u[0]), &(u[1]), &(u[2]));
       u += opsize;
@@ -4264,13 +4950,14 @@ static void convert_argb_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, i
   if (out_has_alpha) a = yuvp[3];
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(vsize, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)vsize / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)vsize / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((rgbdata + dheight * i * rowstride) < end) {
@@ -4294,18 +4981,11 @@ static void convert_argb_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, i
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_argb_to_yuvp_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_argb_to_yuvp_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_argb_to_yuvp_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -4314,7 +4994,12 @@ static void convert_argb_to_yuvp_frame(uint8_t *rgbdata, int hsize, int vsize, i
   orow -= hsize;
 
   for (; rgbdata < end; rgbdata += rowstride) {
-    for (i = 0; i < iwidth; i += ipsize) {
+    i = rgb_row_to_yuv(rgbdata, ipsize, CC_ORDER_ARGB, y, u, v, a, NULL, 0, hsize);
+    y += i;
+    u += i;
+    v += i;
+    if (a) a += i;
+    for (i *= ipsize; i < iwidth; i += ipsize) {
       if (out_has_alpha) *(a++) = rgbdata[i];
       rgb2yuv(rgbdata[i + 1], rgbdata[i + 2], rgbdata[i + 3], y, u, v);
       y++;
@@ -4714,13 +5399,14 @@ static void convert_uyvy_to_rgb_frame(uyvy_macropixel *src, int width, int heigh
     set_conversion_arrays(clamping, subspace);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, orowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((dheight * i) < height) {
@@ -4741,18 +5427,11 @@ static void convert_uyvy_to_rgb_frame(uyvy_macropixel *src, int width, int heigh
         ccparams[i].in_subspace = subspace;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_uyvy_to_rgb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_uyvy_to_rgb_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_uyvy_to_rgb_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -4800,13 +5479,14 @@ static void convert_uyvy_to_bgr_frame(uyvy_macropixel *src, int width, int heigh
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, orowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((dheight * i) < height) {
@@ -4826,18 +5506,11 @@ static void convert_uyvy_to_bgr_frame(uyvy_macropixel *src, int width, int heigh
         ccparams[i].in_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_uyvy_to_bgr_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_uyvy_to_bgr_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_uyvy_to_bgr_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -4882,13 +5555,14 @@ static void convert_uyvy_to_argb_frame(uyvy_macropixel *src, int width, int heig
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, orowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((dheight * i) < height) {
@@ -4907,18 +5581,11 @@ static void convert_uyvy_to_argb_frame(uyvy_macropixel *src, int width, int heig
         ccparams[i].in_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_uyvy_to_argb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_uyvy_to_argb_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_uyvy_to_argb_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -4957,13 +5624,14 @@ static void convert_yuyv_to_rgb_frame(yuyv_macropixel *src, int width, int heigh
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, orowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((dheight * i) < height) {
@@ -4982,18 +5650,11 @@ static void convert_yuyv_to_rgb_frame(yuyv_macropixel *src, int width, int heigh
         ccparams[i].in_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuyv_to_rgb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuyv_to_rgb_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuyv_to_rgb_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -5039,13 +5700,14 @@ static void convert_yuyv_to_bgr_frame(yuyv_macropixel *src, int width, int heigh
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, orowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((dheight * i) < height) {
@@ -5065,18 +5727,11 @@ static void convert_yuyv_to_bgr_frame(yuyv_macropixel *src, int width, int heigh
         ccparams[i].in_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuyv_to_bgr_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuyv_to_bgr_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuyv_to_bgr_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -5121,13 +5776,14 @@ static void convert_yuyv_to_argb_frame(yuyv_macropixel *src, int width, int heig
     set_conversion_arrays(clamping, WEED_YUV_SUBSPACE_YCBCR);
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, orowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((dheight * i) < height) {
@@ -5146,18 +5802,11 @@ static void convert_yuyv_to_argb_frame(yuyv_macropixel *src, int width, int heig
         ccparams[i].in_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuyv_to_argb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuyv_to_argb_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuyv_to_argb_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -5299,13 +5948,14 @@ static void convert_yuv_planar_to_rgb_frame(uint8_t **src, int width, int height
   if (in_alpha) a = src[3];
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((y + dheight * i * irowstride) < end) {
@@ -5331,18 +5981,11 @@ static void convert_yuv_planar_to_rgb_frame(uint8_t **src, int width, int height
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuv_planar_to_rgb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv_planar_to_rgb_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuv_planar_to_rgb_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -5352,7 +5995,13 @@ static void convert_yuv_planar_to_rgb_frame(uint8_t **src, int width, int height
   irowstride -= width;
 
   for (i = 0; i < height; i++) {
-    for (j = 0; j < width; j++) {
+    j = yuvp_row_to_rgb(y, u, v, out_alpha ? a : NULL, dest, width, opstep, CC_ORDER_RGB);
+    y += j;
+    u += j;
+    v += j;
+    if (out_alpha && a) a += j;
+    dest += j * opstep;
+    for (; j < width; j++) {
       yuv2rgb(*(y++), *(u++), *(v++), &dest[0], &dest[1], &dest[2]);
       if (out_alpha) {
         if (in_alpha) {
@@ -5399,14 +6048,15 @@ static void convert_yuv_planar_to_bgr_frame(uint8_t **src, int width, int height
   if (in_alpha) a = src[3];
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
 
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((y + dheight * i * irowstride) < end) {
@@ -5432,26 +6082,27 @@ static void convert_yuv_planar_to_bgr_frame(uint8_t **src, int width, int height
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuv_planar_to_bgr_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv_planar_to_bgr_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuv_planar_to_bgr_frame_thread, ccparams, nthreads);
     return;
   }
 
+  if (!out_alpha) opstep = 3;
+
   orowstride -= width * opstep;
   irowstride -= width;
 
   for (i = 0; i < height; i++) {
-    for (j = 0; j < width; j++) {
+    j = yuvp_row_to_rgb(y, u, v, out_alpha ? a : NULL, dest, width, opstep, CC_ORDER_BGR);
+    y += j;
+    u += j;
+    v += j;
+    if (out_alpha && a) a += j;
+    dest += j * opstep;
+    for (; j < width; j++) {
       yuv2bgr(*(y++), *(u++), *(v++), &dest[0], &dest[1], &dest[2]);
       if (out_alpha) {
         if (in_alpha) {
@@ -5497,13 +6148,14 @@ static void convert_yuv_planar_to_argb_frame(uint8_t **src, int width, int heigh
   if (in_alpha) a = src[3];
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((y + dheight * i * irowstride) < end) {
@@ -5528,26 +6180,25 @@ static void convert_yuv_planar_to_argb_frame(uint8_t **src, int width, int heigh
         ccparams[i].out_clamping = clamping;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_yuv_planar_to_argb_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_yuv_planar_to_argb_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_yuv_planar_to_argb_frame_thread, ccparams, nthreads);
     return;
   }
 
   orowstride -= width * opstep;
-  orowstride -= width;
+  irowstride -= width;
 
   for (i = 0; i < height; i++) {
-    for (j = 0; j < width; j++) {
+    j = yuvp_row_to_rgb(y, u, v, a, dest, width, opstep, CC_ORDER_ARGB);
+    y += j;
+    u += j;
+    v += j;
+    if (a) a += j;
+    dest += j * opstep;
+    for (; j < width; j++) {
       yuv2rgb(*(y++), *(u++), *(v++), &dest[1], &dest[2], &dest[3]);
       if (in_alpha) {
         dest[0] = *(a++);
@@ -7331,13 +7982,14 @@ static void convert_swap3_frame(uint8_t *src, int width, int height, int irowstr
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -7356,18 +8008,11 @@ static void convert_swap3_frame(uint8_t *src, int width, int height, int irowstr
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap3_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap3_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap3_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -7449,13 +8094,14 @@ static void convert_swap4_frame(uint8_t *src, int width, int height, int irowstr
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -7471,18 +8117,11 @@ static void convert_swap4_frame(uint8_t *src, int width, int height, int irowstr
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap4_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap4_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap4_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -7543,13 +8182,14 @@ static void convert_swap3addpost_frame(uint8_t *src, int width, int height, int
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -7567,18 +8207,11 @@ static void convert_swap3addpost_frame(uint8_t *src, int width, int height, int
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap3addpost_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap3addpost_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap3addpost_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -7621,13 +8254,14 @@ static void convert_swap3addpre_frame(uint8_t *src, int width, int height, int i
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -7645,18 +8279,11 @@ static void convert_swap3addpre_frame(uint8_t *src, int width, int height, int i
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap3addpre_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap3addpre_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap3addpre_frame_thread, ccparams, nthreads);
     return;
   }
   if ((irowstride == width * 3) && (orowstride == width * 4)) {
@@ -7698,13 +8325,14 @@ static void convert_swap3postalpha_frame(uint8_t *src, int width, int height, in
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * rowstride) < end) {
@@ -7720,18 +8348,11 @@ static void convert_swap3postalpha_frame(uint8_t *src, int width, int height, in
         ccparams[i].irowstrides[0] = rowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap3postalpha_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap3postalpha_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap3postalpha_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -7762,13 +8383,14 @@ static void convert_swap3prealpha_frame(uint8_t *src, int width, int height, int
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, rowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * rowstride) < end) {
@@ -7784,18 +8406,11 @@ static void convert_swap3prealpha_frame(uint8_t *src, int width, int height, int
         ccparams[i].irowstrides[0] = rowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap3prealpha_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap3prealpha_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap3prealpha_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -7827,13 +8442,14 @@ static void convert_addpost_frame(uint8_t *src, int width, int height, int irows
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -7852,18 +8468,11 @@ static void convert_addpost_frame(uint8_t *src, int width, int height, int irows
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_addpost_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_addpost_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_addpost_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -7923,13 +8532,14 @@ static void convert_addpre_frame(uint8_t *src, int width, int height, int irowst
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -7947,18 +8557,11 @@ static void convert_addpre_frame(uint8_t *src, int width, int height, int irowst
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_addpre_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_addpre_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_addpre_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -7999,13 +8602,14 @@ static void convert_swap3delpost_frame(uint8_t *src, int width, int height, int
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -8023,18 +8627,11 @@ static void convert_swap3delpost_frame(uint8_t *src, int width, int height, int
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap3delpost_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap3delpost_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap3delpost_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -8075,13 +8672,14 @@ static void convert_delpost_frame(uint8_t *src, int width, int height, int irows
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -8100,18 +8698,11 @@ static void convert_delpost_frame(uint8_t *src, int width, int height, int irows
         ccparams[i].lut = gamma_lut;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_delpost_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_delpost_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_delpost_frame_thread, ccparams, nthreads);
     if (gamma_lut) lives_gamma_lut_free(gamma_lut);
     return;
   }
@@ -8163,13 +8754,14 @@ static void convert_delpre_frame(uint8_t *src, int width, int height, int irowst
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -8187,18 +8779,11 @@ static void convert_delpre_frame(uint8_t *src, int width, int height, int irowst
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_delpre_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_delpre_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_delpre_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -8239,13 +8824,14 @@ static void convert_swap3delpre_frame(uint8_t *src, int width, int height, int i
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -8263,18 +8849,11 @@ static void convert_swap3delpre_frame(uint8_t *src, int width, int height, int i
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swap3delpre_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swap3delpre_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swap3delpre_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -8316,13 +8895,14 @@ static void convert_swapprepost_frame(uint8_t *src, int width, int height, int i
   register int i;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, irowstride);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * irowstride) < end) {
@@ -8340,18 +8920,11 @@ static void convert_swapprepost_frame(uint8_t *src, int width, int height, int i
         ccparams[i].orowstrides[0] = orowstride;
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swapprepost_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swapprepost_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swapprepost_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -8419,13 +8992,14 @@ static void convert_swab_frame(uint8_t *src, int width, int height, int irow, in
   uint8_t *end = src + height * irow;
 
   if (thread_id == -1 && prefs->nfx_threads > 1) {
-    lives_thread_t threads[prefs->nfx_threads];
-    int nthreads = 1;
+    int ntiles = cc_get_ntiles(height, width4);
+    int nthreads = 0;
     int dheight, xdheight;
-    lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(prefs->nfx_threads, sizeof(lives_cc_params));
+    lives_cc_params ccparams[ntiles];
 
-    xdheight = CEIL((double)height / (double)prefs->nfx_threads, 4);
-    for (i = prefs->nfx_threads - 1; i >= 0; i--) {
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    xdheight = CEIL((double)height / (double)ntiles, 4);
+    for (i = ntiles - 1; i >= 0; i--) {
       dheight = xdheight;
 
       if ((src + dheight * i * width4) < end) {
@@ -8443,18 +9017,11 @@ static void convert_swab_frame(uint8_t *src, int width, int height, int irow, in
 
         ccparams[i].thread_id = i;
 
-        if (i == 0) convert_swab_frame_thread(&ccparams[i]);
-        else {
-          lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, convert_swab_frame_thread, &ccparams[i]);
-          nthreads++;
-        }
+        if (!nthreads) nthreads = i + 1;
       }
     }
 
-    for (i = 1; i < nthreads; i++) {
-      lives_thread_join(threads[i], NULL);
-    }
-    lives_free(ccparams);
+    cc_run_tiles(convert_swab_frame_thread, ccparams, nthreads);
     return;
   }
 
@@ -12133,19 +12700,18 @@ boolean gamma_convert_sub_layer(int gamma_type, double fileg, weed_layer_t *laye
       //g_print("gam from %d to %d with fileg %f\n", lgamma_type, gamma_type, fileg);
       if (gamma_type == lgamma_type && fileg == 1.0) return TRUE;
       else {
-        lives_thread_t threads[prefs->nfx_threads];
-        int nfx_threads = may_thread ? prefs->nfx_threads : 1;
         uint8_t *pixels = weed_layer_get_pixel_data_packed(layer);
         uint8_t *gamma_lut;
         int orowstride = weed_layer_get_rowstride(layer);
-        int nthreads = 1;
+        int ntiles = may_thread && prefs->nfx_threads > 1 ? cc_get_ntiles(height, orowstride) : 1;
+        int nthreads = 0;
         int dheight;
         int psize = pixel_size(pal);
-        lives_cc_params *ccparams = (lives_cc_params *)lives_calloc(nfx_threads,
-                                    sizeof(lives_cc_params));
-        int xdheight = CEIL((double)height / (double)nfx_threads, 4);
+        lives_cc_params ccparams[ntiles];
+        int xdheight = CEIL((double)height / (double)ntiles, 4);
         uint8_t *end = pixels + (y + height) * orowstride;
 
+        lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
         pixels += y * orowstride;
 
         if (gamma_type == WEED_GAMMA_VARIANT)
@@ -12153,8 +12719,7 @@ boolean gamma_convert_sub_layer(int gamma_type, double fileg, weed_layer_t *laye
         else
           gamma_lut = create_gamma_lut(1.0, lgamma_type, gamma_type);
 
-        //for (int i = nfx_threads - 1; i >= 0; i--) {
-        for (int i = nfx_threads - 1; i >= 0; i--) {
+        for (int i = ntiles - 1; i >= 0; i--) {
           dheight = xdheight;
 
           if ((pixels + dheight * i * orowstride) < end) {
@@ -12168,20 +12733,13 @@ boolean gamma_convert_sub_layer(int gamma_type, double fileg, weed_layer_t *laye
             ccparams[i].vsize = dheight;
             ccparams[i].psize = psize;
             ccparams[i].orowstrides[0] = orowstride;
-            if (pal == WEED_PALETTE_ARGB32) ccparams->alpha_first = TRUE;
+            if (pal == WEED_PALETTE_ARGB32) ccparams[i].alpha_first = TRUE;
             ccparams[i].lut = (void *)gamma_lut;
             ccparams[i].thread_id = i;
-            if (i == 0) gamma_convert_layer_thread(&ccparams[i]);
-            else {
-              lives_thread_create(&threads[i], LIVES_THRDATTR_NONE, gamma_convert_layer_thread, &ccparams[i]);
-              nthreads++;
-            }
+            if (!nthreads) nthreads = i + 1;
           }
         }
-        for (int i = 1; i < nthreads; i++) {
-          lives_thread_join(threads[i], NULL);
-        }
-        lives_free(ccparams);
+        cc_run_tiles(gamma_convert_layer_thread, ccparams, nthreads);
         lives_gamma_lut_free(gamma_lut);
         if (gamma_type != WEED_GAMMA_VARIANT)
           weed_set_int_value(layer, WEED_LEAF_GAMMA_TYPE, gamma_type);
@@ -12902,7 +13460,7 @@ boolean resize_layer(weed_layer_t *layer, int width, int height, LiVESInterpType
         }
         swparams[sl].irw = irw;
         swparams[sl].orw = orw;
-        if (sl < nthrds - 1) lives_thread_create(&threads[sl], LIVES_THRDATTR_NONE, swscale_threadfunc, &swparams[sl]);
+        if (sl < nthrds - 1) lives_thread_create(&threads[sl], LIVES_THRDATTR_INLINE_OK, swscale_threadfunc, &swparams[sl]);
         else swscale_threadfunc(&swparams[sl]);
       }
     }
@@ -13012,6 +13570,352 @@ boolean resize_layer(weed_layer_t *layer, int width, int height, LiVESInterpType
 }
 
 
+////////////////////////////////////////////////////////////
+// fused convert / resize / gamma
+
+// when a layer needs resizing and converting to an RGB display palette, we can produce the output in a single
+// tiled pass: each output row samples the source planes directly (nearest or bilinear), then converts the sampled
+// row in cache and applies any gamma change on the way out. This replaces resize_layer(), convert_layer_palette_full()
+// and gamma_convert_layer(), each of which would walk the entire frame and allocate new pixel data.
+
+#define FUSED_WBITS 8 ///< bits of precision for bilinear weights
+
+typedef struct {
+  const uint8_t *plane[4]; ///< first sample of each source channel (Y, U, V, A or R, G, B, A)
+  int irow[4];
+  int step[4]; ///< byte distance between consecutive samples in a channel
+  int hshift[4], vshift[4]; ///< chroma subsampling for each channel
+  int nchans;
+  boolean is_yuv;
+  boolean bilinear;
+  int iwidth, iheight;
+  int owidth, oheight;
+  uint8_t *dest;
+  int orow;
+  int opsize, order;
+  boolean out_alpha;
+  int *xoffs[4][2]; ///< byte offsets of left / right samples for each output column
+  int *xw[4]; ///< weight of the right hand sample
+  uint8_t *gamma_lut;
+} cc_fused_plan_t;
+
+
+static boolean fused_map_input(cc_fused_plan_t *plan, int pal, uint8_t **pd, int *rows) {
+  // describe the source channels; returns FALSE if the palette is not handled by the fused path
+  int offs[4] = {0, 1, 2, 3}, psize = 1, c;
+  switch (pal) {
+  case WEED_PALETTE_BGR24:
+  case WEED_PALETTE_BGRA32:
+    offs[0] = 2; offs[2] = 0;
+  // fallthrough
+  case WEED_PALETTE_RGB24:
+  case WEED_PALETTE_RGBA32:
+    psize = pixel_size(pal);
+    plan->nchans = psize;
+    break;
+  case WEED_PALETTE_ARGB32:
+    offs[0] = 1; offs[1] = 2; offs[2] = 3; offs[3] = 0;
+    psize = plan->nchans = 4;
+    break;
+  case WEED_PALETTE_YUV888:
+  case WEED_PALETTE_YUVA8888:
+    psize = pixel_size(pal);
+    plan->nchans = psize;
+    plan->is_yuv = TRUE;
+    break;
+  case WEED_PALETTE_YUV444P:
+  case WEED_PALETTE_YUVA4444P:
+  case WEED_PALETTE_YUV422P:
+  case WEED_PALETTE_YUV420P:
+  case WEED_PALETTE_YVU420P:
+    plan->nchans = weed_palette_has_alpha(pal) ? 4 : 3;
+    plan->is_yuv = TRUE;
+    for (c = 0; c < plan->nchans; c++) {
+      plan->plane[c] = pd[c];
+      plan->irow[c] = rows[c];
+      plan->step[c] = 1;
+    }
+    if (pal == WEED_PALETTE_YVU420P) {
+      plan->plane[1] = pd[2];
+      plan->irow[1] = rows[2];
+      plan->plane[2] = pd[1];
+      plan->irow[2] = rows[1];
+    }
+    if (pal == WEED_PALETTE_YUV422P || pal == WEED_PALETTE_YUV420P || pal == WEED_PALETTE_YVU420P) {
+      plan->hshift[1] = plan->hshift[2] = 1;
+      if (pal != WEED_PALETTE_YUV422P) plan->vshift[1] = plan->vshift[2] = 1;
+    }
+    return TRUE;
+  default:
+    return FALSE;
+  }
+  for (c = 0; c < plan->nchans; c++) {
+    plan->plane[c] = pd[0] + offs[c];
+    plan->irow[c] = rows[0];
+    plan->step[c] = psize;
+  }
+  return TRUE;
+}
+
+
+static void fused_map_coord(int o, int osize, int isize, boolean bilinear, int *i0, int *i1, int *w) {
+  // map output coordinate o to source samples i0, i1 with weight w for i1 (sample centres are aligned)
+  if (!bilinear) {
+    *i0 = *i1 = (int)(((int64_t)o * 2 + 1) * isize / (osize * 2));
+    if (*i0 >= isize) *i0 = *i1 = isize - 1;
+    *w = 0;
+  } else {
+    int64_t pos = (((int64_t)o * 2 + 1) * isize << FUSED_WBITS) / (osize * 2) - (1 << (FUSED_WBITS - 1));
+    if (pos < 0) pos = 0;
+    *i0 = (int)(pos >> FUSED_WBITS);
+    *w = (int)(pos & ((1 << FUSED_WBITS) - 1));
+    if (*i0 >= isize - 1) {
+      *i0 = *i1 = isize - 1;
+      *w = 0;
+    } else *i1 = *i0 + 1;
+  }
+}
+
+
+static void *fused_convert_resize_thread(void *data) {
+  lives_cc_params *ccparams = (lives_cc_params *)data;
+  cc_fused_plan_t *plan = (cc_fused_plan_t *)ccparams->plan;
+  int owidth = plan->owidth, opsize = plan->opsize;
+  int ystart = (int)ccparams->yoffset, yend = ystart + (int)ccparams->vsize;
+  uint8_t *dest = (uint8_t *)ccparams->dest;
+  uint8_t *rowbuf = cc_get_scratch(owidth * 4);
+  uint8_t *ch[4];
+  uint8_t *lut = plan->gamma_lut;
+  int y, x, c, k;
+
+  if (!rowbuf) return NULL;
+  for (c = 0; c < 4; c++) ch[c] = rowbuf + c * owidth;
+
+  for (y = ystart; y < yend; y++) {
+    // sample each source channel into the row buffer
+    for (c = 0; c < plan->nchans; c++) {
+      int cheight = (plan->iheight + (1 << plan->vshift[c]) - 1) >> plan->vshift[c];
+      int y0, y1, wy;
+      const uint8_t *r0, *r1;
+      int *x0 = plan->xoffs[c][0], *x1 = plan->xoffs[c][1], *wx = plan->xw[c];
+      uint8_t *out = ch[c];
+      fused_map_coord(y, plan->oheight, cheight, plan->bilinear, &y0, &y1, &wy);
+      r0 = plan->plane[c] + y0 * plan->irow[c];
+      r1 = plan->plane[c] + y1 * plan->irow[c];
+      if (!plan->bilinear) {
+        for (x = 0; x < owidth; x++) out[x] = r0[x0[x]];
+      } else {
+        for (x = 0; x < owidth; x++) {
+          int top = (r0[x0[x]] << FUSED_WBITS) + (r0[x1[x]] - r0[x0[x]]) * wx[x];
+          int bot = (r1[x0[x]] << FUSED_WBITS) + (r1[x1[x]] - r1[x0[x]]) * wx[x];
+          out[x] = (uint8_t)(((top << FUSED_WBITS) + (bot - top) * wy + (1 << (FUSED_WBITS * 2 - 1)))
+                             >> (FUSED_WBITS * 2));
+        }
+      }
+    }
+
+    // convert the sampled row to the output palette
+    if (plan->is_yuv) {
+      uint8_t *alpha = plan->nchans == 4 && plan->out_alpha ? ch[3] : NULL;
+      int rpos = plan->order == CC_ORDER_BGR ? 2 : plan->order == CC_ORDER_ARGB ? 1 : 0;
+      int bpos = plan->order == CC_ORDER_BGR ? 0 : rpos + 2;
+      int apos = plan->order == CC_ORDER_ARGB ? 0 : 3;
+      k = lut ? 0 : yuvp_row_to_rgb(ch[0], ch[1], ch[2], alpha, dest, owidth, opsize, plan->order);
+      for (x = k; x < owidth; x++) {
+        uint8_t *d = dest + x * opsize;
+        if (lut) yuv2rgb_with_gamma(ch[0][x], ch[1][x], ch[2][x], &d[rpos], &d[rpos + 1], &d[bpos], lut);
+        else yuv2rgb(ch[0][x], ch[1][x], ch[2][x], &d[rpos], &d[rpos + 1], &d[bpos]);
+        if (plan->out_alpha) d[apos] = alpha ? alpha[x] : 255;
+      }
+    } else {
+      int rpos = plan->order == CC_ORDER_BGR ? 2 : plan->order == CC_ORDER_ARGB ? 1 : 0;
+      int bpos = plan->order == CC_ORDER_BGR ? 0 : rpos + 2;
+      int apos = plan->order == CC_ORDER_ARGB ? 0 : 3;
+      uint8_t *d = dest;
+      for (x = 0; x < owidth; x++) {
+        if (lut) {
+          d[rpos] = lut[ch[0][x]];
+          d[rpos + 1] = lut[ch[1][x]];
+          d[bpos] = lut[ch[2][x]];
+        } else {
+          d[rpos] = ch[0][x];
+          d[rpos + 1] = ch[1][x];
+          d[bpos] = ch[2][x];
+        }
+        if (plan->out_alpha) d[apos] = plan->nchans == 4 ? ch[3][x] : 255;
+        d += opsize;
+      }
+    }
+    dest += plan->orow;
+  }
+  return NULL;
+}
+
+
+static boolean fused_convert_resize(weed_layer_t *layer, int outpl, int width, int height, LiVESInterpType interp,
+                                    int tgamma) {
+  // returns FALSE if the fused path cannot be used, in which case the layer is unaltered
+  cc_fused_plan_t plan;
+  weed_layer_t *old_layer;
+  uint8_t **pd;
+  int *rows;
+  int inpl = weed_layer_get_palette(layer);
+  int igamma = weed_layer_get_gamma(layer);
+  int flags = weed_layer_get_flags(layer);
+  int ntiles, nthreads = 0, xdheight, c, x, i;
+  boolean ok = FALSE;
+
+  if (interp != LIVES_INTERP_FAST && interp != LIVES_INTERP_NORMAL) return FALSE;
+  if (outpl != WEED_PALETTE_RGB24 && outpl != WEED_PALETTE_RGBA32 && outpl != WEED_PALETTE_BGR24
+      && outpl != WEED_PALETTE_BGRA32 && outpl != WEED_PALETTE_ARGB32) return FALSE;
+  if (weed_palette_has_alpha(inpl) && !weed_palette_has_alpha(outpl) && (flags & WEED_LAYER_ALPHA_PREMULT)) return FALSE;
+#ifdef USE_RESTHREAD
+  if (weed_get_int_value(layer, WEED_LEAF_PROGSCAN, NULL) > 0) return FALSE;
+#endif
+
+  lives_memset(&plan, 0, sizeof(cc_fused_plan_t));
+  plan.iwidth = weed_layer_get_width(layer);
+  plan.iheight = weed_layer_get_height(layer);
+  if (plan.iwidth < 2 || plan.iheight < 2) return FALSE;
+
+  pd = (uint8_t **)weed_layer_get_pixel_data(layer, NULL);
+  if (!pd) return FALSE;
+  rows = weed_layer_get_rowstrides(layer, NULL);
+  if (!rows) {
+    lives_free(pd);
+    return FALSE;
+  }
+  if (!fused_map_input(&plan, inpl, pd, rows)) goto done;
+
+  plan.bilinear = interp != LIVES_INTERP_FAST;
+  plan.owidth = width;
+  plan.oheight = height;
+  plan.opsize = pixel_size(outpl);
+  plan.out_alpha = weed_palette_has_alpha(outpl);
+  plan.order = (outpl == WEED_PALETTE_BGR24 || outpl == WEED_PALETTE_BGRA32) ? CC_ORDER_BGR
+               : outpl == WEED_PALETTE_ARGB32 ? CC_ORDER_ARGB : CC_ORDER_RGB;
+
+  if (plan.is_yuv) {
+    int iclamping = weed_layer_get_yuv_clamping(layer);
+    int isubspace = WEED_YUV_SUBSPACE_YCBCR;
+    if (weed_plant_has_leaf(layer, WEED_LEAF_YUV_SUBSPACE)) isubspace = weed_layer_get_yuv_subspace(layer);
+    if (isubspace == WEED_YUV_SUBSPACE_YUV) isubspace = WEED_YUV_SUBSPACE_YCBCR;
+    if (LIVES_UNLIKELY(!conv_YR_inited)) init_YUV_to_RGB_tables();
+    set_conversion_arrays(iclamping, isubspace);
+  }
+
+  if (prefs->apply_gamma && tgamma != WEED_GAMMA_UNKNOWN && igamma != tgamma)
+    plan.gamma_lut = create_gamma_lut(1.0, igamma, tgamma);
+
+  // column tables are shared by all tiles
+  for (c = 0; c < plan.nchans; c++) {
+    int cwidth = (plan.iwidth + (1 << plan.hshift[c]) - 1) >> plan.hshift[c];
+    if (c > 0 && plan.hshift[c] == plan.hshift[c - 1] && plan.step[c] == plan.step[c - 1]) {
+      // same sampling as the previous channel, offset by the difference in plane start
+      plan.xoffs[c][0] = plan.xoffs[c - 1][0];
+      plan.xoffs[c][1] = plan.xoffs[c - 1][1];
+      plan.xw[c] = plan.xw[c - 1];
+      continue;
+    }
+    plan.xoffs[c][0] = (int *)lives_malloc(width * 3 * sizeof(int));
+    if (!plan.xoffs[c][0]) goto done;
+    plan.xoffs[c][1] = plan.xoffs[c][0] + width;
+    plan.xw[c] = plan.xoffs[c][1] + width;
+    for (x = 0; x < width; x++) {
+      int x0, x1;
+      fused_map_coord(x, width, cwidth, plan.bilinear, &x0, &x1, &plan.xw[c][x]);
+      plan.xoffs[c][0][x] = x0 * plan.step[c];
+      plan.xoffs[c][1][x] = x1 * plan.step[c];
+    }
+  }
+
+  old_layer = weed_layer_new(WEED_LAYER_TYPE_VIDEO);
+  weed_layer_copy(old_layer, layer);
+  weed_layer_set_palette(layer, outpl);
+  weed_layer_set_size(layer, width, height);
+  weed_layer_nullify_pixel_data(layer);
+  if (!create_empty_pixel_data(layer, FALSE, TRUE)) {
+    weed_layer_copy(layer, old_layer);
+    weed_layer_nullify_pixel_data(old_layer);
+    weed_layer_free(old_layer);
+    goto done;
+  }
+  plan.dest = weed_layer_get_pixel_data_packed(layer);
+  plan.orow = weed_layer_get_rowstride(layer);
+
+  ntiles = prefs->nfx_threads > 1 ? cc_get_ntiles(height, plan.orow) : 1;
+  xdheight = CEIL((double)height / (double)ntiles, 4);
+
+  if (1) {
+    lives_cc_params ccparams[ntiles];
+    lives_memset(ccparams, 0, ntiles * sizeof(lives_cc_params));
+    for (i = ntiles - 1; i >= 0; i--) {
+      int dheight = xdheight;
+      if (dheight * i < height) {
+        if (dheight * (i + 1) > height) dheight = height - dheight * i;
+        ccparams[i].dest = plan.dest + xdheight * i * plan.orow;
+        ccparams[i].yoffset = xdheight * i;
+        ccparams[i].vsize = dheight;
+        ccparams[i].plan = &plan;
+        ccparams[i].thread_id = i;
+        if (!nthreads) nthreads = i + 1;
+      }
+    }
+    cc_run_tiles(fused_convert_resize_thread, ccparams, nthreads);
+  }
+
+  // this will free the original pixel data
+  weed_layer_free(old_layer);
+
+  if (prefs->apply_gamma && tgamma != WEED_GAMMA_UNKNOWN) weed_layer_set_gamma(layer, tgamma);
+  weed_leaf_delete(layer, WEED_LEAF_YUV_CLAMPING);
+  weed_leaf_delete(layer, WEED_LEAF_YUV_SUBSPACE);
+  weed_leaf_delete(layer, WEED_LEAF_YUV_SAMPLING);
+  if (!prefs->alpha_post && !weed_palette_has_alpha(inpl) && plan.out_alpha)
+    weed_set_int_value(layer, WEED_LEAF_FLAGS, flags | WEED_LAYER_ALPHA_PREMULT);
+  ok = TRUE;
+
+done:
+  for (c = 0; c < plan.nchans; c++) {
+    if (plan.xoffs[c][0] && (c == 0 || plan.xoffs[c][0] != plan.xoffs[c - 1][0])) lives_free(plan.xoffs[c][0]);
+  }
+  if (plan.gamma_lut) lives_gamma_lut_free(plan.gamma_lut);
+  lives_free(rows);
+  lives_free(pd);
+  return ok;
+}
+
+
+/**
+   @brief resize a layer and convert it to palette outpl and gamma tgamma
+
+   where possible this is done in a single fused pass over the frame (currently for nearest or bilinear
+   scaling to packed RGB palettes); otherwise we fall back to resize_layer() followed by
+   convert_layer_palette_full(). width is in pixels.
+   If tgamma is WEED_GAMMA_UNKNOWN then the gamma type is not changed.
+*/
+boolean convert_resize_layer(weed_layer_t *layer, int outpl, int oclamping, int width, int height,
+                             LiVESInterpType interp, int tgamma) {
+  int iwidth, iheight;
+  if (!layer || !weed_layer_get_pixel_data_packed(layer)) return FALSE;
+
+  iwidth = weed_layer_get_width_pixels(layer);
+  iheight = weed_layer_get_height(layer);
+
+  if (iwidth != width || iheight != height) {
+    // same size adjustments as resize_layer
+    if (width < 4) width = 4;
+    if (height < 4) height = 4;
+    width = (width >> 1) << 1;
+    height = (height >> 1) << 1;
+    if ((iwidth != width || iheight != height)
+        && fused_convert_resize(layer, outpl, width, height, interp, tgamma)) return TRUE;
+    if (!resize_layer(layer, width, height, interp, outpl, oclamping)) return FALSE;
+  }
+  return convert_layer_palette_full(layer, outpl, oclamping, WEED_YUV_SAMPLING_DEFAULT, WEED_YUV_SUBSPACE_YUV, tgamma);
+}
+
+
 boolean letterbox_layer(weed_layer_t *layer, int nwidth, int nheight, int width, int height,
                         LiVESInterpType interp, int tpal, int tclamp) {
   // stretch or shrink layer to width/height, then overlay it in a black rectangle size nwidth/nheight
@@ -13905,16 +14809,49 @@ LIVES_GLOBAL_INLINE int weed_layer_ref(weed_layer_t *layer) {
 }
 
 
+#ifdef WEED_HAVE_KEY_INTERN
+// interned handles for the leaves read on every frame; these are set once at startup, and until then
+// the accessors below fall back to the string keys
+static struct {
+  const weed_key_t *pixel_data, *rowstrides, *width, *height, *current_palette;
+  const weed_key_t *yuv_clamping, *yuv_sampling, *yuv_subspace;
+} layer_keys;
+
+#define LAYER_KEY(what, key) (layer_keys.what ? layer_keys.what : weed_key_intern(key))
+#endif
+
+void weed_layer_init_keys(void) {
+#ifdef WEED_HAVE_KEY_INTERN
+  layer_keys.pixel_data = weed_key_intern(WEED_LEAF_PIXEL_DATA);
+  layer_keys.rowstrides = weed_key_intern(WEED_LEAF_ROWSTRIDES);
+  layer_keys.width = weed_key_intern(WEED_LEAF_WIDTH);
+  layer_keys.height = weed_key_intern(WEED_LEAF_HEIGHT);
+  layer_keys.current_palette = weed_key_intern(WEED_LEAF_CURRENT_PALETTE);
+  layer_keys.yuv_clamping = weed_key_intern(WEED_LEAF_YUV_CLAMPING);
+  layer_keys.yuv_sampling = weed_key_intern(WEED_LEAF_YUV_SAMPLING);
+  layer_keys.yuv_subspace = weed_key_intern(WEED_LEAF_YUV_SUBSPACE);
+#endif
+}
+
+
 LIVES_GLOBAL_INLINE void **weed_layer_get_pixel_data(weed_layer_t *layer, int *nplanes) {
   if (nplanes) *nplanes = 0;
   if (!layer)  return NULL;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_voidptr_array_counted_k(layer, LAYER_KEY(pixel_data, WEED_LEAF_PIXEL_DATA), nplanes);
+#else
   return weed_get_voidptr_array_counted(layer, WEED_LEAF_PIXEL_DATA, nplanes);
+#endif
 }
 
 
 LIVES_GLOBAL_INLINE uint8_t *weed_layer_get_pixel_data_packed(weed_layer_t *layer) {
   if (!layer)  return NULL;
+#ifdef WEED_HAVE_KEY_INTERN
+  return (uint8_t *)weed_get_voidptr_value_k(layer, LAYER_KEY(pixel_data, WEED_LEAF_PIXEL_DATA), NULL);
+#else
   return (uint8_t *)weed_get_voidptr_value(layer, WEED_LEAF_PIXEL_DATA, NULL);
+#endif
 }
 
 
@@ -13928,19 +14865,31 @@ LIVES_GLOBAL_INLINE float **weed_layer_get_audio_data(weed_layer_t *layer, int *
 LIVES_GLOBAL_INLINE int *weed_layer_get_rowstrides(weed_layer_t *layer, int *nplanes) {
   if (nplanes) *nplanes = 0;
   if (!layer)  return NULL;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_array_counted_k(layer, LAYER_KEY(rowstrides, WEED_LEAF_ROWSTRIDES), nplanes);
+#else
   return weed_get_int_array_counted(layer, WEED_LEAF_ROWSTRIDES, nplanes);
+#endif
 }
 
 
 LIVES_GLOBAL_INLINE int weed_layer_get_rowstride(weed_layer_t *layer) {
   if (!layer)  return 0;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_value_k(layer, LAYER_KEY(rowstrides, WEED_LEAF_ROWSTRIDES), NULL);
+#else
   return weed_get_int_value(layer, WEED_LEAF_ROWSTRIDES, NULL);
+#endif
 }
 
 
 LIVES_GLOBAL_INLINE int weed_layer_get_width(weed_layer_t *layer) {
   if (!layer)  return -1;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_value_k(layer, LAYER_KEY(width, WEED_LEAF_WIDTH), NULL);
+#else
   return weed_get_int_value(layer, WEED_LEAF_WIDTH, NULL);
+#endif
 }
 
 
@@ -13952,31 +14901,51 @@ LIVES_GLOBAL_INLINE int weed_layer_get_width_pixels(weed_layer_t *layer) {
 
 LIVES_GLOBAL_INLINE int weed_layer_get_height(weed_layer_t *layer) {
   if (!layer)  return -1;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_value_k(layer, LAYER_KEY(height, WEED_LEAF_HEIGHT), NULL);
+#else
   return weed_get_int_value(layer, WEED_LEAF_HEIGHT, NULL);
+#endif
 }
 
 
 LIVES_GLOBAL_INLINE int weed_layer_get_yuv_clamping(weed_layer_t *layer) {
   if (!layer)  return 0;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_value_k(layer, LAYER_KEY(yuv_clamping, WEED_LEAF_YUV_CLAMPING), NULL);
+#else
   return weed_get_int_value(layer, WEED_LEAF_YUV_CLAMPING, NULL);
+#endif
 }
 
 
 LIVES_GLOBAL_INLINE int weed_layer_get_yuv_sampling(weed_layer_t *layer) {
   if (!layer)  return 0;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_value_k(layer, LAYER_KEY(yuv_sampling, WEED_LEAF_YUV_SAMPLING), NULL);
+#else
   return weed_get_int_value(layer, WEED_LEAF_YUV_SAMPLING, NULL);
+#endif
 }
 
 
 LIVES_GLOBAL_INLINE int weed_layer_get_yuv_subspace(weed_layer_t *layer) {
   if (!layer)  return 0;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_value_k(layer, LAYER_KEY(yuv_subspace, WEED_LEAF_YUV_SUBSPACE), NULL);
+#else
   return weed_get_int_value(layer, WEED_LEAF_YUV_SUBSPACE, NULL);
+#endif
 }
 
 
 LIVES_GLOBAL_INLINE int weed_layer_get_palette(weed_layer_t *layer) {
   if (!layer)  return WEED_PALETTE_END;
+#ifdef WEED_HAVE_KEY_INTERN
+  return weed_get_int_value_k(layer, LAYER_KEY(current_palette, WEED_LEAF_CURRENT_PALETTE), NULL);
+#else
   return weed_get_int_value(layer, WEED_LEAF_CURRENT_PALETTE, NULL);
+#endif
 }
 
 
@@ -13985,7 +14954,7 @@ LIVES_GLOBAL_INLINE int weed_layer_get_palette_yuv(weed_layer_t *layer, int *cla
   if (clamping) *clamping = weed_layer_get_yuv_clamping(layer);
   if (sampling) *sampling = weed_layer_get_yuv_sampling(layer);
   if (subspace) *subspace = weed_layer_get_yuv_subspace(layer);
-  return weed_get_int_value(layer, WEED_LEAF_CURRENT_PALETTE, NULL);
+  return weed_layer_get_palette(layer);
 }
 
 
@@ -107,6 +107,7 @@ typedef struct {
   boolean is_bottom;
   size_t psize;
   size_t xoffset;
+  size_t yoffset;
   int irowstrides[4];
   int orowstrides[4];
   void *dest;
@@ -122,6 +123,7 @@ typedef struct {
   boolean alpha_first;
   boolean is_422;
   void *lut;
+  void *plan; ///< shared state for fused passes
   int thread_id;
 } lives_cc_params;
 
@@ -208,6 +210,7 @@ int32_t round_special(int32_t val);
 void init_conversions(int intent);
 
 void init_colour_engine(void);
+void cc_engine_stop(void);
 
 double get_luma8(uint8_t r, uint8_t g, uint8_t b);
 double get_luma16(uint16_t r, uint16_t g, uint16_t b);
@@ -277,6 +280,8 @@ boolean consider_swapping(int *inpal, int *outpal);
 
 /// widths in PIXELS
 boolean resize_layer(weed_layer_t *, int width, int height, LiVESInterpType interp, int opal_hint, int oclamp_hint);
+boolean convert_resize_layer(weed_layer_t *, int outpl, int oclamping, int width, int height, LiVESInterpType interp,
+                             int tgamma);
 boolean letterbox_layer(weed_layer_t *, int nwidth, int nheight, int width, int height, LiVESInterpType interp, int tpal,
                         int tclamp);
 boolean compact_rowstrides(weed_layer_t *);
@@ -301,6 +306,7 @@ LiVESPixbuf *layer_to_pixbuf(weed_layer_t *, boolean realpalette, boolean fordis
 boolean pixbuf_to_layer(weed_layer_t *, LiVESPixbuf *) WARN_UNUSED;
 
 // layer info
+void weed_layer_init_keys(void); ///< intern the keys used by the layer accessors
 int weed_layer_is_video(weed_layer_t *);
 int weed_layer_is_audio(weed_layer_t *);
 int weed_layer_get_palette(weed_layer_t *);
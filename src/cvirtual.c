@@ -138,7 +138,7 @@ frames_t load_frame_index(int fileno) {
 
   do {
     retval = 0;
-    fd = lives_open_buffered_rdonly(fname);
+    fd = lives_open_buffered_rdonly_mapped(fname);
     if (fd < 0) {
       THREADVAR(read_failed) = 0;
       retval = do_read_failed_error_s_with_retry(fname, lives_strerror(errno));
@@ -1653,6 +1653,9 @@ switch_point:
       requested_frame = sfile->frameno;
     else sfile->frameno = requested_frame;
 
+    if (!mainw->multitrack && !mainw->preview)
+      lives_readahead_update(mainw->playing_file, requested_frame, sfile->pb_fps);
+
     if (mainw->scratch != SCRATCH_NONE) scratch  = mainw->scratch;
     mainw->scratch = SCRATCH_NONE;
 
@@ -2088,6 +2091,9 @@ switch_point:
             if (!is_virtual_frame(mainw->pred_clip, mainw->pred_frame)) {
               mainw->frame_layer_preload = lives_layer_new_for_frame(mainw->pred_clip, mainw->pred_frame);
               pull_frame_threaded(mainw->frame_layer_preload, img_ext, (weed_timecode_t)mainw->currticks, 0, 0);
+            } else if (lives_readahead_active(mainw->pred_clip)) {
+              // the read-ahead thread is already decoding upcoming frames on its own decoder
+              mainw->pred_clip = -1;
             } else {
               // if the target is a clip-frame we have to decode it now, since we cannot simply decode 2 frames simultaneously
               // (although it could be possible in the future to have 2 clone decoders and have them leapfrog...)
@@ -16,6 +16,13 @@
 static lives_pconnect_t *spconx;
 static lives_cconnect_t *scconx;
 
+/// bumped whenever a data or alpha channel connection is added, removed or remapped
+static volatile uint64_t conx_epoch = 0;
+
+LIVES_LOCAL_INLINE void conx_changed(void) {__atomic_add_fetch(&conx_epoch, 1, __ATOMIC_RELEASE);}
+
+LIVES_GLOBAL_INLINE uint64_t conx_get_epoch(void) {return __atomic_load_n(&conx_epoch, __ATOMIC_ACQUIRE);}
+
 static boolean do_chan_connected_query(lives_conx_w *, int okey, int omode, int ocnum, boolean is_same_key);
 static boolean do_param_connected_query(lives_conx_w *, int okey, int omode, int opnum, boolean is_same_key);
 static void do_param_incompatible_error(lives_conx_w *);
@@ -164,6 +171,7 @@ void pconx_delete_all(void) {
     pconx = pconx_next;
   }
   mainw->pconx = NULL;
+  conx_changed();
 
   for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) pthread_mutex_unlock(&mainw->fx_mutex[i]);
 }
@@ -290,6 +298,7 @@ void pconx_delete(int okey, int omode, int opnum, int ikey, int imode, int ipnum
         lives_free(pconx->autoscale); lives_free(pconx);
         if (mainw->pconx == pconx) mainw->pconx = pconx_next;
         else pconx_prev->next = pconx_next;
+        conx_changed();
         if (okey >= 0 && okey != FX_DATA_WILDCARD) for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++)
             pthread_mutex_unlock(&mainw->fx_mutex[i]);
         return;
@@ -372,6 +381,8 @@ void pconx_delete(int okey, int omode, int opnum, int ikey, int imode, int ipnum
     pconx_prev = pconx;
     pconx = pconx_next;
   }
+  conx_changed();
+
   if (okey >= 0 && okey != FX_DATA_WILDCARD)
     for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) pthread_mutex_unlock(&mainw->fx_mutex[i]);
 }
@@ -398,6 +409,7 @@ void pconx_remap_mode(int key, int omode, int nmode) {
     // *INDENT-ON*
     pconx = pconx->next;
   }
+  conx_changed();
 }
 
 
@@ -412,6 +424,7 @@ static void pconx_append(lives_pconnect_t *pconx) {
 
   if (last_pconx) last_pconx->next = pconx;
   if (!mainw->pconx) mainw->pconx = pconx;
+  conx_changed();
 }
 
 
@@ -1572,6 +1585,7 @@ void cconx_delete_all(void) {
     cconx = cconx_next;
   }
   mainw->cconx = NULL;
+  conx_changed();
 }
 
 
@@ -1676,6 +1690,7 @@ void cconx_delete(int okey, int omode, int ocnum, int ikey, int imode, int icnum
         lives_free(cconx->imode); lives_free(cconx->icnum); lives_free(cconx);
         if (mainw->cconx == cconx) mainw->cconx = cconx_next;
         else cconx_prev->next = cconx_next;
+        conx_changed();
         return;
       }
 
@@ -1738,6 +1753,7 @@ void cconx_delete(int okey, int omode, int ocnum, int ikey, int imode, int icnum
     cconx_prev = cconx;
     cconx = cconx_next;
   }
+  conx_changed();
 }
 
 
@@ -1762,6 +1778,7 @@ void cconx_remap_mode(int key, int omode, int nmode) {
     }
     cconx = cconx->next;
   }
+  conx_changed();
 }
 
 
@@ -1776,6 +1793,7 @@ static void cconx_append(lives_cconnect_t *cconx) {
 
   if (last_cconx) last_cconx->next = cconx;
   if (!mainw->cconx) mainw->cconx = cconx;
+  conx_changed();
 }
 
 
@@ -4481,6 +4499,7 @@ static void conxw_cancel_clicked(LiVESWidget * button, livespointer user_data) {
   // restore old values
   mainw->pconx = spconx;
   mainw->cconx = scconx;
+  conx_changed();
 
   lives_general_button_clicked(LIVES_BUTTON(button), NULL);
 }
@@ -4498,6 +4517,7 @@ static void conxw_ok_clicked(LiVESWidget * button, livespointer user_data) {
 
   mainw->cconx = cconx_bak;
   mainw->pconx = pconx_bak;
+  conx_changed();
 
   lives_general_button_clicked(LIVES_BUTTON(button), NULL);
 }
@@ -119,6 +119,9 @@ char *cconx_list(int okey, int omode, int ocnum);
 
 boolean cconx_chain_data_internal(weed_plant_t *ichan);
 
+/// returns a counter which changes whenever any data or alpha channel connection is added, removed or remapped
+uint64_t conx_get_epoch(void);
+
 //////////////////////////////////////////////////////////
 
 void override_if_active_input(int hotkey);
@@ -46,8 +46,9 @@ struct _procvals {
   weed_plant_t *inst;
   weed_timecode_t tc;
   weed_error_t ret;
+  ticks_t busy; ///< time the slice took to process
   char padding[DEF_ALIGN - ((sizeof(weed_process_f) - sizeof(weed_plant_t *)
-                             - sizeof(weed_timecode_t) - sizeof(weed_error_t)) % DEF_ALIGN)];
+                             - sizeof(weed_timecode_t) - sizeof(weed_error_t) - sizeof(ticks_t)) % DEF_ALIGN)];
 };
 
 static weed_plantptr_t statsplant = NULL;
@@ -404,6 +405,244 @@ static void **pchains[FX_KEYS_MAX]; // parameter changes, used during recording
 static void *filter_map[FX_KEYS_MAX + 2];
 static int next_free_key;
 
+/////////////////// realtime effect profiling /////////////////
+
+/// adaptive size policy: when the effect chain takes more than FX_ADAPT_OVER of the frame period, the key with the
+/// highest recent cost is processed FX_ADAPT_STEP percent smaller (down to FX_ADAPT_MIN_SCALE); after FX_ADAPT_RECOVER
+/// frames under FX_ADAPT_UNDER the most reduced key is stepped back up
+#define FX_ADAPT_OVER 0.8
+#define FX_ADAPT_UNDER 0.5
+#define FX_ADAPT_STEP 25
+#define FX_ADAPT_MIN_SCALE 25
+#define FX_ADAPT_HOLD 4 ///< frames to wait after a reduction; the key's cost ring is restarted, so it reflects only these
+#define FX_ADAPT_RECOVER 50
+
+typedef struct {
+  volatile boolean inited;
+  volatile int mode;
+  volatile uint64_t calls, proc_usec, max_usec, applies, conv_usec;
+  volatile uint64_t threaded_calls, slice_busy_usec, slice_avail_usec;
+  volatile uint64_t hist[FX_PROF_NBUCKETS];
+  volatile uint32_t ring_pos;
+  volatile uint32_t ring[FX_PROF_RING]; ///< per frame cost (apply time) in usec
+  volatile int scale_drop; ///< percent reduction of processing size, 0 == normal
+} fx_prof_t;
+
+static fx_prof_t fx_prof[FX_KEYS_MAX_VIRTUAL];
+static pthread_mutex_t fx_prof_mutex = PTHREAD_MUTEX_INITIALIZER; ///< serialises resets, and stats snapshots against them
+static volatile boolean fx_adaptive = FALSE;
+static int fx_adapt_hold = 0, fx_adapt_calm = 0;
+
+/// process_func time accumulated by this thread, so that apply time can be split into processing and host overhead
+static __thread ticks_t fx_prof_proc_ticks = 0;
+
+#define TICKS_TO_USEC(t) ((uint64_t)((t) < 0 ? 0 : (t) / USEC_TO_TICKS))
+
+/// zero the counters with atomic stores, so that updaters running concurrently only ever race on single values;
+/// scale_drop is not a statistic, and is left alone. Call with fx_prof_mutex held
+static void fx_prof_clear(fx_prof_t *prof) {
+  __atomic_store_n(&prof->calls, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->proc_usec, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->max_usec, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->applies, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->conv_usec, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->threaded_calls, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->slice_busy_usec, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->slice_avail_usec, 0, __ATOMIC_RELAXED);
+  for (int i = 0; i < FX_PROF_NBUCKETS; i++) __atomic_store_n(&prof->hist[i], 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->ring_pos, 0, __ATOMIC_RELAXED);
+}
+
+
+static fx_prof_t *fx_prof_slot(int key) {
+  // get the stats for key, resetting them (and the processing size) if the key has changed mode since they were recorded
+  fx_prof_t *prof;
+  int mode;
+  if (key < 0 || key >= FX_KEYS_MAX_VIRTUAL) return NULL;
+  prof = &fx_prof[key];
+  mode = key_modes[key];
+  if (!__atomic_load_n(&prof->inited, __ATOMIC_ACQUIRE) || __atomic_load_n(&prof->mode, __ATOMIC_ACQUIRE) != mode) {
+    pthread_mutex_lock(&fx_prof_mutex);
+    if (!prof->inited || prof->mode != mode) {
+      fx_prof_clear(prof);
+      __atomic_store_n(&prof->scale_drop, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&prof->mode, mode, __ATOMIC_RELEASE);
+      __atomic_store_n(&prof->inited, TRUE, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&fx_prof_mutex);
+  }
+  return prof;
+}
+
+
+static void fx_prof_add_proc(int key, ticks_t ticks, int nslices, ticks_t busy) {
+  fx_prof_t *prof = fx_prof_slot(key);
+  uint64_t usec = TICKS_TO_USEC(ticks), max;
+  int bucket;
+  if (!prof) return;
+  bucket = 63 - __builtin_clzll(usec | 1);
+  if (bucket >= FX_PROF_NBUCKETS) bucket = FX_PROF_NBUCKETS - 1;
+  __atomic_add_fetch(&prof->calls, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&prof->proc_usec, usec, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&prof->hist[bucket], 1, __ATOMIC_RELAXED);
+  max = __atomic_load_n(&prof->max_usec, __ATOMIC_RELAXED);
+  while (usec > max && !__atomic_compare_exchange_n(&prof->max_usec, &max, usec, FALSE, __ATOMIC_RELAXED,
+         __ATOMIC_RELAXED));
+  if (nslices > 1) {
+    __atomic_add_fetch(&prof->threaded_calls, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&prof->slice_busy_usec, TICKS_TO_USEC(busy), __ATOMIC_RELAXED);
+    __atomic_add_fetch(&prof->slice_avail_usec, usec * nslices, __ATOMIC_RELAXED);
+  }
+}
+
+
+static void fx_prof_add_apply(int key, ticks_t ticks, ticks_t proc_ticks) {
+  fx_prof_t *prof = fx_prof_slot(key);
+  uint32_t pos;
+  if (!prof) return;
+  __atomic_add_fetch(&prof->applies, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&prof->conv_usec, TICKS_TO_USEC(ticks - proc_ticks), __ATOMIC_RELAXED);
+  pos = __atomic_fetch_add(&prof->ring_pos, 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&prof->ring[pos % FX_PROF_RING], (uint32_t)TICKS_TO_USEC(ticks), __ATOMIC_RELAXED);
+}
+
+
+static uint64_t fx_prof_recent_usec(fx_prof_t *prof) {
+  uint32_t n = __atomic_load_n(&prof->ring_pos, __ATOMIC_RELAXED);
+  uint64_t tot = 0;
+  if (n > FX_PROF_RING) n = FX_PROF_RING;
+  if (!n) return 0;
+  for (int i = 0; i < n; i++) tot += __atomic_load_n(&prof->ring[i], __ATOMIC_RELAXED);
+  return tot / n;
+}
+
+
+LIVES_LOCAL_INLINE int fx_prof_get_scale(int key) {
+  if (key < 0 || key >= FX_KEYS_MAX_VIRTUAL) return 100;
+  return 100 - __atomic_load_n(&fx_prof[key].scale_drop, __ATOMIC_RELAXED);
+}
+
+
+void fx_prof_get_stats(int key, lives_fx_prof_stats_t *stats) {
+  fx_prof_t *prof;
+  lives_memset(stats, 0, sizeof(lives_fx_prof_stats_t));
+  stats->scale = 100;
+  if (key < 0 || key >= FX_KEYS_MAX_VIRTUAL) return;
+  prof = &fx_prof[key];
+  if (!__atomic_load_n(&prof->inited, __ATOMIC_ACQUIRE)) return;
+  // the apply path updates the counters concurrently, so each is read atomically;
+  // holding the mutex keeps a reset from landing half way through the snapshot
+  pthread_mutex_lock(&fx_prof_mutex);
+  stats->mode = __atomic_load_n(&prof->mode, __ATOMIC_ACQUIRE);
+  stats->calls = __atomic_load_n(&prof->calls, __ATOMIC_RELAXED);
+  stats->proc_usec = __atomic_load_n(&prof->proc_usec, __ATOMIC_RELAXED);
+  stats->max_usec = __atomic_load_n(&prof->max_usec, __ATOMIC_RELAXED);
+  stats->applies = __atomic_load_n(&prof->applies, __ATOMIC_RELAXED);
+  stats->conv_usec = __atomic_load_n(&prof->conv_usec, __ATOMIC_RELAXED);
+  stats->threaded_calls = __atomic_load_n(&prof->threaded_calls, __ATOMIC_RELAXED);
+  stats->slice_busy_usec = __atomic_load_n(&prof->slice_busy_usec, __ATOMIC_RELAXED);
+  stats->slice_avail_usec = __atomic_load_n(&prof->slice_avail_usec, __ATOMIC_RELAXED);
+  for (int i = 0; i < FX_PROF_NBUCKETS; i++) stats->hist[i] = __atomic_load_n(&prof->hist[i], __ATOMIC_RELAXED);
+  stats->recent_usec = fx_prof_recent_usec(prof);
+  pthread_mutex_unlock(&fx_prof_mutex);
+  stats->scale = fx_prof_get_scale(key);
+}
+
+
+void fx_prof_reset_stats(int key) {
+  // the adaptive processing size is kept
+  if (key >= FX_KEYS_MAX_VIRTUAL) return;
+  pthread_mutex_lock(&fx_prof_mutex);
+  if (key < 0) {
+    for (int i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) fx_prof_clear(&fx_prof[i]);
+  } else fx_prof_clear(&fx_prof[key]);
+  pthread_mutex_unlock(&fx_prof_mutex);
+}
+
+
+/// change the processing size of key by delta percent, and restart its cost ring so that the next decision
+/// is based only on frames processed at the new size
+static void fx_prof_change_scale(int key, int delta) {
+  __atomic_add_fetch(&fx_prof[key].scale_drop, delta, __ATOMIC_RELAXED);
+  __atomic_store_n(&fx_prof[key].ring_pos, 0, __ATOMIC_RELEASE);
+}
+
+
+uint64_t fx_prof_percentile(const lives_fx_prof_stats_t *stats, double pc) {
+  uint64_t tot = 0, target, n = 0;
+  int i;
+  for (i = 0; i < FX_PROF_NBUCKETS; i++) tot += stats->hist[i];
+  if (!tot) return 0;
+  target = (uint64_t)(pc / 100. * (double)tot + .5);
+  if (target < 1) target = 1;
+  for (i = 0; i < FX_PROF_NBUCKETS - 1; i++) {
+    if ((n += stats->hist[i]) >= target) break;
+  }
+  return (uint64_t)2 << i;
+}
+
+
+void fx_prof_set_adaptive(boolean enable) {
+  fx_adaptive = enable;
+  if (!enable) {
+    // back to full size
+    for (int i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) __atomic_store_n(&fx_prof[i].scale_drop, 0, __ATOMIC_RELAXED);
+  }
+  fx_adapt_hold = fx_adapt_calm = 0;
+}
+
+
+LIVES_GLOBAL_INLINE boolean fx_prof_get_adaptive(void) {return fx_adaptive;}
+
+
+static void fx_prof_adapt(ticks_t chain_ticks) {
+  // called once per frame with the time taken by the realtime effect chain
+  double fps, budget;
+  uint64_t cost, best_cost = 0;
+  int best = -1, drop, i;
+
+  if (!fx_adaptive || !LIVES_IS_PLAYING || !IS_VALID_CLIP(mainw->playing_file)) return;
+  fps = fabs(mainw->files[mainw->playing_file]->pb_fps);
+  if (fps <= 0.) return;
+  budget = TICKS_PER_SECOND_DBL / fps;
+
+  if (fx_adapt_hold > 0) fx_adapt_hold--;
+
+  if ((double)chain_ticks > budget * FX_ADAPT_OVER) {
+    fx_adapt_calm = 0;
+    if (fx_adapt_hold > 0) return;
+    for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) {
+      if (!__atomic_load_n(&fx_prof[i].inited, __ATOMIC_ACQUIRE) || !rte_key_is_enabled(i + 1)) continue;
+      if (__atomic_load_n(&fx_prof[i].scale_drop, __ATOMIC_RELAXED) + FX_ADAPT_STEP > 100 - FX_ADAPT_MIN_SCALE) continue;
+      cost = fx_prof_recent_usec(&fx_prof[i]);
+      if (cost > best_cost) {
+        best_cost = cost;
+        best = i;
+      }
+    }
+    if (best != -1) {
+      fx_prof_change_scale(best, FX_ADAPT_STEP);
+      fx_adapt_hold = FX_ADAPT_HOLD;
+    }
+    return;
+  }
+
+  if ((double)chain_ticks < budget * FX_ADAPT_UNDER) {
+    if (++fx_adapt_calm < FX_ADAPT_RECOVER) return;
+    fx_adapt_calm = 0;
+    for (i = 0, drop = 0; i < FX_KEYS_MAX_VIRTUAL; i++) {
+      int xdrop = __atomic_load_n(&fx_prof[i].scale_drop, __ATOMIC_RELAXED);
+      if (xdrop > drop) {
+        drop = xdrop;
+        best = i;
+      }
+    }
+    if (best != -1) fx_prof_change_scale(best, -FX_ADAPT_STEP);
+    return;
+  }
+  fx_adapt_calm = 0;
+}
+
 ////////////////////////////////////////////////////////////////////
 
 
@@ -1323,19 +1562,163 @@ void weed_reinit_all(void) {
 
 static void *thread_process_func(void *arg) {
   struct _procvals *procvals = (struct _procvals *)arg;
+  ticks_t start = lives_get_current_ticks();
   procvals->ret = (*procvals->procfunc)(procvals->inst, procvals->tc);
+  procvals->busy = lives_get_current_ticks() - start;
   return NULL;
 }
 
 
 #define SLICE_ALIGN 2
 
-static lives_filter_error_t process_func_threaded(weed_plant_t *inst, weed_timecode_t tc) {
+/// shadow copies of an instance for threaded slice processing. Each slice but the last (which uses the instance
+/// itself) gets its own copy of the instance and out channels, so it can have its own WEED_LEAF_OFFSET and
+/// WEED_LEAF_HEIGHT. The copies are made once and kept in WEED_LEAF_HOST_SLICE_SHADOWS; on later frames any leaf
+/// whose value differs from the instance or its out channels is copied again, since plugins may update their own
+/// leaves in process() and the instance may have been processed unthreaded in between. They are dropped when the
+/// instance is deinited or freed.
+typedef struct {
+  int nshadows, nchannels;
+  weed_plant_t **insts; ///< nshadows shadow instances
+  weed_plant_t **chans; ///< nshadows * nchannels shadow out channels
+  char **inst_keys; ///< leaves of the instance at the last sync
+  char ***chan_keys; ///< leaves of each out channel at the last sync
+  struct _procvals *procvals; ///< nshadows + 1
+  lives_thread_t *dthreads; ///< nshadows
+} slice_shadows_t;
+
+
+static void slice_keys_free(char **keys) {
+  if (!keys) return;
+  for (int i = 0; keys[i]; i++) free(keys[i]);
+  free(keys);
+}
+
+
+static void slice_shadows_free(weed_plant_t *inst) {
+  slice_shadows_t *shadows = (slice_shadows_t *)weed_get_voidptr_value(inst, WEED_LEAF_HOST_SLICE_SHADOWS, NULL);
+  if (!shadows) return;
+  weed_leaf_delete(inst, WEED_LEAF_HOST_SLICE_SHADOWS);
+  for (int i = 0; i < shadows->nshadows; i++) {
+    for (int j = 0; j < shadows->nchannels; j++) weed_plant_free(shadows->chans[i * shadows->nchannels + j]);
+    weed_plant_free(shadows->insts[i]);
+  }
+  slice_keys_free(shadows->inst_keys);
+  for (int j = 0; j < shadows->nchannels; j++) slice_keys_free(shadows->chan_keys[j]);
+  lives_free(shadows->chan_keys);
+  lives_free(shadows->insts);
+  lives_free(shadows->chans);
+  lives_free(shadows->procvals);
+  lives_free(shadows->dthreads);
+  lives_free(shadows);
+}
+
+
+#define SLICE_SYNC_MAX_STR 256 ///< strings longer than this are recopied rather than compared
+
+/// TRUE if key holds the same values in dst as in src. Values are compared in place, so nothing is allocated
+static boolean slice_leaf_equal(weed_plant_t *dst, weed_plant_t *src, const char *key) {
+  uint32_t st = weed_leaf_seed_type(src, key);
+  int ne = weed_leaf_num_elements(src, key);
+  if (st != weed_leaf_seed_type(dst, key) || ne != weed_leaf_num_elements(dst, key)) return FALSE;
+  for (int i = 0; i < ne; i++) {
+    if (st == WEED_SEED_STRING) {
+      char s0[SLICE_SYNC_MAX_STR], s1[SLICE_SYNC_MAX_STR], *p0 = s0, *p1 = s1;
+      weed_size_t sz = weed_leaf_element_size(src, key, i);
+      if (sz >= SLICE_SYNC_MAX_STR || sz != weed_leaf_element_size(dst, key, i)) return FALSE;
+      weed_leaf_get(src, key, i, &p0);
+      weed_leaf_get(dst, key, i, &p1);
+      if (lives_memcmp(s0, s1, sz)) return FALSE;
+    } else {
+      // every other seed type fits in 64 bits
+      uint64_t v0 = 0, v1 = 0;
+      weed_leaf_get(src, key, i, &v0);
+      weed_leaf_get(dst, key, i, &v1);
+      if (v0 != v1) return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+
+LIVES_LOCAL_INLINE boolean slice_leaf_synced(const char *key, const char *skip) {
+  return strcmp(key, WEED_LEAF_TYPE) && (!skip || strcmp(key, skip)) && strcmp(key, WEED_LEAF_HOST_SLICE_SHADOWS);
+}
+
+
+/**
+   @brief bring shadow plants back in line with src, as if they had just been copied
+
+   the shadows are dsts[0], dsts[stride], ... (ndsts of them); the leaf named skip is left alone.
+   src is listed once for all of them and only leaves which differ are copied. *keys holds the leaves of src at the
+   last sync, so that any which have since gone can be deleted; it is replaced by the current list.
+*/
+static void slice_shadows_sync(weed_plant_t **dsts, int ndsts, int stride, weed_plant_t *src, const char *skip,
+                               char ***keys) {
+  char **leaves = weed_plant_list_leaves(src, NULL), **oleaves = *keys;
+  if (oleaves) {
+    for (int i = 0; oleaves[i]; i++) {
+      if (!slice_leaf_synced(oleaves[i], skip) || weed_plant_has_leaf(src, oleaves[i])) continue;
+      for (int k = 0; k < ndsts; k++) weed_leaf_delete(dsts[k * stride], oleaves[i]);
+    }
+    slice_keys_free(oleaves);
+  }
+  for (int i = 0; leaves[i]; i++) {
+    if (!slice_leaf_synced(leaves[i], skip)) continue;
+    for (int k = 0; k < ndsts; k++) {
+      if (!slice_leaf_equal(dsts[k * stride], src, leaves[i])) weed_leaf_copy(dsts[k * stride], leaves[i], src, leaves[i]);
+    }
+  }
+  *keys = leaves;
+}
+
+
+static slice_shadows_t *slice_shadows_get(weed_plant_t *inst, weed_plant_t **out_channels, int nchannels, int nshadows) {
+  slice_shadows_t *shadows = (slice_shadows_t *)weed_get_voidptr_value(inst, WEED_LEAF_HOST_SLICE_SHADOWS, NULL);
+
+  if (shadows && shadows->nshadows == nshadows && shadows->nchannels == nchannels) {
+    pthread_mutex_lock(&mainw->instance_ref_mutex);
+    slice_shadows_sync(shadows->insts, nshadows, 1, inst, WEED_LEAF_OUT_CHANNELS, &shadows->inst_keys);
+    pthread_mutex_unlock(&mainw->instance_ref_mutex);
+    for (int j = 0; j < nchannels; j++)
+      slice_shadows_sync(&shadows->chans[j], nshadows, nchannels, out_channels[j], NULL, &shadows->chan_keys[j]);
+    return shadows;
+  }
+
+  slice_shadows_free(inst);
+  shadows = (slice_shadows_t *)lives_calloc(1, sizeof(slice_shadows_t));
+  shadows->nshadows = nshadows;
+  shadows->nchannels = nchannels;
+  shadows->insts = (weed_plant_t **)lives_calloc(nshadows, sizeof(weed_plant_t *));
+  shadows->chans = (weed_plant_t **)lives_calloc(nshadows * nchannels, sizeof(weed_plant_t *));
+  shadows->procvals = (struct _procvals *)lives_calloc(nshadows + 1, sizeof(struct _procvals));
+  shadows->dthreads = (lives_thread_t *)lives_calloc(nshadows, sizeof(lives_thread_t));
+  shadows->chan_keys = (char ***)lives_calloc(nchannels, sizeof(char **));
+
+  pthread_mutex_lock(&mainw->instance_ref_mutex);
+  shadows->inst_keys = weed_plant_list_leaves(inst, NULL);
+  pthread_mutex_unlock(&mainw->instance_ref_mutex);
+  for (int j = 0; j < nchannels; j++) shadows->chan_keys[j] = weed_plant_list_leaves(out_channels[j], NULL);
+
+  for (int i = 0; i < nshadows; i++) {
+    pthread_mutex_lock(&mainw->instance_ref_mutex);
+    shadows->insts[i] = weed_plant_copy(inst);
+    pthread_mutex_unlock(&mainw->instance_ref_mutex);
+    for (int j = 0; j < nchannels; j++) shadows->chans[i * nchannels + j] = weed_plant_copy(out_channels[j]);
+    weed_set_plantptr_array(shadows->insts[i], WEED_LEAF_OUT_CHANNELS, nchannels, &shadows->chans[i * nchannels]);
+  }
+  weed_set_voidptr_value(inst, WEED_LEAF_HOST_SLICE_SHADOWS, shadows);
+  return shadows;
+}
+
+
+static lives_filter_error_t process_func_threaded(weed_plant_t *inst, weed_timecode_t tc, int *nslices, ticks_t *busy) {
   // split output(s) into horizontal slices
+  // if nslices and busy are non-NULL, they are set to the number of slices used and their summed processing time
+  slice_shadows_t *shadows;
   struct _procvals *procvals;
   lives_thread_t *dthreads = NULL;
-  weed_plant_t **xinst = NULL;
-  weed_plant_t **xchannels, *xchan;
+  weed_plant_t *xinst, *xchan;
   weed_plant_t *filter = weed_instance_get_filter(inst, FALSE);
   weed_error_t retval;
   int nchannels;
@@ -1349,7 +1732,7 @@ static lives_filter_error_t process_func_threaded(weed_plant_t *inst, weed_timec
 
   int vstep = SLICE_ALIGN, minh;
   int slices, slices_per_thread, to_use;
-  int heights[2], *xheights;
+  int heights[2], xheights[2];
   int offset = 0;
   int dheight, height, xheight = 0, cheight;
   int nthreads = 0;
@@ -1358,6 +1741,9 @@ static lives_filter_error_t process_func_threaded(weed_plant_t *inst, weed_timec
 
   weed_process_f process_func = (weed_process_f)weed_get_funcptr_value(filter, WEED_LEAF_PROCESS_FUNC, NULL);
 
+  if (nslices) *nslices = 0;
+  if (busy) *busy = 0;
+
   filter = weed_instance_get_filter(inst, TRUE);
   if (weed_plant_has_leaf(filter, WEED_LEAF_VSTEP)) {
     minh = weed_get_int_value(filter, WEED_LEAF_VSTEP, NULL);
@@ -1376,75 +1762,58 @@ static lives_filter_error_t process_func_threaded(weed_plant_t *inst, weed_timec
     }
   }
 
-  if (xheight % vstep != 0) return FILTER_ERROR_DONT_THREAD;
+  if (xheight % vstep != 0) {
+    lives_freep((void **)&out_channels);
+    return FILTER_ERROR_DONT_THREAD;
+  }
 
   // slices = min height / step
   slices = xheight / vstep;
   slices_per_thread = ALIGN_CEIL(slices, prefs->nfx_threads) / prefs->nfx_threads;
 
   to_use = ALIGN_CEIL(slices, slices_per_thread) / slices_per_thread;
-  if (--to_use < 1) return FILTER_ERROR_DONT_THREAD;
+  if (--to_use < 1) {
+    lives_freep((void **)&out_channels);
+    return FILTER_ERROR_DONT_THREAD;
+  }
 
-  procvals = (struct _procvals *)lives_calloc(to_use, sizeof(struct _procvals));
-  procvals->ret = WEED_SUCCESS;
-  xinst = (weed_plant_t **)lives_calloc(to_use, sizeof(weed_plant_t *));
-  dthreads = (lives_thread_t *)lives_calloc(to_use - 1, sizeof(lives_thread_t));
+  // each slice but the last needs its own copy of the output channels, so it can have its own WEED_LEAF_OFFSET and
+  // WEED_LEAF_HEIGHT; therefore it also needs its own copy of inst
+  // but note that WEED_LEAF_PIXEL_DATA always points to the same memory buffer(s)
+  // this is good also because it avoids concurrency problems with updating inst leaves
+  // the last slice gets the original inst so it can update values
+  shadows = slice_shadows_get(inst, out_channels, nchannels, to_use - 1);
+  procvals = shadows->procvals;
+  dthreads = shadows->dthreads;
 
   for (i = 0; i < nchannels; i++) {
     heights[1] = height = weed_get_int_value(out_channels[i], WEED_LEAF_HEIGHT, NULL);
     slices = height / vstep;
     slices_per_thread = CEIL((double)slices / (double)to_use, 1.);
-    dheight = slices_per_thread * vstep;
-    heights[0] = dheight;
-    weed_set_int_value(out_channels[i], WEED_LEAF_OFFSET, 0);
-    weed_set_int_array(out_channels[i], WEED_LEAF_HEIGHT, 2, heights);
-  }
-
-  for (j = 0; j < to_use; j++) {
-    // each thread needs its own copy of the output channels, so it can have its own WEED_LEAF_OFFSET and WEED_LEAF_HEIGHT
-    // therefore it also needs its own copy of inst
-    // but note that WEED_LEAF_PIXEL_DATA always points to the same memory buffer(s)
-    // this is good also because it avoids concurrency problems with updating inst leaves
-    // one of the threads (in this case the last one) will get the original inst so it can update values
-    if (j < to_use - 1) {
-      pthread_mutex_lock(&mainw->instance_ref_mutex);
-      xinst[j] = weed_plant_copy(inst);
-      pthread_mutex_unlock(&mainw->instance_ref_mutex);
-      xchannels = (weed_plant_t **)lives_calloc(nchannels, sizeof(weed_plant_t *));
-    } else {
-      xinst[j] = inst;
-      xchannels = NULL;
-    }
+    heights[0] = slices_per_thread * vstep;
 
-    for (i = 0; i < nchannels; i++) {
-      if (j < to_use - 1) {
-        xchan = xchannels[i] = weed_plant_copy(out_channels[i]);
-      } else {
-        xchan = out_channels[i];
-      }
-      xheights = weed_get_int_array(out_channels[i], WEED_LEAF_HEIGHT, NULL);
-      height = xheights[1];
-      dheight = xheights[0];
-      offset = dheight * j;
+    for (j = 0; j < to_use; j++) {
+      xchan = j < to_use - 1 ? shadows->chans[j * nchannels + i] : out_channels[i];
+      offset = heights[0] * j;
+      dheight = heights[0];
       if ((height - offset) < dheight) dheight = height - offset;
       xheights[0] = dheight;
+      xheights[1] = height;
       weed_set_int_value(xchan, WEED_LEAF_OFFSET, offset);
       weed_set_int_array(xchan, WEED_LEAF_HEIGHT, 2, xheights);
-      lives_free(xheights);
     }
+  }
 
-    if (j < to_use - 1) {
-      weed_set_plantptr_array(xinst[j], WEED_LEAF_OUT_CHANNELS, nchannels, xchannels);
-    }
-    lives_freep((void **)&xchannels);
-
+  for (j = 0; j < to_use; j++) {
+    xinst = j < to_use - 1 ? shadows->insts[j] : inst;
     procvals[j].procfunc = process_func;
-    procvals[j].inst = xinst[j];
+    procvals[j].inst = xinst;
     procvals[j].tc = tc; // use same timecode for all slices
+    procvals[j].ret = WEED_SUCCESS;
 
     if (j < to_use - 1) {
       // start a thread for processing
-      lives_thread_create(&dthreads[j], LIVES_THRDATTR_NONE, thread_process_func, &procvals[j]);
+      lives_thread_create(&dthreads[j], LIVES_THRDATTR_INLINE_OK, thread_process_func, &procvals[j]);
       nthreads++; // actual number of threads used
     } else {
       /// do the last portion oiurselves, rather than just waiting around
@@ -1463,26 +1832,18 @@ static lives_filter_error_t process_func_threaded(weed_plant_t *inst, weed_timec
     if (retval == WEED_ERROR_PLUGIN_INVALID) plugin_invalid = TRUE;
     if (retval == WEED_ERROR_FILTER_INVALID) filter_invalid = TRUE;
     if (retval == WEED_ERROR_REINIT_NEEDED) needs_reinit = TRUE;
-
-    xchannels = weed_get_plantptr_array(xinst[j], WEED_LEAF_OUT_CHANNELS, NULL);
-    for (i = 0; i < nchannels; i++) {
-      weed_plant_free(xchannels[i]);
-    }
-    lives_freep((void **)&xchannels);
-    weed_plant_free(xinst[j]);
   }
 
+  if (nslices) *nslices = to_use;
+  if (busy) for (j = 0; j < to_use; j++) *busy += procvals[j].busy;
+
   for (i = 0; i < nchannels; i++) {
     // reset the channel heights
-    xheights = weed_get_int_array(out_channels[i], WEED_LEAF_HEIGHT, NULL);
-    weed_set_int_value(out_channels[i], WEED_LEAF_HEIGHT, xheights[1]);
-    lives_free(xheights);
+    if (weed_leaf_get(out_channels[i], WEED_LEAF_HEIGHT, 1, &height) == WEED_SUCCESS)
+      weed_set_int_value(out_channels[i], WEED_LEAF_HEIGHT, height);
     weed_leaf_delete(out_channels[i], WEED_LEAF_OFFSET);
   }
 
-  lives_freep((void **)&procvals);
-  lives_freep((void **)&xinst);
-  lives_freep((void **)&dthreads);
   lives_freep((void **)&out_channels);
   weed_leaf_delete(inst, WEED_LEAF_HOST_UNUSED);
 
@@ -2005,6 +2366,15 @@ lives_filter_error_t weed_apply_instance(weed_plant_t *inst, weed_plant_t *init_
     }
   }
 
+  if (!LIVES_IS_RENDERING && !is_converter) {
+    /// adaptive policy: process at a reduced size if this key has been too slow to keep up
+    int scale = fx_prof_get_scale(key);
+    if (scale < 100) {
+      opwidth = MAX(opwidth * scale / 100, 4);
+      opheight = MAX(opheight * scale / 100, 4);
+    }
+  }
+
   opwidth = (opwidth >> 1) << 1;
   opheight = (opheight >> 1) << 1;
 
@@ -2800,8 +3170,10 @@ lives_filter_error_t run_process_func(weed_plant_t *instance, weed_timecode_t tc
   weed_plant_t *filter = weed_instance_get_filter(instance, FALSE);
   weed_process_f process_func;
   lives_filter_error_t retval = FILTER_SUCCESS;
+  ticks_t start = lives_get_current_ticks(), busy = 0, elapsed;
   boolean did_thread = FALSE;
   int filter_flags = weed_get_int_value(filter, WEED_LEAF_FLAGS, NULL);
+  int nslices = 0;
 #ifdef PLMEMCHECK
   int npl;
   weed_plant_t *och = weed_instance_get_out_channels(instance, &npl);
@@ -2814,7 +3186,7 @@ lives_filter_error_t run_process_func(weed_plant_t *instance, weed_timecode_t tc
       filter_flags & WEED_FILTER_HINT_MAY_THREAD) {
     weed_plant_t **out_channels = weed_instance_get_out_channels(instance, NULL);
     if (key == -1 || !filter_mutex_trylock(key)) {
-      retval = process_func_threaded(instance, tc);
+      retval = process_func_threaded(instance, tc, &nslices, &busy);
       if (key != -1) filter_mutex_unlock(key);
     } else retval = FILTER_ERROR_INVALID_PLUGIN;
     lives_free(out_channels);
@@ -2833,6 +3205,9 @@ lives_filter_error_t run_process_func(weed_plant_t *instance, weed_timecode_t tc
 #ifdef PLMEMCHECK
   weed_mem_chkreg(NULL, NULL, 0, 0);
 #endif
+  elapsed = lives_get_current_ticks() - start;
+  fx_prof_proc_ticks += elapsed;
+  if (retval != FILTER_ERROR_INVALID_PLUGIN) fx_prof_add_proc(key, elapsed, nslices, busy);
   return retval;
 }
 
@@ -3481,6 +3856,364 @@ apply_inst2:
 }
 
 
+/// realtime effect chain scheduling for free playback
+///
+/// every key with video channels reads and writes the shared layers, so those keys are always applied in key order.
+/// Keys which only use their own channels (data processors, alpha only filters) and keys whose only role here is
+/// the activation check can be applied alongside them, unless a data or alpha connection links them.
+/// Each valid key is placed in the stage after the last earlier key it conflicts with; keys in the same stage are
+/// independent and run concurrently. The schedule is cached and rebuilt only when bound filters or connections change.
+
+typedef struct {
+  uint64_t conx_epoch;
+  lives_pconnect_t *pconx;
+  lives_cconnect_t *cconx;
+  weed_plant_t *filters[FX_KEYS_MAX_VIRTUAL]; ///< filter bound to each key, or NULL if the key is not valid
+  int nkeys;
+  int keys[FX_KEYS_MAX_VIRTUAL]; ///< valid keys, ordered by stage then by key
+  int nstages;
+  int stage_start[FX_KEYS_MAX_VIRTUAL + 1]; ///< first entry in keys for each stage, stage_start[nstages] == nkeys
+  boolean inited;
+} rte_schedule_t;
+
+static rte_schedule_t rte_sched;
+static pthread_mutex_t rte_sched_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+struct _rte_stage_work {
+  weed_plant_t **layers;
+  const int *keys;
+  int nkeys;
+  int opwidth, opheight;
+  weed_timecode_t tc;
+};
+
+
+static boolean rte_sched_uses_layers(weed_plant_t *filter) {
+  // return TRUE if filter may read or write the shared video layers
+  weed_plant_t **ctmpls;
+  boolean ret = FALSE;
+  int nchans, i, k;
+
+  if (num_compound_fx(filter) > 1) return TRUE;
+
+  for (k = 0; k < 2 && !ret; k++) {
+    nchans = 0;
+    ctmpls = k ? weed_filter_get_out_chantmpls(filter, &nchans) : weed_filter_get_in_chantmpls(filter, &nchans);
+    for (i = 0; i < nchans; i++) {
+      if (weed_chantmpl_is_audio(ctmpls[i]) == WEED_TRUE) continue;
+      if (has_non_alpha_palette(ctmpls[i], filter)) {
+        ret = TRUE;
+        break;
+      }
+    }
+    lives_freep((void **)&ctmpls);
+  }
+  return ret;
+}
+
+
+LIVES_LOCAL_INLINE void rte_sched_add_edge(uint64_t *conflicts, int okey, int ikey) {
+  // connections to the playback plugin, subtitles etc. are resolved after the chain, so they need no ordering here
+  if (okey < 0 || okey >= FX_KEYS_MAX_VIRTUAL || ikey < 0 || ikey >= FX_KEYS_MAX_VIRTUAL) return;
+  conflicts[okey] |= GU641 << ikey;
+  conflicts[ikey] |= GU641 << okey;
+}
+
+
+static void rte_sched_build(rte_schedule_t *sched) {
+  lives_pconnect_t *pconx;
+  lives_cconnect_t *cconx;
+  uint64_t conflicts[FX_KEYS_MAX_VIRTUAL];
+  uint64_t layer_keys = 0;
+  int stage[FX_KEYS_MAX_VIRTUAL];
+  int i, j, n;
+
+  lives_memset(conflicts, 0, sizeof(conflicts));
+
+  for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) {
+    if (sched->filters[i] && rte_sched_uses_layers(sched->filters[i])) layer_keys |= GU641 << i;
+  }
+
+  // data and alpha connections are treated as undirected: whichever key comes first must still run first
+  for (pconx = sched->pconx; pconx; pconx = pconx->next) {
+    for (i = n = 0; i < pconx->nparams; i++) n += pconx->nconns[i];
+    for (j = 0; j < n; j++) rte_sched_add_edge(conflicts, pconx->okey, pconx->ikey[j]);
+  }
+  for (cconx = sched->cconx; cconx; cconx = cconx->next) {
+    for (i = n = 0; i < cconx->nchans; i++) n += cconx->nconns[i];
+    for (j = 0; j < n; j++) rte_sched_add_edge(conflicts, cconx->okey, cconx->ikey[j]);
+  }
+
+  sched->nstages = 0;
+  for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) {
+    stage[i] = -1;
+    if (!sched->filters[i]) continue;
+    if (layer_keys & (GU641 << i)) conflicts[i] |= layer_keys;
+    stage[i] = 0;
+    for (j = 0; j < i; j++) {
+      if (stage[j] >= stage[i] && (conflicts[i] & (GU641 << j))) stage[i] = stage[j] + 1;
+    }
+    if (stage[i] >= sched->nstages) sched->nstages = stage[i] + 1;
+  }
+
+  sched->nkeys = 0;
+  for (n = 0; n < sched->nstages; n++) {
+    sched->stage_start[n] = sched->nkeys;
+    for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) if (stage[i] == n) sched->keys[sched->nkeys++] = i;
+  }
+  sched->stage_start[sched->nstages] = sched->nkeys;
+}
+
+
+static void rte_sched_get(rte_schedule_t *sched) {
+  // copy the current schedule to sched, rebuilding it first if keys or connections changed
+  weed_plant_t *filter;
+  uint64_t epoch = conx_get_epoch();
+  boolean rebuild;
+
+  pthread_mutex_lock(&rte_sched_mutex);
+  rebuild = !rte_sched.inited || rte_sched.conx_epoch != epoch || rte_sched.pconx != mainw->pconx
+            || rte_sched.cconx != mainw->cconx;
+  for (int i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) {
+    filter = rte_key_valid(i + 1, TRUE) ? rte_keymode_get_filter(i + 1, key_modes[i]) : NULL;
+    if (filter != rte_sched.filters[i]) {
+      rte_sched.filters[i] = filter;
+      rebuild = TRUE;
+    }
+  }
+  if (rebuild) {
+    rte_sched.conx_epoch = epoch;
+    rte_sched.pconx = mainw->pconx;
+    rte_sched.cconx = mainw->cconx;
+    rte_sched_build(&rte_sched);
+    rte_sched.inited = TRUE;
+  }
+  lives_memcpy(sched, &rte_sched, sizeof(rte_schedule_t));
+  pthread_mutex_unlock(&rte_sched_mutex);
+}
+
+
+/// GUI updates requested by apply_rte_key(), which may be running on a pool thread; they are made on the main thread
+/// by rte_gui_flush() once all the keys have been applied
+static volatile uint64_t rte_gui_keych_off = 0; ///< keys to be shown as switched off
+static volatile uint64_t rte_gui_redraw = 0; ///< keys whose parameter window should be redrawn
+
+static void _rte_gui_flush(void) {
+  uint64_t keych_off = __atomic_exchange_n(&rte_gui_keych_off, 0, __ATOMIC_SEQ_CST);
+  uint64_t redraw = __atomic_exchange_n(&rte_gui_redraw, 0, __ATOMIC_SEQ_CST);
+  for (int i = 0; i < 64 && (keych_off | redraw) >> i; i++) {
+    uint64_t bit = GU641 << i;
+    if (keych_off & bit) {
+      if (rte_window) rtew_set_keych(i, FALSE);
+      if (mainw->ce_thumbs) ce_thumbs_set_keych(i, FALSE);
+    }
+    if (redraw & bit) update_widget_vis(NULL, i, key_modes[i]);
+  }
+}
+
+
+static void rte_gui_flush(void) {
+  if (!__atomic_load_n(&rte_gui_keych_off, __ATOMIC_ACQUIRE) && !__atomic_load_n(&rte_gui_redraw, __ATOMIC_ACQUIRE))
+    return;
+  if (pthread_equal(capable->main_thread, pthread_self())) _rte_gui_flush();
+  else main_thread_execute((lives_funcptr_t)_rte_gui_flush, 0, NULL, "");
+}
+
+
+static void apply_rte_key(int i, weed_plant_t **layers, int opwidth, int opheight, weed_timecode_t tc) {
+  // apply the effect bound to (valid) key i in free playback
+  weed_plant_t *filter, *instance, *orig_inst, *instance2, *gui;
+  lives_filter_error_t filter_error;
+  ticks_t apply_ticks = 0, proc_ticks = 0, start;
+  boolean needs_reinit;
+  int easeval = 0;
+
+  if (!(rte_key_is_enabled(1 + i))) {
+    // if anything is connected to ACTIVATE, the fx may be activated
+    pconx_chain_data(i, key_modes[i], FALSE);
+  }
+  if (!rte_key_is_enabled(1 + i)) return;
+
+  mainw->osc_block = TRUE;
+  if ((instance = weed_instance_obtain(i, key_modes[i])) == NULL) {
+    mainw->osc_block = FALSE;
+    return;
+  }
+  filter = weed_instance_get_filter(instance, TRUE);
+
+  if (is_pure_audio(filter, TRUE)) {
+    weed_instance_unref(instance);
+    return;
+  }
+  gui = weed_instance_get_gui(instance, FALSE);
+  if (weed_get_int_value(gui, WEED_LEAF_EASE_OUT, NULL) > 0) {
+    // if the plugin is easing out, check if it finished
+    if (!weed_plant_has_leaf(instance, WEED_LEAF_AUTO_EASING)) { // if auto_Easing then we'll deinit it on the event_list
+      if (!weed_get_int_value(gui, WEED_LEAF_EASE_OUT_FRAMES, NULL)) {
+        // easing finished, deinit it
+        uint64_t new_rte = GU641 << (i);
+        // record
+        if (init_events[i]) {
+          // if we are recording, mark the number of frames to ease out
+          // we'll need to repeat the same process during preview / rendering
+          // - when we hit the init_event, we'll find the deinit, then work back x frames and mark easing start
+          weed_set_int_value(init_events[i], WEED_LEAF_EASE_OUT,
+                             weed_get_int_value(instance, WEED_LEAF_EASE_OUT, NULL));
+        }
+        weed_instance_unref(instance);
+        filter_mutex_lock(i);
+        weed_deinit_effect(i);
+        if (mainw->rte & new_rte) {
+          // other keys may be updating mainw->rte concurrently
+          __atomic_and_fetch(&mainw->rte, ~new_rte, __ATOMIC_SEQ_CST);
+          __atomic_or_fetch(&rte_gui_keych_off, new_rte, __ATOMIC_SEQ_CST);
+        }
+        filter_mutex_unlock(i);
+        return;
+	// *INDENT-OFF*
+      }}}
+  // *INDENT-ON*
+
+  if (mainw->pchains && mainw->pchains[i]) {
+    if (!filter_mutex_trylock(i)) {
+      interpolate_params(instance, mainw->pchains[i], tc); // interpolate parameters during preview
+      filter_mutex_unlock(i);
+    }
+  }
+
+  // TODO *** enable this, and apply pconx to audio gens in audio.c
+  if (!is_pure_audio(filter, TRUE)) {
+    if (mainw->pconx && !(mainw->preview || mainw->is_rendering)) {
+      // chain any data pipelines
+      needs_reinit = pconx_chain_data(i, key_modes[i], FALSE);
+
+      // if anything is connected to ACTIVATE, the fx may be activated
+      if ((instance2 = weed_instance_obtain(i, key_modes[i])) == NULL) {
+        weed_instance_unref(instance);
+        return;
+      }
+      weed_instance_unref(instance);
+      instance = instance2;
+      if (needs_reinit) {
+        if ((filter_error = weed_reinit_effect(instance, FALSE)) == FILTER_ERROR_COULD_NOT_REINIT) {
+          weed_instance_unref(instance);
+          return;
+	  // *INDENT-OFF*
+        }}}}
+  // *INDENT-ON*
+
+  orig_inst = instance;
+
+apply_inst3:
+
+  if (weed_plant_has_leaf(instance, WEED_LEAF_HOST_NEXT_INSTANCE)) {
+    // chain any internal data pipelines for compound fx
+    needs_reinit = pconx_chain_data_internal(instance);
+    if (needs_reinit) {
+      if ((filter_error = weed_reinit_effect(instance, FALSE)) == FILTER_ERROR_COULD_NOT_REINIT) {
+        weed_instance_unref(instance);
+        return;
+	// *INDENT-OFF*
+      }}}
+  // *INDENT-ON*
+
+  start = lives_get_current_ticks();
+  fx_prof_proc_ticks = 0;
+  filter_error = weed_apply_instance(instance, NULL, layers, opwidth, opheight, tc);
+  apply_ticks += lives_get_current_ticks() - start;
+  proc_ticks += fx_prof_proc_ticks;
+
+  if (easeval > 0 && !weed_plant_has_leaf(orig_inst, WEED_LEAF_AUTO_EASING)) {
+    // if the plugin is supposed to be easing out, make sure it is really
+    weed_plant_t *gui = weed_instance_get_gui(orig_inst, FALSE);
+    if (gui) {
+      int xeaseval = weed_get_int_value(gui, WEED_LEAF_EASE_OUT_FRAMES, NULL), myeaseval;
+      myeaseval = weed_get_int_value(instance, WEED_LEAF_HOST_EASE_OUT_COUNT, NULL);
+      if (xeaseval > myeaseval) {
+        uint64_t new_rte = GU641 << (i);
+        filter_mutex_lock(i);
+        weed_instance_unref(orig_inst);
+        if (mainw->rte & new_rte) {
+          __atomic_and_fetch(&mainw->rte, ~new_rte, __ATOMIC_SEQ_CST);
+          __atomic_or_fetch(&rte_gui_keych_off, new_rte, __ATOMIC_SEQ_CST);
+        }
+        weed_deinit_effect(i);
+        filter_mutex_unlock(i);
+        return;
+      }
+      // count how many frames to ease out
+      weed_set_int_value(instance, WEED_LEAF_HOST_EASE_OUT_COUNT,
+                         weed_get_int_value(instance, WEED_LEAF_HOST_EASE_OUT_COUNT, NULL) + 1);
+    }
+  }
+  if (filter_error == FILTER_ERROR_NEEDS_REINIT) {
+    // TODO...
+  }
+  if (filter_error == FILTER_INFO_REINITED)
+    __atomic_or_fetch(&rte_gui_redraw, GU641 << i, __ATOMIC_SEQ_CST);
+  //#define DEBUG_RTE
+#ifdef DEBUG_RTE
+  if (filter_error != FILTER_SUCCESS) lives_printerr("Render error was %d\n", filter_error);
+#endif
+  if (filter_error == FILTER_SUCCESS && (instance = get_next_compound_inst(instance))) goto apply_inst3;
+
+  fx_prof_add_apply(i, apply_ticks, proc_ticks);
+
+  if (mainw->pconx && (filter_error == FILTER_SUCCESS || filter_error == FILTER_INFO_REINITED
+                       || filter_error == FILTER_INFO_REDRAWN)) {
+    pconx_chain_data_omc(orig_inst, i, key_modes[i]);
+  }
+  weed_instance_unref(orig_inst);
+}
+
+
+static void *apply_rte_keys_thread(void *arg) {
+  struct _rte_stage_work *work = (struct _rte_stage_work *)arg;
+  for (int i = 0; i < work->nkeys; i++) {
+    apply_rte_key(work->keys[i], work->layers, work->opwidth, work->opheight, work->tc);
+  }
+  return NULL;
+}
+
+
+static void apply_rte_stage(const int *keys, int nkeys, weed_plant_t **layers, int opwidth, int opheight,
+                            weed_timecode_t tc) {
+  // apply a group of mutually independent keys, spreading the enabled ones over the thread pool
+  struct _rte_stage_work work[FX_KEYS_MAX_VIRTUAL];
+  lives_thread_t dthreads[FX_KEYS_MAX_VIRTUAL];
+  int order[FX_KEYS_MAX_VIRTUAL];
+  int nenabled = 0, nworkers, per_worker, i, j = nkeys;
+
+  // enabled keys first; disabled keys (which only check for activation) go to the end, for the calling thread
+  for (i = 0; i < nkeys; i++) {
+    if (rte_key_is_enabled(keys[i] + 1)) order[nenabled++] = keys[i];
+    else order[--j] = keys[i];
+  }
+
+  nworkers = MIN(nenabled, prefs->nfx_threads);
+  if (nworkers < 2) {
+    for (i = 0; i < nkeys; i++) apply_rte_key(keys[i], layers, opwidth, opheight, tc);
+    return;
+  }
+
+  per_worker = (nenabled + nworkers - 1) / nworkers;
+  nworkers = (nenabled + per_worker - 1) / per_worker;
+
+  for (i = 0; i < nworkers; i++) {
+    work[i].layers = layers;
+    work[i].keys = order + i * per_worker;
+    work[i].nkeys = i < nworkers - 1 ? per_worker : nkeys - i * per_worker;
+    work[i].opwidth = opwidth;
+    work[i].opheight = opheight;
+    work[i].tc = tc;
+    // do the last group ourselves, rather than just waiting around
+    if (i < nworkers - 1) lives_thread_create(&dthreads[i], LIVES_THRDATTR_INLINE_OK, apply_rte_keys_thread, &work[i]);
+    else apply_rte_keys_thread(&work[i]);
+  }
+  for (i = 0; i < nworkers - 1; i++) lives_thread_join(dthreads[i], NULL);
+}
+
+
 weed_plant_t *weed_apply_effects(weed_plant_t **layers, weed_plant_t *filter_map, weed_timecode_t tc,
                                  int opwidth, int opheight, void ***pchains) {
   // given a stack of layers, a filter map, a timecode and possibly paramater chains
@@ -3491,14 +4224,10 @@ weed_plant_t *weed_apply_effects(weed_plant_t **layers, weed_plant_t *filter_map
   // returned layer can be of any width,height,palette
   // caller should free all input layers, WEED_LEAF_PIXEL_DATA of all non-returned layers is free()d here
 
-  weed_plant_t *filter, *instance, *orig_inst, *instance2, *layer;
-  lives_filter_error_t filter_error;
-
-  boolean needs_reinit;
+  weed_plant_t *layer;
 
   int output = -1;
   int clip;
-  int easeval = 0;
 
   int i;
 
@@ -3510,145 +4239,19 @@ weed_plant_t *weed_apply_effects(weed_plant_t **layers, weed_plant_t *filter_map
   }
 
   // free playback: we will have here only one or two layers, and no filter_map.
-  // Effects are applied in key order, in tracks are 0 and 1, out track is 0
+  // Effects are applied in key order, in tracks are 0 and 1, out track is 0;
+  // keys which cannot affect each other may be applied concurrently
   else {
-    weed_plant_t *gui;
-    for (i = 0; i < FX_KEYS_MAX_VIRTUAL; i++) {
-      if (rte_key_valid(i + 1, TRUE)) {
-        if (!(rte_key_is_enabled(1 + i))) {
-          // if anything is connected to ACTIVATE, the fx may be activated
-          pconx_chain_data(i, key_modes[i], FALSE);
-        }
-        if (rte_key_is_enabled(1 + i)) {
-          mainw->osc_block = TRUE;
-          if ((instance = weed_instance_obtain(i, key_modes[i])) == NULL) {
-            mainw->osc_block = FALSE;
-            continue;
-          }
-          filter = weed_instance_get_filter(instance, TRUE);
-
-          if (is_pure_audio(filter, TRUE)) {
-            weed_instance_unref(instance);
-            continue;
-          }
-          gui = weed_instance_get_gui(instance, FALSE);
-          if (weed_get_int_value(gui, WEED_LEAF_EASE_OUT, NULL) > 0) {
-            // if the plugin is easing out, check if it finished
-            if (!weed_plant_has_leaf(instance, WEED_LEAF_AUTO_EASING)) { // if auto_Easing then we'll deinit it on the event_list
-              if (!weed_get_int_value(gui, WEED_LEAF_EASE_OUT_FRAMES, NULL)) {
-                // easing finished, deinit it
-                uint64_t new_rte = GU641 << (i);
-                // record
-                if (init_events[i]) {
-                  // if we are recording, mark the number of frames to ease out
-                  // we'll need to repeat the same process during preview / rendering
-                  // - when we hit the init_event, we'll find the deinit, then work back x frames and mark easing start
-                  weed_set_int_value(init_events[i], WEED_LEAF_EASE_OUT,
-                                     weed_get_int_value(instance, WEED_LEAF_EASE_OUT, NULL));
-                }
-                weed_instance_unref(instance);
-                filter_mutex_lock(i);
-                weed_deinit_effect(i);
-                if (mainw->rte & new_rte) {
-                  mainw->rte ^= new_rte;
-                  if (rte_window) rtew_set_keych(i, FALSE);
-                  if (mainw->ce_thumbs) ce_thumbs_set_keych(i, FALSE);
-                }
-                filter_mutex_unlock(i);
-                continue;
-		// *INDENT-OFF*
-              }}}
-	  // *INDENT-ON*
-
-          if (mainw->pchains && mainw->pchains[i]) {
-            if (!filter_mutex_trylock(i)) {
-              interpolate_params(instance, mainw->pchains[i], tc); // interpolate parameters during preview
-              filter_mutex_unlock(i);
-            }
-          }
-          //filter = weed_instance_get_filter(instance, TRUE);
-
-          // TODO *** enable this, and apply pconx to audio gens in audio.c
-          if (!is_pure_audio(filter, TRUE)) {
-            if (mainw->pconx && !(mainw->preview || mainw->is_rendering)) {
-              // chain any data pipelines
-              needs_reinit = pconx_chain_data(i, key_modes[i], FALSE);
-
-              // if anything is connected to ACTIVATE, the fx may be activated
-              if ((instance2 = weed_instance_obtain(i, key_modes[i])) == NULL) {
-                weed_instance_unref(instance);
-                continue;
-              }
-              weed_instance_unref(instance);
-              instance = instance2;
-              if (needs_reinit) {
-                if ((filter_error = weed_reinit_effect(instance, FALSE)) == FILTER_ERROR_COULD_NOT_REINIT) {
-                  weed_instance_unref(instance);
-                  continue;
-		// *INDENT-OFF*
-                }}}}
-	  // *INDENT-ON*
-
-          orig_inst = instance;
-
-apply_inst3:
-
-          if (weed_plant_has_leaf(instance, WEED_LEAF_HOST_NEXT_INSTANCE)) {
-            // chain any internal data pipelines for compound fx
-            needs_reinit = pconx_chain_data_internal(instance);
-            if (needs_reinit) {
-              if ((filter_error = weed_reinit_effect(instance, FALSE)) == FILTER_ERROR_COULD_NOT_REINIT) {
-                weed_instance_unref(instance);
-                continue;
-		// *INDENT-OFF*
-              }}}
-	  // *INDENT-ON*
-
-          filter_error = weed_apply_instance(instance, NULL, layers, opwidth, opheight, tc);
-
-          if (easeval > 0 && !weed_plant_has_leaf(orig_inst, WEED_LEAF_AUTO_EASING)) {
-            // if the plugin is supposed to be easing out, make sure it is really
-            weed_plant_t *gui = weed_instance_get_gui(orig_inst, FALSE);
-            if (gui) {
-              int xeaseval = weed_get_int_value(gui, WEED_LEAF_EASE_OUT_FRAMES, NULL), myeaseval;
-              myeaseval = weed_get_int_value(instance, WEED_LEAF_HOST_EASE_OUT_COUNT, NULL);
-              if (xeaseval > myeaseval) {
-                uint64_t new_rte = GU641 << (i);
-                filter_mutex_lock(i);
-                weed_instance_unref(orig_inst);
-                if (mainw->rte & new_rte) {
-                  mainw->rte ^= new_rte;
-                  if (rte_window) rtew_set_keych(i, FALSE);
-                  if (mainw->ce_thumbs) ce_thumbs_set_keych(i, FALSE);
-                }
-                weed_deinit_effect(i);
-                filter_mutex_unlock(i);
-                continue;
-              }
-              // count how many frames to ease out
-              weed_set_int_value(instance, WEED_LEAF_HOST_EASE_OUT_COUNT,
-                                 weed_get_int_value(instance, WEED_LEAF_HOST_EASE_OUT_COUNT, NULL) + 1);
-            }
-          }
-          if (filter_error == FILTER_ERROR_NEEDS_REINIT) {
-            // TODO...
-          }
-          if (filter_error == FILTER_INFO_REINITED)
-            update_widget_vis(NULL, i, key_modes[i]);
-          //#define DEBUG_RTE
-#ifdef DEBUG_RTE
-          if (filter_error != FILTER_SUCCESS) lives_printerr("Render error was %d\n", filter_error);
-#endif
-          if (filter_error == FILTER_SUCCESS && (instance = get_next_compound_inst(instance))) goto apply_inst3;
-
-          if (mainw->pconx && (filter_error == FILTER_SUCCESS || filter_error == FILTER_INFO_REINITED
-                               || filter_error == FILTER_INFO_REDRAWN)) {
-            pconx_chain_data_omc(orig_inst, i, key_modes[i]);
-          }
-          weed_instance_unref(orig_inst);
-	  // *INDENT-OFF*
-        }}}}
-  // *INDENT-ON*
+    rte_schedule_t sched;
+    ticks_t start = lives_get_current_ticks();
+    rte_sched_get(&sched);
+    for (i = 0; i < sched.nstages; i++) {
+      apply_rte_stage(sched.keys + sched.stage_start[i], sched.stage_start[i + 1] - sched.stage_start[i],
+                      layers, opwidth, opheight, tc);
+    }
+    fx_prof_adapt(lives_get_current_ticks() - start);
+    rte_gui_flush();
+  }
 
   // TODO - set mainw->vpp->play_params from connected out params and out alphas
 
@@ -6149,6 +6752,7 @@ static void weed_parameters_free(weed_plant_t *inst) {
 
 
 static void lives_free_instance(weed_plant_t *inst) {
+  slice_shadows_free(inst);
   weed_channels_free(inst);
   weed_parameters_free(inst);
   weed_plant_free(inst);
@@ -7086,6 +7690,8 @@ weed_error_t weed_call_deinit_func(weed_plant_t *instance) {
     }
   }
   weed_set_boolean_value(instance, WEED_LEAF_HOST_INITED, WEED_FALSE);
+  // the plugin may set new leaves in the instance when it is next inited
+  slice_shadows_free(instance);
   weed_instance_unref(instance);
   return error;
 }
@@ -7866,7 +8472,7 @@ matchvals:
 procfunc1:
   // cannot lock the filter here as we may be multithreading
   if (filter_flags & WEED_FILTER_HINT_MAY_THREAD) {
-    retval = process_func_threaded(inst, tc);
+    retval = process_func_threaded(inst, tc, NULL, NULL);
     if (retval != FILTER_ERROR_DONT_THREAD) did_thread = TRUE;
   }
   if (!did_thread) {
@@ -10184,6 +10790,29 @@ static char *get_default_element_string(weed_plant_t *param, int idx) {
 }
 
 
+/// interpolation cursors: each thread remembers, per param, the last pchange at or before the previous timecode
+/// it interpolated, so that playing or rendering forwards only walks the changes since the last frame.
+/// A cursor is only used for the same pchain, in the same pchange epoch (see events.c) and for a timecode no earlier
+/// than its own; anything else (e.g. a seek backwards) restarts from the head of the chain.
+#define INTERP_CURSORS 256 ///< must be a power of 2
+#define INTERP_STACK_VALUES 16 ///< params with up to this many values need no heap allocation for interpolation
+
+typedef struct {
+  weed_plant_t *param;
+  void *pchain;
+  weed_plant_t *last_pchange;
+  weed_timecode_t tc;
+  uint64_t epoch;
+} interp_cursor_t;
+
+static __thread interp_cursor_t interp_cursors[INTERP_CURSORS];
+
+LIVES_LOCAL_INLINE interp_cursor_t *interp_cursor_for(weed_plant_t *param) {
+  uintptr_t h = (uintptr_t)param;
+  return &interp_cursors[((h >> 4) ^ (h >> 12)) & (INTERP_CURSORS - 1)];
+}
+
+
 boolean interpolate_param(weed_plant_t *param, void *pchain, weed_timecode_t tc) {
   // return FALSE if param has no "value"
   // - this can happen during realtime audio processing, if the effect is inited, but no "value" has been set yet
@@ -10191,7 +10820,12 @@ boolean interpolate_param(weed_plant_t *param, void *pchain, weed_timecode_t tc)
 
   weed_plant_t *pchange = (weed_plant_t *)pchain, *last_pchange = NULL;
   weed_plant_t *wtmpl;
+  interp_cursor_t *cursor;
   weed_timecode_t tc_diff = 0, tc_diff2;
+  uint64_t epoch;
+  void *lpcbuf[INTERP_STACK_VALUES], *npcbuf[INTERP_STACK_VALUES];
+  double valdbuf[INTERP_STACK_VALUES];
+  int valibuf[INTERP_STACK_VALUES];
   void **lpc, **npc;
   char **valss, **nvalss;
   double *last_valuesd, *next_valuesd;
@@ -10208,23 +10842,45 @@ boolean interpolate_param(weed_plant_t *param, void *pchain, weed_timecode_t tc)
   if ((num_values = weed_leaf_num_elements(param, WEED_LEAF_VALUE)) == 0) return FALSE;
   if (weed_param_value_irrelevant(param)) return TRUE;
 
+  cursor = interp_cursor_for(param);
+  epoch = get_pchange_epoch();
+  if (cursor->param == param && cursor->pchain == pchain && cursor->epoch == epoch && cursor->last_pchange
+      && tc >= cursor->tc && get_event_timecode(cursor->last_pchange) <= tc) {
+    last_pchange = cursor->last_pchange;
+    pchange = (weed_plant_t *)weed_get_voidptr_value(last_pchange, WEED_LEAF_NEXT_CHANGE, NULL);
+  }
+
   while (pchange && get_event_timecode(pchange) <= tc) {
     last_pchange = pchange;
     pchange = (weed_plant_t *)weed_get_voidptr_value(pchange, WEED_LEAF_NEXT_CHANGE, NULL);
   }
 
+  cursor->param = param;
+  cursor->pchain = pchain;
+  cursor->last_pchange = last_pchange;
+  cursor->tc = tc;
+  cursor->epoch = epoch;
+
   wtmpl = weed_param_get_template(param);
 
   if ((num_pvals = weed_leaf_num_elements((weed_plant_t *)pchain, WEED_LEAF_VALUE)) > num_values)
     num_values = num_pvals; // init a multivalued param
 
-  lpc = (void **)lives_calloc(num_values, sizeof(void *));
-  npc = (void **)lives_calloc(num_values, sizeof(void *));
+  if (num_values <= INTERP_STACK_VALUES) {
+    lpc = lpcbuf;
+    npc = npcbuf;
+    lives_memset(lpc, 0, num_values * sizeof(void *));
+    lives_memset(npc, 0, num_values * sizeof(void *));
+  } else {
+    lpc = (void **)lives_calloc(num_values, sizeof(void *));
+    npc = (void **)lives_calloc(num_values, sizeof(void *));
+  }
 
   if (num_values == 1) {
     lpc[0] = last_pchange;
     npc[0] = pchange;
   } else {
+    // elements may ignore some changes, so we need the whole chain up to tc
     pchange = (weed_plant_t *)pchain;
 
     while (pchange) {
@@ -10253,16 +10909,20 @@ boolean interpolate_param(weed_plant_t *param, void *pchain, weed_timecode_t tc)
     }
   }
 
+#define INTERP_VALDS() (num_values <= INTERP_STACK_VALUES ? valdbuf : (double *)lives_malloc(num_values * (sizeof(double))))
+#define INTERP_VALIS() (num_values <= INTERP_STACK_VALUES ? valibuf : (int *)lives_malloc(num_values * sizint))
+
   ptype = weed_paramtmpl_get_type(wtmpl);
   switch (ptype) {
   case WEED_PARAM_FLOAT:
-    valds = (double *)lives_malloc(num_values * (sizeof(double)));
+    valds = INTERP_VALDS();
     break;
   case WEED_PARAM_COLOR:
+    // colours index their values by triplet / quad, so they always get a heap buffer
     cspace = weed_get_int_value(wtmpl, WEED_LEAF_COLORSPACE, NULL);
     switch (cspace) {
     case WEED_COLORSPACE_RGB:
-      if (!(num_values & 3)) return TRUE;
+      if (!(num_values & 3)) goto interp_done;
       if (weed_leaf_seed_type(wtmpl, WEED_LEAF_DEFAULT) == WEED_SEED_INT) {
         valis = (int *)lives_malloc(num_values * sizint);
       } else {
@@ -10270,7 +10930,7 @@ boolean interpolate_param(weed_plant_t *param, void *pchain, weed_timecode_t tc)
       }
       break;
     case WEED_COLORSPACE_RGBA:
-      if (num_values & 3) return TRUE;
+      if (num_values & 3) goto interp_done;
       if (weed_leaf_seed_type(wtmpl, WEED_LEAF_DEFAULT) == WEED_SEED_INT) {
         valis = (int *)lives_malloc(num_values * sizint);
       } else {
@@ -10281,7 +10941,7 @@ boolean interpolate_param(weed_plant_t *param, void *pchain, weed_timecode_t tc)
     break;
   case WEED_PARAM_SWITCH:
   case WEED_PARAM_INTEGER:
-    valis = (int *)lives_malloc(num_values * sizint);
+    valis = INTERP_VALIS();
     break;
   }
 
@@ -10644,36 +11304,37 @@ boolean interpolate_param(weed_plant_t *param, void *pchain, weed_timecode_t tc)
   switch (ptype) {
   case WEED_PARAM_FLOAT:
     weed_set_double_array(param, WEED_LEAF_VALUE, num_values, valds);
-    lives_free(valds);
     break;
   case WEED_PARAM_COLOR:
     switch (cspace) {
     case WEED_COLORSPACE_RGB:
       if (weed_leaf_seed_type(wtmpl, WEED_LEAF_DEFAULT) == WEED_SEED_INT) {
         weed_set_int_array(param, WEED_LEAF_VALUE, num_values, valis);
-        lives_free(valis);
       } else {
         weed_set_double_array(param, WEED_LEAF_VALUE, num_values, valds);
-        lives_free(valds);
       }
       break;
     }
     break;
   case WEED_PARAM_INTEGER:
     weed_set_int_array(param, WEED_LEAF_VALUE, num_values, valis);
-    lives_free(valis);
     break;
   case WEED_PARAM_SWITCH:
     weed_set_boolean_array(param, WEED_LEAF_VALUE, num_values, valis);
-    lives_free(valis);
     break;
   }
 
-  lives_free(npc);
-  lives_free(lpc);
+interp_done:
+  if (valds != valdbuf) lives_freep((void **)&valds);
+  if (valis != valibuf) lives_freep((void **)&valis);
+  if (npc != npcbuf) lives_free(npc);
+  if (lpc != lpcbuf) lives_free(lpc);
   return TRUE;
 }
 
+#undef INTERP_VALDS
+#undef INTERP_VALIS
+
 /**
    @brief
 
@@ -11017,6 +11678,218 @@ weed_plant_t *get_weed_filter(int idx) {
 }
 
 
+/// serialisation output; with fd < 0 (and mem == NULL) nothing is written and only the size is counted
+LIVES_LOCAL_INLINE void ser_write(int fd, const void *buf, size_t count, boolean allow_fail) {
+  if (fd >= 0) lives_write_buffered(fd, (const char *)buf, count, allow_fail);
+}
+
+LIVES_LOCAL_INLINE void ser_write_le(int fd, const void *buf, size_t count, boolean allow_fail) {
+  if (fd >= 0) lives_write_le_buffered(fd, buf, count, allow_fail);
+}
+
+
+/// one band of pixel data, for the banded (compressed) serialisation format
+typedef struct {
+  uint8_t *data; ///< raw data: input when encoding, output when decoding
+  const uint8_t *cdata; ///< stored data when decoding
+  uint8_t *out; ///< space for the encoded data (at least len bytes), or NULL to store raw
+  size_t len; ///< raw size
+  size_t clen; ///< stored size
+  int codec;
+  int stride; ///< delta filter distance
+  boolean ok;
+} pixdata_band_t;
+
+
+static int pixdata_filter_stride(int pal, int nplanes) {
+  // for the delta filter: distance in bytes between the same channel in neighbouring pixels, or 0 for no filtering
+  size_t psize;
+  if (weed_palette_is_float(pal)) return 0;
+  if (nplanes > 1) return 1;
+  psize = pixel_size(pal);
+  return psize <= 8 ? (int)psize : 0;
+}
+
+
+static void *pixdata_band_encode(void *arg) {
+  pixdata_band_t *band = (pixdata_band_t *)arg;
+  const uint8_t *src = band->data;
+  uint8_t *tmp = NULL;
+
+  band->codec = PIXDATA_CODEC_RAW;
+  band->clen = band->len;
+  if (!band->out || band->len < 2) return NULL;
+
+  if (band->stride > 0 && band->len > (size_t)band->stride
+      && (tmp = (uint8_t *)lives_malloc(band->len))) {
+    size_t stride = band->stride;
+    lives_memcpy(tmp, src, stride);
+    for (size_t i = stride; i < band->len; i++) tmp[i] = src[i] - src[i - stride];
+    src = tmp;
+  }
+
+  // only keep the result if it is smaller than the raw data
+  if ((band->clen = lives_lz_compress(src, band->len, band->out, band->len - 1)) > 0)
+    band->codec = tmp ? PIXDATA_CODEC_DELTA_LZ : PIXDATA_CODEC_LZ;
+  else band->clen = band->len;
+
+  lives_freep((void **)&tmp);
+  return NULL;
+}
+
+
+static void *pixdata_band_decode(void *arg) {
+  pixdata_band_t *band = (pixdata_band_t *)arg;
+  band->ok = FALSE;
+
+  switch (band->codec) {
+  case PIXDATA_CODEC_RAW:
+    if (band->clen != band->len) return NULL;
+    lives_memcpy(band->data, band->cdata, band->len);
+    break;
+  case PIXDATA_CODEC_LZ:
+  case PIXDATA_CODEC_DELTA_LZ:
+    if (lives_lz_decompress(band->cdata, band->clen, band->data, band->len) != (ssize_t)band->len) return NULL;
+    if (band->codec == PIXDATA_CODEC_DELTA_LZ) {
+      size_t stride = band->stride;
+      if (!stride) return NULL;
+      for (size_t i = stride; i < band->len; i++) band->data[i] += band->data[i - stride];
+    }
+    break;
+  default:
+    return NULL;
+  }
+  band->ok = TRUE;
+  return NULL;
+}
+
+
+static void pixdata_run_bands(pixdata_band_t *bands, int nbands, lives_funcptr_t func) {
+  // run func on all bands, spreading them over the thread pool
+  lives_thread_t *threads = NULL;
+  int i;
+  if (nbands > 1) threads = (lives_thread_t *)lives_calloc(nbands - 1, sizeof(lives_thread_t));
+  for (i = 0; i < nbands - 1; i++) {
+    if (threads) lives_thread_create(&threads[i], LIVES_THRDATTR_INLINE_OK, func, &bands[i]);
+    else (*func)(&bands[i]);
+  }
+  (*func)(&bands[nbands - 1]);
+  if (threads) {
+    for (i = 0; i < nbands - 1; i++) lives_thread_join(threads[i], NULL);
+    lives_free(threads);
+  }
+}
+
+
+static size_t pixdata_serialise_bands(int fd, int pal, int nplanes, uint8_t **pixel_data, size_t *vlens) {
+  // write pixel data in banded form: each plane is cut into bands of about PIXDATA_BAND_BYTES, which are compressed
+  // in parallel; any band which does not compress is stored raw. Returns the number of bytes written.
+  pixdata_band_t pbands[4], *bands;
+  uint8_t *out = NULL;
+  size_t totsize = 8, tot = 0, offs = 0;
+  int stride = pixdata_filter_stride(pal, nplanes);
+  int nbands = 0, b = 0, nb, i, j;
+
+  for (j = 0; j < nplanes; j++) {
+    tot += vlens[j];
+    nbands += vlens[j] ? (vlens[j] + PIXDATA_BAND_BYTES - 1) / PIXDATA_BAND_BYTES : 1;
+  }
+
+  if (!(bands = (pixdata_band_t *)lives_calloc(nbands, sizeof(pixdata_band_t)))) {
+    // out of memory, store one raw band per plane
+    bands = pbands;
+    lives_memset(pbands, 0, sizeof(pbands));
+    nbands = nplanes;
+  } else out = (uint8_t *)lives_malloc(tot ? tot : 1);
+
+  for (j = 0; j < nplanes; j++) {
+    size_t bsize, poffs = 0;
+    if (bands == pbands || !vlens[j]) nb = 1;
+    else nb = (vlens[j] + PIXDATA_BAND_BYTES - 1) / PIXDATA_BAND_BYTES;
+    bsize = (vlens[j] + nb - 1) / nb;
+    for (i = 0; i < nb; i++, b++) {
+      bands[b].data = pixel_data[j] + poffs;
+      bands[b].len = poffs + bsize > vlens[j] ? vlens[j] - poffs : bsize;
+      bands[b].out = out ? out + offs : NULL;
+      bands[b].stride = stride;
+      poffs += bands[b].len;
+      offs += bands[b].len;
+    }
+  }
+
+  pixdata_run_bands(bands, nbands, pixdata_band_encode);
+
+  ser_write_le(fd, &stride, 4, TRUE);
+  ser_write_le(fd, &nbands, 4, TRUE);
+  for (b = 0; b < nbands; b++) {
+    uint64_t len = bands[b].len, clen = bands[b].clen;
+    ser_write_le(fd, &bands[b].codec, 4, TRUE);
+    ser_write_le(fd, &len, 8, TRUE);
+    ser_write_le(fd, &clen, 8, TRUE);
+    totsize += 20;
+  }
+  for (b = 0; b < nbands; b++) {
+    if (bands[b].codec == PIXDATA_CODEC_RAW) ser_write(fd, bands[b].data, bands[b].len, TRUE);
+    else ser_write(fd, bands[b].out, bands[b].clen, TRUE);
+    totsize += bands[b].clen;
+  }
+
+  lives_freep((void **)&out);
+  if (bands != pbands) lives_free(bands);
+  return totsize;
+}
+
+
+static boolean pixdata_deserialise_bands(int fd, uint8_t *dst, uint64_t dsize) {
+  // read pixel data written by pixdata_serialise_bands() into dst, which has space for dsize bytes
+  pixdata_band_t *bands;
+  const uint8_t *cdata;
+  uint64_t len, clen, tot = 0, ctot = 0;
+  boolean ok = TRUE;
+  int stride, nbands, b;
+
+  if (lives_read_le_buffered(fd, &stride, 4, TRUE) < 4) return FALSE;
+  if (lives_read_le_buffered(fd, &nbands, 4, TRUE) < 4) return FALSE;
+  if (stride < 0 || nbands < 1 || nbands > PIXDATA_MAX_BANDS) return FALSE;
+
+  bands = (pixdata_band_t *)lives_calloc(nbands, sizeof(pixdata_band_t));
+  if (!bands) return FALSE;
+
+  for (b = 0; b < nbands; b++) {
+    if (lives_read_le_buffered(fd, &bands[b].codec, 4, TRUE) < 4
+        || lives_read_le_buffered(fd, &len, 8, TRUE) < 8
+        || lives_read_le_buffered(fd, &clen, 8, TRUE) < 8
+        || len > dsize - tot || clen > MAX_FRAME_SIZE64) {
+      lives_free(bands);
+      return FALSE;
+    }
+    bands[b].data = dst + tot;
+    bands[b].len = len;
+    bands[b].clen = clen;
+    bands[b].stride = stride;
+    tot += len;
+    ctot += clen;
+  }
+
+  if (tot != dsize || ctot > MAX_FRAME_SIZE64
+      || lives_read_buffered_borrow(fd, &cdata, ctot) != (ssize_t)ctot) {
+    lives_free(bands);
+    return FALSE;
+  }
+
+  for (b = 0; b < nbands; b++) {
+    bands[b].cdata = cdata;
+    cdata += bands[b].clen;
+  }
+
+  pixdata_run_bands(bands, nbands, pixdata_band_decode);
+
+  for (b = 0; b < nbands; b++) if (!bands[b].ok) ok = FALSE;
+  lives_free(bands);
+  return ok;
+}
+
+
 /**
    @brief serialise a leaf
 
@@ -11033,8 +11906,12 @@ weed_plant_t *get_weed_filter(int idx) {
 
    format is [key_len (4 bytes) | key (key_len bytes)] seed_type (4 bytes) n_elements (4 bytes)
    then for each element: value_size (4 bytes) value
+
+   pixel_data for a layer has its own format (see below); if compress is set, it is written in the banded format,
+   which allows the data to be compressed.
 */
-static size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key, boolean write_all, unsigned char **mem) {
+static size_t _weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key, boolean write_all, unsigned char **mem,
+                                   boolean compress) {
   void *value = NULL, *valuer = NULL;
 
   size_t totsize = 0;
@@ -11050,8 +11927,8 @@ static size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key,
   if (write_all) {
     // write byte length of key, followed by key in utf-8
     if (!mem) {
-      lives_write_le_buffered(fd, &keylen, 4, TRUE);
-      lives_write_buffered(fd, key, (size_t)keylen, TRUE);
+      ser_write_le(fd, &keylen, 4, TRUE);
+      ser_write(fd, key, (size_t)keylen, TRUE);
     } else {
       lives_memcpy(*mem, &keylen, 4);
       *mem += 4;
@@ -11065,13 +11942,13 @@ static size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key,
   st = weed_leaf_seed_type(plant, key);
   if (!mem && st == WEED_SEED_PLANTPTR) st = WEED_SEED_VOIDPTR;
 
-  if (!mem) lives_write_le_buffered(fd, &st, 4, TRUE);
+  if (!mem) ser_write_le(fd, &st, 4, TRUE);
   else {
     lives_memcpy(*mem, &st, 4);
     *mem += 4;
   }
   ne = weed_leaf_num_elements(plant, key);
-  if (!mem) lives_write_le_buffered(fd, &ne, 4, TRUE);
+  if (!mem) ser_write_le(fd, &ne, 4, TRUE);
   else {
     lives_memcpy(*mem, &ne, 4);
     *mem += 4;
@@ -11092,6 +11969,8 @@ static size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key,
     boolean contig = FALSE;
     size_t padding = 0;
     size_t pdsize = 0;
+    size_t *vlens = (size_t *)lives_calloc(nplanes, sizeof(size_t));
+    uint64_t vlen64;
 
     uint8_t **pixel_data = (uint8_t **)weed_layer_get_pixel_data(layer, NULL);
     /// new style: we will write 4 bytes 0, then possibly further padding bytes,
@@ -11100,41 +11979,49 @@ static size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key,
     /// width is in macropixel size - for UYVY and YUYV each macropixel is 4 bytes and maps to 2 screen pixels
     /// then for each plane: rowstride 4 bytes, data size 8 bytes (the data size is plane height * rowstride + padding)
     /// finally the pixel data
-    lives_write_le_buffered(fd, &ival, 4, TRUE);
-    ival = 0x44454557;
-    lives_write_le_buffered(fd, &ival, 4, TRUE);
-    ival = 1; /// version
-    lives_write_le_buffered(fd, &ival, 4, TRUE);
-    lives_write_le_buffered(fd, &nplanes, 4, TRUE);
-    lives_write_le_buffered(fd, &pal, 4, TRUE);
-    lives_write_le_buffered(fd, &width, 4, TRUE);
-    lives_write_le_buffered(fd, &height, 4, TRUE);
+    ///
+    /// version 2 (PIXDATA_SER_VERSION_BANDS) replaces the pixel data with: 4 bytes delta filter stride, 4 bytes nbands,
+    /// then for each band: 4 bytes codec (PIXDATA_CODEC_*), 8 bytes data size, 8 bytes stored size; then the stored data
+    /// for each band. Bands follow each other through the planes in order, and no band spans two planes.
+    ser_write_le(fd, &ival, 4, TRUE);
+    ival = PIXDATA_SER_ID;
+    ser_write_le(fd, &ival, 4, TRUE);
+    ival = compress ? PIXDATA_SER_VERSION_BANDS : PIXDATA_SER_VERSION_RAW;
+    ser_write_le(fd, &ival, 4, TRUE);
+    ser_write_le(fd, &nplanes, 4, TRUE);
+    ser_write_le(fd, &pal, 4, TRUE);
+    ser_write_le(fd, &width, 4, TRUE);
+    ser_write_le(fd, &height, 4, TRUE);
 
     totsize += 28;
 
     if (weed_get_boolean_value(layer, WEED_LEAF_HOST_PIXEL_DATA_CONTIGUOUS, NULL) == WEED_TRUE) {
       contig = TRUE;
     }
-    padding = 0;
     for (j = 0; j < nplanes; j++) {
-      vlen = (weed_size_t)((double)height * weed_palette_get_plane_ratio_vertical(pal, j) * (double)rowstrides[j]);
-      if (contig && j < nplanes - 1) padding = pixel_data[j + 1] - pixel_data[j] - vlen;
-      vlen += padding;
-      lives_write_le_buffered(fd, &rowstrides[j], 4, TRUE);
-      lives_write_le_buffered(fd, &vlen, 8, TRUE);
-      pdsize += vlen;
+      vlen64 = (uint64_t)((double)height * weed_palette_get_plane_ratio_vertical(pal, j) * (double)rowstrides[j]);
+      padding = 0;
+      if (contig && j < nplanes - 1) padding = pixel_data[j + 1] - pixel_data[j] - vlen64;
+      vlen64 += padding;
+      ser_write_le(fd, &rowstrides[j], 4, TRUE);
+      ser_write_le(fd, &vlen64, 8, TRUE);
+      vlens[j] = vlen64;
+      pdsize += vlen64;
       totsize += 12;
     }
-    if (!contig) {
+    if (compress) {
+      totsize += pixdata_serialise_bands(fd, pal, nplanes, pixel_data, vlens);
+    } else if (!contig) {
       for (j = 0; j < nplanes; j++) {
         vlen = (weed_size_t)((double)height * weed_palette_get_plane_ratio_vertical(pal, j) * (double)rowstrides[j]);
-        lives_write_buffered(fd, (const char *)pixel_data[j], vlen, TRUE);
+        ser_write(fd, pixel_data[j], vlen, TRUE);
         totsize += vlen;
       }
     } else {
-      lives_write_buffered(fd, (const char *)pixel_data[0], pdsize, TRUE);
+      ser_write(fd, pixel_data[0], pdsize, TRUE);
       totsize += pdsize;
     }
+    lives_free(vlens);
     lives_free(rowstrides);
     lives_free(pixel_data);
   } else {
@@ -11171,10 +12058,10 @@ static size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key,
       } else valuer = value;
 
       if (!mem) {
-        lives_write_le_buffered(fd, &vlen, 4, TRUE);
+        ser_write_le(fd, &vlen, 4, TRUE);
         if (st != WEED_SEED_STRING) {
-          lives_write_le_buffered(fd, valuer, (size_t)vlen, TRUE);
-        } else lives_write_buffered(fd, (const char *)valuer, (size_t)vlen, TRUE);
+          ser_write_le(fd, valuer, (size_t)vlen, TRUE);
+        } else ser_write(fd, valuer, (size_t)vlen, TRUE);
       } else {
         lives_memcpy(*mem, &vlen, 4);
         *mem += 4;
@@ -11194,8 +12081,13 @@ static size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key,
   return totsize;
 }
 
+LIVES_LOCAL_INLINE size_t weed_leaf_serialise(int fd, weed_plant_t *plant, const char *key, boolean write_all,
+    unsigned char **mem) {
+  return _weed_leaf_serialise(fd, plant, key, write_all, mem, FALSE);
+}
 
-size_t weed_plant_serialise(int fd, weed_plant_t *plant, unsigned char **mem) {
+
+static size_t _weed_plant_serialise(int fd, weed_plant_t *plant, unsigned char **mem, boolean compress) {
   // serialise an entire plant
   //
   // write errors should be checked for by the calling function
@@ -11211,7 +12103,7 @@ size_t weed_plant_serialise(int fd, weed_plant_t *plant, unsigned char **mem) {
 
   if (WEED_IS_LAYER(plant)) pd_needed = 1;
 
-  if (!mem) lives_write_le_buffered(fd, &i, 4, TRUE); // write number of leaves
+  if (!mem) ser_write_le(fd, &i, 4, TRUE); // write number of leaves
   else {
     lives_memcpy(*mem, &i, 4);
     *mem += 4;
@@ -11241,14 +12133,14 @@ size_t weed_plant_serialise(int fd, weed_plant_t *plant, unsigned char **mem) {
           if (++pd_reqs == 4 && pd_needed > 1) {
             totsize += weed_leaf_serialise(fd, plant, prop, TRUE, mem);
             lives_free(prop);
-            totsize += weed_leaf_serialise(fd, plant, WEED_LEAF_PIXEL_DATA, TRUE, mem);
+            totsize += _weed_leaf_serialise(fd, plant, WEED_LEAF_PIXEL_DATA, TRUE, mem, compress);
             pd_needed  = 0;
             continue;
 	    // *INDENT-OFF*
 	  }}}}
     // *INDENT-ON*
 
-    totsize += weed_leaf_serialise(fd, plant, prop, TRUE, mem);
+    totsize += _weed_leaf_serialise(fd, plant, prop, TRUE, mem, compress);
     lives_free(prop);
   }
   lives_freep((void **)&proplist);
@@ -11256,6 +12148,24 @@ size_t weed_plant_serialise(int fd, weed_plant_t *plant, unsigned char **mem) {
 }
 
 
+LIVES_GLOBAL_INLINE size_t weed_plant_serialise(int fd, weed_plant_t *plant, unsigned char **mem) {
+  return _weed_plant_serialise(fd, plant, mem, FALSE);
+}
+
+
+/// serialise a layer to fd, with the pixel data compressed (see _weed_leaf_serialise()); the layer is read back
+/// by weed_plant_deserialise() as usual. Returns the number of bytes written.
+LIVES_GLOBAL_INLINE size_t weed_layer_serialise_compressed(int fd, weed_layer_t *layer) {
+  return _weed_plant_serialise(fd, layer, NULL, TRUE);
+}
+
+
+/// returns the number of bytes weed_plant_serialise() would write for plant, without writing anything
+LIVES_GLOBAL_INLINE size_t weed_plant_serialised_size(weed_plant_t *plant) {
+  return weed_plant_serialise(-1, plant, NULL);
+}
+
+
 static int32_t weed_plant_mutate(weed_plantptr_t plant, int32_t newtype) {
   // beware of mutant plants....
   int32_t flags = weed_leaf_get_flags(plant, WEED_LEAF_TYPE);
@@ -11345,7 +12255,7 @@ static int weed_leaf_deserialise(int fd, weed_plant_t *plant, const char *key, u
   weed_size_t len;
   weed_size_t vlen;
   //weed_size_t vlen64;
-  weed_size_t vlen64_tot = 0;
+  uint64_t vlen64_tot = 0;
 
   char *mykey = NULL;
   char *msg;
@@ -11502,15 +12412,26 @@ static int weed_leaf_deserialise(int fd, weed_plant_t *plant, const char *key, u
       if (j == 0 && vlen == 0) {
         int id;
         bytes = lives_read_le_buffered(fd, &id, 4, TRUE);
-        if (id == 0x44454557) {
+        if (id == PIXDATA_SER_ID) {
           weed_layer_t *layer = (weed_layer_t *)plant;
           int ver;
-          uint64_t *vlen64 = lives_calloc(nplanes, 8);
-          //size_t vlen64_tot = 0;
-          int *rs = lives_calloc(nplanes, sizint);
+          uint64_t *vlen64;
+          int *rs;
+          boolean ok;
 
           bytes = lives_read_le_buffered(fd, &ver, 4, TRUE);
+          if (ver != PIXDATA_SER_VERSION_RAW && ver != PIXDATA_SER_VERSION_BANDS) {
+            /// written by a newer version, we cannot know the layout
+            lives_freep((void **)&values);
+            type = -12;
+            goto done;
+          }
           bytes = lives_read_le_buffered(fd, &nplanes, 4, TRUE);
+          if (nplanes < 1 || nplanes > ne) {
+            lives_freep((void **)&values);
+            type = -11;
+            goto done;
+          }
           bytes = lives_read_le_buffered(fd, &pal, 4, TRUE);
           weed_layer_set_palette(layer, pal);
           bytes = lives_read_le_buffered(fd, &width, 4, TRUE);
@@ -11548,7 +12469,10 @@ static int weed_leaf_deserialise(int fd, weed_plant_t *plant, const char *key, u
             goto done;
           }
 
-          if (lives_read_buffered(fd, values[0], vlen64_tot, TRUE) != vlen64_tot) {
+          if (ver == PIXDATA_SER_VERSION_BANDS) ok = pixdata_deserialise_bands(fd, values[0], vlen64_tot);
+          else ok = lives_read_buffered(fd, values[0], vlen64_tot, TRUE) == (ssize_t)vlen64_tot;
+
+          if (!ok) {
             ///// do something
             lives_free(values[0]);
             lives_free(values);
@@ -11558,7 +12482,7 @@ static int weed_leaf_deserialise(int fd, weed_plant_t *plant, const char *key, u
             goto done;
           }
           for (i = 1; i < nplanes; i++) {
-            values[i] = values[i - 1] + vlen64[i];
+            values[i] = values[i - 1] + vlen64[i - 1];
           }
           if (nplanes > 1)
             weed_set_boolean_value(plant, WEED_LEAF_HOST_PIXEL_DATA_CONTIGUOUS, WEED_TRUE);
@@ -85,7 +85,9 @@ typedef enum {
 
 #define WEED_LEAF_FREED_PLANTS "host_freed_plants" // list of freed pointers to avoid freeing dupes during unload
 
-#define WEED_LEAF_HOST_SCRAP_FILE_OFFSET "scrap_offset" // special value for scrap_file
+/// no longer written; scrap frames are found by frame number in the scrap file's offset index.
+/// Event lists saved by older versions may still carry it, and it is ignored
+#define WEED_LEAF_HOST_SCRAP_FILE_OFFSET "scrap_offset"
 
 #define WEED_LEAF_HOST_IDENTIFIER "host_unique_id"
 
@@ -93,6 +95,8 @@ typedef enum {
 #define WEED_LEAF_HOST_EASE_OUT_COUNT "host_ease_out_count"
 #define WEED_LEAF_AUTO_EASING "host_auto_easing"
 
+#define WEED_LEAF_HOST_SLICE_SHADOWS "host_slice_shadows" // per slice copies of the instance for threaded processing
+
 #define WEED_LEAF_RFX_STRINGS "layout_rfx_strings"
 #define WEED_LEAF_RFX_DELIM "layout_rfx_delim"
 
@@ -158,6 +162,31 @@ weed_error_t weed_call_init_func(weed_plant_t *instance);
 weed_error_t weed_call_deinit_func(weed_plant_t *instance);
 lives_filter_error_t run_process_func(weed_plant_t *instance, weed_timecode_t tc, int key);
 
+/// per key runtime profile of realtime effects, see fx_prof_get_stats()
+#define FX_PROF_NBUCKETS 16 ///< log2 buckets of process time in usec; bucket 0 is < 2 usec, the last one is open ended
+#define FX_PROF_RING 32 ///< recent per frame costs kept for the adaptive size policy
+
+typedef struct {
+  int mode; ///< mode the stats refer to; they are reset when the key's mode changes
+  uint64_t calls; ///< process_func calls
+  uint64_t proc_usec; ///< total time inside process_func
+  uint64_t max_usec; ///< longest single process_func call
+  uint64_t applies; ///< frames the key was applied to in free playback
+  uint64_t conv_usec; ///< total host time around process_func (palette conversion, resizing, channel setup)
+  uint64_t threaded_calls; ///< calls which were split into slices
+  uint64_t slice_busy_usec; ///< summed run time of all slices
+  uint64_t slice_avail_usec; ///< wall time multiplied by slices, for threaded calls
+  uint64_t hist[FX_PROF_NBUCKETS]; ///< histogram of process_func times
+  uint64_t recent_usec; ///< mean per frame cost over the last FX_PROF_RING frames
+  int scale; ///< processing size, as percent of normal, set by the adaptive policy
+} lives_fx_prof_stats_t;
+
+void fx_prof_get_stats(int key, lives_fx_prof_stats_t *); ///< key is 0 based
+void fx_prof_reset_stats(int key); ///< key is 0 based, -1 resets all keys
+uint64_t fx_prof_percentile(const lives_fx_prof_stats_t *, double pc); ///< upper bound (usec) of the histogram bucket
+void fx_prof_set_adaptive(boolean enable); ///< lower processing size of the slowest keys when frames are late
+boolean fx_prof_get_adaptive(void);
+
 char *cd_to_plugin_dir(weed_plant_t *filter);
 boolean weed_init_effect(int hotkey); ///< hotkey starts at 1
 boolean  weed_deinit_effect(int hotkey); ///< hotkey starts at 1
@@ -199,7 +228,21 @@ int filter_mutex_lock(int key);  // 0 based key
 int filter_mutex_trylock(int key);  // 0 based key
 int filter_mutex_unlock(int key); // 0 based key
 
+/// pixel_data serialisation (see weed_leaf_serialise())
+#define PIXDATA_SER_ID 0x44454557
+#define PIXDATA_SER_VERSION_RAW 1
+#define PIXDATA_SER_VERSION_BANDS 2 ///< data is split into bands, each of which may be compressed
+
+#define PIXDATA_CODEC_RAW 0
+#define PIXDATA_CODEC_LZ 1
+#define PIXDATA_CODEC_DELTA_LZ 2 ///< difference from the same byte of the previous pixel, then LZ
+
+#define PIXDATA_BAND_BYTES (1024 * 1024) ///< bands are encoded and decoded in parallel
+#define PIXDATA_MAX_BANDS 4096
+
 size_t weed_plant_serialise(int fd, weed_plant_t *plant, unsigned char **mem);
+size_t weed_layer_serialise_compressed(int fd, weed_layer_t *layer);
+size_t weed_plant_serialised_size(weed_plant_t *plant);
 weed_plant_t *weed_plant_deserialise(int fd, unsigned char **mem, weed_plant_t *plant);
 
 /// record a parameter value change in our event_list
@@ -25,6 +25,26 @@ static int render_choice;
 static weed_timecode_t last_rec_start_tc = -1;
 static void **pchains[FX_KEYS_MAX]; // each pchain is an array of void *, these are parameter changes used for rendering
 
+/// bumped whenever a frame event is linked, unlinked, freed or retimed in any event_list; frame indexes built
+/// in an earlier epoch are rebuilt before use
+static volatile uint64_t frame_index_epoch = 1;
+
+LIVES_LOCAL_INLINE void frame_index_invalidate(void) {
+  __atomic_add_fetch(&frame_index_epoch, 1, __ATOMIC_RELEASE);
+}
+
+/// bumped whenever a param change event is unlinked, freed or retimed; positions in pchains cached by
+/// interpolate_param() are only reused within the same epoch
+static volatile uint64_t pchange_epoch = 1;
+
+LIVES_GLOBAL_INLINE uint64_t get_pchange_epoch(void) {
+  return __atomic_load_n(&pchange_epoch, __ATOMIC_ACQUIRE);
+}
+
+LIVES_LOCAL_INLINE void pchange_invalidate(void) {
+  __atomic_add_fetch(&pchange_epoch, 1, __ATOMIC_RELEASE);
+}
+
 ///////////////////////////////////////////////////////
 
 //lib stuff
@@ -83,6 +103,10 @@ LIVES_GLOBAL_INLINE int weed_frame_event_get_audio_tracks(weed_event_t *event,
 LIVES_GLOBAL_INLINE weed_timecode_t weed_event_set_timecode(weed_event_t *event, weed_timecode_t tc) {
   weed_timecode_t otc = get_event_timecode(event);
   weed_set_int64_value(event, WEED_LEAF_TIMECODE, tc);
+  if (otc != tc) {
+    if (WEED_EVENT_IS_FRAME(event)) frame_index_invalidate();
+    else if (WEED_EVENT_IS_PARAM_CHANGE(event)) pchange_invalidate();
+  }
   return otc;
 }
 
@@ -125,13 +149,255 @@ LIVES_GLOBAL_INLINE weed_plant_t *get_last_event(weed_plant_t *event_list) {
   return _get_or_zero(event_list, voidptr, WEED_LEAF_LAST);
 }
 
+/////////////////// frame event index //////////////////////////
+
+/// sorted index of the frame events in an event_list, so that timecode lookups can binary search instead of
+/// walking the list. The index is built on first use and updated in place when a frame is appended, inserted
+/// or unlinked via the functions here which know the list; if that update cannot be made, only the index for that
+/// list is dropped. Any other change to the frame events of any list bumps frame_index_epoch, and a stale index is
+/// rebuilt on the next lookup.
+/// Each hit is checked against its neighbours in the live list; on a mismatch the index is rebuilt once, and if it
+/// still disagrees the caller falls back to walking the list.
+
+#define FRAME_INDEX_SLOTS 4 ///< number of event_lists we keep an index for
+#define FRAME_INDEX_MIN_FRAMES 64 ///< lists with fewer frames are just walked
+
+typedef struct {
+  weed_event_t *event_list;
+  uint64_t epoch;
+  uint64_t lastuse;
+  weed_event_t **frames;
+  weed_timecode_t *tcs;
+  int nframes; ///< -1 if the list is too short to be worth indexing
+  int size;
+} frame_index_t;
+
+static frame_index_t frame_index[FRAME_INDEX_SLOTS];
+static uint64_t frame_index_clock = 0;
+static pthread_mutex_t frame_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static boolean frame_index_add(frame_index_t *fidx, weed_event_t *event, weed_timecode_t tc) {
+  if (fidx->nframes >= fidx->size) {
+    int nsize = fidx->size ? fidx->size * 2 : 1024;
+    weed_event_t **frames = (weed_event_t **)lives_realloc(fidx->frames, nsize * sizeof(weed_event_t *));
+    weed_timecode_t *tcs;
+    if (!frames) return FALSE;
+    fidx->frames = frames;
+    if (!(tcs = (weed_timecode_t *)lives_realloc(fidx->tcs, nsize * sizeof(weed_timecode_t)))) return FALSE;
+    fidx->tcs = tcs;
+    fidx->size = nsize;
+  }
+  fidx->frames[fidx->nframes] = event;
+  fidx->tcs[fidx->nframes++] = tc;
+  return TRUE;
+}
+
+
+static void frame_index_build(frame_index_t *fidx, weed_event_t *event_list, uint64_t epoch) {
+  weed_event_t *event = get_first_frame_event(event_list);
+  weed_timecode_t tc, ltc = 0;
+
+  fidx->event_list = event_list;
+  fidx->epoch = epoch;
+  fidx->nframes = 0;
+
+  for (; event; event = get_next_frame_event(event)) {
+    tc = get_event_timecode(event);
+    // out of order lists are left to the linear search
+    if ((fidx->nframes > 0 && tc < ltc) || !frame_index_add(fidx, event, tc)) {
+      fidx->nframes = -1;
+      return;
+    }
+    ltc = tc;
+  }
+  if (fidx->nframes < FRAME_INDEX_MIN_FRAMES) fidx->nframes = -1;
+}
+
+
+static frame_index_t *frame_index_find(weed_event_t *event_list, boolean create) {
+  frame_index_t *fidx = NULL;
+  for (int i = 0; i < FRAME_INDEX_SLOTS; i++) {
+    if (frame_index[i].event_list == event_list) {
+      fidx = &frame_index[i];
+      break;
+    }
+    if (create && (!fidx || frame_index[i].lastuse < fidx->lastuse)) fidx = &frame_index[i];
+  }
+  if (fidx && fidx->event_list != event_list) {
+    if (!create) return NULL;
+    fidx->event_list = NULL;
+    fidx->epoch = 0;
+  }
+  if (fidx) fidx->lastuse = ++frame_index_clock;
+  return fidx;
+}
+
+
+/// returns the index of the last frame with timecode <= tc, -1 if there is none
+static int frame_index_search(frame_index_t *fidx, weed_timecode_t tc) {
+  int lo = 0, hi = fidx->nframes;
+  while (lo < hi) {
+    int mid = (lo + hi) >> 1;
+    if (fidx->tcs[mid] <= tc) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo - 1;
+}
+
+
+/// check an index hit against the live list: the frame and its successor must still be where the index says
+static boolean frame_index_check(weed_event_t *event_list, frame_index_t *fidx, int idx) {
+  weed_event_t *next;
+  if (idx < 0) {
+    next = get_first_frame_event(event_list);
+  } else {
+    if (!WEED_EVENT_IS_FRAME(fidx->frames[idx]) || get_event_timecode(fidx->frames[idx]) != fidx->tcs[idx]) return FALSE;
+    next = get_next_frame_event(fidx->frames[idx]);
+  }
+  if (idx + 1 >= fidx->nframes) return next == NULL;
+  return next == fidx->frames[idx + 1] && get_event_timecode(next) == fidx->tcs[idx + 1];
+}
+
+
+/**
+   @brief find the last frame event at or before tc using the index
+
+   returns TRUE and sets *frame (possibly to NULL if there is no frame at or before tc) if the index could answer,
+   FALSE if the caller should walk the list instead */
+static boolean frame_index_lookup(weed_event_t *event_list, weed_timecode_t tc, weed_event_t **frame) {
+  frame_index_t *fidx;
+  uint64_t epoch;
+  boolean ret = FALSE;
+  int idx, tries;
+
+  if (!event_list) return FALSE;
+  pthread_mutex_lock(&frame_index_mutex);
+  fidx = frame_index_find(event_list, TRUE);
+  for (tries = 0; tries < 2; tries++) {
+    epoch = __atomic_load_n(&frame_index_epoch, __ATOMIC_ACQUIRE);
+    if (fidx->epoch != epoch || tries) frame_index_build(fidx, event_list, epoch);
+    if (fidx->nframes < 0) break;
+    idx = frame_index_search(fidx, tc);
+    if (frame_index_check(event_list, fidx, idx)) {
+      *frame = idx < 0 ? NULL : fidx->frames[idx];
+      ret = TRUE;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&frame_index_mutex);
+  return ret;
+}
+
+
+/// after a change to the frame events of its list, drop the index unless it was updated to match.
+/// A list with no current index has nothing to update, and other lists are never affected.
+/// Must be called with frame_index_mutex held
+LIVES_LOCAL_INLINE void frame_index_commit(frame_index_t *fidx, boolean updated) {
+  if (fidx && !updated) fidx->epoch = 0;
+}
+
+
+/// returns the index for event_list if it is current (though it may be marked as not worth indexing), or NULL.
+/// If some list changes behind our back meanwhile, the epoch moves on and the index will be rebuilt anyway
+static frame_index_t *frame_index_current(weed_event_t *event_list) {
+  frame_index_t *fidx = frame_index_find(event_list, FALSE);
+  if (!fidx || fidx->epoch != __atomic_load_n(&frame_index_epoch, __ATOMIC_ACQUIRE)) return NULL;
+  return fidx;
+}
+
+
+/// returns the position of event in the index, or -1 if it is not there
+static int frame_index_locate(frame_index_t *fidx, weed_event_t *event, weed_timecode_t tc) {
+  for (int idx = frame_index_search(fidx, tc); idx >= 0 && fidx->tcs[idx] == tc; idx--)
+    if (fidx->frames[idx] == event) return idx;
+  return -1;
+}
+
+
+/// extend a current index with a frame appended at the end of its list
+static void frame_index_append(weed_event_t *event_list, weed_event_t *event) {
+  frame_index_t *fidx;
+  weed_timecode_t tc = get_event_timecode(event);
+  boolean extended = FALSE;
+
+  pthread_mutex_lock(&frame_index_mutex);
+  fidx = frame_index_current(event_list);
+  if (fidx && fidx->nframes > 0 && tc >= fidx->tcs[fidx->nframes - 1]) extended = frame_index_add(fidx, event, tc);
+  frame_index_commit(fidx, extended);
+  pthread_mutex_unlock(&frame_index_mutex);
+}
+
+
+/// update a current index for a frame which has just been linked into its list, anywhere in the list
+static void frame_index_insert(weed_event_t *event_list, weed_event_t *event) {
+  frame_index_t *fidx;
+  weed_event_t *prev;
+  weed_timecode_t tc = get_event_timecode(event);
+  boolean inserted = FALSE;
+  int pos = 0;
+
+  pthread_mutex_lock(&frame_index_mutex);
+  fidx = frame_index_current(event_list);
+  // the new frame goes after the frame which now precedes it in the list, provided that keeps the index sorted
+  if (fidx && fidx->nframes > 0 && (!(prev = get_prev_frame_event(event))
+               || (pos = frame_index_locate(fidx, prev, get_event_timecode(prev)) + 1) > 0)
+      && (pos == 0 || fidx->tcs[pos - 1] <= tc) && (pos == fidx->nframes || tc <= fidx->tcs[pos])) {
+    int nframes = fidx->nframes;
+    if (frame_index_add(fidx, event, tc)) {
+      lives_memmove(&fidx->frames[pos + 1], &fidx->frames[pos], (nframes - pos) * sizeof(weed_event_t *));
+      lives_memmove(&fidx->tcs[pos + 1], &fidx->tcs[pos], (nframes - pos) * sizeof(weed_timecode_t));
+      fidx->frames[pos] = event;
+      fidx->tcs[pos] = tc;
+      inserted = TRUE;
+    }
+  }
+  frame_index_commit(fidx, inserted);
+  pthread_mutex_unlock(&frame_index_mutex);
+}
+
+
+/// update a current index for a frame which is being unlinked from its list
+static void frame_index_remove(weed_event_t *event_list, weed_event_t *event) {
+  frame_index_t *fidx;
+  boolean removed = FALSE;
+  int pos;
+
+  pthread_mutex_lock(&frame_index_mutex);
+  fidx = frame_index_current(event_list);
+  if (fidx && fidx->nframes > 0 && (pos = frame_index_locate(fidx, event, get_event_timecode(event))) >= 0) {
+    fidx->nframes--;
+    lives_memmove(&fidx->frames[pos], &fidx->frames[pos + 1], (fidx->nframes - pos) * sizeof(weed_event_t *));
+    lives_memmove(&fidx->tcs[pos], &fidx->tcs[pos + 1], (fidx->nframes - pos) * sizeof(weed_timecode_t));
+    removed = TRUE;
+  }
+  frame_index_commit(fidx, removed);
+  pthread_mutex_unlock(&frame_index_mutex);
+}
+
+
+static void frame_index_free(weed_event_t *event_list) {
+  frame_index_t *fidx;
+  frame_index_invalidate();
+  pthread_mutex_lock(&frame_index_mutex);
+  if ((fidx = frame_index_find(event_list, FALSE))) {
+    lives_freep((void **)&fidx->frames);
+    lives_freep((void **)&fidx->tcs);
+    lives_memset(fidx, 0, sizeof(frame_index_t));
+  }
+  pthread_mutex_unlock(&frame_index_mutex);
+}
+
+//////////////////////////////////////////////////////////////////
+
 
 boolean has_frame_event_at(weed_plant_t *event_list, weed_timecode_t tc, weed_plant_t **shortcut) {
   weed_plant_t *event;
   weed_timecode_t ev_tc;
 
-  if (!shortcut || !*shortcut) event = get_first_frame_event(event_list);
-  else event = *shortcut;
+  if (!shortcut || !*shortcut) {
+    if (!frame_index_lookup(event_list, tc, &event) || !event) event = get_first_frame_event(event_list);
+  } else event = *shortcut;
 
   while ((ev_tc = get_event_timecode(event)) <= tc) {
     if (ev_tc == tc && WEED_EVENT_IS_FRAME(event)) {
@@ -300,6 +566,8 @@ void unlink_event(weed_plant_t *event_list, weed_plant_t *event) {
   weed_plant_t *prev_event = get_prev_event(event);
   weed_plant_t *next_event = get_next_event(event);
 
+  if (WEED_EVENT_IS_FRAME(event)) frame_index_remove(event_list, event);
+  else if (WEED_EVENT_IS_PARAM_CHANGE(event)) pchange_invalidate();
   if (prev_event) weed_set_voidptr_value(prev_event, WEED_LEAF_NEXT, next_event);
   if (next_event) weed_set_voidptr_value(next_event, WEED_LEAF_PREVIOUS, prev_event);
 
@@ -321,6 +589,7 @@ void delete_event(weed_plant_t *event_list, weed_plant_t *event) {
 boolean insert_event_before(weed_plant_t *at_event, weed_plant_t *event) {
   // insert event before at_event : returns FALSE if event is new start of event list
   weed_plant_t *xevent = get_prev_event(at_event);
+  if (WEED_EVENT_IS_FRAME(event)) frame_index_invalidate();
   if (xevent) weed_set_voidptr_value(xevent, WEED_LEAF_NEXT, event);
   weed_set_voidptr_value(event, WEED_LEAF_NEXT, at_event);
   weed_set_voidptr_value(event, WEED_LEAF_PREVIOUS, xevent);
@@ -334,6 +603,7 @@ boolean insert_event_before(weed_plant_t *at_event, weed_plant_t *event) {
 boolean insert_event_after(weed_plant_t *at_event, weed_plant_t *event) {
   // insert event after at_event : returns FALSE if event is new end of event list
   weed_plant_t *xevent = get_next_event(at_event);
+  if (WEED_EVENT_IS_FRAME(event)) frame_index_invalidate();
   if (xevent) weed_set_voidptr_value(xevent, WEED_LEAF_PREVIOUS, event);
   weed_set_voidptr_value(event, WEED_LEAF_PREVIOUS, at_event);
   weed_set_voidptr_value(event, WEED_LEAF_NEXT, xevent);
@@ -656,7 +926,8 @@ weed_plant_t *event_copy_and_insert(weed_plant_t *in_event, weed_timecode_t out_
   }
 
   event = weed_plant_copy(in_event);
-  weed_event_set_timecode(event, out_tc);
+  // not linked in yet, so there is no need to invalidate the frame index
+  weed_set_int64_value(event, WEED_LEAF_TIMECODE, out_tc);
 
   // need to repoint our avol_init_event
   if (mainw->multitrack) mt_fixup_events(mainw->multitrack, in_event, event);
@@ -683,6 +954,11 @@ weed_plant_t *event_copy_and_insert(weed_plant_t *in_event, weed_timecode_t out_
   else error = weed_set_voidptr_value(event_after, WEED_LEAF_PREVIOUS, event);
   if (error == WEED_ERROR_MEMORY_ALLOCATION) return NULL;
 
+  if (WEED_EVENT_IS_FRAME(event)) {
+    if (!event_after) frame_index_append(event_list, event);
+    else frame_index_insert(event_list, event);
+  }
+
   etype = get_event_type(in_event);
   switch (etype) {
   case WEED_EVENT_TYPE_FILTER_INIT:
@@ -784,7 +1060,10 @@ weed_plant_t *get_frame_event_at(weed_plant_t *event_list, weed_timecode_t tc, w
 
   if (!event_list) return NULL;
   if (shortcut) event = shortcut;
-  else event = get_first_frame_event(event_list);
+  else if (!frame_index_lookup(event_list, tc, &event) || !event) {
+    // the walk can only stop at or after the last frame before tc, so we start there if we know it
+    event = get_first_frame_event(event_list);
+  }
   while (event) {
     next_event = get_next_event(event);
     if (next_event) next_tc = get_event_timecode(next_event);
@@ -1141,6 +1420,8 @@ void insert_param_change_event_at(weed_plant_t *event_list, weed_plant_t *at_eve
 }
 
 
+static weed_plant_t *create_frame_event(weed_timecode_t tc, int numframes, int *clips, int64_t *frames);
+
 weed_plant_t *insert_frame_event_at(weed_plant_t *event_list, weed_timecode_t tc, int numframes, int *clips,
                                     int64_t *frames, weed_plant_t **shortcut) {
   // we will insert a FRAME event at timecode tc, after any other events (except for deinit events) at timecode tc
@@ -1151,7 +1432,7 @@ weed_plant_t *insert_frame_event_at(weed_plant_t *event_list, weed_timecode_t tc
   // returns NULL on memory error
 
   weed_plant_t *event = NULL, *new_event, *prev;
-  weed_plant_t *new_event_list, *xevent_list;
+  weed_plant_t *xevent_list;
   weed_timecode_t xtc;
   weed_error_t error;
   if (!event_list || !get_first_frame_event(event_list)) {
@@ -1166,7 +1447,7 @@ weed_plant_t *insert_frame_event_at(weed_plant_t *event_list, weed_timecode_t tc
   if (tc <= get_event_timecode(get_last_event(event_list))) {
     if (shortcut && *shortcut) {
       event = *shortcut;
-    } else event = get_first_event(event_list);
+    } else if (!frame_index_lookup(event_list, tc, &event) || !event) event = get_first_event(event_list);
 
     if (get_event_timecode(event) > tc) {
       // step backwards until we get to a frame before where we want to add
@@ -1210,10 +1491,7 @@ weed_plant_t *insert_frame_event_at(weed_plant_t *event_list, weed_timecode_t tc
 
   // add frame before "event"
 
-  if (!(new_event_list = append_frame_event(NULL, tc, numframes, clips, frames))) return NULL;
-  // new_event_list is now an event_list with one frame event. We will steal its event and prepend it !
-
-  new_event = get_first_event(new_event_list);
+  if (!(new_event = create_frame_event(tc, numframes, clips, frames))) return NULL;
 
   prev = get_prev_event(event);
 
@@ -1232,8 +1510,7 @@ weed_plant_t *insert_frame_event_at(weed_plant_t *event_list, weed_timecode_t tc
     error = weed_set_voidptr_value(event_list, WEED_LEAF_FIRST, new_event);
     if (error == WEED_ERROR_MEMORY_ALLOCATION) return NULL;
   }
-
-  weed_plant_free(new_event_list);
+  frame_index_insert(event_list, new_event);
 
   if (shortcut) *shortcut = new_event;
   return event_list;
@@ -2301,6 +2578,8 @@ static void event_list_free_events(weed_plant_t *event_list) {
   weed_plant_t *event, *next_event;
   event = get_first_event(event_list);
 
+  frame_index_free(event_list);
+  pchange_invalidate();
   while (event) {
     next_event = get_next_event(event);
     if (mainw->multitrack && event_list == mainw->multitrack->event_list) mt_fixup_events(mainw->multitrack, event, NULL);
@@ -2321,6 +2600,7 @@ void event_list_replace_events(weed_plant_t *event_list, weed_plant_t *new_event
   if (!event_list || !new_event_list) return;
   if (event_list == new_event_list) return;
   event_list_free_events(event_list);
+  frame_index_free(new_event_list);
   weed_set_voidptr_value(event_list, WEED_LEAF_FIRST, get_first_event(new_event_list));
   weed_set_voidptr_value(event_list, WEED_LEAF_LAST, get_last_event(new_event_list));
 }
@@ -2639,6 +2919,7 @@ weed_plant_t *append_frame_event(weed_plant_t *event_list, weed_timecode_t tc, i
   }
   error = weed_set_voidptr_value(event_list, WEED_LEAF_LAST, event);
   if (error == WEED_ERROR_MEMORY_ALLOCATION) return NULL;
+  frame_index_append(event_list, event);
   //////////////////////////////////////
 
   return event_list;
@@ -3207,10 +3488,9 @@ weed_plant_t *process_events(weed_plant_t *next_event, boolean process_audio, we
     if (mainw->scrap_file != -1) {
       int nclips = mainw->num_tracks;
       for (i = 0; i < nclips; i++) {
+        // frames are located via the scrap file's offset index, so we only need the file open
         if (mainw->clip_index[i] == mainw->scrap_file) {
-          int64_t offs = weed_get_int64_value(next_event, WEED_LEAF_HOST_SCRAP_FILE_OFFSET, NULL);
           if (!mainw->files[mainw->scrap_file]->ext_src) load_from_scrap_file(NULL, -1);
-          lives_lseek_buffered_rdonly_absolute(LIVES_POINTER_TO_INT(mainw->files[mainw->scrap_file]->ext_src), offs);
         }
       }
     }
@@ -3555,6 +3835,90 @@ static char *set_proc_label(xprocess * proc, const char *label, boolean copy_old
 }
 
 
+/////// rendered frame output ////////
+
+/// rendered frames are encoded and written by a ring of saver threads, so several frames can be in flight while the
+/// next ones are fetched and have effects applied. Each slot holds its own ref to the pixbuf; slots are always
+/// retired oldest first, so write errors are reported (and retried) in frame order.
+#define RENDER_SAVE_SLOTS_MAX 8
+
+static savethread_priv_t *saveslots[RENDER_SAVE_SLOTS_MAX];
+static lives_thread_t saver_threads[RENDER_SAVE_SLOTS_MAX];
+static int nsaveslots = 0, next_saveslot = 0;
+
+static void render_save_init(void) {
+  nsaveslots = prefs->nfx_threads;
+  if (nsaveslots > RENDER_SAVE_SLOTS_MAX) nsaveslots = RENDER_SAVE_SLOTS_MAX;
+  if (nsaveslots < 1) nsaveslots = 1;
+  for (int i = 0; i < nsaveslots; i++) {
+    saveslots[i] = (savethread_priv_t *)lives_calloc(1, sizeof(savethread_priv_t));
+    saveslots[i]->img_type = cfile->img_type;
+    saveslots[i]->compression = 100 - prefs->ocp;
+    saveslots[i]->width = cfile->hsize;
+    saveslots[i]->height = cfile->vsize;
+  }
+  next_saveslot = 0;
+}
+
+
+/// wait for the save in slot to complete, offering to retry on error; returns FALSE if the frame could not be written
+static boolean render_save_retire(int slot) {
+  savethread_priv_t *saveargs = saveslots[slot];
+  LiVESResponseType retval;
+  boolean ret = TRUE;
+
+  if (!saveargs || !saveargs->fname) return TRUE;
+  lives_thread_join(saver_threads[slot], NULL);
+  while (saveargs->error) {
+    retval = do_write_failed_error_s_with_retry(saveargs->fname, saveargs->error->message);
+    lives_error_free(saveargs->error);
+    saveargs->error = NULL;
+    if (retval != LIVES_RESPONSE_RETRY) {
+      ret = FALSE;
+      break;
+    }
+    lives_pixbuf_save(saveargs->pixbuf, saveargs->fname, saveargs->img_type, saveargs->compression,
+                      saveargs->width, saveargs->height, &saveargs->error);
+  }
+  if (saveargs->pixbuf) {
+    lives_widget_object_unref(saveargs->pixbuf);
+    saveargs->pixbuf = NULL;
+  }
+  lives_freep((void **)&saveargs->fname);
+  return ret;
+}
+
+
+/// queue pixbuf to be written as fname (which is freed after the write); may first wait for the oldest slot
+static boolean render_save_frame(LiVESPixbuf *pixbuf, char *fname) {
+  savethread_priv_t *saveargs;
+  boolean ret;
+
+  if (!nsaveslots) render_save_init();
+  ret = render_save_retire(next_saveslot);
+  saveargs = saveslots[next_saveslot];
+  saveargs->fname = fname;
+  lives_widget_object_ref(pixbuf);
+  saveargs->pixbuf = pixbuf;
+  lives_thread_create(&saver_threads[next_saveslot], LIVES_THRDATTR_NONE, lives_pixbuf_save_threaded, saveargs);
+  if (++next_saveslot == nsaveslots) next_saveslot = 0;
+  return ret;
+}
+
+
+/// wait for all queued frames to be written, and free the slots
+static boolean render_save_finish(void) {
+  boolean ret = TRUE;
+  for (int i = 0; i < nsaveslots; i++) {
+    int slot = (next_saveslot + i) % nsaveslots;
+    if (!render_save_retire(slot)) ret = FALSE;
+    lives_freep((void **)&saveslots[slot]);
+  }
+  nsaveslots = next_saveslot = 0;
+  return ret;
+}
+
+
 /**
    @brief render mainw->event_list to a clip
 
@@ -3608,10 +3972,8 @@ static char *set_proc_label(xprocess * proc, const char *label, boolean copy_old
 */
 lives_render_error_t render_events(boolean reset, boolean rend_video, boolean rend_audio) {
 #define SAVE_THREAD
-#ifdef SAVE_THREAD
-  static savethread_priv_t *saveargs = NULL;
-  static lives_thread_t *saver_thread = NULL;
-#else
+#ifndef SAVE_THREAD
+  LiVESResponseType retval;
   char oname[PATH_MAX];
   char *tmp;
   LiVESError *error;
@@ -3637,7 +3999,6 @@ lives_render_error_t render_events(boolean reset, boolean rend_video, boolean re
   weed_plant_t **layers, *layer = NULL;
 
   weed_error_t weed_error;
-  LiVESResponseType retval;
 
   int key, idx;
   int etype;
@@ -3682,6 +4043,10 @@ lives_render_error_t render_events(boolean reset, boolean rend_video, boolean re
 
   if (reset) {
     LiVESList *list = NULL;
+#ifdef SAVE_THREAD
+    /// flush anything left queued by a cancelled render; slot settings are taken from the new cfile
+    if (nsaveslots) render_save_finish();
+#endif
     r_audio = rend_audio;
     r_video = rend_video;
     progress = frame = 1;
@@ -3826,23 +4191,17 @@ lives_render_error_t render_events(boolean reset, boolean rend_video, boolean re
             }
           }
           if (scrap_track != -1) {
-            int64_t offs;
             // do not apply fx, just pull frame
             if (mainw->frame_index[scrap_track] == old_scrap_frame && mainw->scrap_pixbuf) {
               pixbuf = mainw->scrap_pixbuf;
             } else {
               if (mainw->scrap_pixbuf) {
-#ifndef SAVE_THREAD
                 lives_widget_object_unref(mainw->scrap_pixbuf);
-#endif
                 mainw->scrap_pixbuf = NULL;
               }
               old_scrap_frame = mainw->frame_index[scrap_track];
               layer = lives_layer_new_for_frame(mainw->clip_index[scrap_track], mainw->frame_index[scrap_track]);
-              offs = weed_get_int64_value(event, WEED_LEAF_HOST_SCRAP_FILE_OFFSET, &weed_error);
               if (!mainw->files[mainw->scrap_file]->ext_src) load_from_scrap_file(NULL, -1);
-              lives_lseek_buffered_rdonly_absolute(LIVES_POINTER_TO_INT(mainw->files[mainw->clip_index[scrap_track]]->ext_src),
-                                                   offs);
               if (!pull_frame(layer, get_image_ext_for_type(cfile->img_type), tc)) {
                 weed_layer_free(layer);
                 layer = NULL;
@@ -4112,47 +4471,14 @@ lives_render_error_t render_events(boolean reset, boolean rend_video, boolean re
       } while (retval == LIVES_RESPONSE_RETRY);
 
 #else
-      if (!saver_thread) {
-        if (!mainw->transrend_proc) {
-          saveargs = (savethread_priv_t *)lives_calloc(1, sizeof(savethread_priv_t));
-          saveargs->img_type = cfile->img_type;
-          saveargs->compression = 100 - prefs->ocp;
-          saveargs->width = cfile->hsize;
-          saveargs->height = cfile->vsize;
-          saver_thread = (lives_thread_t *)lives_calloc(1, sizeof(lives_thread_t));
-        }
-      } else {
-        lives_thread_join(*saver_thread, NULL);
-        while (saveargs->error) {
-          retval = do_write_failed_error_s_with_retry(saveargs->fname, saveargs->error->message);
-          lives_error_free(saveargs->error);
-          saveargs->error = NULL;
-          if (retval != LIVES_RESPONSE_RETRY) {
-            read_write_error = LIVES_RENDER_ERROR_WRITE_FRAME;
-            break;
-          }
-          lives_pixbuf_save(saveargs->pixbuf, saveargs->fname, saveargs->img_type, saveargs->compression,
-                            saveargs->width, saveargs->height, &saveargs->error);
-        }
-
-        if (saveargs->pixbuf && saveargs->pixbuf != pixbuf) {
-          if (saveargs->pixbuf == mainw->scrap_pixbuf) mainw->scrap_pixbuf = NULL;
-          lives_widget_object_unref(saveargs->pixbuf);
-          saveargs->pixbuf = NULL;
-        }
-        lives_free(saveargs->fname);
-        saveargs->fname = NULL;
-      }
-
       if (!mainw->transrend_proc) {
+        char *fname;
         if (cfile->old_frames > 0) {
-          saveargs->fname = make_image_file_name(cfile, out_frame, LIVES_FILE_EXT_MGK);
+          fname = make_image_file_name(cfile, out_frame, LIVES_FILE_EXT_MGK);
         } else {
-          saveargs->fname = make_image_file_name(cfile, out_frame, get_image_ext_for_type(cfile->img_type));
+          fname = make_image_file_name(cfile, out_frame, get_image_ext_for_type(cfile->img_type));
         }
-
-        saveargs->pixbuf = pixbuf;
-        lives_thread_create(saver_thread, LIVES_THRDATTR_NONE, lives_pixbuf_save_threaded, saveargs);
+        if (!render_save_frame(pixbuf, fname)) read_write_error = LIVES_RENDER_ERROR_WRITE_FRAME;
       }
 #endif
 
@@ -4169,6 +4495,10 @@ lives_render_error_t render_events(boolean reset, boolean rend_video, boolean re
       // if our pixbuf came from scrap file, and next frame is also from scrap file with same frame number,
       // save the pixbuf and re-use it
       if (scrap_track != -1) mainw->scrap_pixbuf = pixbuf;
+#ifdef SAVE_THREAD
+      /// the save slot has its own ref
+      else lives_widget_object_unref(pixbuf);
+#endif
       break;
 
     case WEED_EVENT_TYPE_FILTER_INIT:
@@ -4386,25 +4716,10 @@ filterinit2:
   } else {
     /// no more events or audio to flush, rendering complete
 #ifdef SAVE_THREAD
-    if (saver_thread) {
-      lives_thread_join(*saver_thread, NULL);
-      while (saveargs->error) {
-        retval = do_write_failed_error_s_with_retry(saveargs->fname, saveargs->error->message);
-        lives_error_free(saveargs->error);
-        saveargs->error = NULL;
-        if (retval != LIVES_RESPONSE_RETRY) read_write_error = LIVES_RENDER_ERROR_WRITE_FRAME;
-        else lives_pixbuf_save(saveargs->pixbuf, saveargs->fname, saveargs->img_type, saveargs->compression,
-                                 saveargs->width, saveargs->height, &saveargs->error);
-      }
-      if (saveargs->pixbuf) {
-        lives_widget_object_unref(saveargs->pixbuf);
-        if (saveargs->pixbuf == mainw->scrap_pixbuf) mainw->scrap_pixbuf = NULL;
-      }
-      lives_freep((void **)&saveargs->fname);
-      lives_free(saveargs);
-      lives_free(saver_thread);
-      saver_thread = NULL;
-      saveargs = NULL;
+    if (nsaveslots && !render_save_finish()) read_write_error = LIVES_RENDER_ERROR_WRITE_FRAME;
+    if (mainw->scrap_pixbuf) {
+      lives_widget_object_unref(mainw->scrap_pixbuf);
+      mainw->scrap_pixbuf = NULL;
     }
 #endif
 
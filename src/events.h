@@ -149,6 +149,8 @@ int weed_event_get_type(weed_event_t *event);
 weed_timecode_t weed_event_set_timecode(weed_event_t *, weed_timecode_t tc);
 weed_timecode_t weed_event_get_timecode(weed_event_t *);
 
+uint64_t get_pchange_epoch(void);
+
 int weed_frame_event_get_tracks(weed_event_t *event,  int **clips, int64_t **frames); // returns ntracks
 int weed_frame_event_get_audio_tracks(weed_event_t *event,  int **aclips, double **aseeks); // returns natracks
 
@@ -36,6 +36,8 @@ static size_t jrb = 0;
 
 static off_t fwd_seek_pos = 0;
 
+static pthread_mutex_t cmdq_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static size_t audio_read_inner(jack_driver_t *jackd, float **in_buffer, int fileno,
                                int nframes, double out_scale, boolean rev_endian, boolean out_unsigned, size_t rbytes);
 
@@ -68,6 +70,189 @@ static boolean check_zero_buff(size_t check_size) {
 }
 
 
+/// size the scratch buffers for bufsize frames; this must not be called from inside the process callback
+static boolean jack_scratch_alloc(jack_driver_t *jackd, nframes_t bufsize) {
+  size_t size = bufsize * JACK_SCRATCH_FRAME_BYTES;
+  int i;
+  if (size <= jackd->scratch_size) return TRUE;
+  for (i = 0; i < JACK_N_SCRATCH; i++) {
+    void *buf = lives_realloc(jackd->scratch[i], size);
+    if (!buf) return FALSE;
+    jackd->scratch[i] = buf;
+  }
+  jackd->scratch_size = size;
+  return check_zero_buff(size);
+}
+
+
+static void jack_scratch_free(jack_driver_t *jackd) {
+  for (int i = 0; i < JACK_N_SCRATCH; i++) lives_freep((void **)&jackd->scratch[i]);
+  jackd->scratch_size = 0;
+}
+
+
+/// get a scratch buffer in the callback. If it is too small (which should not happen), we have to allocate, and count it
+static void *jack_scratch_get(jack_driver_t *jackd, int which, size_t bytes) {
+  if (LIVES_LIKELY(bytes <= jackd->scratch_size)) return jackd->scratch[which];
+  jackd->rt_stats.rt_allocs++;
+  return lives_malloc(bytes);
+}
+
+
+LIVES_LOCAL_INLINE void jack_scratch_release(jack_driver_t *jackd, int which, void *buf) {
+  if (buf && buf != jackd->scratch[which]) lives_free(buf);
+}
+
+
+static int jack_bufsize_changed(nframes_t nframes, void *arg) {
+  // called by jack when the period size changes, the process callback is not running at the same time
+  jack_driver_t *jackd = (jack_driver_t *)arg;
+  jack_scratch_alloc(jackd, nframes);
+  return 0;
+}
+
+
+static int jack_xrun(void *arg) {
+  jack_driver_t *jackd = (jack_driver_t *)arg;
+  jackd->rt_stats.xruns++;
+  if (jackd->client) {
+    float delay = jack_get_xrun_delayed_usecs(jackd->client);
+    if (delay > jackd->rt_stats.max_xrun_delay) jackd->rt_stats.max_xrun_delay = delay;
+  }
+  return 0;
+}
+
+
+static void jack_update_rt_stats(jack_driver_t *jackd, nframes_t nframes, jack_time_t tstart) {
+  lives_jack_rt_stats_t *stats = &jackd->rt_stats;
+  uint64_t usec = jack_get_time() - tstart;
+  int rate = jackd->is_output ? jackd->sample_out_rate : abs(jackd->sample_in_rate);
+
+  stats->last_cycle_usec = usec;
+  if (usec > stats->max_cycle_usec) stats->max_cycle_usec = usec;
+  if (rate > 0) {
+    stats->period_usec = (uint64_t)nframes * 1000000 / rate;
+    if (usec > stats->period_usec) stats->late_cycles++;
+  }
+}
+
+
+/// the counters are read and cleared field by field, since the callbacks may be updating them at the same time
+void jack_get_rt_stats(jack_driver_t *jackd, lives_jack_rt_stats_t *stats) {
+  lives_jack_rt_stats_t *rt = &jackd->rt_stats;
+  float delay;
+  stats->xruns = __atomic_load_n(&rt->xruns, __ATOMIC_RELAXED);
+  __atomic_load(&rt->max_xrun_delay, &delay, __ATOMIC_RELAXED);
+  stats->max_xrun_delay = delay;
+  stats->last_cycle_usec = __atomic_load_n(&rt->last_cycle_usec, __ATOMIC_RELAXED);
+  stats->max_cycle_usec = __atomic_load_n(&rt->max_cycle_usec, __ATOMIC_RELAXED);
+  stats->period_usec = __atomic_load_n(&rt->period_usec, __ATOMIC_RELAXED);
+  stats->late_cycles = __atomic_load_n(&rt->late_cycles, __ATOMIC_RELAXED);
+  stats->rt_allocs = __atomic_load_n(&rt->rt_allocs, __ATOMIC_RELAXED);
+  stats->cmd_overflows = __atomic_load_n(&rt->cmd_overflows, __ATOMIC_RELAXED);
+}
+
+
+void jack_reset_rt_stats(jack_driver_t *jackd) {
+  lives_jack_rt_stats_t *rt = &jackd->rt_stats;
+  float zero = 0.;
+  __atomic_store_n(&rt->xruns, 0, __ATOMIC_RELAXED);
+  __atomic_store(&rt->max_xrun_delay, &zero, __ATOMIC_RELAXED);
+  __atomic_store_n(&rt->last_cycle_usec, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&rt->max_cycle_usec, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&rt->period_usec, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&rt->late_cycles, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&rt->rt_allocs, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&rt->cmd_overflows, 0, __ATOMIC_RELAXED);
+}
+
+
+/// commands are written by the host threads (serialised by cmdq_mutex) and read locklessly by the process callback.
+/// All ncmds are published with a single update of the head, so the callback sees either none or all of them
+boolean jack_send_cmds(jack_driver_t *jackd, const jack_cmd_t *cmds, int ncmds) {
+  uint32_t head;
+
+  pthread_mutex_lock(&cmdq_mutex);
+  head = jackd->cmdq_head;
+  if (head - __atomic_load_n(&jackd->cmdq_tail, __ATOMIC_ACQUIRE) + ncmds > JACK_CMDQ_SIZE) {
+    pthread_mutex_unlock(&cmdq_mutex);
+    __atomic_add_fetch(&jackd->rt_stats.cmd_overflows, 1, __ATOMIC_RELAXED);
+    LIVES_WARN("Jack command queue full");
+    return FALSE;
+  }
+  for (int i = 0; i < ncmds; i++) jackd->cmdq[(head + i) & (JACK_CMDQ_SIZE - 1)] = cmds[i];
+  __atomic_store_n(&jackd->cmdq_head, head + ncmds, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&cmdq_mutex);
+  return TRUE;
+}
+
+
+LIVES_GLOBAL_INLINE boolean jack_send_cmd(jack_driver_t *jackd, int command, int64_t arg) {
+  jack_cmd_t cmd;
+  cmd.command = command;
+  cmd.arg = arg;
+  return jack_send_cmds(jackd, &cmd, 1);
+}
+
+
+boolean jack_cmdq_pending(jack_driver_t *jackd) {
+  if (jackd->jackd_died || mainw->aplayer_broken) return FALSE;
+  return __atomic_load_n(&jackd->cmdq_tail, __ATOMIC_ACQUIRE) != __atomic_load_n(&jackd->cmdq_head, __ATOMIC_ACQUIRE);
+}
+
+
+int jack_cmdq_peek(jack_driver_t *jackd) {
+  if (!jack_cmdq_pending(jackd)) return ASERVER_CMD_PROCESSED;
+  return jackd->cmdq[__atomic_load_n(&jackd->cmdq_tail, __ATOMIC_ACQUIRE) & (JACK_CMDQ_SIZE - 1)].command;
+}
+
+
+/// drop any unprocessed commands; only when the callback is not running
+LIVES_LOCAL_INLINE void jack_cmdq_flush(jack_driver_t *jackd) {
+  __atomic_store_n(&jackd->cmdq_tail, jackd->cmdq_head, __ATOMIC_RELEASE);
+}
+
+
+/// remap interleaved s16 audio with nchans channels to stereo, returns the number of bytes written
+static size_t remap_to_stereo_s16(uint8_t *dst, const uint8_t *src, nframes_t nframes, int nchans) {
+  size_t fbytes = nchans * 2;
+  for (nframes_t i = 0; i < nframes; i++) {
+    lives_memcpy(dst, src, 2);
+    // duplicate a mono channel, or skip any extra channels
+    lives_memcpy(dst + 2, nchans == 1 ? src : src + 2, 2);
+    dst += 4;
+    src += fbytes;
+  }
+  return nframes * 4;
+}
+
+
+static void jack_stream_out(jack_driver_t *jackd, uint8_t *s16buf, float **fbuf, nframes_t nframes) {
+  // push stereo s16 audio to the external stream; the source is either interleaved s16, or non-interleaved float
+  int nchans = jackd->num_output_channels;
+  size_t rbytes = nframes * nchans * 2;
+  uint8_t *xbuf = s16buf, *rbuf = NULL;
+
+  if (!xbuf) {
+    xbuf = (uint8_t *)jack_scratch_get(jackd, JACK_SCRATCH_CONV, rbytes);
+    if (!xbuf) return;
+    sample_move_float_int((void *)xbuf, fbuf, nframes, 1.0, nchans, 16, 0, TRUE, FALSE, 1.0);
+  }
+
+  if (nchans != 2) {
+    // need to remap channels to stereo (assumed for now)
+    rbuf = (uint8_t *)jack_scratch_get(jackd, JACK_SCRATCH_REMAP, nframes * 4);
+    if (rbuf) rbytes = remap_to_stereo_s16(rbuf, xbuf, nframes, nchans);
+  }
+
+  if (rbuf) audio_stream(rbuf, rbytes, jackd->astream_fd);
+  else if (nchans == 2) audio_stream(xbuf, rbytes, jackd->astream_fd);
+
+  jack_scratch_release(jackd, JACK_SCRATCH_REMAP, rbuf);
+  if (xbuf != s16buf) jack_scratch_release(jackd, JACK_SCRATCH_CONV, xbuf);
+}
+
+
 boolean lives_jack_init(void) {
   char *jt_client = lives_strdup_printf("LiVES-%d", capable->mainpid);
   jack_options_t options = JackServerName;
@@ -410,19 +595,20 @@ static void output_silence(size_t offset, nframes_t nframes, jack_driver_t *jack
 }
 
 
-static int audio_process(nframes_t nframes, void *arg) {
+static int audio_process_inner(nframes_t nframes, jack_driver_t *jackd) {
   // JACK calls this periodically to get the next audio buffer
+  // nothing in here should allocate memory or block; scratch buffers are in jackd->scratch
   float *out_buffer[JACK_MAX_OUTPUT_PORTS];
-  jack_driver_t *jackd = (jack_driver_t *)arg;
   jack_position_t pos;
-  aserver_message_t *msg;
+  jack_cmd_t *cmd;
+  uint32_t cmd_tail, cmd_head;
   int64_t xseek;
-  int new_file;
   boolean got_cmd = FALSE;
   boolean from_memory = FALSE;
   boolean wait_cache_buffer = FALSE;
+  boolean cache_underrun = FALSE;
   boolean pl_error = FALSE; ///< flag tells if we had an error during plugin processing
-  size_t nbytes, rbytes;
+  size_t rbytes;
 
   int i;
 #define DEBUG_JACK
@@ -430,17 +616,18 @@ static int audio_process(nframes_t nframes, void *arg) {
   lives_printerr("nframes %ld, sizeof(float) == %d\n", (int64_t)nframes, sizeof(float));
 #endif
 
-  if (!mainw->is_ready || !jackd || (!LIVES_IS_PLAYING && jackd->is_silent && !jackd->msgq)) return 0;
+  cmd_tail = jackd->cmdq_tail;
+  cmd_head = __atomic_load_n(&jackd->cmdq_head, __ATOMIC_ACQUIRE);
+
+  if (!mainw->is_ready || (!LIVES_IS_PLAYING && jackd->is_silent && cmd_tail == cmd_head)) return 0;
 
-  /* process one message */
-  while ((msg = (aserver_message_t *)jackd->msgq) != NULL) {
+  /* process any queued commands */
+  for (; cmd_tail != cmd_head; cmd_tail++) {
+    cmd = &jackd->cmdq[cmd_tail & (JACK_CMDQ_SIZE - 1)];
     got_cmd = TRUE;
-    switch (msg->command) {
+    switch (cmd->command) {
     case ASERVER_CMD_FILE_OPEN:
-      new_file = atoi((char *)msg->data);
-      if (jackd->playing_file != new_file) {
-        jackd->playing_file = new_file;
-      }
+      jackd->playing_file = (int)cmd->arg;
       jackd->seek_pos = jackd->real_seek_pos = 0;
       break;
     case ASERVER_CMD_FILE_CLOSE:
@@ -450,22 +637,17 @@ static int audio_process(nframes_t nframes, void *arg) {
       break;
     case ASERVER_CMD_FILE_SEEK:
       if (jackd->playing_file < 0) break;
-      xseek = atol((char *)msg->data);
-      xseek = ALIGN_CEIL64(xseek, afile->achans * (afile->asampsize >> 3));
+      xseek = ALIGN_CEIL64(cmd->arg, afile->achans * (afile->asampsize >> 3));
       if (xseek < 0) xseek = 0;
       jackd->seek_pos = jackd->real_seek_pos = afile->aseek_pos = xseek;
       push_cache_buffer(cache_buffer, jackd, 0, 0, 1.);
       jackd->in_use = TRUE;
       break;
     default:
-      jackd->msgq = NULL;
-      msg->data = NULL;
+      break;
     }
-
-    if (msg->next != msg) lives_freep((void **) & (msg->data));
-    msg->command = ASERVER_CMD_PROCESSED;
-    jackd->msgq = msg->next;
-    if (jackd->msgq && jackd->msgq->next == jackd->msgq) jackd->msgq->next = NULL;
+    // release the slot back to the sender
+    __atomic_store_n(&jackd->cmdq_tail, cmd_tail + 1, __ATOMIC_RELEASE);
   }
 
   /* retrieve the buffers for the output ports */
@@ -737,8 +919,6 @@ static int audio_process(nframes_t nframes, void *arg) {
           //	if (((int)(jackd->num_calls/100.))*100==jackd->num_calls) if (mainw->soft_debug) g_print("audio pip\n");
           if ((mainw->agen_key != 0 || mainw->agen_needs_reinit || cache_buffer->bufferf) && !mainw->preview &&
               !jackd->mute) { // TODO - try buffer16 instead of bufferf
-            float *fbuffer = NULL;
-
             if (!mainw->preview && !mainw->multitrack && (mainw->agen_key != 0 || mainw->agen_needs_reinit)) {
               // audio generated from plugin
               if (mainw->agen_needs_reinit) pl_error = TRUE;
@@ -806,14 +986,23 @@ static int audio_process(nframes_t nframes, void *arg) {
             } else {
               // audio from a file
               if (wait_cache_buffer) {
-                while (!cache_buffer->is_ready && !cache_buffer->die) {
-                  lives_usleep(prefs->sleep_time);
+                /// the cache thread normally answers from its read ahead data well within this time;
+                /// if it does not, play silence rather than stall the server, and pick the data up next cycle
+                jack_time_t tlimit = jack_get_time() + (jack_time_t)((double)nframes * 1000000. * JACK_CACHE_WAIT_FRAC
+                                     / (double)jackd->sample_out_rate);
+                while (!cache_buffer->is_ready && !cache_buffer->die && jack_get_time() < tlimit) sched_yield();
+                if (cache_buffer->is_ready) wait_cache_buffer = FALSE;
+                else {
+                  audio_cache_note_underrun();
+                  cache_underrun = TRUE;
                 }
-                wait_cache_buffer = FALSE;
               }
 
               pthread_mutex_lock(&mainw->cache_buffer_mutex);
-              if (!cache_buffer->die) {
+              if (cache_underrun) {
+                pthread_mutex_unlock(&mainw->cache_buffer_mutex);
+                output_silence(0, numFramesToWrite, jackd, out_buffer);
+              } else if (!cache_buffer->die) {
                 // push audio from cache_buffer to jack
                 for (i = 0; i < jackd->num_output_channels; i++) {
                   jackd->abs_maxvol_heard = sample_move_d16_float(out_buffer[i], cache_buffer->buffer16[0] + i, numFramesToWrite,
@@ -863,74 +1052,21 @@ static int audio_process(nframes_t nframes, void *arg) {
 
             if (jackd->astream_fd != -1) {
               // audio streaming if enabled
-              unsigned char *xbuf;
-
-              nbytes = numFramesToWrite * jackd->num_output_channels * 4;
-              rbytes = numFramesToWrite * jackd->num_output_channels * 2;
-
               if (pl_error) {
                 // generator plugin error - output silence
+                rbytes = numFramesToWrite * jackd->num_output_channels * 2;
                 check_zero_buff(rbytes);
                 audio_stream(zero_buff, rbytes, jackd->astream_fd);
               } else {
-                if ((mainw->agen_key == 0 && !mainw->agen_needs_reinit) && !mainw->multitrack && !mainw->preview)
-                  xbuf = (unsigned char *)cache_buffer->buffer16[0];
+                if ((mainw->agen_key == 0 && !mainw->agen_needs_reinit) && !mainw->multitrack && !mainw->preview
+                    && !cache_underrun)
+                  jack_stream_out(jackd, (uint8_t *)cache_buffer->buffer16[0], NULL, numFramesToWrite);
                 else {
-                  // plugin is generating and we are streaming: convert fbuffer to s16
-                  float **fp = (float **)lives_malloc(jackd->num_output_channels * sizeof(float *));
-                  for (i = 0; i < jackd->num_output_channels; i++) {
-                    fp[i] = fbuffer + i;
-                  }
-                  xbuf = (unsigned char *)lives_malloc(nbytes * jackd->num_output_channels);
-                  sample_move_float_int((void *)xbuf, fp, numFramesToWrite, 1.0,
-                                        jackd->num_output_channels, 16, 0, TRUE, TRUE, 1.0);
+                  // plugin is generating and we are streaming: convert out_buffer to s16
+                  jack_stream_out(jackd, NULL, out_buffer, numFramesToWrite);
                 }
-
-                if (jackd->num_output_channels != 2) {
-                  // need to remap channels to stereo (assumed for now)
-                  size_t bysize = 4, tsize = 0;
-                  unsigned char *inbuf, *oinbuf = NULL;
-
-                  if ((mainw->agen_key != 0 || mainw->agen_needs_reinit) && !mainw->multitrack && !mainw->preview)
-                    inbuf = (unsigned char *)cache_buffer->buffer16[0];
-                  else oinbuf = inbuf = xbuf;
-
-                  xbuf = (unsigned char *)lives_malloc(nbytes);
-                  if (!xbuf) {
-                    // external streaming
-                    rbytes = numFramesToWrite * jackd->num_output_channels * 2;
-                    if (check_zero_buff(rbytes))
-                      audio_stream(zero_buff, rbytes, jackd->astream_fd);
-                    return 0;
-                  }
-                  if (jackd->num_output_channels == 1) bysize = 2;
-                  while (nbytes > 0) {
-                    lives_memcpy(xbuf + tsize, inbuf, bysize);
-                    tsize += bysize;
-                    nbytes -= bysize;
-                    if (bysize == 2) {
-                      // duplicate mono channel
-                      lives_memcpy(xbuf + tsize, inbuf, bysize);
-                      tsize += bysize;
-                      nbytes -= bysize;
-                      inbuf += bysize;
-                    } else {
-                      // or skip extra channels
-                      inbuf += jackd->num_output_channels * 4;
-                    }
-                  }
-                  nbytes = numFramesToWrite * jackd->num_output_channels * 4;
-                  lives_freep((void **)&oinbuf);
-                }
-
-                // push to stream
-                rbytes = numFramesToWrite * jackd->num_output_channels * 2;
-                audio_stream(xbuf, rbytes, jackd->astream_fd);
-                if (((mainw->agen_key != 0 || mainw->agen_needs_reinit) && !mainw->multitrack
-                     && !mainw->preview) || xbuf != (unsigned char *)cache_buffer->buffer16[0]) lives_free(xbuf);
               }
             } // end audio stream
-            lives_freep((void **)&fbuffer);
           } else {
             // no generator plugin, but audio is muted
             output_silence(0, numFramesToWrite, jackd, out_buffer);
@@ -942,40 +1078,7 @@ static int audio_process(nframes_t nframes, void *arg) {
 
             if (jackd->astream_fd != -1) {
               // audio streaming if enabled
-              unsigned char *xbuf = (unsigned char *)out_buffer;
-              nbytes = numFramesToWrite * jackd->num_output_channels * 4;
-
-              if (jackd->num_output_channels != 2) {
-                // need to remap channels to stereo (assumed for now)
-                size_t bysize = 4, tsize = 0;
-                unsigned char *inbuf = (unsigned char *)out_buffer;
-                xbuf = (unsigned char *)lives_malloc(nbytes);
-                if (!xbuf) {
-                  output_silence(0, numFramesToWrite, jackd, out_buffer);
-                  return 0;
-                }
-
-                if (jackd->num_output_channels == 1) bysize = 2;
-                while (nbytes > 0) {
-                  lives_memcpy(xbuf + tsize, inbuf, bysize);
-                  tsize += bysize;
-                  nbytes -= bysize;
-                  if (bysize == 2) {
-                    // duplicate mono channel
-                    lives_memcpy(xbuf + tsize, inbuf, bysize);
-                    tsize += bysize;
-                    nbytes -= bysize;
-                    inbuf += bysize;
-                  } else {
-                    // or skip extra channels
-                    inbuf += jackd->num_output_channels * 4;
-                  }
-                }
-                nbytes = numFramesToWrite * jackd->num_output_channels * 2;
-              }
-              rbytes = numFramesToWrite * jackd->num_output_channels * 2;
-              audio_stream(xbuf, rbytes, jackd->astream_fd);
-              if (xbuf != (unsigned char *)out_buffer) lives_free(xbuf);
+              jack_stream_out(jackd, NULL, out_buffer, numFramesToWrite);
             }
           } else {
             // muted or no audio available
@@ -1039,6 +1142,20 @@ static int audio_process(nframes_t nframes, void *arg) {
 }
 
 
+static int audio_process(nframes_t nframes, void *arg) {
+  jack_driver_t *jackd = (jack_driver_t *)arg;
+  jack_time_t tstart;
+  int ret;
+
+  if (!jackd) return 0;
+
+  tstart = jack_get_time();
+  ret = audio_process_inner(nframes, jackd);
+  jack_update_rt_stats(jackd, nframes, tstart);
+  return ret;
+}
+
+
 int lives_start_ready_callback(jack_transport_state_t state, jack_position_t *pos, void *arg) {
   // mainw->video_seek_ready is generally FALSE
   // if we are not playing, the transport poll should start playing which will set set
@@ -1131,7 +1248,7 @@ static size_t audio_read_inner(jack_driver_t *jackd, float **in_buffer, int ofil
   frames_out = (int64_t)((double)nframes / out_scale + 1.);
   bytes_out = frames_out * ofile->achans * (ofile->asampsize >> 3);
 
-  holding_buff = lives_malloc(bytes_out);
+  holding_buff = jack_scratch_get(jackd, JACK_SCRATCH_HOLD, bytes_out);
   if (!holding_buff) return 0;
 
   frames_out = sample_move_float_int(holding_buff, in_buffer, nframes, out_scale, ofile->achans,
@@ -1149,6 +1266,7 @@ static size_t audio_read_inner(jack_driver_t *jackd, float **in_buffer, int ofil
   if (jrb < JACK_READ_BYTES && (mainw->rec_samples == -1 || frames_out < mainw->rec_samples)) {
     // buffer until we have enough
     lives_memcpy(&jrbuf[jrb - rbytes], holding_buff, rbytes);
+    jack_scratch_release(jackd, JACK_SCRATCH_HOLD, holding_buff);
     return rbytes;
   }
 
@@ -1161,13 +1279,13 @@ static size_t audio_read_inner(jack_driver_t *jackd, float **in_buffer, int ofil
     jack_flush_read_data(rbytes, holding_buff);
   }
 
-  lives_free(holding_buff);
+  jack_scratch_release(jackd, JACK_SCRATCH_HOLD, holding_buff);
 
   return rbytes;
 }
 
 
-static int audio_read(nframes_t nframes, void *arg) {
+static int audio_read_process(nframes_t nframes, jack_driver_t *jackd) {
   // read nframes from jack buffer, and then write to mainw->aud_rec_fd
 
   // this is the jack callback for when we are recording audio
@@ -1177,7 +1295,6 @@ static int audio_read(nframes_t nframes, void *arg) {
 
   // TODO - get abs_maxvol_heard
 
-  jack_driver_t *jackd = (jack_driver_t *)arg;
   float *in_buffer[jackd->num_input_channels];
   float out_scale;
   float tval = 0;
@@ -1264,6 +1381,15 @@ static int audio_read(nframes_t nframes, void *arg) {
 }
 
 
+static int audio_read(nframes_t nframes, void *arg) {
+  jack_driver_t *jackd = (jack_driver_t *)arg;
+  jack_time_t tstart = jack_get_time();
+  int ret = audio_read_process(nframes, jackd);
+  jack_update_rt_stats(jackd, nframes, tstart);
+  return ret;
+}
+
+
 int jack_get_srate(nframes_t nframes, void *arg) {
   //lives_printerr("the sample rate is now %ld/sec\n", (int64_t)nframes);
   // TODO: reset timebase
@@ -1276,7 +1402,7 @@ void jack_shutdown(void *arg) {
 
   jackd->client = NULL; /* reset client */
   jackd->jackd_died = TRUE;
-  jackd->msgq = NULL;
+  jack_cmdq_flush(jackd);
 
   lives_printerr("jack shutdown, setting client to 0 and jackd_died to true\n");
   lives_printerr("trying to reconnect right now\n");
@@ -1288,7 +1414,7 @@ void jack_shutdown(void *arg) {
   // TODO: init reader as well
 
   mainw->jackd = jack_get_driver(0, TRUE);
-  mainw->jackd->msgq = NULL;
+  jack_cmdq_flush(mainw->jackd);
 
   if (mainw->jackd->playing_file != -1 && afile)
     jack_audio_seek_bytes(mainw->jackd, mainw->jackd->seek_pos, afile); // at least re-seek to the right place
@@ -1315,6 +1441,7 @@ void jack_close_device(jack_driver_t *jackd) {
   jackd->client = NULL;
 
   jackd->is_active = FALSE;
+  jack_scratch_free(jackd);
 
   /* free up the port strings */
   //lives_printerr("freeing up port strings\n");
@@ -1414,6 +1541,9 @@ boolean jack_create_client_writer(jack_driver_t *jackd) {
      just decides to stop calling us. */
   jack_on_shutdown(jackd->client, jack_shutdown, jackd);
 
+  jack_set_buffer_size_callback(jackd->client, jack_bufsize_changed, jackd);
+  jack_set_xrun_callback(jackd->client, jack_xrun, jackd);
+
   jack_set_process_callback((jack_client_t *)jackd->client, audio_process, jackd);
 
   return TRUE;
@@ -1482,6 +1612,9 @@ boolean jack_create_client_reader(jack_driver_t *jackd) {
      just decides to stop calling us. */
   jack_on_shutdown(jackd->client, jack_shutdown, jackd);
 
+  jack_set_buffer_size_callback(jackd->client, jack_bufsize_changed, jackd);
+  jack_set_xrun_callback(jackd->client, jack_xrun, jackd);
+
   jrb = 0;
   // set process callback and start
   jack_set_process_callback(jackd->client, audio_read, jackd);
@@ -1498,6 +1631,8 @@ boolean jack_write_driver_activate(jack_driver_t *jackd) {
 
   if (jackd->is_active) return TRUE; // already running
 
+  jack_scratch_alloc(jackd, jack_get_buffer_size(jackd->client));
+
   /* tell the JACK server that we are ready to roll */
   if (jack_activate(jackd->client)) {
     LIVES_ERROR("Cannot activate jack writer client");
@@ -1575,6 +1710,7 @@ boolean jack_read_driver_activate(jack_driver_t *jackd, boolean autocon) {
   int i;
 
   if (!jackd->is_active) {
+    jack_scratch_alloc(jackd, jack_get_buffer_size(jackd->client));
     if (jack_activate(jackd->client)) {
       LIVES_ERROR("Cannot activate jack reader client");
       return FALSE;
@@ -1678,7 +1814,8 @@ int jack_audio_init(void) {
     jackd->state = (jack_transport_state_t)JackTClosed;
     jackd->sample_out_rate = jackd->sample_in_rate = 0;
     jackd->seek_pos = jackd->seek_end = jackd->real_seek_pos = 0;
-    jackd->msgq = NULL;
+    jackd->cmdq_head = jackd->cmdq_tail = 0;
+    jack_reset_rt_stats(jackd);
     jackd->num_calls = 0;
     jackd->astream_fd = -1;
     jackd->abs_maxvol_heard = 0.;
@@ -1711,7 +1848,8 @@ int jack_audio_read_init(void) {
     jackd->state = (jack_transport_state_t)JackTClosed;
     jackd->sample_out_rate = jackd->sample_in_rate = 0;
     jackd->seek_pos = jackd->seek_end = jackd->real_seek_pos = 0;
-    jackd->msgq = NULL;
+    jackd->cmdq_head = jackd->cmdq_tail = 0;
+    jack_reset_rt_stats(jackd);
     jackd->num_calls = 0;
     jackd->astream_fd = -1;
     jackd->abs_maxvol_heard = 0.;
@@ -1728,12 +1866,6 @@ int jack_audio_read_init(void) {
 }
 
 
-volatile aserver_message_t *jack_get_msgq(jack_driver_t *jackd) {
-  if (jackd->jackd_died || mainw->aplayer_broken) return NULL;
-  return jackd->msgq;
-}
-
-
 void jack_time_reset(jack_driver_t *jackd, int64_t offset) {
   jackd->nframes_start = jack_frame_time(jack_transport_client) + (jack_nframes_t)((float)(offset / USEC_TO_TICKS) *
                          (jack_get_sample_rate(jackd->client) / 1000000.));
@@ -1745,16 +1877,15 @@ void jack_time_reset(jack_driver_t *jackd, int64_t offset) {
 
 ticks_t lives_jack_get_time(jack_driver_t *jackd) {
   // get the time in ticks since playback started
-  volatile aserver_message_t *msg = jackd->msgq;
   jack_nframes_t frames, retframes;
   static jack_nframes_t last_frames = 0;
 
   if (!jackd->client) return -1;
 
-  if (msg && msg->command == ASERVER_CMD_FILE_SEEK) {
+  if (jack_cmdq_peek(jackd) == ASERVER_CMD_FILE_SEEK) {
     ticks_t timeout;
     lives_alarm_t alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
-    while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(jackd)) {
+    while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(jackd)) {
       sched_yield(); // wait for seek
       lives_usleep(prefs->sleep_time);
     }
@@ -1789,10 +1920,10 @@ boolean jack_audio_seek_frame(jack_driver_t *jackd, double frame) {
   // seek to frame "frame" in current audio file
   // position will be adjusted to (floor) nearest sample
 
-  volatile aserver_message_t *jmsg;
   int64_t seekstart;
   ticks_t timeout;
   double thresh = 0., delta = 0.;
+  int cmd;
   lives_alarm_t alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
 
   if (alarm_handle == ALL_USED) return FALSE;
@@ -1800,8 +1931,9 @@ boolean jack_audio_seek_frame(jack_driver_t *jackd, double frame) {
   if (frame < 1) frame = 1;
 
   do {
-    jmsg = jack_get_msgq(jackd);
-  } while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jmsg && jmsg->command != ASERVER_CMD_FILE_SEEK);
+    cmd = jack_cmdq_peek(jackd);
+  } while ((timeout = lives_alarm_check(alarm_handle)) > 0 && cmd != ASERVER_CMD_PROCESSED
+           && cmd != ASERVER_CMD_FILE_SEEK);
   lives_alarm_clear(alarm_handle);
   if (timeout == 0 || jackd->playing_file == -1) {
     return FALSE;
@@ -1809,7 +1941,8 @@ boolean jack_audio_seek_frame(jack_driver_t *jackd, double frame) {
   if (frame > afile->frames && afile->frames != 0) frame = afile->frames;
   seekstart = (int64_t)((double)(frame - 1.) / afile->fps * afile->arps) * afile->achans * (afile->asampsize / 8);
   if (cache_buffer) {
-    delta = (double)(seekstart - lives_buffered_offset(cache_buffer->_fd)) / (double)(afile->arps * afile->achans *
+    /// the file offset runs ahead of playback when the cache thread reads ahead, so compare with the last request served
+    delta = (double)(seekstart - cache_buffer->_cseek) / (double)(afile->arps * afile->achans *
             (afile->asampsize / 8));
     thresh = 1. / (double)afile->fps;
   }
@@ -1825,10 +1958,10 @@ int64_t jack_audio_seek_bytes(jack_driver_t *jackd, int64_t bytes, lives_clip_t
 
   // if the position is > size of file, we will seek to the end of the file
 
-  volatile aserver_message_t *jmsg;
   int64_t seekstart;
 
   ticks_t timeout;
+  int cmd;
   lives_alarm_t alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
 
   fwd_seek_pos = bytes;
@@ -1842,8 +1975,9 @@ int64_t jack_audio_seek_bytes(jack_driver_t *jackd, int64_t bytes, lives_clip_t
 
   if (jackd->in_use) {
     do {
-      jmsg = jack_get_msgq(jackd);
-    } while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jmsg && jmsg->command != ASERVER_CMD_FILE_SEEK);
+      cmd = jack_cmdq_peek(jackd);
+    } while ((timeout = lives_alarm_check(alarm_handle)) > 0 && cmd != ASERVER_CMD_PROCESSED
+             && cmd != ASERVER_CMD_FILE_SEEK);
     lives_alarm_clear(alarm_handle);
     if (timeout == 0 || jackd->playing_file == -1) {
       if (timeout == 0) LIVES_WARN("Jack connect timed out");
@@ -1856,12 +1990,7 @@ int64_t jack_audio_seek_bytes(jack_driver_t *jackd, int64_t bytes, lives_clip_t
 
   if (seekstart < 0) seekstart = 0;
   if (seekstart > sfile->afilesize) seekstart = sfile->afilesize;
-  jack_message2.command = ASERVER_CMD_FILE_SEEK;
-  jack_message2.tc = lives_get_current_ticks();
-  jack_message2.next = NULL;
-  jack_message2.data = lives_strdup_printf("%"PRId64, seekstart);
-  if (!jackd->msgq) jackd->msgq = &jack_message2;
-  else jackd->msgq->next = &jack_message2;
+  if (!jack_send_cmd(jackd, ASERVER_CMD_FILE_SEEK, seekstart)) seek_err = TRUE;
   return seekstart;
 }
 
@@ -1931,7 +2060,7 @@ void jack_aud_pb_ready(int fileno) {
       else mainw->jackd->reverse_endian = FALSE;
 
       alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
-      while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(mainw->jackd)) {
+      while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(mainw->jackd)) {
         sched_yield(); // wait for seek
         lives_usleep(prefs->sleep_time);
       }
@@ -1941,11 +2070,7 @@ void jack_aud_pb_ready(int fileno) {
       if ((!mainw->multitrack || mainw->multitrack->is_rendering) &&
           (!mainw->event_list || mainw->record || (mainw->preview && mainw->is_processing))) {
         // tell jack server to open audio file and start playing it
-        jack_message.command = ASERVER_CMD_FILE_OPEN;
-        jack_message.data = lives_strdup_printf("%d", fileno);
-
-        jack_message.next = NULL;
-        mainw->jackd->msgq = &jack_message;
+        jack_send_cmd(mainw->jackd, ASERVER_CMD_FILE_OPEN, fileno);
 
         jack_audio_seek_bytes(mainw->jackd, sfile->aseek_pos, sfile);
         if (seek_err) {
@@ -58,6 +58,38 @@ typedef jack_nframes_t nframes_t;
 #define JackTReset 1025
 #define JackTStopped 1026
 
+/// commands for the process callback are passed through a fixed size ring, so the callback never allocates or blocks
+#define JACK_CMDQ_SIZE 16 ///< must be a power of 2
+
+typedef struct {
+  int command; ///< one of ASERVER_CMD_*
+  int64_t arg; ///< clip number for ASERVER_CMD_FILE_OPEN, byte offset for ASERVER_CMD_FILE_SEEK
+} jack_cmd_t;
+
+/// scratch buffers used inside the callbacks; they are sized when the client is activated and when the buffer size changes
+#define JACK_SCRATCH_HOLD 0 ///< converted audio for recording
+#define JACK_SCRATCH_CONV 1 ///< float to s16 conversion for streaming
+#define JACK_SCRATCH_REMAP 2 ///< s16 stereo remap for streaming
+#define JACK_N_SCRATCH 3
+
+/// bytes per frame reserved in each scratch buffer; enough for all ports as float, with resampling up to 2x
+#define JACK_SCRATCH_FRAME_BYTES (JACK_MAX_OUTPUT_PORTS * sizeof(float) * 2)
+
+/// longest the playback callback will wait for the audio cache thread, as a fraction of the period
+#define JACK_CACHE_WAIT_FRAC 0.5
+
+/// realtime counters, updated by the callbacks and polled via jack_get_rt_stats() (exposed over OSC as /lives/jack/stats/get)
+typedef struct {
+  volatile uint64_t xruns; ///< xruns reported by the server
+  volatile float max_xrun_delay; ///< longest delay reported for an xrun (usec)
+  volatile uint64_t last_cycle_usec; ///< time spent in the most recent callback
+  volatile uint64_t max_cycle_usec; ///< longest time spent in a callback
+  volatile uint64_t period_usec; ///< duration of the most recent period
+  volatile uint64_t late_cycles; ///< callbacks which took longer than the period
+  volatile uint64_t rt_allocs; ///< times a scratch buffer was too small and the callback had to allocate
+  volatile uint64_t cmd_overflows; ///< commands dropped because the queue was full
+} lives_jack_rt_stats_t;
+
 typedef struct {
   int      dev_idx;                      /**< id of this device ??? */
   int     sample_out_rate;                   /**< samples(frames) per second */
@@ -85,7 +117,14 @@ typedef struct {
   boolean          in_use;                        /**< true if this device is currently in use */
   boolean mute;
 
-  volatile aserver_message_t   *msgq;          /**< linked list of messages we are sending to the callback process */
+  jack_cmd_t cmdq[JACK_CMDQ_SIZE]; /**< commands we are sending to the callback process */
+  volatile uint32_t cmdq_head; ///< next slot to write, only changed by the sender
+  volatile uint32_t cmdq_tail; ///< next slot to read, only changed by the callback
+
+  void *scratch[JACK_N_SCRATCH];
+  size_t scratch_size; ///< size in bytes of each scratch buffer
+
+  lives_jack_rt_stats_t rt_stats;
 
   off_t seek_pos;
   volatile off_t real_seek_pos;
@@ -153,7 +192,12 @@ void jack_pb_end(void);
 size_t jack_flush_read_data(size_t rbytes, void *data);
 
 // utils
-volatile aserver_message_t *jack_get_msgq(jack_driver_t *); ///< pull last msg from msgq, or return NULL
+boolean jack_send_cmd(jack_driver_t *, int command, int64_t arg); ///< queue a command for the callback
+boolean jack_send_cmds(jack_driver_t *, const jack_cmd_t *cmds, int ncmds); ///< queue commands to be seen together
+boolean jack_cmdq_pending(jack_driver_t *); ///< TRUE if the callback has not yet processed all commands
+int jack_cmdq_peek(jack_driver_t *); ///< command at the head of the queue, or ASERVER_CMD_PROCESSED if it is empty
+void jack_get_rt_stats(jack_driver_t *, lives_jack_rt_stats_t *);
+void jack_reset_rt_stats(jack_driver_t *);
 void jack_time_reset(jack_driver_t *, int64_t offset);
 ticks_t lives_jack_get_time(jack_driver_t *); ///< get time from jack, in 10^-8 seconds
 boolean jack_audio_seek_frame(jack_driver_t *, double frame);  ///< seek to (video) frame
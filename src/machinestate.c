@@ -32,6 +32,37 @@ static int get_cacheline_size(void) {
 }
 
 
+static void cpuid_count(unsigned int ax, unsigned int cx, unsigned int *p) {
+  __asm __volatile
+  ("movl %%ebx, %%esi\n\tcpuid\n\txchgl %%ebx, %%esi"
+   : "=a"(p[0]), "=S"(p[1]), "=c"(p[2]), "=d"(p[3])
+   : "0"(ax), "2"(cx));
+}
+
+
+/// check for vector extensions usable by the colour conversion kernels
+uint64_t get_cpu_simd_caps(void) {
+  uint64_t caps = 0;
+#if defined (__x86_64__) || defined (__i386__)
+  unsigned int regs[4], regs1[4], regs7[4];
+  cpuid(0x00000000, regs);
+  if (regs[0] < 0x00000001) return 0;
+  cpuid(0x00000001, regs1);
+  if (regs1[2] & (1 << 19)) caps |= CPU_SIMD_SSE4_1;
+  if (regs[0] >= 0x00000007 && (regs1[2] & (1 << 27)) && (regs1[2] & (1 << 28))) {
+    // AVX needs OS support for saving the ymm registers (XCR0 bits 1 and 2)
+    unsigned int xlo, xhi;
+    __asm __volatile("xgetbv" : "=a"(xlo), "=d"(xhi) : "c"(0));
+    if ((xlo & 6) == 6) {
+      cpuid_count(0x00000007, 0, regs7);
+      if (regs7[1] & (1 << 5)) caps |= CPU_SIMD_AVX2;
+    }
+  }
+#endif
+  return caps;
+}
+
+
 static uint64_t fastrand_val = 0;
 
 LIVES_GLOBAL_INLINE uint64_t fastrand(void) {
@@ -2126,16 +2157,70 @@ void resubmit_proc_thread(lives_proc_thread_t thread_info, lives_thread_attr_t a
 #else
 #define MINPOOLTHREADS 2
 #endif
-static int npoolthreads;
-static pthread_t **poolthrds;
-static pthread_cond_t tcond  = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t tcond_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#define MAXPOOLTHREADS 1024 ///< hard limit on the number of worker slots
+#define DEF_MAXPOOLTHREADS_PER_CPU 8 ///< default ceiling (if prefs->max_pool_threads is 0) is this times ncpus
+
+#define POOL_IDLE_TIMEOUT 30 ///< seconds a surplus worker may sleep before it exits
+#define POOL_INLINE_ID (MAXPOOLTHREADS + 1) ///< reported by lives_thread_join() for tasks run by the caller
+
+#define POOL_DEQUE_SIZE 256 ///< initial capacity of each worker deque (must be a power of 2)
+#define POOL_TASK_SLAB 256 ///< tasks are allocated this many at a time
+#define POOL_MAX_SLABS 4096
+
+/// ring buffer for a worker deque. When a deque grows the old buffer is retired rather than freed,
+/// since a thief may still be reading from it.
+typedef struct _pool_deque_buf {
+  int64_t mask;
+  struct _pool_deque_buf *retired;
+  thrd_work_t *tasks[];
+} pool_deque_buf_t;
+
+/// per worker state: a Chase-Lev deque (the owner pushes and pops at the bottom, idle workers steal from the top),
+/// an inbox for tasks submitted from outside the pool, and a private cond so we can wake workers one at a time
+typedef struct {
+  volatile int64_t top __attribute__((aligned(64)));
+  volatile int64_t bottom __attribute__((aligned(64)));
+  pool_deque_buf_t *volatile buf;
+  thrd_work_t *volatile inbox __attribute__((aligned(64)));
+  volatile int sleeping;
+  volatile int signalled;
+  volatile int retired; ///< set when the worker thread exits on an idle timeout; the slot may be reused later
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_t thread;
+  lives_thread_data_t *tdata;
+} pool_worker_t;
+
+static pool_worker_t *poolworkers[MAXPOOLTHREADS];
+static volatile int npoolthreads;
+static int basepoolthreads, maxpoolthreads;
+static int pool_nslots; ///< worker slots allocated so far, live or retired
+static volatile int nsleeping;
+static volatile uint32_t next_target; ///< round robin start point for submissions from outside the pool
 static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t twork_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t twork_count_mutex = PTHREAD_MUTEX_INITIALIZER;
-static LiVESList *twork_first, *twork_last; /// FIFO list of tasks
 static volatile int ntasks;
-static boolean threads_die;
+static volatile boolean threads_die;
+
+/// counters for lives_threadpool_get_stats()
+static volatile int64_t pool_nqueued;
+static volatile int pool_bp_waiters; ///< submitters blocked by backpressure, waiting on pool_bp_cond
+static pthread_mutex_t pool_bp_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_bp_cond = PTHREAD_COND_INITIALIZER;
+static volatile uint64_t pool_ncompleted, pool_nsteals, pool_ninlined, pool_nreaped;
+static volatile int pool_peak_threads;
+static volatile ticks_t pool_total_wait, pool_max_wait;
+
+static __thread pool_worker_t *self_worker = NULL; ///< set in pool threads only
+
+/// tasks live in slabs which are never freed, and are recycled via a lock free stack;
+/// the head holds a generation count in the upper 32 bits to avoid ABA problems
+static thrd_work_t *task_slabs[POOL_MAX_SLABS];
+static volatile int ntask_slabs;
+static volatile uint64_t task_freelist; ///< (generation << 32) | (index + 1), 0 == empty
+static pthread_mutex_t slab_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#define POOL_TASK(idx) (&task_slabs[(idx) / POOL_TASK_SLAB][(idx) % POOL_TASK_SLAB])
 
 static LiVESList *allctxs = NULL;
 
@@ -2160,13 +2245,6 @@ LIVES_GLOBAL_INLINE lives_threadvars_t *get_threadvars(void) {
   return &thrdat->vars;
 }
 
-static lives_thread_data_t *get_thread_data_by_id(uint64_t idx) {
-  LiVESList *list = allctxs;
-  for (; list; list = list->next) {
-    if (((lives_thread_data_t *)list->data)->idx == idx) return list->data;
-  }
-  return NULL;
-}
 
 lives_thread_data_t *lives_thread_data_create(uint64_t idx) {
   lives_thread_data_t *tdata = (lives_thread_data_t *)lives_calloc(1, sizeof(lives_thread_data_t));
@@ -2181,38 +2259,302 @@ lives_thread_data_t *lives_thread_data_create(uint64_t idx) {
 }
 
 
-static boolean gsrc_wrapper(livespointer data) {
-  thrd_work_t *mywork = (thrd_work_t *)data;
-  (*mywork->func)(mywork->arg);
+static void task_free(thrd_work_t *work) {
+  uint64_t head = __atomic_load_n(&task_freelist, __ATOMIC_RELAXED), nhead;
+  do {
+    __atomic_store_n(&work->fl_next, (uint32_t)head, __ATOMIC_RELAXED);
+    nhead = ((((head >> 32) + 1) << 32) | (uint64_t)(work->fl_idx + 1));
+  } while (!__atomic_compare_exchange_n(&task_freelist, &head, nhead, TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+
+static boolean task_slab_add(void) {
+  thrd_work_t *slab;
+  int nslabs;
+  pthread_mutex_lock(&slab_mutex);
+  if ((uint32_t)__atomic_load_n(&task_freelist, __ATOMIC_ACQUIRE)) {
+    // somebody beat us to it
+    pthread_mutex_unlock(&slab_mutex);
+    return TRUE;
+  }
+  nslabs = ntask_slabs;
+  if (nslabs == POOL_MAX_SLABS) {
+    pthread_mutex_unlock(&slab_mutex);
+    return FALSE;
+  }
+  slab = (thrd_work_t *)lives_calloc(POOL_TASK_SLAB, sizeof(thrd_work_t));
+  if (!slab) {
+    pthread_mutex_unlock(&slab_mutex);
+    return FALSE;
+  }
+  task_slabs[nslabs] = slab;
+  __atomic_store_n(&ntask_slabs, nslabs + 1, __ATOMIC_RELEASE);
+  for (int i = POOL_TASK_SLAB - 1; i >= 0; i--) {
+    slab[i].fl_idx = nslabs * POOL_TASK_SLAB + i;
+    task_free(&slab[i]);
+  }
+  pthread_mutex_unlock(&slab_mutex);
+  return TRUE;
+}
+
+
+static thrd_work_t *task_alloc(void) {
+  uint64_t head = __atomic_load_n(&task_freelist, __ATOMIC_ACQUIRE), nhead;
+  thrd_work_t *work;
+  uint32_t idx;
+  while (1) {
+    if (!(uint32_t)head) {
+      if (!task_slab_add()) LIVES_FATAL("Unable to allocate tasks for the thread pool");
+      head = __atomic_load_n(&task_freelist, __ATOMIC_ACQUIRE);
+      continue;
+    }
+    // slabs are never freed, so reading fl_next is safe even if another thread popped the task first;
+    // the generation count then makes the CAS fail
+    work = POOL_TASK((uint32_t)head - 1);
+    nhead = ((((head >> 32) + 1) << 32) | (uint64_t)__atomic_load_n(&work->fl_next, __ATOMIC_RELAXED));
+    if (__atomic_compare_exchange_n(&task_freelist, &head, nhead, TRUE, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) break;
+  }
+  idx = work->fl_idx;
+  lives_memset(work, 0, sizeof(thrd_work_t));
+  work->fl_idx = idx;
+  return work;
+}
+
+
+static pool_deque_buf_t *deque_buf_new(int64_t size) {
+  pool_deque_buf_t *buf = (pool_deque_buf_t *)lives_calloc(1, sizeof(pool_deque_buf_t) + size * sizeof(thrd_work_t *));
+  buf->mask = size - 1;
+  return buf;
+}
+
+
+static pool_deque_buf_t *deque_grow(pool_worker_t *w, pool_deque_buf_t *buf, int64_t t, int64_t b) {
+  pool_deque_buf_t *nbuf = deque_buf_new((buf->mask + 1) << 1);
+  for (int64_t i = t; i < b; i++)
+    nbuf->tasks[i & nbuf->mask] = __atomic_load_n(&buf->tasks[i & buf->mask], __ATOMIC_RELAXED);
+  nbuf->retired = buf;
+  __atomic_store_n(&w->buf, nbuf, __ATOMIC_RELEASE);
+  return nbuf;
+}
+
+
+/// owner only
+static void deque_push(pool_worker_t *w, thrd_work_t *work) {
+  int64_t b = __atomic_load_n(&w->bottom, __ATOMIC_RELAXED);
+  int64_t t = __atomic_load_n(&w->top, __ATOMIC_ACQUIRE);
+  pool_deque_buf_t *buf = __atomic_load_n(&w->buf, __ATOMIC_RELAXED);
+  if (b - t > buf->mask) buf = deque_grow(w, buf, t, b);
+  __atomic_store_n(&buf->tasks[b & buf->mask], work, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&w->bottom, b + 1, __ATOMIC_RELAXED);
+}
+
+
+/// owner only
+static thrd_work_t *deque_pop(pool_worker_t *w) {
+  int64_t b = __atomic_load_n(&w->bottom, __ATOMIC_RELAXED) - 1, t;
+  pool_deque_buf_t *buf = __atomic_load_n(&w->buf, __ATOMIC_RELAXED);
+  thrd_work_t *work = NULL;
+  __atomic_store_n(&w->bottom, b, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  t = __atomic_load_n(&w->top, __ATOMIC_RELAXED);
+  if (t <= b) {
+    work = __atomic_load_n(&buf->tasks[b & buf->mask], __ATOMIC_RELAXED);
+    if (t == b) {
+      // last task, race against any thieves
+      if (!__atomic_compare_exchange_n(&w->top, &t, t + 1, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        work = NULL;
+      __atomic_store_n(&w->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+  } else __atomic_store_n(&w->bottom, b + 1, __ATOMIC_RELAXED);
+  return work;
+}
+
+
+/// any thread
+static thrd_work_t *deque_steal(pool_worker_t *w) {
+  int64_t t = __atomic_load_n(&w->top, __ATOMIC_ACQUIRE), b;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  b = __atomic_load_n(&w->bottom, __ATOMIC_ACQUIRE);
+  if (t < b) {
+    pool_deque_buf_t *buf = __atomic_load_n(&w->buf, __ATOMIC_ACQUIRE);
+    thrd_work_t *work = __atomic_load_n(&buf->tasks[t & buf->mask], __ATOMIC_RELAXED);
+    if (__atomic_compare_exchange_n(&w->top, &t, t + 1, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+      return work;
+  }
+  return NULL;
+}
+
+
+static void inbox_push(pool_worker_t *w, thrd_work_t *work) {
+  thrd_work_t *head = __atomic_load_n(&w->inbox, __ATOMIC_RELAXED);
+  do {
+    work->qnext = head;
+  } while (!__atomic_compare_exchange_n(&w->inbox, &head, work, TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+
+/// take the whole inbox of worker w and push it into our own deque. The inbox is newest first, so pushing in
+/// that order leaves the oldest task at the bottom, where we pop it next.
+static boolean inbox_take(pool_worker_t *self, pool_worker_t *w) {
+  thrd_work_t *work, *next;
+  if (!__atomic_load_n(&w->inbox, __ATOMIC_RELAXED)) return FALSE;
+  work = __atomic_exchange_n(&w->inbox, NULL, __ATOMIC_ACQUIRE);
+  if (!work) return FALSE;
+  for (; work; work = next) {
+    next = work->qnext;
+    deque_push(self, work);
+  }
+  return TRUE;
+}
+
+
+static boolean pool_has_work(void) {
+  int n = __atomic_load_n(&npoolthreads, __ATOMIC_ACQUIRE);
+  for (int i = 0; i < n; i++) {
+    pool_worker_t *w = poolworkers[i];
+    if (__atomic_load_n(&w->inbox, __ATOMIC_RELAXED)) return TRUE;
+    if (__atomic_load_n(&w->bottom, __ATOMIC_RELAXED) > __atomic_load_n(&w->top, __ATOMIC_RELAXED)) return TRUE;
+  }
   return FALSE;
 }
 
 
-boolean do_something_useful(lives_thread_data_t *tdata) {
-  /// yes, why don't you lend a hand instead of just lying around nanosleeping...
-  LiVESList *list;
-  thrd_work_t *mywork;
-  uint64_t myflags = 0;
+/// wake worker w if it is sleeping; returns TRUE if we were the ones to wake it
+static boolean pool_wake(pool_worker_t *w) {
+  int sleeping = 1;
+  if (!__atomic_load_n(&w->sleeping, __ATOMIC_SEQ_CST)) return FALSE;
+  if (!__atomic_compare_exchange_n(&w->sleeping, &sleeping, 0, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    return FALSE;
+  pthread_mutex_lock(&w->mutex);
+  w->signalled = 1;
+  pthread_cond_signal(&w->cond);
+  pthread_mutex_unlock(&w->mutex);
+  return TRUE;
+}
+
+
+static boolean pool_wake_one(void) {
+  int n, start;
+  if (!__atomic_load_n(&nsleeping, __ATOMIC_SEQ_CST)) return FALSE;
+  n = __atomic_load_n(&npoolthreads, __ATOMIC_ACQUIRE);
+  start = __atomic_fetch_add(&next_target, 1, __ATOMIC_RELAXED) % n;
+  for (int i = 0; i < n; i++) {
+    if (pool_wake(poolworkers[(start + i) % n])) return TRUE;
+  }
+  return FALSE;
+}
 
-  if (!tdata->idx) abort();
 
-  pthread_mutex_lock(&twork_mutex);
-  list = twork_last;
-  if (LIVES_UNLIKELY(!list)) {
-    pthread_mutex_unlock(&twork_mutex);
+/// returns TRUE if a surplus worker timed out waiting for work
+static boolean pool_sleep(pool_worker_t *self) {
+  boolean timedout = FALSE;
+  __atomic_add_fetch(&nsleeping, 1, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&self->sleeping, 1, __ATOMIC_SEQ_CST);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  // a task may have been queued before the submitter could see we were going to sleep
+  if (!pool_has_work() && !threads_die) {
+    pthread_mutex_lock(&self->mutex);
+    if (self->tdata->idx > basepoolthreads) {
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      ts.tv_sec += POOL_IDLE_TIMEOUT;
+      while (!self->signalled && !threads_die && !timedout)
+        timedout = (pthread_cond_timedwait(&self->cond, &self->mutex, &ts) == ETIMEDOUT);
+    } else {
+      while (!self->signalled && !threads_die) pthread_cond_wait(&self->cond, &self->mutex);
+    }
+    if (self->signalled) timedout = FALSE;
+    self->signalled = 0;
+    pthread_mutex_unlock(&self->mutex);
+  }
+  __atomic_store_n(&self->sleeping, 0, __ATOMIC_SEQ_CST);
+  __atomic_sub_fetch(&nsleeping, 1, __ATOMIC_SEQ_CST);
+  return timedout;
+}
+
+
+/// an idle surplus worker may exit, provided it occupies the highest slot, so the live slots stay contiguous.
+/// Its pool_worker_t is kept, since other threads may still be looking at it.
+static boolean pool_retire(pool_worker_t *self) {
+  int slot = self->tdata->idx - 1;
+  pthread_mutex_lock(&pool_mutex);
+  if (threads_die || slot < basepoolthreads || slot != npoolthreads - 1) {
+    pthread_mutex_unlock(&pool_mutex);
     return FALSE;
   }
+  __atomic_store_n(&self->retired, 1, __ATOMIC_SEQ_CST);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  // pairs with the check in pool_submit(); either we see the new task here, or the submitter sees retired
+  if (__atomic_load_n(&self->inbox, __ATOMIC_RELAXED)
+      || __atomic_load_n(&self->bottom, __ATOMIC_RELAXED) > __atomic_load_n(&self->top, __ATOMIC_RELAXED)) {
+    __atomic_store_n(&self->retired, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pool_mutex);
+    return FALSE;
+  }
+  __atomic_store_n(&npoolthreads, slot, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&pool_nreaped, 1, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&pool_mutex);
+  return TRUE;
+}
 
-  if (twork_first == list) twork_last = twork_first = NULL;
-  else {
-    twork_last = list->prev;
-    twork_last->next = NULL;
+
+static thrd_work_t *pool_find_work(pool_worker_t *self) {
+  thrd_work_t *work;
+  int n, start;
+  inbox_take(self, self);
+  if ((work = deque_pop(self))) return work;
+
+  // nothing of our own to do, try to steal something, starting after ourselves
+  n = __atomic_load_n(&npoolthreads, __ATOMIC_ACQUIRE);
+  start = self->tdata->idx;
+  for (int i = 0; i < n; i++) {
+    pool_worker_t *victim = poolworkers[(start + i) % n];
+    if (victim == self) continue;
+    if (inbox_take(self, victim)) {
+      __atomic_add_fetch(&pool_nsteals, 1, __ATOMIC_RELAXED);
+      if ((work = deque_pop(self))) return work;
+    }
+    if ((work = deque_steal(victim))) {
+      __atomic_add_fetch(&pool_nsteals, 1, __ATOMIC_RELAXED);
+      return work;
+    }
   }
-  pthread_mutex_unlock(&twork_mutex);
+  return NULL;
+}
+
+
+static boolean gsrc_wrapper(livespointer data) {
+  thrd_work_t *mywork = (thrd_work_t *)data;
+  (*mywork->func)(mywork->arg);
+  return FALSE;
+}
+
+
+static void pool_bp_wake(void) {
+  pthread_mutex_lock(&pool_bp_mutex);
+  pthread_cond_broadcast(&pool_bp_cond);
+  pthread_mutex_unlock(&pool_bp_mutex);
+}
 
-  mywork = (thrd_work_t *)list->data;
+
+static void pool_note_wait(thrd_work_t *mywork) {
+  ticks_t wait = lives_get_current_ticks() - mywork->qtime, maxwait;
+  // seq_cst pairs with the waiter registering itself before it checks the backlog, so no wakeup can be missed
+  if (__atomic_sub_fetch(&pool_nqueued, 1, __ATOMIC_SEQ_CST) < __atomic_load_n(&npoolthreads, __ATOMIC_RELAXED)
+      && __atomic_load_n(&pool_bp_waiters, __ATOMIC_SEQ_CST)) pool_bp_wake();
+  __atomic_add_fetch(&pool_total_wait, wait, __ATOMIC_RELAXED);
+  maxwait = __atomic_load_n(&pool_max_wait, __ATOMIC_RELAXED);
+  while (wait > maxwait && !__atomic_compare_exchange_n(&pool_max_wait, &maxwait, wait, TRUE,
+         __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+
+static void pool_run_task(lives_thread_data_t *tdata, thrd_work_t *mywork) {
+  uint64_t myflags = mywork->flags;
+
+  pool_note_wait(mywork);
   mywork->busy = tdata->idx;
-  myflags = mywork->flags;
 
   if (myflags & LIVES_THRDFLAG_WAIT_SYNC) {
     lives_nanosleep_until_nonzero(mywork->sync_ready);
@@ -2222,37 +2564,51 @@ boolean do_something_useful(lives_thread_data_t *tdata) {
   //(*mywork->func)(mywork->arg);
 
   if (myflags & LIVES_THRDFLAG_AUTODELETE) {
-    lives_free(mywork); lives_free(list);
-  } else mywork->done = tdata->idx;
+    LiVESList *list = mywork->list;
+    task_free(mywork);
+    lives_free(list);
+  } else __atomic_store_n(&mywork->done, tdata->idx, __ATOMIC_RELEASE);
+
+  __atomic_add_fetch(&pool_ncompleted, 1, __ATOMIC_RELAXED);
+  __atomic_sub_fetch(&ntasks, 1, __ATOMIC_RELAXED);
+}
+
+
+boolean do_something_useful(lives_thread_data_t *tdata) {
+  /// yes, why don't you lend a hand instead of just lying around nanosleeping...
+  thrd_work_t *mywork;
+
+  if (!tdata->idx) abort();
+  if (!self_worker) return FALSE;
+
+  mywork = pool_find_work(self_worker);
+  if (LIVES_UNLIKELY(!mywork)) return FALSE;
 
-  pthread_mutex_lock(&twork_count_mutex);
-  ntasks--;
-  pthread_mutex_unlock(&twork_count_mutex);
+  pool_run_task(tdata, mywork);
   return TRUE;
 }
 
 
 static void *thrdpool(void *arg) {
-  boolean skip_wait = FALSE;
-  lives_thread_data_t *tdata = (lives_thread_data_t *)arg;
+  pool_worker_t *self = (pool_worker_t *)arg;
+  lives_thread_data_t *tdata = self->tdata;
   if (!rpmalloc_is_thread_initialized()) {
     rpmalloc_thread_initialize();
   }
 
+  self_worker = self;
   lives_widget_context_push_thread_default(tdata->ctx);
 
   while (!threads_die) {
-    if (!skip_wait) {
-      pthread_mutex_lock(&tcond_mutex);
-      pthread_cond_wait(&tcond, &tcond_mutex);
-      pthread_mutex_unlock(&tcond_mutex);
+    if (!do_something_useful(tdata)) {
+      if (pool_sleep(self) && pool_retire(self)) break;
+      continue;
     }
-    if (LIVES_UNLIKELY(threads_die)) break;
-    skip_wait = do_something_useful(tdata);
     if (rpmalloc_is_thread_initialized()) {
       rpmalloc_thread_collect();
     }
   }
+  lives_widget_context_pop_thread_default(tdata->ctx);
   if (rpmalloc_is_thread_initialized()) {
     rpmalloc_thread_finalize();
   }
@@ -2274,50 +2630,166 @@ LIVES_GLOBAL_INLINE weed_plant_t *lives_plant_new_with_index(int subtype, int64_
 }
 
 
+/// add nthreads workers to the pool, reusing slots of retired workers; must be called with pool_mutex held
+static void pool_add_workers(int nthreads) {
+  int first = npoolthreads;
+  if (first + nthreads > maxpoolthreads) nthreads = maxpoolthreads - first;
+  if (nthreads <= 0) return;
+  for (int i = first; i < first + nthreads; i++) {
+    pool_worker_t *w = poolworkers[i];
+    if (w) {
+      // the old thread has left (or is leaving) its main loop
+      pthread_join(w->thread, NULL);
+      w->signalled = 0;
+      __atomic_store_n(&w->retired, 0, __ATOMIC_SEQ_CST);
+      continue;
+    }
+    w = (pool_worker_t *)lives_calloc(1, sizeof(pool_worker_t));
+    w->buf = deque_buf_new(POOL_DEQUE_SIZE);
+    pthread_mutex_init(&w->mutex, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    w->tdata = lives_thread_data_create(i + 1);
+    poolworkers[i] = w;
+    pool_nslots = i + 1;
+  }
+  // publish the new slots before starting them, so they can steal from each other straight away
+  __atomic_store_n(&npoolthreads, first + nthreads, __ATOMIC_RELEASE);
+  if (first + nthreads > pool_peak_threads) pool_peak_threads = first + nthreads;
+  for (int i = first; i < first + nthreads; i++) {
+    pthread_create(&poolworkers[i]->thread, NULL, thrdpool, poolworkers[i]);
+  }
+}
+
+
 void lives_threadpool_init(void) {
-  npoolthreads = MINPOOLTHREADS;
-  if (prefs->nfx_threads > npoolthreads) npoolthreads = prefs->nfx_threads;
-  poolthrds = (pthread_t **)lives_calloc(npoolthreads, sizeof(pthread_t *));
+  int nthreads = MINPOOLTHREADS;
+  if (prefs->nfx_threads > nthreads) nthreads = prefs->nfx_threads;
+  if (nthreads > MAXPOOLTHREADS) nthreads = MAXPOOLTHREADS;
+
+  maxpoolthreads = prefs->max_pool_threads;
+  if (maxpoolthreads <= 0) maxpoolthreads = capable->ncpus * DEF_MAXPOOLTHREADS_PER_CPU;
+  if (maxpoolthreads < nthreads) maxpoolthreads = nthreads;
+  if (maxpoolthreads > MAXPOOLTHREADS) maxpoolthreads = MAXPOOLTHREADS;
+  basepoolthreads = nthreads;
+
   threads_die = FALSE;
-  twork_first = twork_last = NULL;
-  ntasks = 0;
-  for (int i = 0; i < npoolthreads; i++) {
-    lives_thread_data_t *tdata = lives_thread_data_create(i + 1);
-    poolthrds[i] = (pthread_t *)lives_malloc(sizeof(pthread_t));
-    pthread_create(poolthrds[i], NULL, thrdpool, tdata);
-  }
+  ntasks = nsleeping = 0;
+  pool_nqueued = 0;
+  pool_ncompleted = pool_nsteals = pool_ninlined = pool_nreaped = 0;
+  pool_total_wait = pool_max_wait = 0;
+  pthread_mutex_lock(&pool_mutex);
+  npoolthreads = pool_peak_threads = 0;
+  pool_add_workers(nthreads);
+  pthread_mutex_unlock(&pool_mutex);
 }
 
 
 void lives_threadpool_finish(void) {
+  int n;
   threads_die = TRUE;
-  pthread_mutex_lock(&tcond_mutex);
-  pthread_cond_broadcast(&tcond);
-  pthread_mutex_unlock(&tcond_mutex);
-  for (int i = 0; i < npoolthreads; i++) {
-    lives_thread_data_t *tdata = get_thread_data_by_id(i + 1);
-    pthread_cond_broadcast(&tcond);
-    pthread_mutex_unlock(&tcond_mutex);
-    pthread_join(*(poolthrds[i]), NULL);
-    lives_widget_context_unref(tdata->ctx);
-    lives_free(tdata);
-    lives_free(poolthrds[i]);
-  }
-  lives_free(poolthrds);
-  poolthrds = NULL;
-  npoolthreads = 0;
-  lives_list_free_all((LiVESList **)&twork_first);
-  twork_first = twork_last = NULL;
-  ntasks = 0;
+  pool_bp_wake();
+  pthread_mutex_lock(&pool_mutex);
+  n = npoolthreads;
+  for (int i = 0; i < n; i++) {
+    pool_worker_t *w = poolworkers[i];
+    pthread_mutex_lock(&w->mutex);
+    w->signalled = 1;
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->mutex);
+  }
+  // slots above n belong to retired workers, which still need to be joined
+  for (int i = 0; i < pool_nslots; i++) {
+    pool_worker_t *w = poolworkers[i];
+    pool_deque_buf_t *buf, *next;
+    pthread_join(w->thread, NULL);
+    for (buf = w->buf; buf; buf = next) {
+      next = buf->retired;
+      lives_free(buf);
+    }
+    pthread_mutex_destroy(&w->mutex);
+    pthread_cond_destroy(&w->cond);
+    allctxs = lives_list_remove(allctxs, w->tdata);
+    lives_widget_context_unref(w->tdata->ctx);
+    lives_free(w->tdata);
+    lives_free(w);
+    poolworkers[i] = NULL;
+  }
+  npoolthreads = pool_nslots = 0;
+  ntasks = nsleeping = 0;
+  pthread_mutex_unlock(&pool_mutex);
+}
+
+
+void lives_threadpool_get_stats(lives_threadpool_stats_t *stats) {
+  uint64_t ncompleted = __atomic_load_n(&pool_ncompleted, __ATOMIC_RELAXED);
+  if (!stats) return;
+  stats->nthreads = __atomic_load_n(&npoolthreads, __ATOMIC_RELAXED);
+  stats->max_threads = maxpoolthreads;
+  stats->peak_threads = pool_peak_threads;
+  stats->idle_threads = __atomic_load_n(&nsleeping, __ATOMIC_RELAXED);
+  stats->queued = __atomic_load_n(&pool_nqueued, __ATOMIC_RELAXED);
+  stats->running = __atomic_load_n(&ntasks, __ATOMIC_RELAXED) - stats->queued;
+  if (stats->queued < 0) stats->queued = 0;
+  if (stats->running < 0) stats->running = 0;
+  stats->completed = ncompleted;
+  stats->steals = __atomic_load_n(&pool_nsteals, __ATOMIC_RELAXED);
+  stats->inlined = __atomic_load_n(&pool_ninlined, __ATOMIC_RELAXED);
+  stats->reaped = __atomic_load_n(&pool_nreaped, __ATOMIC_RELAXED);
+  stats->avg_wait = ncompleted ? (double)__atomic_load_n(&pool_total_wait, __ATOMIC_RELAXED)
+                    / (double)ncompleted / TICKS_PER_SECOND_DBL : 0.;
+  stats->max_wait = (double)__atomic_load_n(&pool_max_wait, __ATOMIC_RELAXED) / TICKS_PER_SECOND_DBL;
+}
+
+
+static void pool_submit(thrd_work_t *work, boolean priority) {
+  pool_worker_t *self = self_worker, *target = NULL;
+  int n, start;
+
+  if (self && !priority) {
+    // submitted from inside the pool, keep it local; an idle worker can steal it if we get busy
+    deque_push(self, work);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    pool_wake_one();
+    return;
+  }
+
+  // hand the task to an idle worker if we can find one, otherwise spread tasks round robin
+  n = __atomic_load_n(&npoolthreads, __ATOMIC_ACQUIRE);
+  start = __atomic_fetch_add(&next_target, 1, __ATOMIC_RELAXED) % n;
+  for (int i = 0; i < n; i++) {
+    pool_worker_t *w = poolworkers[(start + i) % n];
+    if (__atomic_load_n(&w->sleeping, __ATOMIC_RELAXED)) {
+      target = w;
+      break;
+    }
+  }
+  if (!target) {
+    target = poolworkers[start];
+    // a priority task from inside the pool should go to somebody else
+    if (target == self && n > 1) target = poolworkers[(start + 1) % n];
+  }
+  inbox_push(target, work);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (LIVES_UNLIKELY(__atomic_load_n(&target->retired, __ATOMIC_SEQ_CST))) {
+    // the worker exited as we were handing it the task, take back whatever is in its inbox and resubmit it
+    thrd_work_t *next;
+    for (work = __atomic_exchange_n(&target->inbox, NULL, __ATOMIC_ACQUIRE); work; work = next) {
+      next = work->qnext;
+      pool_submit(work, priority);
+    }
+    return;
+  }
+  if (!pool_wake(target)) pool_wake_one();
 }
 
 
 int lives_thread_create(lives_thread_t *thread, lives_thread_attr_t attr, lives_funcptr_t func, void *arg) {
   LiVESList *list = (LiVESList *)thread;
-  thrd_work_t *work = (thrd_work_t *)lives_calloc(1, sizeof(thrd_work_t));
+  thrd_work_t *work = task_alloc();
   if (!thread) list = (LiVESList *)lives_calloc(1, sizeof(LiVESList));
   else list->next = list->prev = NULL;
   list->data = work;
+  work->list = list;
   work->func = func;
   work->arg = arg;
 
@@ -2328,80 +2800,91 @@ int lives_thread_create(lives_thread_t *thread, lives_thread_attr_t attr, lives_
     work->sync_ready = FALSE;
   }
 
-  pthread_mutex_lock(&twork_mutex);
-  if (!twork_first) {
-    twork_first = twork_last = list;
-  } else {
-    if (!(attr & LIVES_THRDATTR_PRIORITY)) {
-      twork_first->prev = list;
-      list->next = twork_first;
-      twork_first = list;
-    } else {
-      twork_last->next = list;
-      list->prev = twork_last;
-      twork_last = list;
-    }
-  }
-  pthread_mutex_unlock(&twork_mutex);
-  pthread_mutex_lock(&twork_count_mutex);
-  ntasks++;
-  pthread_mutex_unlock(&twork_count_mutex);
-  pthread_mutex_lock(&tcond_mutex);
-  pthread_cond_signal(&tcond);
-  pthread_mutex_unlock(&tcond_mutex);
-  pthread_mutex_lock(&pool_mutex);
-  if (ntasks >= npoolthreads) {
-    pthread_mutex_lock(&tcond_mutex);
-    pthread_cond_broadcast(&tcond);
-    pthread_mutex_unlock(&tcond_mutex);
-    poolthrds = (pthread_t **)lives_realloc(poolthrds, (npoolthreads + MINPOOLTHREADS) * sizeof(pthread_t *));
-    for (int i = npoolthreads; i < npoolthreads + MINPOOLTHREADS; i++) {
-      lives_thread_data_t *tdata = lives_thread_data_create(i + 1);
-      poolthrds[i] = (pthread_t *)lives_malloc(sizeof(pthread_t));
-      pthread_create(poolthrds[i], NULL, thrdpool, tdata);
-      pthread_mutex_lock(&tcond_mutex);
-      pthread_cond_signal(&tcond);
-      pthread_mutex_unlock(&tcond_mutex);
-    }
-    npoolthreads += MINPOOLTHREADS;
+  if (__atomic_add_fetch(&ntasks, 1, __ATOMIC_RELAXED) >= __atomic_load_n(&npoolthreads, __ATOMIC_RELAXED)) {
+    boolean saturated = FALSE;
+    pthread_mutex_lock(&pool_mutex);
+    if (ntasks >= npoolthreads && !threads_die) {
+      if (npoolthreads < maxpoolthreads) pool_add_workers(MINPOOLTHREADS);
+      else saturated = pool_nqueued >= npoolthreads;
+    }
+    pthread_mutex_unlock(&pool_mutex);
+
+    if (saturated) {
+      // backpressure: the pool is at its ceiling with a backlog. Tasks flagged as not needing to run alongside
+      // their submitter are simply run by the caller. Anything else must still be queued.
+      if ((attr & LIVES_THRDATTR_INLINE_OK) && !(work->flags & (LIVES_THRDFLAG_AUTODELETE | LIVES_THRDFLAG_WAIT_SYNC))) {
+        work->busy = POOL_INLINE_ID;
+        (*work->func)(work->arg);
+        __atomic_store_n(&work->done, POOL_INLINE_ID, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&pool_ninlined, 1, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&ntasks, 1, __ATOMIC_RELAXED);
+        return 0;
+      }
+      // a submitter outside the pool waits for the backlog to drop first. Pool workers cannot,
+      // since the backlog may be waiting on them, but they will help out when they join. Nor can the main thread,
+      // since queued tasks may need it to run something in the foreground.
+      if (!self_worker && !is_fg_thread()) {
+        pthread_mutex_lock(&pool_bp_mutex);
+        __atomic_add_fetch(&pool_bp_waiters, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&pool_nqueued, __ATOMIC_SEQ_CST) >= __atomic_load_n(&npoolthreads, __ATOMIC_ACQUIRE)
+               && !threads_die) pthread_cond_wait(&pool_bp_cond, &pool_bp_mutex);
+        __atomic_sub_fetch(&pool_bp_waiters, 1, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&pool_bp_mutex);
+      }
+    }
   }
-  pthread_mutex_unlock(&pool_mutex);
+
+  work->qtime = lives_get_current_ticks();
+  __atomic_add_fetch(&pool_nqueued, 1, __ATOMIC_RELAXED);
+  pool_submit(work, (attr & LIVES_THRDATTR_PRIORITY) ? TRUE : FALSE);
   return 0;
 }
 
 
 uint64_t lives_thread_join(lives_thread_t work, void **retval) {
   thrd_work_t *task = (thrd_work_t *)work.data;
+  pool_worker_t *self = self_worker;
   uint64_t nthrd = 0;
   if (task->flags & LIVES_THRDFLAG_AUTODELETE) {
     LIVES_FATAL("lives_thread_join() called on an autodelete thread");
     return 0;
   }
 
-  while (!task->busy) {
-    pthread_mutex_lock(&tcond_mutex);
-    pthread_cond_signal(&tcond);
-    pthread_mutex_unlock(&tcond_mutex);
-    if (task->busy) break;
-    sched_yield();
-    lives_nanosleep(1000);
-  }
-
-  if (!task->done) {
-    pthread_mutex_lock(&tcond_mutex);
-    pthread_cond_signal(&tcond);
-    pthread_mutex_unlock(&tcond_mutex);
+  if (self) {
+    // joining from inside the pool: rather than block, keep working. We drain our inbox and run what we queued
+    // ourselves, which includes the one we are waiting for unless it was stolen, and steal from the others
+    // once that runs out, so the pool keeps making progress even if every worker is joining.
+    while (!__atomic_load_n(&task->done, __ATOMIC_ACQUIRE)) {
+      thrd_work_t *mywork = pool_find_work(self);
+      if (!mywork) {
+        sched_yield();
+        continue;
+      }
+      if (mywork->flags & LIVES_THRDFLAG_WAIT_SYNC) {
+        // this would block until its submitter syncs, and that may be waiting on us, so pass it to another worker
+        pool_submit(mywork, TRUE);
+        sched_yield();
+        continue;
+      }
+      pool_run_task(self->tdata, mywork);
+    }
+  } else {
+    if (!task->busy) pool_wake_one();
+    lives_nanosleep_until_nonzero(task->done);
   }
-
-  lives_nanosleep_until_nonzero(task->done);
   nthrd = task->done;
 
   if (retval) *retval = task->ret;
-  lives_free(task);
+  task_free(task);
   return nthrd;
 }
 
 
+LIVES_GLOBAL_INLINE boolean is_fg_thread(void) {
+  return capable && pthread_equal(capable->main_thread, pthread_self());
+}
+
+
 LIVES_GLOBAL_INLINE pid_t lives_getpid(void) {
 #ifdef IS_MINGW
   return GetCurrentProcessId(),
@@ -398,7 +398,9 @@ struct _lives_thread_data_t {
   lives_threadvars_t vars;
 };
 
-typedef struct {
+typedef struct _thrd_work thrd_work_t;
+
+struct _thrd_work {
   lives_funcptr_t func;
   void *arg;
   uint64_t flags;
@@ -406,7 +408,14 @@ typedef struct {
   volatile uint64_t done;
   void *ret;
   volatile boolean sync_ready;
-} thrd_work_t;
+
+  // internal to the pool
+  ticks_t qtime; ///< time when the task was queued, for the pool statistics
+  LiVESList *list; ///< the lives_thread_t holding this task, freed after the task if AUTODELETE is set
+  thrd_work_t *volatile qnext; ///< link for worker inboxes
+  uint32_t fl_idx; ///< index in the task slabs
+  volatile uint32_t fl_next; ///< free-list link (index + 1, 0 == end)
+};
 
 #define WEED_LEAF_NOTIFY "notify"
 #define WEED_LEAF_DONE "done"
@@ -440,9 +449,28 @@ typedef uint64_t lives_thread_attr_t;
 #define LIVES_THRDATTR_WAIT_SYNC	(1 << 2)
 #define LIVES_THRDATTR_FG_THREAD	(1 << 3)
 #define LIVES_THRDATTR_NO_GUI		(1 << 4)
+/// the task does not need to run alongside its submitter, so under backpressure the submitter may run it itself
+#define LIVES_THRDATTR_INLINE_OK	(1 << 5)
+
+/// snapshot of the thread pool counters
+typedef struct {
+  int nthreads; ///< current number of worker threads
+  int max_threads; ///< ceiling for nthreads
+  int peak_threads; ///< highest value of nthreads so far
+  int idle_threads; ///< workers currently sleeping
+  int64_t queued; ///< tasks waiting for a worker
+  int64_t running; ///< tasks being run by a worker
+  uint64_t completed; ///< tasks run by workers since startup
+  uint64_t steals; ///< tasks taken from another worker's deque or inbox
+  uint64_t inlined; ///< tasks run by the caller because the pool was saturated
+  uint64_t reaped; ///< idle workers which exited
+  double avg_wait; ///< mean time (seconds) tasks spent queued
+  double max_wait; ///< longest time (seconds) a task spent queued
+} lives_threadpool_stats_t;
 
 void lives_threadpool_init(void);
 void lives_threadpool_finish(void);
+void lives_threadpool_get_stats(lives_threadpool_stats_t *stats);
 int lives_thread_create(lives_thread_t *thread, lives_thread_attr_t attr, lives_funcptr_t func, void *arg);
 uint64_t lives_thread_join(lives_thread_t work, void **retval);
 
@@ -559,6 +587,7 @@ void resubmit_proc_thread(lives_proc_thread_t, lives_thread_attr_t);
 
 void *fg_run_func(lives_proc_thread_t lpt, void *retval);
 void *main_thread_execute(lives_funcptr_t func, int return_type, void *retval, const char *args_fmt, ...);
+boolean is_fg_thread(void); ///< TRUE if called from the main (GUI) thread
 
 void free_fdets_list(LiVESList **);
 lives_proc_thread_t dir_to_file_details(LiVESList **, const char *dir,
@@ -609,6 +638,11 @@ boolean get_wm_caps(void);
 boolean get_distro_dets(void);
 boolean get_machine_dets(void);
 int get_num_cpus(void);
+
+#define CPU_SIMD_SSE4_1 (1ul << 0)
+#define CPU_SIMD_AVX2 (1ul << 1)
+
+uint64_t get_cpu_simd_caps(void);
 double get_disk_load(const char *mp);
 int64_t get_cpu_load(int cpun); ///< percent * 1 million
 
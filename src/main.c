@@ -730,6 +730,9 @@ static boolean pre_init(void) {
   /// kick off the thread pool ////////////////////////////////
   /// this must be done before we can check the disk status
   future_prefs->nfx_threads = prefs->nfx_threads = get_int_prefd(PREF_NFX_THREADS, capable->ncpus);
+  prefs->max_pool_threads = get_int_prefd(PREF_MAX_POOL_THREADS, 0);
+  prefs->frame_cache_mb = get_int_prefd(PREF_FRAME_CACHE_MB, DEF_FRAME_CACHE_MB);
+  prefs->readahead_frames = get_int_prefd(PREF_READAHEAD_FRAMES, DEF_READAHEAD_FRAMES);
 
 #ifdef VALGRIND_ON
   prefs->nfx_threads = 2;
@@ -4138,6 +4141,7 @@ int real_main(int argc, char *argv[], pthread_t *gtk_thread, ulong id) {
 
   capable = (capability *)lives_calloc(1, sizeof(capability));
   capable->cacheline_size = sizeof(void *) * 8;
+  capable->simd_caps = get_cpu_simd_caps();
 
   // _runtime_ byte order, needed for lives_strlen and other things
   if (IS_BIG_ENDIAN)
@@ -4188,7 +4192,11 @@ int real_main(int argc, char *argv[], pthread_t *gtk_thread, ulong id) {
   weed_abi_version = weed_get_abi_version();
   if (weed_abi_version > WEED_ABI_VERSION) weed_abi_version = WEED_ABI_VERSION;
   //werr = weed_init(weed_abi_version, WEED_INIT_DEBUGMODE);
+#ifdef WEED_INIT_HASHINDEX
+  werr = weed_init(weed_abi_version, WEED_INIT_HASHINDEX);
+#else
   werr = weed_init(weed_abi_version, 0);
+#endif
   if (werr != WEED_SUCCESS) {
     lives_notify(LIVES_OSC_NOTIFY_QUIT, "Failed to init Weed");
     LIVES_FATAL("Failed to init Weed");
@@ -4212,6 +4220,8 @@ int real_main(int argc, char *argv[], pthread_t *gtk_thread, ulong id) {
   _weed_leaf_get_flags = weed_leaf_get_flags;
   _weed_leaf_set_flags = weed_leaf_set_flags;
 
+  weed_layer_init_keys();
+
   mainw = (mainwindow *)(lives_calloc(1, sizeof(mainwindow)));
   init_random();
 
@@ -7164,6 +7174,253 @@ static weed_plant_t *render_subs_from_file(lives_clip_t *sfile, double xtime, we
 }
 
 
+/// decoded frame cache //////////////////////////////////////////////////////////
+// frames returned by pull_frame_at_size() for decoder and image backed clips are kept in a byte limited
+// LRU cache, shared by playback, the clip editor previews, thumbnails and multitrack.
+// The cache holds its own copy of each frame, and on a hit the pixel data is copied out again, since callers
+// are free to alter the layer they are given.
+//
+// virtual frames are keyed by the decoder frame number, which does not change when the clip is edited;
+// for image frames we note the inode, size and mtime of the file, and treat any change as a miss
+
+#define FRAME_CACHE_NBUCKETS 1024
+
+typedef struct _frame_cache_entry frame_cache_entry_t;
+
+struct _frame_cache_entry {
+  uint64_t uid; ///< unique_id of the clip
+  int64_t srcframe; ///< decoder frame for virtual frames, else the clip frame number
+  int width, height, palette; ///< the size and palette asked for
+  int gamma; ///< the gamma handling in effect when the frame was pulled
+  boolean nobord;
+  ino_t finode;
+  off_t fsize;
+  struct timespec fmtime;
+  weed_layer_t *layer;
+  size_t bytes;
+  uint32_t hash;
+  frame_cache_entry_t *hnext, *prev, *next;
+};
+
+static pthread_mutex_t fcache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static frame_cache_entry_t *fcache_buckets[FRAME_CACHE_NBUCKETS];
+static frame_cache_entry_t *fcache_head = NULL, *fcache_tail = NULL; ///< most / least recently used
+static lives_frame_cache_stats_t fcache_stats;
+
+
+static uint32_t frame_cache_hash(frame_cache_entry_t *key) {
+  uint64_t h = key->uid * 0x9E3779B97F4A7C15ull;
+  h ^= (uint64_t)key->srcframe + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+  h ^= ((uint64_t)key->width << 32 | (uint32_t)key->height) + (h << 6) + (h >> 2);
+  h ^= ((uint64_t)key->palette << 8 | key->gamma << 1 | key->nobord) + (h << 6) + (h >> 2);
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+
+static boolean frame_cache_make_key(int clip, frames_t frame, int width, int height, int palette,
+                                    frame_cache_entry_t *key) {
+  // fill in key for clip / frame; returns FALSE if the frame should not be cached
+  lives_clip_t *sfile;
+  if (!IS_VALID_CLIP(clip) || frame <= 0) return FALSE;
+  sfile = mainw->files[clip];
+  if (frame > sfile->frames) return FALSE;
+  if (sfile->clip_type != CLIP_TYPE_DISK && sfile->clip_type != CLIP_TYPE_FILE) return FALSE;
+  if (clip == mainw->scrap_file || clip == mainw->ascrap_file) return FALSE;
+  if (sfile->deinterlace) return FALSE;
+
+  lives_memset(key, 0, sizeof(frame_cache_entry_t));
+  key->uid = sfile->unique_id;
+  key->width = width;
+  key->height = height;
+  key->palette = palette;
+  key->gamma = prefs->apply_gamma && prefs->pb_quality != PB_QUALITY_LOW;
+  key->nobord = prefs->auto_nobord;
+
+  if (sfile->clip_type == CLIP_TYPE_FILE && sfile->frame_index && is_virtual_frame(clip, frame)) {
+    lives_decoder_t *dplug = (lives_decoder_t *)sfile->ext_src;
+    if (!dplug || !dplug->cdata) return FALSE;
+    if (prefs->auto_deint && dplug->cdata->interlace != LIVES_INTERLACE_NONE) return FALSE;
+    key->srcframe = sfile->frame_index[frame - 1];
+  } else {
+    struct stat st;
+    char *fname = make_image_file_name(sfile, frame, get_image_ext_for_type(sfile->img_type));
+    int res = stat(fname, &st);
+    lives_free(fname);
+    if (res) return FALSE;
+    key->srcframe = frame;
+    key->finode = st.st_ino;
+    key->fsize = st.st_size;
+    key->fmtime = st.st_mtim;
+  }
+  key->hash = frame_cache_hash(key);
+  return TRUE;
+}
+
+
+static inline boolean frame_cache_key_match(frame_cache_entry_t *a, frame_cache_entry_t *b) {
+  return a->hash == b->hash && a->uid == b->uid && a->srcframe == b->srcframe && a->width == b->width
+         && a->height == b->height && a->palette == b->palette && a->gamma == b->gamma && a->nobord == b->nobord
+         && a->finode == b->finode && a->fsize == b->fsize && a->fmtime.tv_sec == b->fmtime.tv_sec
+         && a->fmtime.tv_nsec == b->fmtime.tv_nsec;
+}
+
+
+static void frame_cache_unlink(frame_cache_entry_t *ent) {
+  // remove from the hash chain and the LRU list, must be called with fcache_mutex locked
+  frame_cache_entry_t **pp = &fcache_buckets[ent->hash % FRAME_CACHE_NBUCKETS];
+  for (; *pp; pp = &(*pp)->hnext) {
+    if (*pp == ent) {
+      *pp = ent->hnext;
+      break;
+    }
+  }
+  if (ent->prev) ent->prev->next = ent->next;
+  else fcache_head = ent->next;
+  if (ent->next) ent->next->prev = ent->prev;
+  else fcache_tail = ent->prev;
+  fcache_stats.bytes -= ent->bytes;
+  fcache_stats.nentries--;
+}
+
+
+static void frame_cache_drop(frame_cache_entry_t *ent) {
+  // must be called with fcache_mutex locked; if a reader is copying the layer it will free it when done
+  frame_cache_unlink(ent);
+  weed_layer_unref(ent->layer);
+  lives_free(ent);
+}
+
+
+static void frame_cache_push_front(frame_cache_entry_t *ent) {
+  ent->prev = NULL;
+  ent->next = fcache_head;
+  if (fcache_head) fcache_head->prev = ent;
+  else fcache_tail = ent;
+  fcache_head = ent;
+}
+
+
+static size_t layer_pixel_bytes(weed_layer_t *layer) {
+  int pal = weed_layer_get_palette(layer), height = weed_layer_get_height(layer), nplanes;
+  int *rowstrides = weed_layer_get_rowstrides(layer, &nplanes);
+  size_t bytes = 0;
+  if (!rowstrides) return 0;
+  for (int i = 0; i < nplanes; i++)
+    bytes += (size_t)(rowstrides[i] * height * weed_palette_get_plane_ratio_vertical(pal, i));
+  lives_free(rowstrides);
+  return bytes;
+}
+
+
+static boolean frame_cache_fetch(weed_layer_t *layer, frame_cache_entry_t *key) {
+  frame_cache_entry_t *ent;
+  weed_layer_t *cached = NULL, *copy;
+
+  pthread_mutex_lock(&fcache_mutex);
+  for (ent = fcache_buckets[key->hash % FRAME_CACHE_NBUCKETS]; ent; ent = ent->hnext) {
+    if (frame_cache_key_match(ent, key)) {
+      if (ent != fcache_head) {
+        if (ent->prev) ent->prev->next = ent->next;
+        if (ent->next) ent->next->prev = ent->prev;
+        else fcache_tail = ent->prev;
+        frame_cache_push_front(ent);
+      }
+      cached = ent->layer;
+      weed_layer_ref(cached);
+      break;
+    }
+  }
+  if (!cached) fcache_stats.misses++;
+  pthread_mutex_unlock(&fcache_mutex);
+  if (!cached) return FALSE;
+
+  copy = weed_layer_copy(NULL, cached);
+
+  pthread_mutex_lock(&fcache_mutex);
+  weed_layer_unref(cached);
+  if (copy) fcache_stats.hits++;
+  else fcache_stats.misses++;
+  pthread_mutex_unlock(&fcache_mutex);
+
+  if (!copy) return FALSE;
+
+  // move the pixel data into layer
+  weed_layer_copy(layer, copy);
+  weed_layer_nullify_pixel_data(copy);
+  weed_layer_free(copy);
+  return TRUE;
+}
+
+
+static void frame_cache_store(weed_layer_t *layer, frame_cache_entry_t *key) {
+  frame_cache_entry_t *ent, *xent;
+  weed_layer_t *copy;
+  size_t max_bytes = (size_t)prefs->frame_cache_mb << 20, bytes = layer_pixel_bytes(layer);
+
+  if (!bytes || bytes > max_bytes / 4) return;
+  if (!(copy = weed_layer_copy(NULL, layer))) return;
+  if (!(ent = (frame_cache_entry_t *)lives_malloc(sizeof(frame_cache_entry_t)))) {
+    weed_layer_free(copy);
+    return;
+  }
+  lives_memcpy(ent, key, sizeof(frame_cache_entry_t));
+  ent->layer = copy;
+  ent->bytes = bytes;
+
+  pthread_mutex_lock(&fcache_mutex);
+  // another thread may have pulled the same frame meanwhile
+  for (xent = fcache_buckets[ent->hash % FRAME_CACHE_NBUCKETS]; xent; xent = xent->hnext) {
+    if (frame_cache_key_match(xent, ent)) {
+      frame_cache_drop(xent);
+      break;
+    }
+  }
+  while (fcache_tail && fcache_stats.bytes + bytes > max_bytes) {
+    frame_cache_drop(fcache_tail);
+    fcache_stats.evictions++;
+  }
+  ent->hnext = fcache_buckets[ent->hash % FRAME_CACHE_NBUCKETS];
+  fcache_buckets[ent->hash % FRAME_CACHE_NBUCKETS] = ent;
+  frame_cache_push_front(ent);
+  fcache_stats.bytes += bytes;
+  fcache_stats.nentries++;
+  fcache_stats.stores++;
+  pthread_mutex_unlock(&fcache_mutex);
+}
+
+
+/**
+   @brief remove all cached frames for clip, or all frames if clip is -1
+   should be called when a clip is closed or its frames are rewritten
+*/
+void lives_frame_cache_invalidate(int clip) {
+  frame_cache_entry_t *ent, *next;
+  uint64_t uid = 0;
+  if (clip >= 0) {
+    if (!IS_VALID_CLIP(clip)) return;
+    uid = mainw->files[clip]->unique_id;
+  }
+  pthread_mutex_lock(&fcache_mutex);
+  for (ent = fcache_head; ent; ent = next) {
+    next = ent->next;
+    if (clip < 0 || ent->uid == uid) {
+      frame_cache_drop(ent);
+      fcache_stats.invalidations++;
+    }
+  }
+  pthread_mutex_unlock(&fcache_mutex);
+}
+
+
+void lives_frame_cache_get_stats(lives_frame_cache_stats_t *stats) {
+  if (!stats) return;
+  pthread_mutex_lock(&fcache_mutex);
+  lives_memcpy(stats, &fcache_stats, sizeof(lives_frame_cache_stats_t));
+  stats->max_bytes = (size_t)prefs->frame_cache_mb << 20;
+  pthread_mutex_unlock(&fcache_mutex);
+}
+
+
 boolean pull_frame_at_size(weed_layer_t *layer, const char *image_ext, weed_timecode_t tc, int width, int height,
                            int target_palette) {
   // pull a frame from an external source into a layer
@@ -7180,7 +7437,8 @@ boolean pull_frame_at_size(weed_layer_t *layer, const char *image_ext, weed_time
   frames_t frame = lives_layer_get_frame(layer);
   int clip_type;
 
-  boolean is_thread = FALSE;
+  frame_cache_entry_t fckey;
+  boolean is_thread = FALSE, use_fcache = FALSE;
 
   // the default unless overridden
   weed_layer_set_gamma(layer, WEED_GAMMA_SRGB);
@@ -7232,6 +7490,13 @@ boolean pull_frame_at_size(weed_layer_t *layer, const char *image_ext, weed_time
       mainw->osc_block = FALSE;
       return TRUE;
     } else {
+      if (prefs->frame_cache_mb > 0
+          && (use_fcache = frame_cache_make_key(clip, frame, width, height, target_palette, &fckey))
+          && frame_cache_fetch(layer, &fckey)) {
+        mainw->osc_block = FALSE;
+        if (!fckey.finode) return TRUE;
+        break;
+      }
       if (sfile->clip_type == CLIP_TYPE_FILE && sfile->frame_index && frame > 0 &&
           frame <= sfile->frames && is_virtual_frame(clip, frame)) {
         // pull frame from video clip
@@ -7385,7 +7650,7 @@ boolean pull_frame_at_size(weed_layer_t *layer, const char *image_ext, weed_time
             if (!is_thread) {
               deinterlace_frame(layer, tc);
             } else weed_set_boolean_value(layer, WEED_LEAF_HOST_DEINTERLACE, WEED_TRUE);
-          }
+          } else if (use_fcache) frame_cache_store(layer, &fckey);
         }
         mainw->osc_block = FALSE;
         return res;
@@ -7413,6 +7678,7 @@ boolean pull_frame_at_size(weed_layer_t *layer, const char *image_ext, weed_time
           create_blank_layer(layer, image_ext, width, height, target_palette);
           return FALSE;
         }
+        if (use_fcache) frame_cache_store(layer, &fckey);
       }
     }
     break;
@@ -7670,6 +7936,258 @@ void pull_frame_threaded(weed_layer_t *layer, const char *img_ext, weed_timecode
 // *INDENT-ON*
 }
 
+/// frame read-ahead ///////////////////////////////////////////////////////////
+// during playback of a decoder backed clip, a thread with its own clone of the clip decoder decodes the next
+// few frames in the direction of play, so that seeking to distant keyframes (long-GOP sources) happens in
+// advance rather than while the player is waiting for the frame.
+// The player reports each frame it requests via lives_readahead_update(), and picks up ready frames with
+// lives_readahead_fetch(); only one clip (the one playing) is read ahead at a time.
+
+#define MAX_READAHEAD_FRAMES 32
+#define MAX_READAHEAD_STRIDE 8
+
+typedef struct {
+  int clip;
+  lives_decoder_t *dplug; ///< cloned decoder, owned by the read-ahead
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  volatile boolean die;
+  frames_t pos; ///< last frame requested by the player
+  int dir, stride;
+  uint64_t seq; ///< incremented each time pos changes
+  int nslots;
+  frames_t frames[MAX_READAHEAD_FRAMES];
+  weed_layer_t *slots[MAX_READAHEAD_FRAMES];
+  uint64_t hits, misses;
+} lives_readahead_t;
+
+static lives_readahead_t *readahead = NULL;
+
+
+static frames_t readahead_predict(lives_readahead_t *ra, int k) {
+  // return the frame we expect to be asked for in k steps, or 0 if there is none
+  lives_clip_t *sfile = mainw->files[ra->clip];
+  frames_t first = 1, last = sfile->frames, range, frame;
+  int dir = ra->dir;
+  if (mainw->playing_sel) {
+    first = sfile->start;
+    last = sfile->end;
+  }
+  if ((range = last - first + 1) <= 0) return 0;
+  frame = ra->pos + dir * ra->stride * k;
+  if (frame >= first && frame <= last) return frame;
+  if (!mainw->loop && !mainw->loop_cont) return 0;
+  if (mainw->ping_pong) {
+    // reflect at the ends
+    frame -= first;
+    frame %= 2 * (range - 1 > 0 ? range - 1 : 1);
+    if (frame < 0) frame = -frame;
+    if (frame >= range) frame = 2 * (range - 1) - frame;
+    return frame + first;
+  }
+  frame = (frame - first) % range;
+  if (frame < 0) frame += range;
+  return frame + first;
+}
+
+
+static boolean readahead_wanted(lives_readahead_t *ra, frames_t frame) {
+  for (int k = 1; k <= ra->nslots; k++) if (readahead_predict(ra, k) == frame) return TRUE;
+  return FALSE;
+}
+
+
+static void *readahead_thread(void *arg) {
+  lives_readahead_t *ra = (lives_readahead_t *)arg;
+  lives_clip_t *sfile = mainw->files[ra->clip];
+  const char *img_ext = get_image_ext_for_type(sfile->img_type);
+
+  pthread_mutex_lock(&ra->mutex);
+  while (!ra->die) {
+    frames_t frame = 0;
+    weed_layer_t *layer;
+    uint64_t seq = ra->seq;
+    int slot = -1;
+
+    // find the nearest upcoming frame which we do not have yet, and a slot to put it in
+    for (int k = 1; k <= ra->nslots && !frame; k++) {
+      frames_t pframe = readahead_predict(ra, k);
+      int i;
+      if (pframe <= 0) break;
+      if (!is_virtual_frame(ra->clip, pframe)) continue;
+      for (i = 0; i < ra->nslots; i++) if (ra->frames[i] == pframe) break;
+      if (i == ra->nslots) frame = pframe;
+    }
+    if (frame) {
+      for (int i = 0; i < ra->nslots; i++) {
+        if (!ra->slots[i] || !readahead_wanted(ra, ra->frames[i])) {
+          slot = i;
+          break;
+        }
+      }
+    }
+    if (slot == -1) {
+      pthread_cond_wait(&ra->cond, &ra->mutex);
+      continue;
+    }
+    if (ra->slots[slot]) {
+      weed_layer_free(ra->slots[slot]);
+      ra->slots[slot] = NULL;
+    }
+    ra->frames[slot] = 0;
+    pthread_mutex_unlock(&ra->mutex);
+
+    layer = lives_layer_new_for_frame(ra->clip, frame);
+    weed_set_voidptr_value(layer, WEED_LEAF_HOST_DECODER, (void *)ra->dplug);
+    if (!pull_frame_at_size(layer, img_ext, (weed_timecode_t)((frame - 1.) / sfile->fps * TICKS_PER_SECOND_DBL),
+                            0, 0, WEED_PALETTE_END)) {
+      weed_layer_free(layer);
+      layer = NULL;
+    } else weed_leaf_delete(layer, WEED_LEAF_HOST_DECODER);
+
+    pthread_mutex_lock(&ra->mutex);
+    if (layer) {
+      if (ra->seq != seq && !readahead_wanted(ra, frame)) weed_layer_free(layer);
+      else {
+        ra->slots[slot] = layer;
+        ra->frames[slot] = frame;
+      }
+    } else {
+      // could not decode it, wait for the player to move on
+      if (ra->seq == seq && !ra->die) pthread_cond_wait(&ra->cond, &ra->mutex);
+    }
+  }
+  pthread_mutex_unlock(&ra->mutex);
+  return NULL;
+}
+
+
+/**
+   @brief stop reading ahead, and free any frames not yet collected
+   blocks until any frame being decoded is done
+*/
+void lives_readahead_stop(void) {
+  lives_readahead_t *ra = readahead;
+  if (!ra) return;
+  readahead = NULL;
+  pthread_mutex_lock(&ra->mutex);
+  ra->die = TRUE;
+  pthread_cond_signal(&ra->cond);
+  pthread_mutex_unlock(&ra->mutex);
+  pthread_join(ra->thread, NULL);
+
+  if (prefs->show_dev_opts)
+    g_printerr("read-ahead for clip %d: %" PRIu64 " hits, %" PRIu64 " misses\n", ra->clip, ra->hits, ra->misses);
+
+  for (int i = 0; i < ra->nslots; i++) if (ra->slots[i]) weed_layer_free(ra->slots[i]);
+  close_decoder_plugin(ra->dplug);
+  pthread_cond_destroy(&ra->cond);
+  pthread_mutex_destroy(&ra->mutex);
+  lives_free(ra);
+}
+
+
+static lives_readahead_t *readahead_start(int clip) {
+  lives_clip_t *sfile = mainw->files[clip];
+  lives_readahead_t *ra;
+  lives_decoder_t *dplug;
+
+  if (sfile->clip_type != CLIP_TYPE_FILE || !sfile->frame_index || !sfile->ext_src
+      || sfile->ext_src_type != LIVES_EXT_SRC_DECODER) return NULL;
+  if (!(dplug = clone_decoder(clip))) return NULL;
+
+  ra = (lives_readahead_t *)lives_calloc(1, sizeof(lives_readahead_t));
+  ra->clip = clip;
+  ra->dplug = dplug;
+  ra->dir = 1;
+  ra->stride = 1;
+  ra->nslots = prefs->readahead_frames > MAX_READAHEAD_FRAMES ? MAX_READAHEAD_FRAMES : prefs->readahead_frames;
+  pthread_mutex_init(&ra->mutex, NULL);
+  pthread_cond_init(&ra->cond, NULL);
+  pthread_create(&ra->thread, NULL, readahead_thread, ra);
+  return ra;
+}
+
+
+/**
+   @brief tell the read-ahead which frame the player just asked for
+   direction comes from the sign of pb_fps, and the stride from the distance between successive requests,
+   so frames which will be skipped over at high speeds are not decoded.
+   Starts (or restarts, on a clip switch) reading ahead as needed
+*/
+void lives_readahead_update(int clip, frames_t frame, double pb_fps) {
+  lives_readahead_t *ra = readahead;
+  frames_t delta;
+
+  if (prefs->readahead_frames <= 0 || !IS_NORMAL_CLIP(clip) || frame <= 0) {
+    if (ra) lives_readahead_stop();
+    return;
+  }
+  if (ra && ra->clip != clip) {
+    lives_readahead_stop();
+    ra = NULL;
+  }
+  if (!ra) {
+    if (mainw->files[clip]->clip_type != CLIP_TYPE_FILE) return;
+    if (!(ra = readahead = readahead_start(clip))) return;
+  }
+
+  pthread_mutex_lock(&ra->mutex);
+  if (frame != ra->pos) {
+    if (ra->pos > 0) {
+      delta = ABS(frame - ra->pos);
+      if (delta > 0 && delta <= MAX_READAHEAD_STRIDE) ra->stride = delta;
+    }
+    ra->dir = pb_fps < 0. ? -1 : 1;
+    ra->pos = frame;
+    ra->seq++;
+    pthread_cond_signal(&ra->cond);
+  }
+  pthread_mutex_unlock(&ra->mutex);
+}
+
+
+LIVES_GLOBAL_INLINE boolean lives_readahead_active(int clip) {
+  return readahead && readahead->clip == clip;
+}
+
+
+/**
+   @brief if the frame for layer (WEED_LEAF_CLIP, WEED_LEAF_FRAME) has been read ahead, move it into layer
+   @return TRUE if layer now has pixel data, FALSE if the caller should pull the frame as normal
+*/
+boolean lives_readahead_fetch(weed_layer_t *layer) {
+  lives_readahead_t *ra = readahead;
+  weed_layer_t *rlayer = NULL;
+  frames_t frame;
+
+  if (!ra || !layer || lives_layer_get_clip(layer) != ra->clip) return FALSE;
+  frame = lives_layer_get_frame(layer);
+
+  pthread_mutex_lock(&ra->mutex);
+  for (int i = 0; i < ra->nslots; i++) {
+    if (ra->frames[i] == frame && ra->slots[i]) {
+      rlayer = ra->slots[i];
+      ra->slots[i] = NULL;
+      ra->frames[i] = 0;
+      pthread_cond_signal(&ra->cond);
+      break;
+    }
+  }
+  if (rlayer) ra->hits++;
+  else ra->misses++;
+  pthread_mutex_unlock(&ra->mutex);
+
+  if (!rlayer) return FALSE;
+  weed_layer_pixel_data_free(layer);
+  weed_layer_copy(layer, rlayer);
+  weed_layer_nullify_pixel_data(rlayer);
+  weed_layer_free(rlayer);
+  return TRUE;
+}
+
+
 LiVESPixbuf *pull_lives_pixbuf_at_size(int clip, int frame, const char *image_ext, weed_timecode_t tc,
                                        int width, int height, LiVESInterpType interp, boolean fordisp) {
   // return a correctly sized (Gdk)Pixbuf (RGB24 for jpeg, RGB24 / RGBA32 for png) for the given clip and frame
@@ -7995,7 +8513,6 @@ void load_frame_image(int frame) {
   const char *img_ext = NULL;
 
   LiVESInterpType interp;
-  double scrap_file_size = -1;
 
   ticks_t audio_timed_out = 1;
 
@@ -8095,7 +8612,6 @@ void load_frame_image(int frame) {
           if (mainw->scrap_file == -1) open_scrap_file();
           fg_file = mainw->scrap_file;
           fg_frame = mainw->files[mainw->scrap_file]->frames + 1;
-          scrap_file_size = mainw->files[mainw->scrap_file]->f_size;
           bg_file = -1;
           bg_frame = 0;
         }
@@ -8122,7 +8638,7 @@ void load_frame_image(int frame) {
             // get current seek postion
             alarm_handle = lives_alarm_set(LIVES_SHORT_TIMEOUT);
 
-            while ((audio_timed_out = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(mainw->jackd) != NULL) {
+            while ((audio_timed_out = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(mainw->jackd)) {
               // wait for audio player message queue clearing
               sched_yield();
               lives_usleep(prefs->sleep_time);
@@ -8176,26 +8692,23 @@ void load_frame_image(int frame) {
           if (!mainw->event_list) mainw->event_list = event_list;
 
           // TODO ***: do we need to perform more checks here ???
-          if (scrap_file_size != -1 || (mainw->rec_aclip != -1 && (prefs->rec_opts & REC_AUDIO))) {
+          /// scrap file frames are located via the offset index in the file, so no offset is recorded here
+          if (mainw->rec_aclip != -1 && (prefs->rec_opts & REC_AUDIO)) {
             weed_plant_t *event = get_last_frame_event(mainw->event_list);
 
-            if (scrap_file_size != -1) weed_set_int64_value(event, WEED_LEAF_HOST_SCRAP_FILE_OFFSET, scrap_file_size);
+            if (mainw->rec_aclip == mainw->ascrap_file) {
+              mainw->rec_aseek = (double)mainw->files[mainw->ascrap_file]->aseek_pos /
+                                 (double)(mainw->files[mainw->ascrap_file]->arps * mainw->files[mainw->ascrap_file]->achans *
+                                          mainw->files[mainw->ascrap_file]->asampsize >> 3);
+              mainw->rec_avel = 1.;
 
-            if (mainw->rec_aclip != -1) {
-              if (mainw->rec_aclip == mainw->ascrap_file) {
-                mainw->rec_aseek = (double)mainw->files[mainw->ascrap_file]->aseek_pos /
-                                   (double)(mainw->files[mainw->ascrap_file]->arps * mainw->files[mainw->ascrap_file]->achans *
-                                            mainw->files[mainw->ascrap_file]->asampsize >> 3);
-                mainw->rec_avel = 1.;
-
-              }
-              if (!mainw->mute) {
-                weed_event_t *xevent = get_prev_frame_event(event);
-                if (!xevent) xevent = event;
-                insert_audio_event_at(xevent, -1, mainw->rec_aclip, mainw->rec_aseek, mainw->rec_avel);
-              }
-              mainw->rec_aclip = -1;
             }
+            if (!mainw->mute) {
+              weed_event_t *xevent = get_prev_frame_event(event);
+              if (!xevent) xevent = event;
+              insert_audio_event_at(xevent, -1, mainw->rec_aclip, mainw->rec_aseek, mainw->rec_avel);
+            }
+            mainw->rec_aclip = -1;
           }
           pthread_mutex_unlock(&mainw->event_list_mutex);
 
@@ -8474,7 +8987,7 @@ void load_frame_image(int frame) {
               }
               //if (delta > 0) g_print("    waiting...\n");
             }
-            if (!got_preload) {
+            if (!got_preload && !lives_readahead_fetch(mainw->frame_layer)) {
               pull_frame_threaded(mainw->frame_layer, img_ext, (weed_timecode_t)mainw->currticks, 0, 0);
               //pull_frame(mainw->frame_layer, img_ext, (weed_timecode_t)mainw->currticks);
             }
@@ -8801,7 +9314,9 @@ void load_frame_image(int frame) {
             /// TODO - save w. screen_gamma
             gamma_convert_layer(WEED_GAMMA_SRGB, return_layer);
           }
-          save_to_scrap_file(return_layer);
+          /// we are done with it, so hand it to the scrap writer rather than copying it
+          save_to_scrap_file_take(return_layer);
+          return_layer = NULL;
         }
         weed_layer_free(return_layer);
         lives_free(retdata);
@@ -9063,7 +9578,8 @@ void load_frame_image(int frame) {
             // TODO - save w. screen_gamma
             gamma_convert_layer(WEED_GAMMA_SRGB, frame_layer);
           }
-          save_to_scrap_file(return_layer);
+          save_to_scrap_file_take(return_layer);
+          return_layer = NULL;
         }
         weed_layer_free(return_layer);
         lives_free(retdata);
@@ -9131,18 +9647,19 @@ void load_frame_image(int frame) {
       }
     }
 
-    if (lb_width != pwidth || lb_height != pheight ||
-        weed_get_boolean_value(mainw->frame_layer, "letterboxed", NULL) == WEED_FALSE) {
-      if (weed_layer_get_width_pixels(mainw->frame_layer) != pwidth ||
-          weed_layer_get_height(mainw->frame_layer) != pheight) {
-        if (!resize_layer(mainw->frame_layer, pwidth, pheight, interp, cpal, 0)) goto lfi_done;
-      }
+    if (lb_width == pwidth && lb_height == pheight &&
+        weed_get_boolean_value(mainw->frame_layer, "letterboxed", NULL) != WEED_FALSE) {
+      // no resize needed
+      pwidth = weed_layer_get_width_pixels(mainw->frame_layer);
+      pheight = weed_layer_get_height(mainw->frame_layer);
     }
+
+    /// resize, palette convert and gamma convert together; this is done in a single pass where possible
+    if (!convert_resize_layer(mainw->frame_layer, cpal, 0, pwidth, pheight, interp, WEED_GAMMA_SRGB)) goto lfi_done;
+
     if (prefs->dev_show_timing)
       g_printerr("res end @ %f\n", lives_get_current_ticks() / TICKS_PER_SECOND_DBL);
 
-    if (!convert_layer_palette_full(mainw->frame_layer, cpal, 0, 0, 0, WEED_GAMMA_SRGB)) goto lfi_done;
-
     if (prefs->dev_show_timing)
       g_printerr("clp end @ %f\n", lives_get_current_ticks() / TICKS_PER_SECOND_DBL);
     if (LIVES_IS_PLAYING) {
@@ -9446,12 +9963,15 @@ void close_current_file(int file_to_switch_to) {
       if (mainw->current_file != mainw->scrap_file && mainw->current_file != mainw->ascrap_file) remove_from_clipmenu();
     }
 
+    if (lives_readahead_active(mainw->current_file)) lives_readahead_stop();
+
     if (CURRENT_CLIP_IS_NORMAL && cfile->ext_src) {
       if (cfile->ext_src_type == LIVES_EXT_SRC_DECODER) {
         close_clip_decoder(mainw->current_file);
       }
     }
     free_thumb_cache(mainw->current_file, 0);
+    lives_frame_cache_invalidate(mainw->current_file);
     lives_freep((void **)&cfile->frame_index);
     lives_freep((void **)&cfile->frame_index_back);
 
@@ -9820,7 +10340,7 @@ boolean  switch_audio_clip(int new_file, boolean activate) {
       if (!activate) mainw->jackd->in_use = FALSE;
 
       alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
-      while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(mainw->jackd) != NULL) {
+      while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(mainw->jackd)) {
         // wait for seek
         lives_nanosleep(1000);
       }
@@ -9835,13 +10355,10 @@ boolean  switch_audio_clip(int new_file, boolean activate) {
           jack_get_rec_avals(mainw->jackd);
           mainw->rec_avel = 0.;
         }
-        jack_message.command = ASERVER_CMD_FILE_CLOSE;
-        jack_message.data = NULL;
-        jack_message.next = NULL;
-        mainw->jackd->msgq = &jack_message;
+        jack_send_cmd(mainw->jackd, ASERVER_CMD_FILE_CLOSE, 0);
 
         alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
-        while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(mainw->jackd) != NULL) {
+        while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(mainw->jackd)) {
           // wait for seek
           lives_nanosleep(1000);
         }
@@ -9858,6 +10375,7 @@ boolean  switch_audio_clip(int new_file, boolean activate) {
     }
 
     if (CLIP_HAS_AUDIO(new_file)) {
+      jack_cmd_t jack_cmds[2];
       int asigned = !(mainw->files[new_file]->signed_endian & AFORM_UNSIGNED);
       int aendian = !(mainw->files[new_file]->signed_endian & AFORM_BIG_ENDIAN);
       mainw->jackd->num_input_channels = mainw->files[new_file]->achans;
@@ -9886,19 +10404,13 @@ boolean  switch_audio_clip(int new_file, boolean activate) {
 
       avsync_force();
 
-      // tell jack server to open audio file and start playing it
-
-      jack_message.command = ASERVER_CMD_FILE_OPEN;
-
-      jack_message.data = lives_strdup_printf("%d", new_file);
-
-      jack_message2.command = ASERVER_CMD_FILE_SEEK;
-      jack_message.next = &jack_message2;
-      jack_message2.data = lives_strdup_printf("%"PRId64, mainw->files[new_file]->aseek_pos);
-      if (LIVES_IS_PLAYING && !mainw->preview) jack_message2.tc = lives_get_current_ticks();
-      jack_message2.next = NULL;
-
-      mainw->jackd->msgq = &jack_message;
+      // tell jack server to open audio file and start playing it; the seek must arrive with the open,
+      // else the callback may play from the start of the file first
+      jack_cmds[0].command = ASERVER_CMD_FILE_OPEN;
+      jack_cmds[0].arg = new_file;
+      jack_cmds[1].command = ASERVER_CMD_FILE_SEEK;
+      jack_cmds[1].arg = mainw->files[new_file]->aseek_pos;
+      jack_send_cmds(mainw->jackd, jack_cmds, 2);
       mainw->jackd->in_use = TRUE;
 
       mainw->jackd->is_paused = mainw->files[new_file]->play_paused;
@@ -581,6 +581,7 @@ typedef struct {
   char *cpu_name;
   short cpu_bits;
   int cacheline_size;
+  uint64_t simd_caps; ///< bitmap of CPU_SIMD_* vector extensions
 
   int64_t boot_time;
   int xstdout;
@@ -1449,9 +1450,36 @@ boolean read_headers(int clipno, const char *dir, const char *file_name);
 void open_set_file(int clipnum);
 
 // saveplay.c scrap file
+
+/// frames recorded to the scrap file are queued and written by a background thread;
+/// the player only waits when this many frames, or this many bytes, are still unwritten
+#define SCRAP_QUEUE_FRAMES 32
+#define SCRAP_QUEUE_MAX_BYTES (512 * 1024 * 1024)
+
+typedef struct {
+  uint64_t frames_queued; ///< frames handed to the writer
+  uint64_t frames_written;
+  uint64_t bytes_written; ///< bytes written to the file (compressed)
+  uint64_t raw_bytes; ///< uncompressed size of the frames written
+  uint64_t stalls; ///< times the player had to wait for the writer (queue full)
+  uint64_t stall_usec; ///< total time spent waiting
+  uint64_t max_stall_usec;
+  int max_depth; ///< most frames ever waiting in the queue
+  uint64_t max_bytes; ///< most bytes ever waiting in the queue
+} lives_scrap_stats_t;
+
+/// frames in the scrap file are found through an index of their offsets, kept in memory while the file is open
+/// and also written at the end of the file each time the writer finishes, in a block:
+/// magic (4 bytes) count (8 bytes) offsets (count * 8 bytes) count (8 bytes) version (4 bytes) magic (4 bytes)
+#define SCRAP_INDEX_MAGIC 0x58494353 // "SCIX"
+#define SCRAP_INDEX_VERSION 2
+
 boolean open_scrap_file(void);
 boolean open_ascrap_file(void);
 int save_to_scrap_file(weed_layer_t *layer);
+int save_to_scrap_file_take(weed_layer_t *layer);
+void scrap_file_get_stats(lives_scrap_stats_t *stats);
+void flush_scrap_file(void);
 boolean load_from_scrap_file(weed_layer_t *layer, int frame);
 void close_ascrap_file(boolean remove);
 void close_scrap_file(boolean remove);
@@ -1485,7 +1513,21 @@ boolean lazy_startup_checks(void *data);
 			       && weed_get_voidptr_value(layer, WEED_LEAF_RESIZE_THREAD, NULL) == NULL)
 
 boolean pull_frame(weed_layer_t *layer, const char *image_ext, ticks_t tc);
+
+typedef struct {
+  uint64_t hits, misses, stores;
+  uint64_t evictions, invalidations;
+  size_t bytes, max_bytes;
+  int nentries;
+} lives_frame_cache_stats_t;
+
+void lives_frame_cache_invalidate(int clip);
+void lives_frame_cache_get_stats(lives_frame_cache_stats_t *);
 void pull_frame_threaded(weed_layer_t *layer, const char *img_ext, ticks_t tc, int width, int height);
+void lives_readahead_update(int clip, frames_t frame, double pb_fps);
+boolean lives_readahead_fetch(weed_layer_t *layer);
+boolean lives_readahead_active(int clip);
+void lives_readahead_stop(void);
 boolean check_layer_ready(weed_layer_t *layer);
 boolean pull_frame_at_size(weed_layer_t *layer, const char *image_ext, ticks_t tc,
                            int width, int height, int target_palette);
@@ -1588,6 +1630,9 @@ ssize_t lives_read_le(int fd, void *buf, ssize_t count, boolean allow_less);
 #define BUFFER_FILL_BYTES_BIGMED 16386  /// 2049 - 8192 bytes
 #define BUFFER_FILL_BYTES_LARGE 65536
 
+/// read files which are memory mapped: the kernel is asked to page in this much ahead of the read position
+#define BUFFER_MAP_ADVISE_BYTES (BUFFER_FILL_BYTES_LARGE * 16)
+
 #define BUFF_SIZE_READ_SMALL 0
 #define BUFF_SIZE_READ_SMALLMED 1
 #define BUFF_SIZE_READ_MED 2
@@ -1618,6 +1663,11 @@ typedef struct {
   volatile boolean invalid;
   size_t orig_size;
   char *pathname;
+  uint8_t *mapped; ///< if non-NULL the file is memory mapped and reads are served from here
+  size_t mapsize; ///< bytes mapped
+  off_t advised; ///< read position when we last gave the kernel a paging hint (mapped only)
+  uint8_t *bounce; ///< lent by lives_read_buffered_borrow() when the data cannot be lent in place
+  size_t bounce_size;
 } lives_file_buffer_t;
 
 lives_file_buffer_t *find_in_file_buffers(int fd);
@@ -1626,9 +1676,11 @@ lives_file_buffer_t *find_in_file_buffers_by_pathname(const char *pathname);
 size_t get_read_buff_size(int sztype);
 
 int lives_open_buffered_rdonly(const char *pathname);
+int lives_open_buffered_rdonly_mapped(const char *pathname);
 int lives_open_buffered_writer(const char *pathname, int mode, boolean append);
 int lives_create_buffered(const char *pathname, int mode);
 int lives_create_buffered_nosync(const char *pathname, int mode);
+int lives_append_buffered_nosync(const char *pathname, int mode);
 int lives_close_buffered(int fd);
 off_t lives_lseek_buffered_writer(int fd, off_t offset);
 off_t lives_lseek_buffered_rdonly(int fd, off_t offset);
@@ -1641,10 +1693,18 @@ ssize_t lives_buffered_write_printf(int fd, boolean allow_fail, const char *fmt,
 ssize_t lives_write_le_buffered(int fd, livesconstpointer buf, ssize_t count, boolean allow_fail);
 ssize_t lives_read_buffered(int fd, void *buf, ssize_t count, boolean allow_less);
 ssize_t lives_read_le_buffered(int fd, void *buf, ssize_t count, boolean allow_less);
+ssize_t lives_read_buffered_borrow(int fd, const uint8_t **ptr, ssize_t count);
 boolean lives_read_buffered_eof(int fd);
 lives_file_buffer_t *get_file_buffer(int fd);
 void lives_buffered_rdonly_slurp(int fd, off_t skip);
 
+#define LIVES_LZ_MINMATCH 4
+#define LIVES_LZ_MAX_INPUT ((size_t)1 << 30) ///< offsets in the match table are 32 bit
+#define LIVES_LZ_BOUND(n) ((n) + (n) / 255 + 16) ///< worst case compressed size for n bytes
+
+size_t lives_lz_compress(const uint8_t *src, size_t srclen, uint8_t *dst, size_t dstlen);
+ssize_t lives_lz_decompress(const uint8_t *src, size_t srclen, uint8_t *dst, size_t dstlen);
+
 int lives_chdir(const char *path, boolean no_error_dlg);
 int lives_fputs(const char *s, FILE *stream);
 char *lives_fgets(char *s, int size, FILE *stream);
@@ -1873,11 +1873,6 @@ _fx_dialog *fx_dialog[2];
 #define LIVES_SIGQUIT SIGQUIT
 #endif
 
-#ifdef ENABLE_JACK
-volatile aserver_message_t jack_message;
-volatile aserver_message_t jack_message2;
-#endif
-
 #ifdef HAVE_PULSE_AUDIO
 volatile aserver_message_t pulse_message;
 volatile aserver_message_t pulse_message2;
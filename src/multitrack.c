@@ -20804,7 +20804,7 @@ boolean event_list_rectify(lives_mt * mt, weed_plant_t *event_list) {
     tc = get_event_timecode(event);
     if (fps != 0.) {
       tc = q_gint64(tc + TICKS_PER_SECOND_DBL / (2. * fps) - 1, fps);
-      weed_set_int64_value(event, WEED_LEAF_TIMECODE, tc);
+      weed_event_set_timecode(event, tc);
     }
     ev_count++;
     lives_snprintf(mainw->msg, MAINW_MSG_SIZE, "%d|", ev_count);
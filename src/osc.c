@@ -4,8 +4,14 @@
 // Released under the GPL 3 or later
 // see file ../COPYING for licensing details
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE ///< for recvmmsg()
+#endif
+
 #ifndef IS_MINGW
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <poll.h>
 #endif
 
 #include "main.h"
@@ -1705,6 +1711,52 @@ boolean lives_osc_cb_getstatus(void *context, int arglen, const void *vargs, OSC
 }
 
 
+/// reply is threads|max_threads|peak_threads|idle_threads|queued|running|completed|steals|inlined|reaped|avg_wait|max_wait
+/// with wait times in seconds
+boolean lives_osc_cb_get_poolstats(void *context, int arglen, const void *vargs, OSCTimeTag when, NetworkReturnAddressPtr ra) {
+  lives_threadpool_stats_t stats;
+  char *tmp;
+  lives_threadpool_get_stats(&stats);
+  lives_status_send((tmp = lives_strdup_printf("%d|%d|%d|%d|%" PRId64 "|%" PRId64 "|%" PRIu64 "|%" PRIu64 "|%" PRIu64
+                                 "|%" PRIu64 "|%.6f|%.6f", stats.nthreads, stats.max_threads, stats.peak_threads,
+                                 stats.idle_threads, stats.queued, stats.running, stats.completed, stats.steals,
+                                 stats.inlined, stats.reaped, stats.avg_wait, stats.max_wait)));
+  lives_free(tmp);
+  return TRUE;
+}
+
+
+boolean lives_osc_cb_get_jackstats(void *context, int arglen, const void *vargs, OSCTimeTag when, NetworkReturnAddressPtr ra) {
+  // realtime counters for the jack output client
+#ifdef ENABLE_JACK
+  lives_jack_rt_stats_t stats;
+  char *tmp;
+  if (prefs->audio_player != AUD_PLAYER_JACK || !mainw->jackd) return lives_osc_notify_failure();
+  jack_get_rt_stats(mainw->jackd, &stats);
+  lives_status_send((tmp = lives_strdup_printf("%" PRIu64 "|%.2f|%" PRIu64 "|%" PRIu64 "|%" PRIu64 "|%" PRIu64 "|%" PRIu64
+                                 "|%" PRIu64, stats.xruns, stats.max_xrun_delay, stats.last_cycle_usec,
+                                 stats.max_cycle_usec, stats.period_usec, stats.late_cycles, stats.rt_allocs,
+                                 stats.cmd_overflows)));
+  lives_free(tmp);
+  return TRUE;
+#else
+  return lives_osc_notify_failure();
+#endif
+}
+
+
+boolean lives_osc_cb_reset_jackstats(void *context, int arglen, const void *vargs, OSCTimeTag when,
+                                     NetworkReturnAddressPtr ra) {
+#ifdef ENABLE_JACK
+  if (prefs->audio_player != AUD_PLAYER_JACK || !mainw->jackd) return lives_osc_notify_failure();
+  jack_reset_rt_stats(mainw->jackd);
+  return lives_osc_notify_success(NULL);
+#else
+  return lives_osc_notify_failure();
+#endif
+}
+
+
 boolean lives_osc_cb_getconst(void *context, int arglen, const void *vargs, OSCTimeTag when, NetworkReturnAddressPtr ra) {
   const char *retval;
   char cname[OSC_STRING_SIZE];
@@ -6156,6 +6208,76 @@ boolean lives_osc_cb_rte_getmodespk(void *context, int arglen, const void *vargs
 }
 
 
+/// reply is mode|calls|avg_usec|p50_usec|p95_usec|max_usec|avg_conv_usec|recent_usec|threaded_calls|slice_util|scale
+/// process times are per process_func call, conversion (host overhead) and recent times are per applied frame;
+/// slice_util is the fraction of slice thread time spent processing, scale is the processing size in percent
+boolean lives_osc_cb_rte_getprofile(void *context, int arglen, const void *vargs, OSCTimeTag when,
+                                    NetworkReturnAddressPtr ra) {
+  lives_fx_prof_stats_t stats;
+  char *tmp;
+  int effect_key;
+
+  if (!lives_osc_check_arguments(arglen, vargs, "i", TRUE)) return lives_osc_notify_failure();
+  lives_osc_parse_int_argument(vargs, &effect_key);
+
+  if (effect_key < 1 || effect_key > FX_KEYS_MAX_VIRTUAL) return lives_osc_notify_failure();
+
+  fx_prof_get_stats(effect_key - 1, &stats);
+  lives_status_send((tmp = lives_strdup_printf("%d|%" PRIu64 "|%" PRIu64 "|%" PRIu64 "|%" PRIu64 "|%" PRIu64 "|%" PRIu64
+                                 "|%" PRIu64 "|%" PRIu64 "|%.3f|%d", stats.mode + 1, stats.calls,
+                                 stats.calls ? stats.proc_usec / stats.calls : 0,
+                                 fx_prof_percentile(&stats, 50.), fx_prof_percentile(&stats, 95.), stats.max_usec,
+                                 stats.applies ? stats.conv_usec / stats.applies : 0, stats.recent_usec,
+                                 stats.threaded_calls, stats.slice_avail_usec
+                                 ? (double)stats.slice_busy_usec / (double)stats.slice_avail_usec : 0.,
+                                 stats.scale)));
+  lives_free(tmp);
+  return TRUE;
+}
+
+
+boolean lives_osc_cb_rte_resetprofile(void *context, int arglen, const void *vargs, OSCTimeTag when,
+                                      NetworkReturnAddressPtr ra) {
+  int effect_key;
+
+  if (!lives_osc_check_arguments(arglen, vargs, "i", FALSE)) {
+    if (lives_osc_check_arguments(arglen, vargs, "", TRUE)) {
+      // no key: reset all
+      fx_prof_reset_stats(-1);
+      return lives_osc_notify_success(NULL);
+    }
+    return lives_osc_notify_failure();
+  }
+
+  lives_osc_check_arguments(arglen, vargs, "i", TRUE);
+  lives_osc_parse_int_argument(vargs, &effect_key);
+
+  if (effect_key < 1 || effect_key > FX_KEYS_MAX_VIRTUAL) return lives_osc_notify_failure();
+
+  fx_prof_reset_stats(effect_key - 1);
+  return lives_osc_notify_success(NULL);
+}
+
+
+boolean lives_osc_cb_rte_setadaptive(void *context, int arglen, const void *vargs, OSCTimeTag when,
+                                     NetworkReturnAddressPtr ra) {
+  int enable;
+
+  if (!lives_osc_check_arguments(arglen, vargs, "i", TRUE)) return lives_osc_notify_failure();
+  lives_osc_parse_int_argument(vargs, &enable);
+
+  fx_prof_set_adaptive(enable != 0);
+  return lives_osc_notify_success(NULL);
+}
+
+
+boolean lives_osc_cb_rte_getadaptive(void *context, int arglen, const void *vargs, OSCTimeTag when,
+                                     NetworkReturnAddressPtr ra) {
+  if (fx_prof_get_adaptive()) return lives_status_send(get_omc_const("LIVES_TRUE"));
+  return lives_status_send(get_omc_const("LIVES_FALSE"));
+}
+
+
 boolean lives_osc_cb_rte_addpconnection(void *context, int arglen, const void *vargs, OSCTimeTag when,
                                         NetworkReturnAddressPtr ra) {
   weed_plant_t *ofilter, *ifilter;
@@ -6706,6 +6828,10 @@ static struct {
   { "/effect_key/outchannel/palette/get",		"get",	(osc_cb)lives_osc_cb_rte_getoutpal,		        162	},
   { "/effect_key/mode/set",		"set",	(osc_cb)lives_osc_cb_rte_setmode,		        43	},
   { "/effect_key/mode/get",		"get",	(osc_cb)lives_osc_cb_rte_getmode,		        43	},
+  { "/effect_key/profile/get",		"get",	(osc_cb)lives_osc_cb_rte_getprofile,		        190	},
+  { "/effect_key/profile/reset",		"reset",	(osc_cb)lives_osc_cb_rte_resetprofile,		        190	},
+  { "/effect_key/profile/adaptive/set",		"set",	(osc_cb)lives_osc_cb_rte_setadaptive,		        191	},
+  { "/effect_key/profile/adaptive/get",		"get",	(osc_cb)lives_osc_cb_rte_getadaptive,		        191	},
   { "/effect_key/mode/next",		"next",	(osc_cb)lives_osc_cb_rte_nextmode,		        43	},
   { "/effect_key/mode/previous",	"previous",	(osc_cb)lives_osc_cb_rte_prevmode,		        43	},
   { "/effect_key/name/get",		"get",	(osc_cb)lives_osc_cb_rte_get_keyfxname,		        44	},
@@ -6750,6 +6876,9 @@ static struct {
   { "/lives/version/get",	         "get", (osc_cb)lives_osc_cb_getversion,			24	},
   { "/lives/status/get",	         "get", (osc_cb)lives_osc_cb_getstatus,			122	},
   { "/lives/constant/value/get",	         "get", (osc_cb)lives_osc_cb_getconst,			121	},
+  { "/lives/threadpool/stats/get",	         "get", (osc_cb)lives_osc_cb_get_poolstats,			127	},
+  { "/lives/jack/stats/get",	         "get", (osc_cb)lives_osc_cb_get_jackstats,			129	},
+  { "/lives/jack/stats/reset",	         "reset", (osc_cb)lives_osc_cb_reset_jackstats,			129	},
   { "/app/quit",	         "quit", (osc_cb)lives_osc_cb_quit,			22	},
   { "/app/name",	         "name", (osc_cb)lives_osc_cb_getname,			22	},
   { "/app/name/get",	         "get", (osc_cb)lives_osc_cb_getname,			23	},
@@ -6907,12 +7036,18 @@ static struct {
   {	"/effect_key/outparameter/min/", 	"min",	 156, 150, 0	},
   {	"/effect_key/outparameter/max/", 	"max",	 157, 150, 0	},
   {	"/effect_key/outparameter/default/", 	"default",	 158, 150, 0	},
+  {	"/effect_key/profile/", 	"profile",	 190, 25, 0	},
+  {	"/effect_key/profile/adaptive/", 	"adaptive",	 191, 190, 0	},
   {	"/lives/", 		"lives",	 21, -1, 0	},
   {	"/lives/version/", 		"version",	 24, 21, 0	},
   {	"/lives/mode/", 		"mode",	 103, 21, 0	},
   {	"/lives/status/", 		"status",	 122, 21, 0	},
   {	"/lives/constant/", 		"constant",	 120, 21, 0	},
   {	"/lives/constant/value/", 		"value",	 121, 120, 0	},
+  {	"/lives/threadpool/", 		"threadpool",	 126, 21, 0	},
+  {	"/lives/threadpool/stats/", 		"stats",	 127, 126, 0	},
+  {	"/lives/jack/", 		"jack",	 128, 21, 0	},
+  {	"/lives/jack/stats/", 		"stats",	 129, 128, 0	},
   {	"/clipset/", 		"clipset",	 35, -1, 0	},
   {	"/clipset/name/", 		"name",	 135, 35, 0	},
   {	"/app/", 		"app",	         22, -1, 0	},
@@ -7090,6 +7225,306 @@ static int lives_osc_get_packet(lives_osc * o) {
 }
 
 
+#ifndef IS_MINGW
+/// dedicated receive thread: all pending datagrams are drained on each wakeup and passed to the main thread
+/// through a single producer / single consumer ring; lives_osc_poll() then dispatches everything queued.
+/// Redundant parameter value sets for the same key / parameter are coalesced, and bundles with a future
+/// timetag are held back and dispatched against the playback clock.
+
+#define OSC_RECV_QUEUE 256 ///< ring slots (power of 2)
+#define OSC_RECV_BATCH 32 ///< max datagrams per recvmmsg() call
+#define OSC_RECV_POLL_MS 100 ///< wakeup interval to check for shutdown
+#define OSC_DISPATCH_MAX OSC_RECV_QUEUE ///< max datagrams dispatched per lives_osc_poll()
+
+#define SECONDS_FROM_1900_TO_1970 2208988800ULL
+
+typedef struct {
+  int n; ///< datagram length, 0 if it was coalesced away
+  struct sockaddr_in from;
+  ticks_t recv_ticks; ///< time of receipt
+  ticks_t delay; ///< time from receipt until the bundle timetag is due, 0 == immediate
+  char buf[OSC_BUFFLEN];
+} osc_datagram_t;
+
+typedef struct {
+  ticks_t due;
+  boolean pb_clock; ///< due is in playback ticks (for play_sequence) rather than system ticks
+  int play_sequence;
+  int n;
+  struct sockaddr_in from;
+  char *buf;
+} osc_scheduled_t;
+
+static osc_datagram_t *osc_ring = NULL;
+static volatile uint32_t osc_ring_head = 0, osc_ring_tail = 0;
+static pthread_t osc_recv_thread;
+static volatile boolean osc_recv_running = FALSE;
+static volatile boolean osc_recv_quit = FALSE;
+static LiVESList *osc_scheduled = NULL;
+static boolean osc_dispatching = FALSE;
+
+
+static uint64_t osc_ntp_now(void) {
+  // current time as an OSC (NTP) timetag
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (((uint64_t)ts.tv_sec + SECONDS_FROM_1900_TO_1970) << 32)
+         + (((uint64_t)ts.tv_nsec << 32) / ONE_BILLION);
+}
+
+
+LIVES_LOCAL_INLINE uint32_t osc_get_be32(const char *p) {
+  const uint8_t *u = (const uint8_t *)p;
+  return ((uint32_t)u[0] << 24) | ((uint32_t)u[1] << 16) | ((uint32_t)u[2] << 8) | (uint32_t)u[3];
+}
+
+
+LIVES_LOCAL_INLINE boolean osc_is_bundle(const char *buf, int n) {
+  return n >= 16 && !lives_memcmp(buf, "#bundle", 8);
+}
+
+
+static ticks_t osc_bundle_delay(const char *buf, int n, uint64_t ntp_now) {
+  // return ticks until the timetag of a bundle is due, or 0 if it is a message, immediate or already late
+  uint64_t tt;
+  if (!osc_is_bundle(buf, n)) return 0;
+  tt = ((uint64_t)osc_get_be32(buf + 8) << 32) | osc_get_be32(buf + 12);
+  if (tt <= 1 || tt <= ntp_now) return 0;
+  tt -= ntp_now;
+  return (ticks_t)((tt >> 32) * TICKS_PER_SECOND + (((tt & 0xFFFFFFFF) * TICKS_PER_SECOND) >> 32));
+}
+
+
+static void osc_bundle_make_immediate(char *buf, int n) {
+  // libOSC only invokes messages whose timetag has passed its idea of "now", which is always "immediately",
+  // so once a bundle is due we rewrite its timetag (and those of nested bundles) to 1
+  int i, size;
+  if (!osc_is_bundle(buf, n)) return;
+  lives_memset(buf + 8, 0, 7);
+  buf[15] = 1;
+  for (i = 16; i + 4 <= n; i += size) {
+    size = (int)osc_get_be32(buf + i);
+    i += 4;
+    if (size <= 0 || i + size > n) break;
+    osc_bundle_make_immediate(buf + i, size);
+  }
+}
+
+
+static boolean osc_param_set_id(const osc_datagram_t *dg, int *addr, uint32_t *key, uint32_t *pnum) {
+  // if dg is a single parameter value set with typed key and parameter number args, return TRUE and identify it
+  static const char *paddrs[] = {"/effect_key/parameter/value/set", "/effect_key/nparameter/value/set", NULL};
+  int i, len;
+  if (dg->n < 4 || dg->buf[0] != '/' || !memchr(dg->buf, 0, dg->n)) return FALSE;
+  for (i = 0; paddrs[i]; i++) if (!lives_strcmp(dg->buf, paddrs[i])) break;
+  if (!paddrs[i]) return FALSE;
+  *addr = i;
+  len = (lives_strlen(paddrs[i]) + 4) & ~3;
+  if (len + 4 > dg->n || lives_strncmp(dg->buf + len, ",ii", 3) || !memchr(dg->buf + len, 0, dg->n - len)) return FALSE;
+  // skip the type tags
+  len += (lives_strlen(dg->buf + len) + 4) & ~3;
+  if (len + 8 > dg->n) return FALSE;
+  *key = osc_get_be32(dg->buf + len);
+  *pnum = osc_get_be32(dg->buf + len + 4);
+  return TRUE;
+}
+
+
+static void osc_coalesce(osc_datagram_t **dgrams, int ndgrams) {
+  // drop parameter value sets which are superseded by a later set of the same key and parameter
+  // we only look ahead through a run of parameter sets, since any other message (e.g. a mode change) may alter
+  // what the set refers to
+  uint32_t key, pnum, key2, pnum2;
+  int addr, addr2, i, j;
+  for (i = 0; i < ndgrams - 1; i++) {
+    if (!dgrams[i]->n || dgrams[i]->delay || !osc_param_set_id(dgrams[i], &addr, &key, &pnum)) continue;
+    for (j = i + 1; j < ndgrams; j++) {
+      if (!dgrams[j]->n) continue;
+      if (dgrams[j]->delay || !osc_param_set_id(dgrams[j], &addr2, &key2, &pnum2)) break;
+      if (addr == addr2 && key == key2 && pnum == pnum2) {
+        dgrams[i]->n = 0;
+        break;
+      }
+    }
+  }
+}
+
+
+static void *osc_recv_func(void *arg) {
+  osc_datagram_t *dgrams[OSC_RECV_BATCH];
+  struct pollfd pfd;
+  uint32_t head, space;
+  uint64_t ntp_now;
+  ticks_t now;
+  int fd = LIVES_POINTER_TO_INT(arg);
+  int nmax, n, i;
+#ifdef __linux__
+  struct mmsghdr msgs[OSC_RECV_BATCH];
+  struct iovec iovs[OSC_RECV_BATCH];
+#endif
+
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+
+  while (!osc_recv_quit) {
+    head = osc_ring_head;
+    space = OSC_RECV_QUEUE - (head - __atomic_load_n(&osc_ring_tail, __ATOMIC_ACQUIRE));
+    if (!space) {
+      // the main thread is behind; leave the datagrams in the socket until it catches up
+      lives_nanosleep(ONE_MILLION);
+      continue;
+    }
+    if (poll(&pfd, 1, OSC_RECV_POLL_MS) <= 0 || !(pfd.revents & POLLIN)) continue;
+
+    nmax = MIN(space, OSC_RECV_BATCH);
+    for (i = 0; i < nmax; i++) dgrams[i] = &osc_ring[(head + i) & (OSC_RECV_QUEUE - 1)];
+#ifdef __linux__
+    for (i = 0; i < nmax; i++) {
+      iovs[i].iov_base = dgrams[i]->buf;
+      iovs[i].iov_len = OSC_BUFFLEN;
+      lives_memset(&msgs[i], 0, sizeof(struct mmsghdr));
+      msgs[i].msg_hdr.msg_name = &dgrams[i]->from;
+      msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    n = recvmmsg(fd, msgs, nmax, MSG_DONTWAIT, NULL);
+    if (n <= 0) continue;
+    for (i = 0; i < n; i++) {
+      dgrams[i]->n = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : (int)msgs[i].msg_len;
+    }
+#else
+    for (n = 0; n < nmax; n++) {
+      socklen_t fromlen = sizeof(struct sockaddr_in);
+      ssize_t len = recvfrom(fd, dgrams[n]->buf, OSC_BUFFLEN, MSG_DONTWAIT, (struct sockaddr *)&dgrams[n]->from,
+                             &fromlen);
+      if (len <= 0) break;
+      dgrams[n]->n = (int)len;
+    }
+    if (!n) continue;
+#endif
+    now = lives_get_current_ticks();
+    ntp_now = osc_ntp_now();
+    for (i = 0; i < n; i++) {
+      dgrams[i]->recv_ticks = now;
+      dgrams[i]->delay = osc_bundle_delay(dgrams[i]->buf, dgrams[i]->n, ntp_now);
+    }
+    osc_coalesce(dgrams, n);
+    __atomic_store_n(&osc_ring_head, head + n, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
+
+
+static void lives_osc_recv_start(lives_osc *o) {
+  NetworkReturnAddressPtr na = OSCPacketBufferGetClientAddr(o->packet);
+  if (osc_recv_running || na->sockfd < 0) return;
+  if (!osc_ring) osc_ring = (osc_datagram_t *)lives_calloc(OSC_RECV_QUEUE, sizeof(osc_datagram_t));
+  osc_ring_head = osc_ring_tail = 0;
+  osc_recv_quit = FALSE;
+  if (pthread_create(&osc_recv_thread, NULL, osc_recv_func, LIVES_INT_TO_POINTER(na->sockfd))) return;
+  osc_recv_running = TRUE;
+}
+
+
+static void lives_osc_recv_stop(void) {
+  if (!osc_recv_running) return;
+  osc_recv_quit = TRUE;
+  pthread_join(osc_recv_thread, NULL);
+  osc_recv_running = FALSE;
+}
+
+
+static void lives_osc_dispatch_packet(lives_osc *o, char *buf, int n, struct sockaddr_in *from) {
+  NetworkReturnAddressPtr na = OSCPacketBufferGetClientAddr(o->packet);
+  osc_bundle_make_immediate(buf, n);
+  lives_memcpy(OSCPacketBufferGetBuffer(o->packet), buf, n);
+  *OSCPacketBufferGetSize(o->packet) = n;
+  lives_memcpy(&na->cl_addr, from, sizeof(struct sockaddr_in));
+  OSCAcceptPacket(o->packet);
+#ifdef DEBUG_OSC
+  g_print("got osc msg %s\n", OSCPacketBufferGetBuffer((OSCPacketBuffer)o->packet));
+#endif
+  OSCBeProductiveWhileWaiting();
+}
+
+
+static void lives_osc_schedule(osc_datagram_t *dg) {
+  // hold a timed bundle until it is due; while playing, the due time is measured on the playback clock
+  osc_scheduled_t *sch = (osc_scheduled_t *)lives_malloc(sizeof(osc_scheduled_t));
+  ticks_t remaining = dg->delay - (lives_get_current_ticks() - dg->recv_ticks);
+  sch->pb_clock = LIVES_IS_PLAYING;
+  sch->play_sequence = mainw->play_sequence;
+  sch->due = (sch->pb_clock ? mainw->currticks : lives_get_current_ticks()) + remaining;
+  sch->n = dg->n;
+  sch->from = dg->from;
+  sch->buf = (char *)lives_malloc(dg->n);
+  lives_memcpy(sch->buf, dg->buf, dg->n);
+  osc_scheduled = lives_list_append(osc_scheduled, sch);
+}
+
+
+static boolean osc_scheduled_is_due(osc_scheduled_t *sch) {
+  if (sch->pb_clock) {
+    // if playback ended or restarted, the playback clock no longer applies, so it is due now
+    if (!LIVES_IS_PLAYING || mainw->play_sequence != sch->play_sequence) return TRUE;
+    return mainw->currticks >= sch->due;
+  }
+  return lives_get_current_ticks() >= sch->due;
+}
+
+
+static void lives_osc_dispatch_queued(lives_osc *o) {
+  osc_datagram_t *dgrams[OSC_DISPATCH_MAX];
+  osc_scheduled_t *sch;
+  LiVESList *list, *next;
+  uint32_t tail = osc_ring_tail;
+  int n, i;
+
+  if (osc_dispatching) return; ///< a callback is running the main loop
+  osc_dispatching = TRUE;
+
+  for (list = osc_scheduled; list; list = next) {
+    next = list->next;
+    sch = (osc_scheduled_t *)list->data;
+    if (!osc_scheduled_is_due(sch)) continue;
+    osc_scheduled = lives_list_remove_link(osc_scheduled, list);
+    lives_list_free(list);
+    lives_osc_dispatch_packet(o, sch->buf, sch->n, &sch->from);
+    lives_free(sch->buf);
+    lives_free(sch);
+  }
+
+  n = (int)(__atomic_load_n(&osc_ring_head, __ATOMIC_ACQUIRE) - tail);
+  if (n > OSC_DISPATCH_MAX) n = OSC_DISPATCH_MAX;
+  for (i = 0; i < n; i++) dgrams[i] = &osc_ring[(tail + i) & (OSC_RECV_QUEUE - 1)];
+
+  // coalesce again over everything which built up since the last poll
+  osc_coalesce(dgrams, n);
+
+  for (i = 0; i < n; i++) {
+    if (!dgrams[i]->n) continue;
+    if (dgrams[i]->delay > 0) lives_osc_schedule(dgrams[i]);
+    else lives_osc_dispatch_packet(o, dgrams[i]->buf, dgrams[i]->n, &dgrams[i]->from);
+  }
+  __atomic_store_n(&osc_ring_tail, tail + n, __ATOMIC_RELEASE);
+
+  osc_dispatching = FALSE;
+}
+
+
+static void lives_osc_scheduled_free(void) {
+  for (LiVESList *list = osc_scheduled; list; list = list->next) {
+    osc_scheduled_t *sch = (osc_scheduled_t *)list->data;
+    lives_free(sch->buf);
+    lives_free(sch);
+  }
+  lives_list_free(osc_scheduled);
+  osc_scheduled = NULL;
+}
+#endif
+
+
 static void oscbuf_to_packet(OSCbuf * obuf, OSCPacketBuffer packet) {
   int *psize = OSCPacketBufferGetSize(packet);
   int bufsize = OSC_packetSize(obuf);
@@ -7141,6 +7576,9 @@ boolean lives_osc_init(uint32_t udp_port) {
       d_print( lives_strdup_printf (_("Cannot shut down OSC/UDP server\n"));
       }
     */
+#ifndef IS_MINGW
+    lives_osc_recv_stop();
+#endif
     if (NetworkStartUDPServer(livesOSC->packet, udp_port) != TRUE) {
       d_print(_("Cannot start OSC/UDP server at port %d \n"), udp_port);
     }
@@ -7150,6 +7588,9 @@ boolean lives_osc_init(uint32_t udp_port) {
     status_socket = NULL;
     notify_socket = NULL;
   }
+#ifndef IS_MINGW
+  if (udp_port != 0) lives_osc_recv_start(livesOSC);
+#endif
   return TRUE;
 }
 
@@ -7157,7 +7598,15 @@ boolean lives_osc_init(uint32_t udp_port) {
 boolean lives_osc_poll(livespointer data) {
   // data is always NULL
   // must return TRUE
-  if (!mainw->osc_block && livesOSC) lives_osc_get_packet(livesOSC);
+  if (!mainw->osc_block && livesOSC) {
+#ifndef IS_MINGW
+    if (osc_recv_running) {
+      lives_osc_dispatch_queued(livesOSC);
+      return TRUE;
+    }
+#endif
+    lives_osc_get_packet(livesOSC);
+  }
   return TRUE;
 }
 
@@ -7171,6 +7620,10 @@ void lives_osc_end(void) {
     lives_osc_close_status_socket();
   }
 
+#ifndef IS_MINGW
+  lives_osc_recv_stop();
+  lives_osc_scheduled_free();
+#endif
   if (livesOSC) lives_osc_free(livesOSC);
   livesOSC = NULL;
 }
@@ -354,6 +354,11 @@ typedef struct {
   char def_autotrans[256];
 
   int nfx_threads;
+  int max_pool_threads; ///< ceiling for the worker thread pool; 0 == choose automatically
+  int frame_cache_mb; ///< memory budget for the decoded frame cache (MB); 0 == disabled
+#define DEF_FRAME_CACHE_MB 256
+  int readahead_frames; ///< number of frames to decode ahead during playback of decoder clips; 0 == disabled
+#define DEF_READAHEAD_FRAMES 8
 
   boolean alpha_post; ///< set to TRUE to force use of post alpha internally
 
@@ -973,6 +978,9 @@ void apply_button_set_enabled(LiVESWidget *widget, livespointer func_data);
 #define PREF_REC_STOP_GB "rec_stop-gb"
 
 #define PREF_NFX_THREADS "nfx_threads"
+#define PREF_MAX_POOL_THREADS "max_pool_threads"
+#define PREF_FRAME_CACHE_MB "frame_cache_mb"
+#define PREF_READAHEAD_FRAMES "readahead_frames"
 
 #define PREF_BTGAMMA "experimental_bt709_gamma"
 #define PREF_USE_SCREEN_GAMMA "use_screen_gamma"
@@ -353,7 +353,7 @@ static void pulse_audio_write_process(pa_stream *pstream, size_t nbytes, void *a
       new_file = atoi((char *)msg->data);
       if (pulsed->playing_file != new_file) {
         filename = lives_get_audio_file_name(new_file);
-        pulsed->fd = lives_open_buffered_rdonly(filename);
+        pulsed->fd = lives_open_buffered_rdonly_mapped(filename);
         if (pulsed->fd == -1) {
           // dont show gui errors - we are running in realtime thread
           LIVES_ERROR("pulsed: error opening");
@@ -364,6 +364,7 @@ static void pulse_audio_write_process(pa_stream *pstream, size_t nbytes, void *a
       }
       pulsed->real_seek_pos = pulsed->seek_pos = 0;
       pulsed->playing_file = new_file;
+      lives_resampler_reset(pulsed->resampler);
       //pa_stream_trigger(pulsed->pstream, NULL, NULL); // only needed for prebuffer
       break;
     case ASERVER_CMD_FILE_CLOSE:
@@ -380,6 +381,7 @@ static void pulse_audio_write_process(pa_stream *pstream, size_t nbytes, void *a
       pulsed->fd = pulsed->playing_file = -1;
       pulsed->in_use = FALSE;
       pulsed->seek_pos = pulsed->real_seek_pos = fwd_seek_pos = 0;
+      lives_resampler_reset(pulsed->resampler);
       break;
     case ASERVER_CMD_FILE_SEEK:
       if (pulsed->fd < 0) break;
@@ -401,6 +403,7 @@ static void pulse_audio_write_process(pa_stream *pstream, size_t nbytes, void *a
       xseek = ALIGN_CEIL64(xseek, afile->achans * (afile->asampsize >> 3));
       lives_lseek_buffered_rdonly_absolute(pulsed->fd, xseek);
       pulsed->real_seek_pos = pulsed->seek_pos = afile->aseek_pos = xseek;
+      lives_resampler_reset(pulsed->resampler);
       if (pulsed->playing_file == mainw->ascrap_file || afile->adirection == LIVES_DIRECTION_FORWARD) {
         lives_buffered_rdonly_set_reversed(pulsed->fd, FALSE);
       } else {
@@ -844,9 +847,10 @@ static void pulse_audio_write_process(pa_stream *pstream, size_t nbytes, void *a
               sample_move_d8_d16((short *)(pulsed->sound_buffer), (uint8_t *)buffer, nsamples, in_bytes,
                                  shrink_factor, pulsed->out_achans, pulsed->in_achans, swap_sign ? SWAP_U_TO_S : 0);
             } else {
-              sample_move_d16_d16((short *)pulsed->sound_buffer, (short *)buffer, nsamples, in_bytes, shrink_factor,
-                                  pulsed->out_achans, pulsed->in_achans, pulsed->reverse_endian ? SWAP_X_TO_L : 0,
-                                  swap_sign ? SWAP_U_TO_S : 0);
+              if (!pulsed->resampler) pulsed->resampler = lives_resampler_new();
+              lives_resample_s16(pulsed->resampler, (short *)pulsed->sound_buffer, (short *)buffer, nsamples, in_bytes,
+                                 shrink_factor, pulsed->out_achans, pulsed->in_achans,
+                                 pulsed->reverse_endian ? SWAP_X_TO_L : 0, swap_sign ? SWAP_U_TO_S : 0);
             }
           }
 
@@ -1203,8 +1207,9 @@ size_t pulse_flush_read_data(pulse_driver_t *pulsed, int fileno, size_t rbytes,
   }
 
   if (ofile->asampsize == 16) {
-    sample_move_d16_d16((short *)holding_buff, gbuf, frames_out, prb, out_scale, ofile->achans, pulsed->in_achans,
-                        pulsed->reverse_endian ? SWAP_L_TO_X : 0, swap_sign ? SWAP_S_TO_U : 0);
+    if (!pulsed->resampler) pulsed->resampler = lives_resampler_new();
+    lives_resample_s16(pulsed->resampler, (short *)holding_buff, gbuf, frames_out, prb, out_scale, ofile->achans,
+                       pulsed->in_achans, pulsed->reverse_endian ? SWAP_L_TO_X : 0, swap_sign ? SWAP_S_TO_U : 0);
   } else {
     sample_move_d16_d8((uint8_t *)holding_buff, gbuf, frames_out, prb, out_scale, ofile->achans, pulsed->in_achans,
                        swap_sign ? SWAP_S_TO_U : 0);
@@ -1461,6 +1466,8 @@ void pulse_close_client(pulse_driver_t *pdriver) {
   if (pdriver->pa_props) pa_proplist_free(pdriver->pa_props);
   pdriver->pa_props = NULL;
   pdriver->pstream = NULL;
+  lives_resampler_free(pdriver->resampler);
+  pdriver->resampler = NULL;
 }
 
 
@@ -66,6 +66,7 @@ typedef struct {
   lives_audio_loop_t loop;
 
   uint8_t *sound_buffer; ///< transformed data
+  lives_resampler_t *resampler; ///< rate conversion state for the stream
 
   pa_cvolume volume;
 
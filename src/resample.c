@@ -840,9 +840,6 @@ weed_plant_t *quantise_events(weed_plant_t *in_list, double qfps, boolean allow_
           lives_free(what);
           return NULL;
         }
-        if (weed_plant_has_leaf(frame_event, WEED_LEAF_HOST_SCRAP_FILE_OFFSET)) {
-          weed_leaf_dup(newframe, frame_event, WEED_LEAF_HOST_SCRAP_FILE_OFFSET);
-        }
         weed_leaf_dup(newframe, frame_event, WEED_LEAF_OVERLAY_TEXT);
 
         lives_freep((void **)&frames);
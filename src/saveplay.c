@@ -2940,17 +2940,14 @@ void play_file(void) {
       ticks_t timeout = 0;
       if (mainw->cancelled != CANCEL_AUDIO_ERROR) {
         lives_alarm_t alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
-        while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(mainw->jackd)) {
+        while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(mainw->jackd)) {
           sched_yield(); // wait for seek
           lives_usleep(prefs->sleep_time);
         }
         lives_alarm_clear(alarm_handle);
       }
       if (mainw->cancelled == CANCEL_AUDIO_ERROR) mainw->cancelled = CANCEL_ERROR;
-      jack_message.command = ASERVER_CMD_FILE_CLOSE;
-      jack_message.data = NULL;
-      jack_message.next = NULL;
-      mainw->jackd->msgq = &jack_message;
+      jack_send_cmd(mainw->jackd, ASERVER_CMD_FILE_CLOSE, 0);
       if (timeout == 0) handle_audio_timeout();
       else {
         while (mainw->jackd->playing_file > -1) {
@@ -3047,6 +3044,8 @@ void play_file(void) {
           || !mainw->preview || mainw->preview_rendering)))
     audio_cache_end();
 
+  lives_readahead_stop();
+
   // terminate autolives if running
   lives_check_menu_item_set_active(LIVES_CHECK_MENU_ITEM(mainw->autolives), FALSE);
 
@@ -3112,6 +3111,8 @@ void play_file(void) {
     lives_free(stfile);
   }
 
+  if (IS_VALID_CLIP(mainw->scrap_file)) flush_scrap_file();
+
   if (IS_VALID_CLIP(mainw->scrap_file) && mainw->files[mainw->scrap_file]->ext_src) {
     lives_close_buffered(LIVES_POINTER_TO_INT(mainw->files[mainw->scrap_file]->ext_src));
     mainw->files[mainw->scrap_file]->ext_src = NULL;
@@ -3330,7 +3331,7 @@ void play_file(void) {
   if (audio_player == AUD_PLAYER_JACK && mainw->jackd) {
     ticks_t timeout;
     lives_alarm_t alarm_handle = lives_alarm_set(LIVES_DEFAULT_TIMEOUT);
-    while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_get_msgq(mainw->jackd)) {
+    while ((timeout = lives_alarm_check(alarm_handle)) > 0 && jack_cmdq_pending(mainw->jackd)) {
       sched_yield(); ///< wait for seek
       lives_usleep(prefs->sleep_time);
     }
@@ -5227,6 +5228,137 @@ void add_to_ascrap_mb(uint64_t bytes) {
 }
 
 
+/// frames waiting to be written to the scrap file; filled by the player, emptied by scrap_writer()
+static weed_layer_t *scrap_queue[SCRAP_QUEUE_FRAMES];
+static size_t scrap_queue_sizes[SCRAP_QUEUE_FRAMES]; ///< uncompressed size of each frame
+static int scrap_queue_head = 0, scrap_queue_count = 0;
+static size_t scrap_queue_bytes = 0;
+static boolean scrap_writer_running = FALSE, scrap_writer_die = FALSE;
+static pthread_t scrap_writer_thread;
+static pthread_mutex_t scrap_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t scrap_queue_cond = PTHREAD_COND_INITIALIZER; ///< a frame was queued, or the writer should exit
+static pthread_cond_t scrap_done_cond = PTHREAD_COND_INITIALIZER; ///< a frame was written
+static lives_scrap_stats_t scrap_stats;
+
+/// the writer has its own fd; clip ext_src is only used for reading
+static int scrap_wfd = -1;
+static off_t scrap_wpos = 0; ///< where the next frame will be written
+/// offset of each frame in the file (-1 if it could not be written), by frame number - 1; see SCRAP_INDEX_MAGIC
+static int64_t *scrap_index = NULL;
+static int scrap_index_len = 0, scrap_index_size = 0;
+static boolean scrap_index_dirty = FALSE; ///< frames were added since the index was last written to the file
+static boolean scrap_index_loaded = FALSE; ///< we already looked for an index in the file
+
+
+static void scrap_index_reset(void) {
+  // called with scrap_queue_mutex locked
+  lives_freep((void **)&scrap_index);
+  scrap_index_len = scrap_index_size = 0;
+  scrap_index_dirty = scrap_index_loaded = FALSE;
+  scrap_wpos = 0;
+}
+
+
+static boolean scrap_index_append(int64_t offs) {
+  // called with scrap_queue_mutex locked
+  if (scrap_index_len == scrap_index_size) {
+    int nsize = scrap_index_size ? scrap_index_size * 2 : 1024;
+    int64_t *nindex = (int64_t *)lives_realloc(scrap_index, nsize * sizeof(int64_t));
+    if (!nindex) return FALSE;
+    scrap_index = nindex;
+    scrap_index_size = nsize;
+  }
+  scrap_index[scrap_index_len++] = offs;
+  scrap_index_dirty = TRUE;
+  return TRUE;
+}
+
+
+static void scrap_index_write(int fd) {
+  // append the index to the file; called with scrap_queue_mutex locked
+  uint64_t n = scrap_index_len;
+  uint32_t ival = SCRAP_INDEX_MAGIC;
+  lives_write_le_buffered(fd, &ival, 4, TRUE);
+  lives_write_le_buffered(fd, &n, 8, TRUE);
+  for (int i = 0; i < scrap_index_len; i++) lives_write_le_buffered(fd, &scrap_index[i], 8, TRUE);
+  lives_write_le_buffered(fd, &n, 8, TRUE);
+  ival = SCRAP_INDEX_VERSION;
+  lives_write_le_buffered(fd, &ival, 4, TRUE);
+  ival = SCRAP_INDEX_MAGIC;
+  lives_write_le_buffered(fd, &ival, 4, TRUE);
+  scrap_wpos += 28 + n * 8;
+  scrap_index_dirty = FALSE;
+}
+
+
+static void scrap_index_load(int fd) {
+  // for a scrap file we did not write in this session (e.g. after crash recovery), read the index from the end of the file;
+  // if there is none (the writer never finished) rebuild it by reading through the frames.
+  // Called with scrap_queue_mutex locked.
+  off_t fsize = get_file_size(fd), offs;
+  uint64_t n, n2;
+  uint32_t magic, ver;
+
+  scrap_index_loaded = TRUE;
+
+  if (fsize >= 28) {
+    lives_lseek_buffered_rdonly_absolute(fd, fsize - 16);
+    if (lives_read_le_buffered(fd, &n, 8, TRUE) == 8 && lives_read_le_buffered(fd, &ver, 4, TRUE) == 4
+        && lives_read_le_buffered(fd, &magic, 4, TRUE) == 4 && magic == SCRAP_INDEX_MAGIC && ver == SCRAP_INDEX_VERSION
+        && n <= (uint64_t)(fsize - 28) / 8 && n < INT_MAX) {
+      lives_lseek_buffered_rdonly_absolute(fd, fsize - 28 - n * 8);
+      if (lives_read_le_buffered(fd, &magic, 4, TRUE) == 4 && magic == SCRAP_INDEX_MAGIC
+          && lives_read_le_buffered(fd, &n2, 8, TRUE) == 8 && n2 == n
+          && (scrap_index = (int64_t *)lives_calloc(n ? n : 1, sizeof(int64_t)))) {
+        scrap_index_size = n ? n : 1;
+        for (; (uint64_t)scrap_index_len < n; scrap_index_len++) {
+          if (lives_read_le_buffered(fd, &scrap_index[scrap_index_len], 8, TRUE) < 8) break;
+        }
+      }
+    }
+  }
+
+  if (!scrap_index_len) {
+    lives_lseek_buffered_rdonly_absolute(fd, 0);
+    while (1) {
+      weed_layer_t *layer;
+      offs = lives_buffered_offset(fd);
+      if (lives_read_le_buffered(fd, &magic, 4, TRUE) < 4) break;
+      if (magic == SCRAP_INDEX_MAGIC) {
+        // index from an earlier recording pass, skip over it
+        if (lives_read_le_buffered(fd, &n, 8, TRUE) < 8 || n > (uint64_t)fsize) break;
+        lives_lseek_buffered_rdonly_absolute(fd, offs + 28 + n * 8);
+        continue;
+      }
+      lives_lseek_buffered_rdonly_absolute(fd, offs);
+      layer = weed_layer_new(WEED_LAYER_TYPE_VIDEO);
+      if (!weed_plant_deserialise(fd, NULL, layer)) {
+        weed_layer_free(layer);
+        break;
+      }
+      weed_layer_free(layer);
+      if (!scrap_index_append(offs)) break;
+    }
+  }
+
+  scrap_index_dirty = FALSE;
+  /// anything recorded from now on is added after what is there already
+  if (!scrap_wpos) scrap_wpos = fsize;
+  lives_lseek_buffered_rdonly_absolute(fd, 0);
+}
+
+
+static int64_t scrap_frame_offset(int fd, int frame) {
+  // returns the offset of frame in the scrap file, or -1 if it is not known
+  int64_t offs = -1;
+  pthread_mutex_lock(&scrap_queue_mutex);
+  if (!scrap_index_len && !scrap_index_loaded && !scrap_writer_running && scrap_wfd < 0) scrap_index_load(fd);
+  if (frame > 0 && frame <= scrap_index_len) offs = scrap_index[frame - 1];
+  pthread_mutex_unlock(&scrap_queue_mutex);
+  return offs;
+}
+
+
 boolean open_scrap_file(void) {
   // create a scrap file for recording generated video frames
   int current_file = mainw->current_file;
@@ -5255,6 +5387,11 @@ boolean open_scrap_file(void) {
 
   lives_snprintf(cfile->type, 40, "scrap");
 
+  pthread_mutex_lock(&scrap_queue_mutex);
+  lives_memset(&scrap_stats, 0, sizeof(lives_scrap_stats_t));
+  scrap_index_reset();
+  pthread_mutex_unlock(&scrap_queue_mutex);
+
   scrap_handle = lives_strdup_printf("scrap|%s", cfile->handle);
   if (prefs->crash_recovery) add_to_recovery_file(scrap_handle);
   lives_free(scrap_handle);
@@ -5368,12 +5505,14 @@ boolean load_from_scrap_file(weed_layer_t *layer, int frame) {
 
   lives_clip_t *scrapfile = mainw->files[mainw->scrap_file];
 
+  int64_t offs;
   int fd;
   if (!IS_VALID_CLIP(mainw->scrap_file)) return FALSE;
 
   if (!scrapfile->ext_src) {
     oname = make_image_file_name(scrapfile, 1, LIVES_FILE_EXT_SCRAP);
-    fd = lives_open_buffered_rdonly(oname);
+    /// the scrap file only ever grows while open, so it is safe to map
+    fd = lives_open_buffered_rdonly_mapped(oname);
     lives_free(oname);
     if (fd < 0) return FALSE;
 #ifdef HAVE_POSIX_FADVISE
@@ -5385,6 +5524,10 @@ boolean load_from_scrap_file(weed_layer_t *layer, int frame) {
 
   if (frame < 0 || !layer) return TRUE; /// just open fd
 
+  /// frames written by the scrap writer are indexed, so we can go straight there;
+  /// otherwise we read from wherever the last seek left us
+  if ((offs = scrap_frame_offset(fd, frame)) >= 0) lives_lseek_buffered_rdonly_absolute(fd, offs);
+
   if (!weed_plant_deserialise(fd, NULL, layer)) {
     //g_print("bad scrapfile frame\n");
     return FALSE;
@@ -5483,11 +5626,10 @@ boolean check_for_disk_space(boolean fullcheck) {
 }
 
 
-static void _save_to_scrap_file(weed_layer_t *layer) {
-  // returns frame number
-  // dump the raw layer (frame) data to disk
-
-  // TODO: run as bg thread
+static size_t _save_to_scrap_file(weed_layer_t *layer, uint64_t nframe) {
+  // dump the raw layer (frame) data to disk, and free the layer
+  // returns the number of bytes written
+  // runs in the scrap writer thread
 
   size_t pdata_size;
 
@@ -5500,7 +5642,7 @@ static void _save_to_scrap_file(weed_layer_t *layer) {
   //int flags = O_WRONLY | O_CREAT | O_TRUNC;
   int fd;
 
-  if (!scrapfile->ext_src) {
+  if (scrap_wfd < 0) {
     char *oname = make_image_file_name(scrapfile, 1, LIVES_FILE_EXT_SCRAP), *dirname;
 
 #ifdef O_NOATIME
@@ -5511,30 +5653,29 @@ static void _save_to_scrap_file(weed_layer_t *layer) {
     lives_mkdir_with_parents(dirname, capable->umask);
     lives_free(dirname);
 
-    fd = lives_create_buffered_nosync(oname, DEF_FILE_PERMS);
+    /// after the first pass we append, so that frames already indexed stay where they are
+    if (scrap_wpos > 0) fd = lives_append_buffered_nosync(oname, DEF_FILE_PERMS);
+    else fd = lives_create_buffered_nosync(oname, DEF_FILE_PERMS);
     lives_free(oname);
 
     if (fd < 0) {
       weed_layer_free(layer);
-      return;
+      return 0;
     }
-    scrapfile->ext_src = LIVES_INT_TO_POINTER(fd);
-    scrapfile->ext_src_type = LIVES_EXT_SRC_FILE_BUFF;
+    scrap_wfd = fd;
 
 #ifdef HAVE_POSIX_FADVISE
     posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
 #endif
-  } else fd = LIVES_POINTER_TO_INT(scrapfile->ext_src);
+  } else fd = scrap_wfd;
 
 
-  // serialise entire frame to scrap file
-  pdata_size = weed_plant_serialise(fd, layer, NULL);
+  // serialise entire frame to scrap file, compressing the pixel data
+  pdata_size = weed_layer_serialise_compressed(fd, layer);
   weed_layer_free(layer);
 
-  scrapfile->f_size += pdata_size;
-
   // check free space every 256 frames or every 10 MB of audio (TODO ****)
-  if ((scrapfile->frames & 0xFF) == 0) {
+  if ((nframe & 0xFF) == 0) {
     char *dir = lives_build_filename(prefs->workdir, scrapfile->handle, NULL);
     free_mb = (double)get_ds_free(dir) / 1000000.;
     if (free_mb == 0) writeable = is_writeable_dir(dir);
@@ -5561,34 +5702,175 @@ static void _save_to_scrap_file(weed_layer_t *layer) {
   }
 
   /// check every 64 frames for quota overrun, because its a background task
-  check_for_disk_space((scrapfile->frames & 0x3F) ? TRUE : FALSE);
+  check_for_disk_space((nframe & 0x3F) ? TRUE : FALSE);
+
+  return pdata_size;
+}
+
+
+static void scrap_write_frame(weed_layer_t *layer, size_t rawsize) {
+  // write one frame at the end of the scrap file and add it to the index; called without scrap_queue_mutex
+  off_t offs = scrap_wpos;
+  size_t written = _save_to_scrap_file(layer, scrap_stats.frames_written);
+
+  pthread_mutex_lock(&scrap_queue_mutex);
+  scrap_index_append(written ? offs : -1);
+  scrap_wpos += written;
+  mainw->files[mainw->scrap_file]->f_size += written;
+  scrap_stats.frames_written++;
+  scrap_stats.bytes_written += written;
+  scrap_stats.raw_bytes += rawsize;
+  pthread_mutex_unlock(&scrap_queue_mutex);
+}
+
+
+static void *scrap_writer(void *arg) {
+  // write queued frames to the scrap file in order until told to exit, then drain the queue
+  weed_layer_t *layer;
+  size_t rawsize;
+
+  pthread_mutex_lock(&scrap_queue_mutex);
+  while (1) {
+    while (!scrap_queue_count && !scrap_writer_die) pthread_cond_wait(&scrap_queue_cond, &scrap_queue_mutex);
+    if (!scrap_queue_count) break;
+
+    layer = scrap_queue[scrap_queue_head];
+    rawsize = scrap_queue_sizes[scrap_queue_head];
+    pthread_mutex_unlock(&scrap_queue_mutex);
+
+    scrap_write_frame(layer, rawsize);
+
+    pthread_mutex_lock(&scrap_queue_mutex);
+    scrap_queue_head = (scrap_queue_head + 1) % SCRAP_QUEUE_FRAMES;
+    scrap_queue_count--;
+    scrap_queue_bytes -= rawsize;
+    pthread_cond_broadcast(&scrap_done_cond);
+  }
+  pthread_mutex_unlock(&scrap_queue_mutex);
+  return NULL;
+}
+
+
+static void scrap_writer_stop(void) {
+  // wait for all queued frames to be written, then stop the writer thread
+  pthread_mutex_lock(&scrap_queue_mutex);
+  if (!scrap_writer_running) {
+    pthread_mutex_unlock(&scrap_queue_mutex);
+    return;
+  }
+  scrap_writer_die = TRUE;
+  pthread_cond_signal(&scrap_queue_cond);
+  pthread_mutex_unlock(&scrap_queue_mutex);
+
+  pthread_join(scrap_writer_thread, NULL);
+  scrap_writer_running = FALSE;
+}
+
+
+/**
+   @brief queue a frame for the scrap file, taking ownership of layer
+
+   the frame is written later by the scrap writer thread, which frees the layer; the caller must not touch it afterwards.
+   The frame number is assigned immediately (and returned), and the writer records where the frame ends up in the
+   scrap file index, so load_from_scrap_file() can find it by number however well it compressed.
+
+   If the writer falls too far behind (SCRAP_QUEUE_FRAMES / SCRAP_QUEUE_MAX_BYTES) we wait for it, rather than drop
+   a frame which the event list already refers to. Such waits are counted in the stats (see scrap_file_get_stats()).
+*/
+int save_to_scrap_file_take(weed_layer_t *layer) {
+  lives_clip_t *scrapfile;
+  size_t size;
+  int idx;
+
+  if (!IS_VALID_CLIP(mainw->scrap_file)) {
+    if (layer) weed_layer_free(layer);
+    return -1;
+  }
+  scrapfile = mainw->files[mainw->scrap_file];
+  if (!layer) return scrapfile->frames;
+
+  size = weed_plant_serialised_size(layer);
+
+  pthread_mutex_lock(&scrap_queue_mutex);
+  if (!scrap_writer_running) {
+    scrap_writer_die = FALSE;
+    if (pthread_create(&scrap_writer_thread, NULL, scrap_writer, NULL)) {
+      // cannot start the writer, write it here
+      scrap_stats.frames_queued++;
+      pthread_mutex_unlock(&scrap_queue_mutex);
+      scrap_write_frame(layer, size);
+      return ++scrapfile->frames;
+    }
+    scrap_writer_running = TRUE;
+  }
+
+  if (scrap_queue_count == SCRAP_QUEUE_FRAMES
+      || (scrap_queue_count > 0 && scrap_queue_bytes + size > SCRAP_QUEUE_MAX_BYTES)) {
+    ticks_t tstart = lives_get_current_ticks();
+    uint64_t usec;
+    scrap_stats.stalls++;
+    while (scrap_queue_count == SCRAP_QUEUE_FRAMES
+           || (scrap_queue_count > 0 && scrap_queue_bytes + size > SCRAP_QUEUE_MAX_BYTES))
+      pthread_cond_wait(&scrap_done_cond, &scrap_queue_mutex);
+    usec = (uint64_t)((lives_get_current_ticks() - tstart) / USEC_TO_TICKS);
+    scrap_stats.stall_usec += usec;
+    if (usec > scrap_stats.max_stall_usec) scrap_stats.max_stall_usec = usec;
+  }
+
+  idx = (scrap_queue_head + scrap_queue_count) % SCRAP_QUEUE_FRAMES;
+  scrap_queue[idx] = layer;
+  scrap_queue_sizes[idx] = size;
+  scrap_queue_count++;
+  scrap_queue_bytes += size;
+  scrap_stats.frames_queued++;
+  if (scrap_queue_count > scrap_stats.max_depth) scrap_stats.max_depth = scrap_queue_count;
+  if (scrap_queue_bytes > scrap_stats.max_bytes) scrap_stats.max_bytes = scrap_queue_bytes;
+
+  pthread_cond_signal(&scrap_queue_cond);
+  pthread_mutex_unlock(&scrap_queue_mutex);
+
+  return ++scrapfile->frames;
 }
 
-static lives_proc_thread_t scrap_file_procthrd = NULL;
 
 int save_to_scrap_file(weed_layer_t *layer) {
-  weed_layer_t *orig_layer;
-  lives_clip_t *scrapfile = mainw->files[mainw->scrap_file];
+  // queue a copy of layer for the scrap file; the caller keeps the original
   if (!IS_VALID_CLIP(mainw->scrap_file)) return -1;
-  if (!layer) return scrapfile->frames;
-  orig_layer = weed_layer_copy(NULL, layer);
-  if (scrap_file_procthrd) {
-    lives_proc_thread_join(scrap_file_procthrd);
-  }
-  scrap_file_procthrd = lives_proc_thread_create(LIVES_THRDATTR_NONE,
-                        (lives_funcptr_t)_save_to_scrap_file, -1, "V", orig_layer);
-  return scrapfile->frames;
+  if (!layer) return mainw->files[mainw->scrap_file]->frames;
+  return save_to_scrap_file_take(weed_layer_copy(NULL, layer));
 }
 
+
+void scrap_file_get_stats(lives_scrap_stats_t *stats) {
+  pthread_mutex_lock(&scrap_queue_mutex);
+  lives_memcpy(stats, &scrap_stats, sizeof(lives_scrap_stats_t));
+  pthread_mutex_unlock(&scrap_queue_mutex);
+}
+
+/**
+   @brief make everything recorded so far readable from the scrap file
+
+   waits for the queued frames to be written, then appends the frame index and closes the writer's fd.
+   If recording continues, the writer is restarted and appends to the file.
+*/
+void flush_scrap_file(void) {
+  scrap_writer_stop();
+  pthread_mutex_lock(&scrap_queue_mutex);
+  if (scrap_wfd >= 0) {
+    if (scrap_index_dirty) scrap_index_write(scrap_wfd);
+    lives_close_buffered(scrap_wfd);
+    scrap_wfd = -1;
+  }
+  pthread_mutex_unlock(&scrap_queue_mutex);
+}
+
+
 void close_scrap_file(boolean remove) {
   int current_file = mainw->current_file;
 
   if (!IS_VALID_CLIP(mainw->scrap_file)) return;
 
-  if (scrap_file_procthrd) {
-    lives_proc_thread_join(scrap_file_procthrd);
-    scrap_file_procthrd = NULL;
-  }
+  flush_scrap_file();
 
   mainw->current_file = mainw->scrap_file;
   if (cfile->ext_src && cfile->ext_src_type == LIVES_EXT_SRC_FILE_BUFF)
@@ -5605,6 +5887,10 @@ void close_scrap_file(boolean remove) {
 
   if (prefs->crash_recovery) rewrite_recovery_file();
 
+  pthread_mutex_lock(&scrap_queue_mutex);
+  scrap_index_reset();
+  pthread_mutex_unlock(&scrap_queue_mutex);
+
   mainw->scrap_file = -1;
 }
 
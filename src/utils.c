@@ -7,6 +7,7 @@
 #include <fcntl.h>
 #include <dirent.h>
 #include <sys/statvfs.h>
+#include <sys/mman.h>
 #ifdef HAVE_LIBEXPLAIN
 #include <libexplain/system.h>
 #include <libexplain/read.h>
@@ -638,6 +639,92 @@ LIVES_GLOBAL_INLINE int lives_open_buffered_rdonly(const char *pathname) {
 }
 
 
+static boolean file_buffer_map(lives_file_buffer_t *fbuff) {
+  // map (or remap, if the size changed) the whole file; returns FALSE if it cannot be mapped
+  struct stat filestat;
+  void *map;
+
+  if (fstat(fbuff->fd, &filestat) || filestat.st_size <= 0 || (uint64_t)filestat.st_size > (uint64_t)SIZE_MAX)
+    return FALSE;
+  if (fbuff->mapped && (size_t)filestat.st_size == fbuff->mapsize) return TRUE;
+
+  map = mmap(NULL, (size_t)filestat.st_size, PROT_READ, MAP_SHARED, fbuff->fd, 0);
+  if (map == MAP_FAILED) return FALSE;
+
+  if (fbuff->mapped) munmap(fbuff->mapped, fbuff->mapsize);
+  fbuff->mapped = (uint8_t *)map;
+  fbuff->mapsize = (size_t)filestat.st_size;
+  fbuff->advised = -1;
+
+  /// the kernel's own readahead only works forwards; in reverse we rely on file_buffer_advise()
+  posix_madvise(fbuff->mapped, fbuff->mapsize, fbuff->reversed ? POSIX_MADV_RANDOM : POSIX_MADV_SEQUENTIAL);
+  return TRUE;
+}
+
+
+static void file_buffer_advise(lives_file_buffer_t *fbuff) {
+  // ask for the next stretch of a mapped file to be paged in, in the direction of reading
+  static size_t pgsize = 0;
+  off_t start, len = BUFFER_MAP_ADVISE_BYTES, aligned;
+
+  if (fbuff->advised >= 0 && fbuff->offset > fbuff->advised - (BUFFER_MAP_ADVISE_BYTES >> 1)
+      && fbuff->offset < fbuff->advised + (BUFFER_MAP_ADVISE_BYTES >> 1)) return;
+  fbuff->advised = fbuff->offset;
+
+  if (!pgsize) pgsize = (size_t)sysconf(_SC_PAGESIZE);
+
+  start = fbuff->reversed ? fbuff->offset - len : fbuff->offset;
+  if (start < 0) {
+    len += start;
+    start = 0;
+  }
+  if (start + len > (off_t)fbuff->mapsize) len = (off_t)fbuff->mapsize - start;
+  if (len <= 0) return;
+
+  aligned = start & ~((off_t)pgsize - 1);
+  posix_madvise(fbuff->mapped + aligned, len + start - aligned, POSIX_MADV_WILLNEED);
+}
+
+
+/**
+   @brief bytes readable in place from a mapped file at the current offset, up to count
+
+   remaps first if the read would go past the end of the mapping, since the file may have grown
+   (e.g. a scrap file which is still being recorded)
+*/
+static ssize_t file_buffer_mapped_avail(lives_file_buffer_t *fbuff, ssize_t count) {
+  ssize_t avail;
+  if (fbuff->offset + count > (off_t)fbuff->mapsize) file_buffer_map(fbuff);
+  avail = fbuff->offset < (off_t)fbuff->mapsize ? (off_t)fbuff->mapsize - fbuff->offset : 0;
+  if (count > avail) {
+    count = avail;
+    fbuff->eof = TRUE;
+  } else fbuff->eof = FALSE;
+  if (count > 0) file_buffer_advise(fbuff);
+  return count;
+}
+
+
+/**
+   @brief open a file for buffered reading via a memory mapping
+
+   reads are copied straight out of the page cache rather than through an intermediate buffer,
+   and lives_read_buffered_borrow() can hand out pointers into the mapping without copying at all.
+   Paging hints follow lives_buffered_rdonly_set_reversed().
+
+   If the file cannot be mapped (e.g. it is empty) this behaves exactly like lives_open_buffered_rdonly().
+   Do not use this for files which may be truncated while open.
+*/
+int lives_open_buffered_rdonly_mapped(const char *pathname) {
+  int fd = lives_open_real_buffered(pathname, O_RDONLY, 0, TRUE);
+  if (fd >= 0) {
+    lives_file_buffer_t *fbuff = find_in_file_buffers(fd);
+    if (fbuff) file_buffer_map(fbuff);
+  }
+  return fd;
+}
+
+
 boolean _lives_buffered_rdonly_slurp(int fd, off_t skip) {
   lives_file_buffer_t *fbuff = find_in_file_buffers(fd);
   off_t fsize = get_file_size(fd) - skip, bufsize = smbytes, res;
@@ -670,7 +757,7 @@ boolean _lives_buffered_rdonly_slurp(int fd, off_t skip) {
 
 void lives_buffered_rdonly_slurp(int fd, off_t skip) {
   lives_file_buffer_t *fbuff = find_in_file_buffers(fd);
-  if (!fbuff || fbuff->slurping) return;
+  if (!fbuff || fbuff->slurping || fbuff->mapped) return;
   fbuff->slurping = TRUE;
   fbuff->bytes = fbuff->offset = 0;
   lives_proc_thread_create(LIVES_THRDATTR_NONE, (lives_funcptr_t)_lives_buffered_rdonly_slurp, 0, "iI", fd, skip);
@@ -685,6 +772,10 @@ LIVES_GLOBAL_INLINE boolean lives_buffered_rdonly_set_reversed(int fd, boolean v
     LIVES_DEBUG("lives_buffered_readonly_set_reversed: no file buffer found");
     return FALSE;
   }
+  if (fbuff->mapped && val != fbuff->reversed) {
+    posix_madvise(fbuff->mapped, fbuff->mapsize, val ? POSIX_MADV_RANDOM : POSIX_MADV_SEQUENTIAL);
+    fbuff->advised = -1;
+  }
   fbuff->reversed = val;
   return TRUE;
 }
@@ -703,6 +794,10 @@ LIVES_GLOBAL_INLINE int lives_create_buffered_nosync(const char *pathname, int m
   return lives_open_real_buffered(pathname, O_CREAT | O_WRONLY | O_TRUNC, mode, FALSE);
 }
 
+LIVES_GLOBAL_INLINE int lives_append_buffered_nosync(const char *pathname, int mode) {
+  return lives_open_real_buffered(pathname, O_CREAT | O_WRONLY | O_APPEND, mode, FALSE);
+}
+
 int lives_open_buffered_writer(const char *pathname, int mode, boolean append) {
   return lives_open_real_buffered(pathname, O_CREAT | O_WRONLY | O_DSYNC | (append ? O_APPEND : 0), mode, FALSE);
 }
@@ -763,6 +858,9 @@ int lives_close_buffered(int fd) {
     lives_free(fbuff->buffer);
   }
 
+  if (fbuff->mapped) munmap(fbuff->mapped, fbuff->mapsize);
+  lives_freep((void **)&fbuff->bounce);
+
   lives_free(fbuff);
   return ret;
 }
@@ -847,6 +945,14 @@ static off_t _lives_lseek_buffered_rdonly_relative(lives_file_buffer_t *fbuff, o
   if (offset == 0) return fbuff->offset - fbuff->bytes;
   fbuff->nseqreads = 0;
 
+  if (fbuff->mapped) {
+    // nothing is buffered, the offset is simply the read position
+    fbuff->offset += offset;
+    if (fbuff->offset < 0) fbuff->offset = 0;
+    fbuff->eof = FALSE;
+    return fbuff->offset;
+  }
+
   if (offset > 0) {
     // seek forwards
     if (offset < fbuff->bytes) {
@@ -914,6 +1020,7 @@ off_t lives_lseek_buffered_rdonly_absolute(int fd, off_t offset) {
 
   if (!fbuff->ptr || !fbuff->buffer) {
     fbuff->offset = offset;
+    fbuff->eof = FALSE;
     return fbuff->offset;
   }
   offset -= fbuff->offset - fbuff->bytes;
@@ -943,6 +1050,18 @@ ssize_t lives_read_buffered(int fd, void *buf, ssize_t count, boolean allow_less
     return 0;
   }
 
+  if (fbuff->mapped) {
+    /// copy directly from the mapping; with buf == NULL this just prefetches
+    retval = file_buffer_mapped_avail(fbuff, count);
+    if (!buf) return retval;
+    lives_memcpy(buf, fbuff->mapped + fbuff->offset, retval);
+    fbuff->offset += retval;
+    fbuff->totbytes += retval;
+    fbuff->totops++;
+    count -= retval;
+    goto rd_exit;
+  }
+
   bufsztype = fbuff->bufsztype;
 
 #ifdef AUTOTUNE
@@ -1183,6 +1302,64 @@ boolean lives_read_buffered_eof(int fd) {
 }
 
 
+/**
+   @brief read without copying: *ptr is set to point at up to count bytes of file data at the current position
+
+   returns the number of bytes available at *ptr, which is fewer than count only at the end of the file, or -1 on error.
+   The data must be treated as read only, and remains valid only until the next read, seek or close on fd.
+
+   For a file opened with lives_open_buffered_rdonly_mapped() this is a view into the mapping; otherwise the data is lent
+   from the read buffer when it is already there, and copied into a buffer owned by the file buffer when it is not.
+*/
+ssize_t lives_read_buffered_borrow(int fd, const uint8_t **ptr, ssize_t count) {
+  lives_file_buffer_t *fbuff;
+  ssize_t res;
+
+  *ptr = NULL;
+  if (count <= 0) return 0;
+
+  if ((fbuff = find_in_file_buffers(fd)) == NULL) {
+    LIVES_DEBUG("lives_read_buffered_borrow: no file buffer found");
+    return -1;
+  }
+
+  if (!fbuff->read) {
+    LIVES_ERROR("lives_read_buffered_borrow: wrong buffer type");
+    return -1;
+  }
+
+  if (fbuff->mapped) {
+    res = file_buffer_mapped_avail(fbuff, count);
+    *ptr = fbuff->mapped + fbuff->offset;
+    fbuff->offset += res;
+    fbuff->totbytes += res;
+    fbuff->totops++;
+    return res;
+  }
+
+  if (!fbuff->slurping && !fbuff->invalid && fbuff->buffer && fbuff->bytes >= count) {
+    // already buffered, lend it in place
+    *ptr = fbuff->ptr;
+    fbuff->ptr += count;
+    fbuff->bytes -= count;
+    fbuff->totbytes += count;
+    fbuff->totops++;
+    fbuff->nseqreads++;
+    return count;
+  }
+
+  if (fbuff->bounce_size < (size_t)count) {
+    lives_freep((void **)&fbuff->bounce);
+    fbuff->bounce_size = 0;
+    if (!(fbuff->bounce = (uint8_t *)lives_malloc(count))) return -1;
+    fbuff->bounce_size = count;
+  }
+  res = lives_read_buffered(fd, fbuff->bounce, count, TRUE);
+  if (res >= 0) *ptr = fbuff->bounce;
+  return res;
+}
+
+
 static ssize_t lives_write_buffered_direct(lives_file_buffer_t *fbuff, const char *buf, ssize_t count, boolean allow_fail) {
   ssize_t res = 0;
   ssize_t bytes = fbuff->bytes;
@@ -1388,6 +1565,166 @@ size_t lives_buffered_orig_size(int fd) {
 }
 
 
+/////////////////////////////////////////////
+/// fast lossless compression (LZ4 style block format) for frame data
+
+/// a block is a sequence of: token (literal count << 4 | (match length - LIVES_LZ_MINMATCH)), [extra literal count],
+/// literals, 2 byte little endian match offset, [extra match length]; a count of 15 in the token continues in following bytes,
+/// each of which is added until one is less than 255. The final sequence has only literals.
+#define LZ_HASH_LOG 14
+#define LZ_MAX_OFFSET 65535
+#define LZ_LAST_LITERALS 5 ///< the last bytes are always literals
+#define LZ_MFLIMIT 12 ///< no match may start this close to the end
+#define LZ_SKIP_SHIFT 6 ///< when nothing matches, move on faster the longer it lasts
+
+LIVES_LOCAL_INLINE uint32_t lz_read32(const uint8_t *p) {
+  uint32_t v;
+  lives_memcpy(&v, p, 4);
+  return v;
+}
+
+LIVES_LOCAL_INLINE uint32_t lz_hash(uint32_t v) {
+  return (v * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+/// bytes needed after the token for a count of len
+LIVES_LOCAL_INLINE size_t lz_len_bytes(size_t len) {
+  return len >= 15 ? (len - 15) / 255 + 1 : 0;
+}
+
+LIVES_LOCAL_INLINE uint8_t *lz_put_len(uint8_t *op, size_t len) {
+  for (; len >= 255; len -= 255) *op++ = 255;
+  *op++ = (uint8_t)len;
+  return op;
+}
+
+
+/**
+   @brief compress srclen bytes from src into dst
+
+   returns the compressed size, or 0 if the result would not fit in dstlen bytes (so passing dstlen < srclen
+   asks for the data only if it compresses). LIVES_LZ_BOUND(srclen) bytes are always enough.
+   Inputs larger than LIVES_LZ_MAX_INPUT are not compressed.
+*/
+size_t lives_lz_compress(const uint8_t *src, size_t srclen, uint8_t *dst, size_t dstlen) {
+  const uint8_t *ip = src, *anchor = src, *iend = src + srclen;
+  const uint8_t *mflimit = iend - LZ_MFLIMIT, *matchlimit = iend - LZ_LAST_LITERALS;
+  uint8_t *op = dst, *oend = dst + dstlen, *token;
+  uint32_t *htab;
+  size_t lits, mlen;
+
+  if (srclen > LIVES_LZ_MAX_INPUT) return 0;
+  if (!(htab = (uint32_t *)lives_calloc(1 << LZ_HASH_LOG, 4))) return 0;
+
+  if (srclen > LZ_MFLIMIT) {
+    while (ip < mflimit) {
+      uint32_t seq = lz_read32(ip), h = lz_hash(seq);
+      const uint8_t *ref = src + htab[h];
+      htab[h] = (uint32_t)(ip - src);
+      if (ref >= ip || ip - ref > LZ_MAX_OFFSET || lz_read32(ref) != seq) {
+        ip += 1 + ((ip - anchor) >> LZ_SKIP_SHIFT);
+        continue;
+      }
+      while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+        ip--;
+        ref--;
+      }
+      for (mlen = LIVES_LZ_MINMATCH; ip + mlen < matchlimit && ip[mlen] == ref[mlen]; mlen++);
+
+      lits = ip - anchor;
+      if ((size_t)(oend - op) < 1 + lz_len_bytes(lits) + lits + 2 + lz_len_bytes(mlen - LIVES_LZ_MINMATCH)) {
+        lives_free(htab);
+        return 0;
+      }
+      token = op++;
+      if (lits >= 15) {
+        *token = 15 << 4;
+        op = lz_put_len(op, lits - 15);
+      } else *token = (uint8_t)(lits << 4);
+      lives_memcpy(op, anchor, lits);
+      op += lits;
+      *op++ = (uint8_t)((ip - ref) & 0xFF);
+      *op++ = (uint8_t)((ip - ref) >> 8);
+      mlen -= LIVES_LZ_MINMATCH;
+      if (mlen >= 15) {
+        *token |= 15;
+        op = lz_put_len(op, mlen - 15);
+      } else *token |= (uint8_t)mlen;
+      ip += mlen + LIVES_LZ_MINMATCH;
+      anchor = ip;
+      if (ip < mflimit) htab[lz_hash(lz_read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+    }
+  }
+
+  lits = iend - anchor;
+  if ((size_t)(oend - op) < 1 + lz_len_bytes(lits) + lits) {
+    lives_free(htab);
+    return 0;
+  }
+  token = op++;
+  if (lits >= 15) {
+    *token = 15 << 4;
+    op = lz_put_len(op, lits - 15);
+  } else *token = (uint8_t)(lits << 4);
+  lives_memcpy(op, anchor, lits);
+  op += lits;
+
+  lives_free(htab);
+  return op - dst;
+}
+
+
+/**
+   @brief decompress a block made by lives_lz_compress() into dst
+
+   returns the number of bytes produced, or -1 if the block is damaged or would overflow dstlen
+*/
+ssize_t lives_lz_decompress(const uint8_t *src, size_t srclen, uint8_t *dst, size_t dstlen) {
+  const uint8_t *ip = src, *iend = src + srclen, *ref;
+  uint8_t *op = dst, *oend = dst + dstlen, *mend;
+  size_t lits, mlen, offs;
+  uint8_t b;
+
+  while (ip < iend) {
+    uint8_t token = *ip++;
+    if ((lits = token >> 4) == 15) {
+      do {
+        if (ip >= iend) return -1;
+        lits += (b = *ip++);
+      } while (b == 255);
+    }
+    if (lits > (size_t)(iend - ip) || lits > (size_t)(oend - op)) return -1;
+    lives_memcpy(op, ip, lits);
+    op += lits;
+    ip += lits;
+    if (ip == iend) break;
+
+    if (iend - ip < 2) return -1;
+    offs = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (!offs || offs > (size_t)(op - dst)) return -1;
+    if ((mlen = token & 15) == 15) {
+      do {
+        if (ip >= iend) return -1;
+        mlen += (b = *ip++);
+      } while (b == 255);
+    }
+    mlen += LIVES_LZ_MINMATCH;
+    if (mlen > (size_t)(oend - op)) return -1;
+    ref = op - offs;
+    mend = op + mlen;
+    // an overlapping match repeats the pattern; each copy doubles the length we can copy in one go
+    for (; op + offs < mend; offs <<= 1) {
+      lives_memcpy(op, ref, offs);
+      op += offs;
+    }
+    lives_memcpy(op, ref, mend - op);
+    op = mend;
+  }
+  return op - dst;
+}
+
+
 /////////////////////////////////////////////
 
 int lives_chdir(const char *path, boolean no_error_dlg) {